@@ -12,6 +12,9 @@
 
 #include "klee/Expr/Expr.h"
 
+#include <memory>
+#include <vector>
+
 // FIXME: Currently we use ConstraintManager for two things: to pass
 // sets of constraints around, and to optimize constraints. We should
 // move the first usage into a separate data structure
@@ -19,6 +22,7 @@
 namespace klee {
 
 class ExprVisitor;
+class IndependenceIndex;
 
 class ConstraintManager {
 public:
@@ -50,6 +54,17 @@ public:
   const_iterator end() const { return constraints.cend(); }
   std::size_t size() const noexcept { return constraints.size(); }
 
+  /// Append the constraints that (transitively) share an array element with
+  /// \a e to \a result, preserving their order.
+  void getIndependentConstraints(const ref<Expr> &e,
+                                 std::vector<ref<Expr>> &result) const;
+
+  /// Partition \a e and the constraints into independent factors. The first
+  /// factor contains \a e (unless it is null) and all constraints depending
+  /// on it. Constraints that do not read any symbolic array are omitted.
+  std::vector<std::vector<ref<Expr>>>
+  getIndependentFactors(const ref<Expr> &e) const;
+
   bool operator==(const ConstraintManager &other) const {
     return constraints == other.constraints;
   }
@@ -61,6 +76,12 @@ public:
 private:
   std::vector<ref<Expr>> constraints;
 
+  /// Independence information about a prefix of the constraints, extended
+  /// on demand and shared between copies until one of them modifies it.
+  mutable std::shared_ptr<IndependenceIndex> independence;
+
+  const IndependenceIndex &getIndependence() const;
+
   // returns true iff the constraints were modified
   bool rewriteConstraints(ExprVisitor &visitor);
 
@@ -0,0 +1,83 @@
+//===-- IndependenceIndex.h -------------------------------------*- C++ -*-===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef KLEE_INDEPENDENCEINDEX_H
+#define KLEE_INDEPENDENCEINDEX_H
+
+#include "klee/Expr/Expr.h"
+
+#include "llvm/ADT/DenseMap.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace klee {
+
+/// Union-find over the array elements read by a sequence of constraints.
+///
+/// Every element that is read at a concrete index (arr[1]) is a node of its
+/// own, while all elements of an array that is read at a symbolic index
+/// (arr[x]) are represented by a single node. Two constraints are in the
+/// same component iff they are (transitively) connected by reading a common
+/// node, i.e. the components are exactly the independent factors of the
+/// constraints.
+class IndependenceIndex {
+public:
+  /// Node of constraints that do not read any symbolic array
+  static constexpr int noNode = -1;
+
+private:
+  struct ArrayNodes {
+    /// node representing all elements of the array, or noNode
+    int whole = noNode;
+    /// nodes of the elements read at concrete indices, empty once whole is set
+    llvm::DenseMap<unsigned, unsigned> elements;
+  };
+
+  std::unordered_map<const Array *, ArrayNodes> arrays;
+
+  // mutable because finding a root compresses paths, which does not change
+  // the represented partition
+  mutable std::vector<unsigned> parent;
+  std::vector<unsigned> size;
+
+  /// one node (or noNode) for each registered constraint
+  std::vector<int> constraintNodes;
+
+  unsigned createNode();
+  unsigned unite(unsigned a, unsigned b);
+  unsigned getElementNode(const Array *array, unsigned index);
+  unsigned getWholeNode(const Array *array);
+
+public:
+  /// Register the next constraint, connecting all elements it reads.
+  void addConstraint(const ref<Expr> &e);
+
+  /// Forget all but the first \a count registered constraints. The partition
+  /// itself is kept, as it can only become coarser than necessary.
+  void truncate(std::size_t count);
+
+  /// Number of registered constraints
+  std::size_t constraintCount() const noexcept { return constraintNodes.size(); }
+
+  /// Root of the component of the i-th registered constraint, or noNode
+  int getConstraintRoot(std::size_t i) const {
+    int node = constraintNodes[i];
+    return node == noNode ? noNode : static_cast<int>(find(node));
+  }
+
+  /// The roots of all components that share an element with \a e (sorted)
+  std::vector<unsigned> getRoots(const ref<Expr> &e) const;
+
+  unsigned find(unsigned node) const;
+};
+
+} // namespace klee
+
+#endif /* KLEE_INDEPENDENCEINDEX_H */
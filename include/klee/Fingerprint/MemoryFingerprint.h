@@ -164,6 +164,10 @@ public:
   void updateThreadWaitingOnCV_1Fragment(const ThreadId &threadId, std::uint64_t condId, std::uint64_t lockId);
   void updateThreadWaitingOnCV_2Fragment(const ThreadId &threadId, std::uint64_t condId, std::uint64_t lockId);
   void updateThreadWaitingOnJoinFragment(const ThreadId &threadId, const ThreadId &joinedId);
+  void updateThreadWaitingOnRwLockFragment(const ThreadId &threadId, std::uint64_t rwLockId, bool write);
+  void updateThreadWaitingOnSemaphoreFragment(const ThreadId &threadId, std::uint64_t semaphoreId);
+  void updateThreadWaitingOnBarrierFragment(const ThreadId &threadId, std::uint64_t barrierId, bool released);
+  void updateSemaphoreBalanceFragment(std::uint64_t semaphoreId, const ThreadId &threadId, std::int64_t balance);
 };
 
 template <typename T>
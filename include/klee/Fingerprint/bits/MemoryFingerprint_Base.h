@@ -468,4 +468,42 @@ void MemoryFingerprintT<D, S, V>::updateThreadWaitingOnJoinFragment(const Thread
   updateThreadId(joinedId);
 }
 
+template <typename D, std::size_t S, typename V>
+void MemoryFingerprintT<D, S, V>::updateThreadWaitingOnRwLockFragment(const ThreadId &threadId,
+                                                                      std::uint64_t rwLockId,
+                                                                      bool write) {
+  getDerived().updateUint8(17);
+  updateThreadId(threadId);
+  getDerived().updateUint64(rwLockId);
+  getDerived().updateUint8(write ? 1 : 0);
+}
+
+template <typename D, std::size_t S, typename V>
+void MemoryFingerprintT<D, S, V>::updateThreadWaitingOnSemaphoreFragment(const ThreadId &threadId,
+                                                                         std::uint64_t semaphoreId) {
+  getDerived().updateUint8(18);
+  updateThreadId(threadId);
+  getDerived().updateUint64(semaphoreId);
+}
+
+template <typename D, std::size_t S, typename V>
+void MemoryFingerprintT<D, S, V>::updateThreadWaitingOnBarrierFragment(const ThreadId &threadId,
+                                                                       std::uint64_t barrierId,
+                                                                       bool released) {
+  getDerived().updateUint8(19);
+  updateThreadId(threadId);
+  getDerived().updateUint64(barrierId);
+  getDerived().updateUint8(released ? 1 : 0);
+}
+
+template <typename D, std::size_t S, typename V>
+void MemoryFingerprintT<D, S, V>::updateSemaphoreBalanceFragment(std::uint64_t semaphoreId,
+                                                                 const ThreadId &threadId,
+                                                                 std::int64_t balance) {
+  getDerived().updateUint8(20);
+  getDerived().updateUint64(semaphoreId);
+  updateThreadId(threadId);
+  getDerived().updateUint64(static_cast<std::uint64_t>(balance));
+}
+
 } // namespace klee
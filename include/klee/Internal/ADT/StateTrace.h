@@ -0,0 +1,61 @@
+//===-- StateTrace.h --------------------------------------------*- C++ -*-===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Binary format of the state trace written by -log-state-trace
+// (states.trace). The file starts with a StateTraceHeader followed by
+// StateTraceRecords, each immediately followed by its ktest file name and its
+// error (both without terminating null). All values are stored in host byte
+// order; klee-state-trace converts a trace to the former states.json format.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef KLEE_STATETRACE_H
+#define KLEE_STATETRACE_H
+
+#include <cstdint>
+
+namespace klee {
+
+constexpr char StateTraceMagic[8] = {'K', 'S', 'T', 'R', 'A', 'C', 'E', '\0'};
+constexpr std::uint32_t StateTraceVersion = 1;
+
+/// Value of StateTraceRecord::instructionId for records that are not
+/// associated with an instruction (e.g. when a state terminates)
+constexpr std::uint32_t StateTraceNoInstruction = UINT32_MAX;
+
+struct StateTraceHeader {
+  char magic[8];
+  std::uint32_t version;
+  /// sizeof(StateTraceRecord) of the writer
+  std::uint32_t recordSize;
+  std::uint64_t functionPointerSize;
+  std::uint64_t memoryStateSize;
+  std::uint64_t loggingOverhead;
+  std::uint64_t functionListsLength;
+  std::uint64_t functionListsCapacity;
+};
+
+struct StateTraceRecord {
+  std::uint64_t stateId;
+  /// bytes allocated on the heap of KLEE (sampled every 0x10000 instructions)
+  std::uint64_t heap;
+  /// microseconds since the start of the executor
+  std::uint64_t timestamp;
+  std::uint64_t instructions;
+  std::uint32_t instructionId;
+  std::uint16_t ktestLength;
+  std::uint16_t errorLength;
+};
+
+static_assert(sizeof(StateTraceHeader) == 56, "unexpected padding");
+static_assert(sizeof(StateTraceRecord) == 40, "unexpected padding");
+
+} // namespace klee
+
+#endif /* KLEE_STATETRACE_H */
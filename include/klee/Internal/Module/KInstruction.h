@@ -42,6 +42,15 @@ namespace klee {
     /// Destination register index.
     unsigned dest;
 
+    /// Opcode of inst, decoded once when the KFunction is built.
+    unsigned opcode;
+    /// Size in bits of the value produced by inst, or 0 if its type is not
+    /// sized (e.g. void).
+    unsigned width;
+    /// For branches, switches and invokes: index of the first instruction of
+    /// each successor block (in successor order), null otherwise.
+    unsigned *targets;
+
   public:
     virtual ~KInstruction();
     std::string getSourceLocation() const;
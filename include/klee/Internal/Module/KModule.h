@@ -51,7 +51,8 @@ namespace klee {
     KInstruction **instructions;
 
     std::map<const llvm::BasicBlock *, unsigned> basicBlockEntry;
-    std::map<const llvm::BasicBlock *, std::vector<const KInstruction *>> basicBlockLiveSet;
+    /// Live sets of basic blocks, indexed by the entry of the basic block
+    std::unordered_map<unsigned, std::vector<const KInstruction *>> basicBlockLiveSet;
 
     /// Whether instructions in this function should count as
     /// "coverable" for statistics and search heuristics.
@@ -68,14 +69,21 @@ namespace klee {
 
     /// @brief Set which locals are live *before* executing bb.
     void setLiveLocals(llvm::BasicBlock* bb, std::vector<const KInstruction *> &&set) {
-      basicBlockLiveSet[bb] = std::move(set);
+      basicBlockLiveSet[basicBlockEntry.at(bb)] = std::move(set);
+    }
+
+    /// @brief Get set of locals live *before* executing the basic block
+    /// starting at instruction index entry.
+    const std::vector<const KInstruction *> *getLiveLocalsAt(unsigned entry) const {
+      auto it = basicBlockLiveSet.find(entry);
+      if (it == basicBlockLiveSet.end())
+        return nullptr;
+      return &it->second;
     }
 
     /// @brief Get set of locals live *before* executing bb.
     const std::vector<const KInstruction *> *getLiveLocals(const llvm::BasicBlock *bb) const {
-      if (basicBlockLiveSet.count(bb) == 0)
-        return nullptr;
-      return &basicBlockLiveSet.at(bb);
+      return getLiveLocalsAt(basicBlockEntry.at(bb));
     }
   };
 
@@ -227,6 +227,17 @@ namespace klee {
   /// \param s - The underlying solver to use.
   Solver *createCachingSolver(Solver *s);
 
+  /// createPersistentCachingSolver - Create a solver which caches the results
+  /// of queries in a memory-mapped file that can be reused by later runs and
+  /// shared by concurrently running processes. Arrays are identified by their
+  /// structure, not by their name.
+  ///
+  /// \param s - The underlying solver to use.
+  /// \param path - The cache file, which is created if it does not exist.
+  /// \param size - The size (in bytes) of a newly created cache file.
+  Solver *createPersistentCachingSolver(Solver *s, const std::string &path,
+                                        std::uint64_t size);
+
   /// createCexCachingSolver - Create a counterexample caching solver. This is a
   /// more sophisticated cache which records counterexamples for a constraint
   /// set and uses subset/superset relations among constraints to try and
@@ -25,8 +25,16 @@ namespace stats {
   extern Statistic queryCexCacheMisses;
   extern Statistic queryConstructTime;
   extern Statistic queryConstructs;
+  /// Constraints that an incremental core solver still had asserted from
+  /// a previous query
+  extern Statistic queryConstraintsReused;
+  /// Constraints that an incremental core solver had to assert
+  extern Statistic queryConstraintsAsserted;
   extern Statistic queryCounterexamples;
   extern Statistic queryTime;
+  /// Queries answered from the persistent solver cache (-solver-cache-file)
+  extern Statistic solverCacheHits;
+  extern Statistic solverCacheMisses;
   
 #ifdef KLEE_ARRAY_DEBUG
   extern Statistic arrayHashTime;
@@ -13,6 +13,7 @@
 #include "por/event/event.h"
 
 #include <map>
+#include <memory>
 #include <optional>
 #include <variant>
 #include <vector>
@@ -29,6 +30,7 @@ namespace por {
 namespace klee {
   class Array;
   class CallPathNode;
+  class ThreadSegmentLease;
 
   struct StackFrame {
     KInstIterator caller;
@@ -96,8 +98,13 @@ namespace klee {
       struct wait_cv_1_t { por::event::cond_id_t cond; por::event::lock_id_t lock; };
       struct wait_cv_2_t { por::event::cond_id_t cond; por::event::lock_id_t lock; };
       struct wait_join_t { ThreadId thread; };
+      struct wait_rdlock_t { por::event::rwlock_id_t lock; };
+      struct wait_wrlock_t { por::event::rwlock_id_t lock; };
+      struct wait_semaphore_t { por::event::semaphore_id_t semaphore; };
+      /// arrivals is empty until the last thread of the current round arrives at the barrier
+      struct wait_barrier_t { por::event::barrier_id_t barrier; std::vector<const por::event::event *> arrivals; };
 
-      using waiting_t = std::variant<wait_none_t,wait_lock_t,wait_cv_1_t,wait_cv_2_t,wait_join_t>;
+      using waiting_t = std::variant<wait_none_t,wait_lock_t,wait_cv_1_t,wait_cv_2_t,wait_join_t,wait_rdlock_t,wait_wrlock_t,wait_semaphore_t,wait_barrier_t>;
 
     private:
       /// @brief Pointer to instruction to be executed after the current
@@ -148,6 +155,9 @@ namespace klee {
       std::unique_ptr<pseudoalloc::allocator_t> threadHeapAlloc;
       std::unique_ptr<pseudoalloc::stack_allocator_t> threadStackAlloc;
 
+      /// @brief keeps the memory segments of this thread reserved while the thread exists in any state
+      std::shared_ptr<ThreadSegmentLease> segmentLease;
+
       MemoryFingerprint fingerprint;
 
       /// @brief maps allocation thread to list of memory object which were allocated
@@ -171,6 +171,32 @@ extern "C" {
   void klee_cond_signal(klee_sync_primitive_t* cond);
   void klee_cond_broadcast(klee_sync_primitive_t* cond);
 
+  /* Reader/writer locks. Return 0 on success, EDEADLK if the calling
+     thread already holds the rwlock and EPERM if it unlocks a rwlock it
+     does not hold. Recursive read acquisitions are left to the caller.
+     klee_rwlock_tryrdlock and klee_rwlock_trywrlock return EBUSY instead
+     of blocking. */
+  int klee_rwlock_rdlock(klee_sync_primitive_t* rwlock);
+  int klee_rwlock_wrlock(klee_sync_primitive_t* rwlock);
+  int klee_rwlock_tryrdlock(klee_sync_primitive_t* rwlock);
+  int klee_rwlock_trywrlock(klee_sync_primitive_t* rwlock);
+  int klee_rwlock_unlock(klee_sync_primitive_t* rwlock);
+
+  /* Counting semaphores. klee_semaphore_post returns EOVERFLOW instead of
+     incrementing a value that reached max, klee_semaphore_wait blocks until
+     the value is positive and klee_semaphore_trywait returns EAGAIN
+     instead. */
+  void klee_semaphore_init(klee_sync_primitive_t* sem, unsigned value);
+  int klee_semaphore_post(klee_sync_primitive_t* sem, unsigned max);
+  void klee_semaphore_wait(klee_sync_primitive_t* sem);
+  int klee_semaphore_trywait(klee_sync_primitive_t* sem);
+  int klee_semaphore_getvalue(klee_sync_primitive_t* sem);
+
+  /* Blocks until count threads arrived at the barrier. Afterwards,
+     klee_barrier_is_serial returns 1 for exactly one of them. */
+  void klee_barrier_wait(klee_sync_primitive_t* barrier, unsigned count);
+  int klee_barrier_is_serial(klee_sync_primitive_t* barrier);
+
 #ifdef __cplusplus
 }
 #endif
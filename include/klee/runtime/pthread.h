@@ -144,6 +144,10 @@ struct kpr_thread_data {
   void* (*threadFunction) (void* arg);
 
   kpr_list cleanupStack;
+
+  // rwlocks that are currently read-acquired by this thread, once per
+  // (recursive) acquisition
+  kpr_list readLocks;
 };
 
 struct kpr_thread {
@@ -190,13 +194,10 @@ typedef struct kpr_mutex {
 
 typedef struct {
   pthread_internal_t magic;
-  pthread_t acquiredWriter;
-  unsigned long acquiredReaderCount;
 
-  pthread_mutex_t mutex;
-  pthread_cond_t cond;
+  klee_sync_primitive_t lock;
 } pthread_rwlock_t;
-#define PTHREAD_RWLOCK_INITIALIZER { PTHREAD_INTERNAL_MAGIC, NULL, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER }
+#define PTHREAD_RWLOCK_INITIALIZER { PTHREAD_INTERNAL_MAGIC, 0 }
 
 typedef pthread_mutex_t pthread_spinlock_t;
 
@@ -212,10 +213,8 @@ typedef struct {
   pthread_internal_t magic;
 
   unsigned count;
-  unsigned currentCount;
 
-  pthread_mutex_t mutex;
-  pthread_cond_t cond;
+  klee_sync_primitive_t barrier;
 } pthread_barrier_t;
 
 // Attributes
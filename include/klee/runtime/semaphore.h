@@ -19,13 +19,8 @@
 typedef struct {
   pthread_internal_t magic;
 
-  int value;
+  klee_sync_primitive_t sem;
   const char* name;
-
-  unsigned long waitingCount;
-
-  klee_sync_primitive_t mutex;
-  klee_sync_primitive_t cond;
 } sem_t;
 
 int sem_init(sem_t *sem, int f, unsigned v);
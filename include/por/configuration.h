@@ -8,7 +8,9 @@
 #include "util/check.h"
 #include "util/sso_array.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iterator>
 #include <map>
 #include <ostream>
@@ -112,6 +114,20 @@ namespace por {
 		// contains all previous w2 events of ACTIVE condition variables
 		std::map<por::event::cond_id_t, std::vector<por::event::event const*>> _w2_heads;
 
+		// contains most recent write (if any) and all subsequent reads of each atomic
+		std::map<por::event::atomic_id_t, std::vector<por::event::event const*>> _atomic_heads;
+
+		// contains most recent write acquisition or write release (if any) and,
+		// for each thread, the most recent subsequent read acquisition or read release of each rwlock
+		// and the failed attempts (rwlock_busy) that have not been followed by a write release or acquisition
+		std::map<por::event::rwlock_id_t, std::vector<por::event::event const*>> _rwlock_heads;
+
+		// contains creation or most recent semaphore_wait and all subsequent posts of each semaphore
+		std::map<por::event::semaphore_id_t, std::vector<por::event::event const*>> _semaphore_heads;
+
+		// contains the barrier_wait events of the most recent round of each barrier
+		std::map<por::event::barrier_id_t, std::vector<por::event::event const*>> _barrier_heads;
+
 		// contains all previously used condition variable ids
 		std::set<por::event::cond_id_t> _used_cond_ids;
 
@@ -124,6 +140,13 @@ namespace por {
 		// index of last extension (extension can only be applied if number matches)
 		mutable std::size_t _last_extension = 0;
 
+		// most recent event of each thread that was considered by conflicting_extensions()
+		mutable std::map<por::event::thread_id_t, por::event::event const*> _cex_watermark;
+
+		// wait1, signal and broadcast events before the watermark: their conflicting extensions
+		// depend on concurrent events of the configuration, so they have to be recomputed each time
+		mutable std::vector<por::event::event const*> _cex_recompute;
+
 		por::extension ex(std::unique_ptr<por::event::event>&& event) const noexcept {
 			return {std::move(event), this, ++_last_extension};
 		}
@@ -152,6 +175,10 @@ namespace por {
 		auto const& thread_heads() const noexcept { return _thread_heads; }
 		auto const& lock_heads() const noexcept { return _lock_heads; }
 		auto const& cond_heads() const noexcept { return _cond_heads; }
+		auto const& atomic_heads() const noexcept { return _atomic_heads; }
+		auto const& rwlock_heads() const noexcept { return _rwlock_heads; }
+		auto const& semaphore_heads() const noexcept { return _semaphore_heads; }
+		auto const& barrier_heads() const noexcept { return _barrier_heads; }
 
 		por::event::event const* last_of_tid(por::thread_id const& tid) const noexcept {
 			auto it = _thread_heads.find(tid);
@@ -177,6 +204,133 @@ namespace por {
 			return it->second;
 		}
 
+		// returns nullptr if the atomic has not been written to (yet)
+		por::event::event const* last_write_of_aid(por::event::atomic_id_t const& aid) const noexcept {
+			auto it = _atomic_heads.find(aid);
+			if(it == _atomic_heads.end() || it->second.empty()) {
+				return nullptr;
+			}
+			// all reads in _atomic_heads read from the most recent write
+			auto const* e = it->second.front();
+			return e->kind() == por::event::event_kind::atomic_write ? e : e->write_predecessor();
+		}
+
+		// returns nullptr if the rwlock has not been write-released (yet)
+		por::event::event const* last_write_release_of_rwid(por::event::rwlock_id_t const& rwid) const noexcept {
+			auto it = _rwlock_heads.find(rwid);
+			if(it == _rwlock_heads.end() || it->second.empty()) {
+				return nullptr;
+			}
+			// all read events in _rwlock_heads follow the most recent write release
+			auto e_it = std::find_if(it->second.begin(), it->second.end(), [](auto const* e) {
+				return e->kind() != por::event::event_kind::rwlock_busy;
+			});
+			assert(e_it != it->second.end() && "rwlock_busy events are always preceded by an acquisition");
+			auto const* e = *e_it;
+			assert(e->kind() != por::event::event_kind::rwlock_wracquire && "rwlock must not be write-acquired");
+			if(e->kind() == por::event::event_kind::rwlock_release) {
+				auto rel = static_cast<por::event::rwlock_release const*>(e);
+				return rel->is_read_release() ? rel->write_predecessor() : rel;
+			}
+			return e->write_predecessor();
+		}
+
+		// returns the event that acquired the rwlock in the given thread (nullptr if the rwlock is not held by it)
+		por::event::event const* rwlock_acquisition_of_tid(por::event::rwlock_id_t const& rwid, por::thread_id const& tid) const noexcept {
+			auto it = _rwlock_heads.find(rwid);
+			if(it == _rwlock_heads.end()) {
+				return nullptr;
+			}
+			for(auto const* e : it->second) {
+				if(e->tid() != tid)
+					continue;
+				if(e->kind() == por::event::event_kind::rwlock_rdacquire || e->kind() == por::event::event_kind::rwlock_wracquire) {
+					return e;
+				}
+			}
+			return nullptr;
+		}
+
+		bool can_rdacquire_rwlock(por::event::rwlock_id_t const& rwid) const noexcept {
+			assert(rwid > 0 && "Rwlock id must not be zero");
+			auto it = _rwlock_heads.find(rwid);
+			if(it == _rwlock_heads.end() || it->second.empty()) {
+				return true;
+			}
+			// a write acquisition is always the first (and only) element
+			return it->second.front()->kind() != por::event::event_kind::rwlock_wracquire;
+		}
+
+		bool can_wracquire_rwlock(por::event::rwlock_id_t const& rwid) const noexcept {
+			assert(rwid > 0 && "Rwlock id must not be zero");
+			auto it = _rwlock_heads.find(rwid);
+			if(it == _rwlock_heads.end()) {
+				return true;
+			}
+			return std::none_of(it->second.begin(), it->second.end(), [](auto const* e) {
+				return e->kind() == por::event::event_kind::rwlock_rdacquire
+					|| e->kind() == por::event::event_kind::rwlock_wracquire;
+			});
+		}
+
+		// returns nullptr if the semaphore has not been created (yet)
+		por::event::event const* last_write_of_sid(por::event::semaphore_id_t const& sid) const noexcept {
+			auto it = _semaphore_heads.find(sid);
+			if(it == _semaphore_heads.end() || it->second.empty()) {
+				return nullptr;
+			}
+			// all posts in _semaphore_heads follow the first element
+			return it->second.front();
+		}
+
+		// value of a semaphore after the given semaphore_create or semaphore_wait
+		static std::size_t semaphore_value_of(por::event::event const& e) noexcept {
+			if(e.kind() == por::event::event_kind::semaphore_create) {
+				return static_cast<por::event::semaphore_create const*>(&e)->value();
+			}
+			assert(e.kind() == por::event::event_kind::semaphore_wait);
+			return static_cast<por::event::semaphore_wait const*>(&e)->value();
+		}
+
+		std::size_t semaphore_value(por::event::semaphore_id_t const& sid) const noexcept {
+			auto it = _semaphore_heads.find(sid);
+			assert(it != _semaphore_heads.end() && !it->second.empty() && "Semaphore must exist");
+			return semaphore_value_of(*it->second.front()) + (it->second.size() - 1);
+		}
+
+		bool can_wait_semaphore(por::event::semaphore_id_t const& sid) const noexcept {
+			assert(sid > 0 && "Semaphore id must not be zero");
+			return last_write_of_sid(sid) != nullptr && semaphore_value(sid) > 0;
+		}
+
+	private:
+		// barrier_wait events take part in the same round iff they share all arrivals
+		static bool is_same_barrier_round(por::event::event const& a, por::event::event const& b) noexcept {
+			assert(a.kind() == por::event::event_kind::barrier_wait && b.kind() == por::event::event_kind::barrier_wait);
+			auto pa = a.predecessors();
+			auto pb = b.predecessors();
+			return pa.size() == pb.size() && std::is_permutation(pa.begin(), pa.end(), pb.begin(), pb.end());
+		}
+
+	public:
+		// checks that none of the arriving threads could have taken part in the most recent round of the barrier
+		// instead, i.e. that each arrival is causally preceded by the completion of that round
+		bool barrier_arrivals_follow_last_round(
+			por::event::barrier_id_t const& bid,
+			std::vector<por::event::event const*> const& arrivals
+		) const noexcept {
+			assert(bid > 0 && "Barrier id must not be zero");
+			auto it = _barrier_heads.find(bid);
+			if(it == _barrier_heads.end()) {
+				return true;
+			}
+			return std::all_of(arrivals.begin(), arrivals.end(), [&](auto const* a) {
+				return std::any_of(it->second.begin(), it->second.end(), [a](auto const* b) {
+					return b->is_less_than_eq(*a);
+				});
+			});
+		}
+
 		bool can_acquire_lock(por::event::lock_id_t const& lock) const noexcept {
 			assert(lock > 0 && "Lock id must not be zero");
 			por::event::event const* lock_event = last_of_lid(lock);
@@ -332,6 +486,81 @@ namespace por {
 					break;
 				}
 
+				case event_kind::atomic_read: {
+					auto& atomic_preds = _atomic_heads[event->aid()];
+					// previous reads on the same thread are in [event] and thus obsolete
+					atomic_preds.erase(std::remove_if(atomic_preds.begin(), atomic_preds.end(), [&event](auto* p) {
+						return p->kind() == por::event::event_kind::atomic_read && p->tid() == event->tid();
+					}), atomic_preds.end());
+					atomic_preds.push_back(event);
+					break;
+				}
+				case event_kind::atomic_write: {
+					_atomic_heads[event->aid()] = std::vector{event};
+					break;
+				}
+
+				case event_kind::rwlock_rdacquire: {
+					auto& rwlock_preds = _rwlock_heads[event->rwid()];
+					// previous read events on the same thread are in [event] and thus obsolete
+					rwlock_preds.erase(std::remove_if(rwlock_preds.begin(), rwlock_preds.end(), [&event](auto* p) {
+						if(p->tid() != event->tid())
+							return false;
+						return p->kind() == por::event::event_kind::rwlock_busy || (p->kind() == por::event::event_kind::rwlock_release
+							&& static_cast<por::event::rwlock_release const*>(p)->is_read_release());
+					}), rwlock_preds.end());
+					rwlock_preds.push_back(event);
+					break;
+				}
+				case event_kind::rwlock_busy: {
+					auto& rwlock_preds = _rwlock_heads[event->rwid()];
+					// previous failed attempts on the same thread are in [event] and thus obsolete
+					rwlock_preds.erase(std::remove_if(rwlock_preds.begin(), rwlock_preds.end(), [&event](auto* p) {
+						return p->kind() == por::event::event_kind::rwlock_busy && p->tid() == event->tid();
+					}), rwlock_preds.end());
+					rwlock_preds.push_back(event);
+					break;
+				}
+				case event_kind::rwlock_wracquire: {
+					_rwlock_heads[event->rwid()] = std::vector{event};
+					break;
+				}
+				case event_kind::rwlock_release: {
+					auto& rwlock_preds = _rwlock_heads[event->rwid()];
+					auto rel = static_cast<por::event::rwlock_release const*>(event);
+					if(rel->is_read_release()) {
+						// failed attempts are kept, as they also have to precede the releases of other readers
+						std::replace(rwlock_preds.begin(), rwlock_preds.end(), rel->acquire_predecessor(), event);
+					} else {
+						rwlock_preds = std::vector{event};
+					}
+					break;
+				}
+
+				case event_kind::semaphore_create:
+				case event_kind::semaphore_wait: {
+					_semaphore_heads[event->sid()] = std::vector{event};
+					break;
+				}
+				case event_kind::semaphore_post: {
+					_semaphore_heads[event->sid()].push_back(event);
+					break;
+				}
+
+				case event_kind::barrier_wait: {
+					auto& barrier_preds = _barrier_heads[event->bid()];
+					if(barrier_preds.empty() || is_same_barrier_round(*barrier_preds.front(), *event)) {
+						barrier_preds.push_back(event);
+					} else if(std::any_of(barrier_preds.begin(), barrier_preds.end(), [&event](auto const* b) {
+						return b->is_less_than_eq(*event);
+					})) {
+						// first event of a new round
+						barrier_preds = std::vector{event};
+					}
+					// otherwise, event belongs to an earlier round and thus precedes all events in barrier_preds
+					break;
+				}
+
 				case event_kind::local:
 				case event_kind::program_init:
 				case event_kind::thread_create:
@@ -773,6 +1002,267 @@ namespace por {
 			}
 		}
 
+		por::extension atomic_read(por::event::thread_id_t thread, por::event::atomic_id_t aid) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			assert(aid > 0 && "Atomic id must not be zero");
+
+			return ex(por::event::atomic_read::alloc(thread, aid, *thread_event, last_write_of_aid(aid)));
+		}
+
+	private:
+		// extracts maximal reads from the most recent write that are not included in [thread_event]
+		// where thread_event is the same-thread predecessor of an atomic write to be created
+		std::vector<por::event::event const*> read_predecessors_atomic(
+			por::event::event const& thread_event,
+			std::vector<por::event::event const*> const& atomic_preds
+		) const noexcept {
+			por::comb reads;
+			for(auto& pred : atomic_preds) {
+				if(pred->kind() != por::event::event_kind::atomic_read)
+					continue;
+
+				if(pred->tid() == thread_event.tid())
+					continue; // excluded event is in [thread_event]
+
+				if(pred->is_less_than_eq(thread_event))
+					continue; // excluded event is in [thread_event]
+
+				reads.insert(*pred);
+			}
+			return reads.max();
+		}
+
+	public:
+		por::extension atomic_write(por::event::thread_id_t thread, por::event::atomic_id_t aid) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			assert(aid > 0 && "Atomic id must not be zero");
+			auto atomic_it = _atomic_heads.find(aid);
+			if(atomic_it == _atomic_heads.end()) {
+				return ex(por::event::atomic_write::alloc(thread, aid, *thread_event, nullptr, {}));
+			}
+
+			auto reads = read_predecessors_atomic(*thread_event, atomic_it->second);
+			return ex(por::event::atomic_write::alloc(thread, aid, *thread_event, last_write_of_aid(aid), std::move(reads)));
+		}
+
+		por::extension rdacquire_rwlock(
+			por::event::thread_id_t thread,
+			por::event::rwlock_id_t rwid,
+			por::event::rwlock_operation operation = por::event::rwlock_operation::lock
+		) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			assert(can_rdacquire_rwlock(rwid) && "Rwlock must not be write-acquired");
+			assert(!rwlock_acquisition_of_tid(rwid, thread) && "Rwlock must not be held by this thread");
+
+			return ex(por::event::rwlock_rdacquire::alloc(thread, rwid, operation, *thread_event, last_write_release_of_rwid(rwid)));
+		}
+
+	private:
+		// extracts maximal read releases following the most recent write release that are not included in [thread_event]
+		// where thread_event is the same-thread predecessor of a write acquisition to be created
+		std::vector<por::event::event const*> read_predecessors_rwlock(
+			por::event::event const& thread_event,
+			std::vector<por::event::event const*> const& rwlock_preds
+		) const noexcept {
+			por::comb reads;
+			for(auto& pred : rwlock_preds) {
+				if(pred->kind() != por::event::event_kind::rwlock_release)
+					continue;
+
+				if(!static_cast<por::event::rwlock_release const*>(pred)->is_read_release())
+					continue;
+
+				if(pred->tid() == thread_event.tid())
+					continue; // excluded event is in [thread_event]
+
+				if(pred->is_less_than_eq(thread_event))
+					continue; // excluded event is in [thread_event]
+
+				reads.insert(*pred);
+			}
+			return reads.max();
+		}
+
+	public:
+		por::extension wracquire_rwlock(
+			por::event::thread_id_t thread,
+			por::event::rwlock_id_t rwid,
+			por::event::rwlock_operation operation = por::event::rwlock_operation::lock
+		) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			assert(can_wracquire_rwlock(rwid) && "Rwlock must not be acquired");
+			auto rwlock_it = _rwlock_heads.find(rwid);
+			if(rwlock_it == _rwlock_heads.end()) {
+				return ex(por::event::rwlock_wracquire::alloc(thread, rwid, operation, *thread_event, nullptr, {}));
+			}
+
+			auto reads = read_predecessors_rwlock(*thread_event, rwlock_it->second);
+			return ex(por::event::rwlock_wracquire::alloc(thread, rwid, operation, *thread_event, last_write_release_of_rwid(rwid), std::move(reads)));
+		}
+
+		// failed non-blocking attempt to acquire a rwlock that is currently held by another thread
+		por::extension busy_rwlock(por::event::thread_id_t thread, por::event::rwlock_id_t rwid, bool write) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			assert((write ? !can_wracquire_rwlock(rwid) : !can_rdacquire_rwlock(rwid)) && "Rwlock must not be acquirable");
+			assert(!rwlock_acquisition_of_tid(rwid, thread) && "Rwlock must not be held by this thread");
+			auto rwlock_it = _rwlock_heads.find(rwid);
+			assert(rwlock_it != _rwlock_heads.end() && !rwlock_it->second.empty());
+
+			por::event::event const* write_event;
+			if(rwlock_it->second.front()->kind() == por::event::event_kind::rwlock_wracquire) {
+				write_event = rwlock_it->second.front();
+			} else {
+				write_event = last_write_release_of_rwid(rwid);
+			}
+
+			// acquisitions and releases that led to the current state of the rwlock
+			por::comb observed;
+			for(auto& pred : rwlock_it->second) {
+				if(pred->kind() == por::event::event_kind::rwlock_busy)
+					continue;
+
+				if(pred->is_less_than_eq(*thread_event))
+					continue; // excluded event is in [thread_event]
+
+				observed.insert(*pred);
+			}
+			return ex(por::event::rwlock_busy::alloc(thread, rwid, write, *thread_event, write_event, observed.max()));
+		}
+
+		por::extension release_rwlock(por::event::thread_id_t thread, por::event::rwlock_id_t rwid) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			auto acquire_event = rwlock_acquisition_of_tid(rwid, thread);
+			assert(acquire_event && "Rwlock must be held by this thread");
+
+			// failed attempts to acquire the rwlock while it was held
+			por::comb busy;
+			for(auto& pred : _rwlock_heads.find(rwid)->second) {
+				if(pred->kind() != por::event::event_kind::rwlock_busy)
+					continue;
+
+				if(pred->is_less_than_eq(*thread_event))
+					continue; // excluded event is in [thread_event]
+
+				busy.insert(*pred);
+			}
+			return ex(por::event::rwlock_release::alloc(thread, rwid, *thread_event, *acquire_event, busy.max()));
+		}
+
+		por::extension create_semaphore(por::event::thread_id_t thread, por::event::semaphore_id_t sid, std::size_t value) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			assert(sid > 0 && "Semaphore id must not be zero");
+
+			return ex(por::event::semaphore_create::alloc(thread, sid, value, *thread_event));
+		}
+
+		por::extension post_semaphore(por::event::thread_id_t thread, por::event::semaphore_id_t sid) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			auto write_event = last_write_of_sid(sid);
+			assert(write_event && "Semaphore must exist");
+
+			return ex(por::event::semaphore_post::alloc(thread, sid, *thread_event, *write_event));
+		}
+
+	private:
+		// extracts maximal posts following the most recent semaphore_wait (or creation) that are not included in [thread_event]
+		// where thread_event is the same-thread predecessor of a semaphore_wait to be created
+		std::vector<por::event::event const*> post_predecessors_semaphore(
+			por::event::event const& thread_event,
+			std::vector<por::event::event const*> const& semaphore_preds
+		) const noexcept {
+			por::comb posts;
+			for(auto& pred : semaphore_preds) {
+				if(pred->kind() != por::event::event_kind::semaphore_post)
+					continue;
+
+				if(pred->tid() == thread_event.tid())
+					continue; // excluded event is in [thread_event]
+
+				if(pred->is_less_than_eq(thread_event))
+					continue; // excluded event is in [thread_event]
+
+				posts.insert(*pred);
+			}
+			return posts.max();
+		}
+
+	public:
+		por::extension wait_semaphore(
+			por::event::thread_id_t thread,
+			por::event::semaphore_id_t sid,
+			por::event::semaphore_operation operation
+		) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			auto semaphore_it = _semaphore_heads.find(sid);
+			assert(semaphore_it != _semaphore_heads.end() && !semaphore_it->second.empty() && "Semaphore must exist");
+			assert((operation != por::event::semaphore_operation::wait || can_wait_semaphore(sid)) && "Semaphore must be positive");
+
+			auto posts = post_predecessors_semaphore(*thread_event, semaphore_it->second);
+			return ex(por::event::semaphore_wait::alloc(thread, sid, operation, semaphore_value(sid), *thread_event,
+			                                            *semaphore_it->second.front(), std::move(posts)));
+		}
+
+		// arrivals contains the most recent event of each thread taking part in the current round of the barrier
+		por::extension wait_barrier(
+			por::event::thread_id_t thread,
+			por::event::barrier_id_t bid,
+			std::vector<por::event::event const*> const& arrivals
+		) const noexcept {
+			auto thread_it = _thread_heads.find(thread);
+			assert(thread_it != _thread_heads.end() && "Thread must exist");
+			auto& thread_event = thread_it->second;
+			assert(thread_event->kind() != por::event::event_kind::thread_exit && "Thread must not yet be exited");
+			assert(thread_event->kind() != por::event::event_kind::wait1 && "Thread must not be blocked");
+			assert(bid > 0 && "Barrier id must not be zero");
+
+			std::vector<por::event::event const*> preds;
+			for(auto& a : arrivals) {
+				if(a->tid() == thread) {
+					assert(a == thread_event && "Thread must not have advanced since its arrival");
+					continue;
+				}
+
+				preds.push_back(a);
+			}
+			return ex(por::event::barrier_wait::alloc(thread, bid, *thread_event, std::move(preds)));
+		}
+
 		template<typename D>
 		por::extension local(event::thread_id_t thread, std::vector<D> local_path) const noexcept {
 			auto thread_it = _thread_heads.find(thread);
@@ -804,30 +1294,36 @@ namespace por {
 
 			assert(et != nullptr);
 
-			if(e.kind() == por::event::event_kind::lock_acquire) {
-				while(em != nullptr && !em->is_less_than_eq(*et)) {
-					// descend chain of lock events until em is in [et]
-					em = em->lock_predecessor();
-				}
-			} else {
-				assert(e.kind() == por::event::event_kind::wait2);
+			if(e.kind() == por::event::event_kind::wait2) {
 				es = static_cast<por::event::wait2 const*>(&e)->notifying_predecessor();
 				assert(es != nullptr);
 
 				if(es->is_cutoff()) {
 					return {};
 				}
-
-				while(em != nullptr && !em->is_less_than_eq(*et) && !em->is_less_than(*es)) {
-					// descend chain of lock events until em is in [et] \cup [es]
-					em = em->lock_predecessor();
-				}
+			} else {
+				assert(e.kind() == por::event::event_kind::lock_acquire);
 			}
 
-			if(em == er) {
+			// lock events in [et] (acq) or [et] \cup [es] (wait2)
+			auto in_history = [&et, &es](por::event::event const* ev) {
+				return ev->is_less_than_eq(*et) || (es != nullptr && ev->is_less_than(*es));
+			};
+
+			if(er == nullptr || in_history(er)) {
+				// em == er
 				return {};
 			}
 
+			// descend chain of lock events until em is in history, recording
+			// lock events in K \ {r}, i.e. strictly between er and em
+			std::vector<por::event::event const*> between;
+			em = er->lock_predecessor();
+			while(em != nullptr && !in_history(em)) {
+				between.push_back(em);
+				em = em->lock_predecessor();
+			}
+
 			if(em == nullptr) {
 				assert(e.kind() == por::event::event_kind::lock_acquire); // wait2 must have a wait1 or release as predecessor
 				result.emplace_back(_unfolding->deduplicate(por::event::lock_acquire::alloc(e.tid(), e.lid(), *et, nullptr)));
@@ -847,9 +1343,7 @@ namespace por {
 				_unfolding->stats_inc_event_created(por::event::event_kind::lock_acquire);
 			}
 
-			assert(er != nullptr); // if er is nullptr, em == er, so we already returned
-			por::event::event const* ep = er->lock_predecessor(); // lock events in K \ {r}
-			while(ep != nullptr && (em == nullptr || !ep->is_less_than_eq(*em)) && (es == nullptr || !ep->is_less_than_eq(*es))) {
+			for(auto* ep : between) {
 				if(ep->kind() == por::event::event_kind::lock_release || ep->kind() == por::event::event_kind::wait1 || ep->kind() == por::event::event_kind::lock_create) {
 					if(e.kind() == por::event::event_kind::lock_acquire) {
 						result.emplace_back(_unfolding->deduplicate(por::event::lock_acquire::alloc(e.tid(), e.lid(), *et, ep)));
@@ -861,7 +1355,6 @@ namespace por {
 						_unfolding->stats_inc_event_created(por::event::event_kind::wait2);
 					}
 				}
-				ep = ep->lock_predecessor();
 			}
 
 			return result;
@@ -1222,25 +1715,626 @@ namespace por {
 			return result;
 		}
 
-	public:
-		std::vector<por::event::event const*>
-		conflicting_extensions_deadlock(por::thread_id tid,
-		                                por::event::lock_id_t lid,
-		                                por::event::event_kind kind,
-		                                bool unknown_only = false) const noexcept {
-			por::event::event const* et = last_of_tid(tid);
+		// collects all atomic_read events on the same atomic as e in [e] \setminus [et], grouped by the write they read from
+		static std::map<por::event::event const*, por::comb> atomic_reads_outside_of_thread_predecessor(por::event::event const& e) noexcept {
+			por::event::event const* et = e.thread_predecessor();
+			std::map<por::event::event const*, por::comb> reads;
+			for(auto& [tid, c] : e.cone()) {
+				if(tid == e.tid())
+					continue; // all events on this thread are in [et]
 
-			if(et->is_cutoff()) {
-				return {};
+				for(auto const* pred = c; pred != nullptr; pred = pred->thread_predecessor()) {
+					if(pred->is_less_than_eq(*et))
+						break; // pred and all its predecessors are in [et]
+
+					if(pred->kind() == por::event::event_kind::atomic_read && pred->aid() == e.aid()) {
+						reads[pred->write_predecessor()].insert(*pred);
+					}
+				}
 			}
+			return reads;
+		}
 
-			por::event::event const* em = last_of_lid(lid);
-			por::event::event const* es = nullptr;
+		std::vector<por::unfolding::deduplication_result> cex_atomic_read(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::atomic_read);
 
-			assert(em);
+			std::vector<por::unfolding::deduplication_result> result;
 
-			// P = [et]
-			por::cone P(*et);
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			// write read by e
+			por::event::event const* ew = e.write_predecessor();
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			if(ew == nullptr || ew->is_less_than_eq(*et)) {
+				// e reads from the maximal write in [et]
+				return {};
+			}
+
+			// descend chain of writes until ep is in [et], e could have read from any of them
+			por::event::event const* ep = ew->write_predecessor();
+			while(ep != nullptr && !ep->is_less_than_eq(*et)) {
+				result.emplace_back(_unfolding->deduplicate(por::event::atomic_read::alloc(e.tid(), e.aid(), *et, ep)));
+				_unfolding->stats_inc_event_created(por::event::event_kind::atomic_read);
+				ep = ep->write_predecessor();
+			}
+
+			// ep is either the maximal write in [et] or nullptr (initial value)
+			result.emplace_back(_unfolding->deduplicate(por::event::atomic_read::alloc(e.tid(), e.aid(), *et, ep)));
+			_unfolding->stats_inc_event_created(por::event::event_kind::atomic_read);
+
+			return result;
+		}
+
+		// collects all read releases on the same rwlock as e in [e] \setminus [et], grouped by the write release they follow
+		static std::map<por::event::event const*, por::comb> rwlock_reads_outside_of_thread_predecessor(por::event::event const& e) noexcept {
+			por::event::event const* et = e.thread_predecessor();
+			std::map<por::event::event const*, por::comb> reads;
+			for(auto& [tid, c] : e.cone()) {
+				if(tid == e.tid())
+					continue; // all events on this thread are in [et]
+
+				for(auto const* pred = c; pred != nullptr; pred = pred->thread_predecessor()) {
+					if(pred->is_less_than_eq(*et))
+						break; // pred and all its predecessors are in [et]
+
+					if(pred->kind() != por::event::event_kind::rwlock_release || pred->rwid() != e.rwid())
+						continue;
+
+					if(static_cast<por::event::rwlock_release const*>(pred)->is_read_release()) {
+						reads[pred->write_predecessor()].insert(*pred);
+					}
+				}
+			}
+			return reads;
+		}
+
+		// chain of write releases from ew down to the maximal one that is possible as write predecessor of
+		// an acquisition with thread predecessor et (i.e. the first one in [et] or one whose successor is held in [et])
+		static std::vector<por::event::event const*> rwlock_write_chain(por::event::event const* ew, por::event::event const& et) noexcept {
+			std::vector<por::event::event const*> writes{ew};
+			for(auto const* w = ew; w != nullptr && !w->is_less_than_eq(et); ) {
+				auto const* acq = static_cast<por::event::rwlock_release const*>(w)->acquire_predecessor();
+				if(acq->is_less_than_eq(et))
+					break; // rwlock is write-acquired in [et] until w
+				w = w->write_predecessor();
+				writes.push_back(w);
+			}
+			return writes;
+		}
+
+		std::vector<por::unfolding::deduplication_result> cex_rwlock_rdacquire(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::rwlock_rdacquire);
+
+			std::vector<por::unfolding::deduplication_result> result;
+
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			// write release followed by e
+			por::event::event const* ew = e.write_predecessor();
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			auto operation = static_cast<por::event::rwlock_rdacquire const*>(&e)->operation();
+
+			// e could have followed any of the earlier write releases, as long as their successor is not in [et]
+			auto writes = rwlock_write_chain(ew, *et);
+			if(operation == por::event::rwlock_operation::trylock) {
+				cex_rwlock_read_attempt(e, writes, result);
+				return result;
+			}
+			for(auto it = std::next(writes.begin()); it != writes.end(); ++it) {
+				result.emplace_back(_unfolding->deduplicate(por::event::rwlock_rdacquire::alloc(e.tid(), e.rwid(), operation, *et, *it)));
+				_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_rdacquire);
+			}
+
+			return result;
+		}
+
+		// collects the given alternative of e unless it is e itself or has already been collected
+		static void add_rwlock_attempt(por::event::event const& e,
+		                               por::unfolding::deduplication_result&& r,
+		                               std::vector<por::unfolding::deduplication_result>& result) noexcept {
+			if(&r.event == &e) {
+				return;
+			}
+			if(std::any_of(result.begin(), result.end(), [&r](auto const& x) { return &x.event == &r.event; })) {
+				return;
+			}
+			result.emplace_back(std::move(r));
+		}
+
+		// alternatives of a non-blocking read attempt e that follow one of the given write releases:
+		// a successful read acquisition or, if the rwlock is write-acquired in between, a failed attempt
+		void cex_rwlock_read_attempt(por::event::event const& e,
+		                             std::vector<por::event::event const*> const& writes,
+		                             std::vector<por::unfolding::deduplication_result>& result) const noexcept {
+			por::event::event const* et = e.thread_predecessor();
+			for(auto const* w : writes) {
+				add_rwlock_attempt(e, _unfolding->deduplicate(por::event::rwlock_rdacquire::alloc(e.tid(), e.rwid(),
+					por::event::rwlock_operation::trylock, *et, w)), result);
+				_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_rdacquire);
+
+				if(w == nullptr || w->is_less_than_eq(*et))
+					continue; // rwlock is not write-acquired in [et] \cup [w]
+
+				auto const* acq = static_cast<por::event::rwlock_release const*>(w)->acquire_predecessor();
+				std::vector<por::event::event const*> observed;
+				if(!acq->is_less_than_eq(*et)) {
+					observed.push_back(acq);
+				}
+				add_rwlock_attempt(e, _unfolding->deduplicate(por::event::rwlock_busy::alloc(e.tid(), e.rwid(), false, *et, acq,
+					std::move(observed))), result);
+				_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_busy);
+			}
+		}
+
+		// collects all read acquisitions and read releases on the same rwlock as e in [e] \setminus [et], grouped by the write release they follow
+		static std::map<por::event::event const*, por::comb> rwlock_read_events_outside_of_thread_predecessor(por::event::event const& e) noexcept {
+			por::event::event const* et = e.thread_predecessor();
+			std::map<por::event::event const*, por::comb> reads;
+			for(auto& [tid, c] : e.cone()) {
+				if(tid == e.tid())
+					continue; // all events on this thread are in [et]
+
+				for(auto const* pred = c; pred != nullptr; pred = pred->thread_predecessor()) {
+					if(pred->is_less_than_eq(*et))
+						break; // pred and all its predecessors are in [et]
+
+					if(pred->rwid() != e.rwid())
+						continue;
+
+					if(pred->kind() == por::event::event_kind::rwlock_rdacquire
+						|| (pred->kind() == por::event::event_kind::rwlock_release
+						    && static_cast<por::event::rwlock_release const*>(pred)->is_read_release())) {
+						reads[pred->write_predecessor()].insert(*pred);
+					}
+				}
+			}
+			return reads;
+		}
+
+		// determines whether the rwlock of e is read-acquired in [et] \cup [M] \cup [w], where w is the most recent
+		// write release in it, and collects the maximal acquisitions and releases of the rwlock that are not in [et]
+		static bool rwlock_read_held(por::event::event const& e,
+		                             por::event::event const* w,
+		                             std::vector<por::event::event const*> const& M,
+		                             std::vector<por::event::event const*>& observed) noexcept {
+			por::event::event const* et = e.thread_predecessor();
+
+			// maximal event of each thread in the configuration
+			std::map<por::thread_id, por::event::event const*> heads;
+			auto include = [&heads](por::event::event const& x) {
+				auto update = [&heads](por::event::event const* y) {
+					auto& h = heads[y->tid()];
+					if(h == nullptr || h->is_less_than(*y)) {
+						h = y;
+					}
+				};
+				update(&x);
+				for(auto& [tid, c] : x.cone()) {
+					update(c);
+				}
+			};
+			include(*et);
+			for(auto const* m : M) {
+				include(*m);
+			}
+			por::comb max;
+			if(w != nullptr) {
+				include(*w);
+				if(!w->is_less_than_eq(*et)) {
+					max.insert(*w);
+				}
+			}
+
+			bool held = false;
+			for(auto& [tid, h] : heads) {
+				for(auto const* x = h; x != nullptr; x = x->thread_predecessor()) {
+					if(w != nullptr && x->is_less_than_eq(*w))
+						break; // all read acquisitions before w have been released
+
+					if(x->rwid() != e.rwid() || x->kind() == por::event::event_kind::rwlock_busy)
+						continue;
+
+					// most recent acquisition or release of this rwlock on this thread
+					held |= x->kind() == por::event::event_kind::rwlock_rdacquire;
+					if(!x->is_less_than_eq(*et)) {
+						max.insert(*x);
+					}
+					break;
+				}
+			}
+			observed = max.max();
+			return held;
+		}
+
+		// alternatives of a non-blocking write attempt e that follow one of the given write releases:
+		// a successful write acquisition or, if the rwlock is acquired in between, a failed attempt
+		void cex_rwlock_write_attempt(por::event::event const& e,
+		                              std::vector<por::event::event const*> const& writes,
+		                              std::vector<por::unfolding::deduplication_result>& result) const noexcept {
+			por::event::event const* et = e.thread_predecessor();
+
+			// all read acquisitions and releases following these write releases are in [e], those in [et] are always included
+			auto reads = rwlock_read_events_outside_of_thread_predecessor(e);
+
+			for(auto const* w : writes) {
+				if(w != nullptr && !w->is_less_than_eq(*et)) {
+					// rwlock is write-acquired in [et] \cup [acq]
+					auto const* acq = static_cast<por::event::rwlock_release const*>(w)->acquire_predecessor();
+					std::vector<por::event::event const*> observed;
+					if(!acq->is_less_than_eq(*et)) {
+						observed.push_back(acq);
+					}
+					add_rwlock_attempt(e, _unfolding->deduplicate(por::event::rwlock_busy::alloc(e.tid(), e.rwid(), true, *et, acq,
+						std::move(observed))), result);
+					_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_busy);
+				}
+
+				reads[w].concurrent_combinations([&](std::vector<por::event::event const*> M) {
+					std::vector<por::event::event const*> observed;
+					if(rwlock_read_held(e, w, M, observed)) {
+						add_rwlock_attempt(e, _unfolding->deduplicate(por::event::rwlock_busy::alloc(e.tid(), e.rwid(), true, *et, w,
+							std::move(observed))), result);
+						_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_busy);
+					} else {
+						// all read acquisitions in M are released in [et] \cup [M], so M only consists of read releases
+						add_rwlock_attempt(e, _unfolding->deduplicate(por::event::rwlock_wracquire::alloc(e.tid(), e.rwid(),
+							por::event::rwlock_operation::trylock, *et, w, std::move(M))), result);
+						_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_wracquire);
+					}
+					return false; // result of concurrent_combinations not needed
+				});
+			}
+		}
+
+		std::vector<por::unfolding::deduplication_result> cex_rwlock_wracquire(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::rwlock_wracquire);
+
+			std::vector<por::unfolding::deduplication_result> result;
+
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			// write release followed by e
+			por::event::event const* ew = e.write_predecessor();
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			auto operation = static_cast<por::event::rwlock_wracquire const*>(&e)->operation();
+
+			auto writes = rwlock_write_chain(ew, *et);
+			if(operation == por::event::rwlock_operation::trylock) {
+				cex_rwlock_write_attempt(e, writes, result);
+				return result;
+			}
+
+			// all read releases following these write releases are in [e], those in [et] are always included
+			auto reads = rwlock_reads_outside_of_thread_predecessor(e);
+
+			auto R = static_cast<por::event::rwlock_wracquire const*>(&e)->read_predecessors();
+			std::vector<por::event::event const*> max(R.begin(), R.end());
+
+			for(auto& w : writes) {
+				auto& W = reads[w];
+				W.concurrent_combinations([&](std::vector<por::event::event const*> M) {
+					// every critical section of w that is acquired in [et] \cup [M] has to be released in it
+					bool held = std::any_of(W.begin(), W.end(), [&](por::event::event const* r) {
+						auto const* acq = static_cast<por::event::rwlock_release const*>(r)->acquire_predecessor();
+						auto in_config = [&](por::event::event const* x) {
+							return x->is_less_than_eq(*et) || std::any_of(M.begin(), M.end(), [x](auto const* m) {
+								return x->is_less_than_eq(*m);
+							});
+						};
+						return in_config(acq) && !in_config(r);
+					});
+					if(held) {
+						return false; // result of concurrent_combinations not needed
+					}
+
+					if(w == ew && M.size() == max.size()) {
+						std::sort(M.begin(), M.end());
+						if(M == max) {
+							return false; // this is e
+						}
+					}
+					result.emplace_back(_unfolding->deduplicate(por::event::rwlock_wracquire::alloc(e.tid(), e.rwid(), operation, *et, w, std::move(M))));
+					_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_wracquire);
+					return false; // result of concurrent_combinations not needed
+				});
+			}
+
+			return result;
+		}
+
+		std::vector<por::unfolding::deduplication_result> cex_rwlock_busy(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::rwlock_busy);
+
+			std::vector<por::unfolding::deduplication_result> result;
+
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			auto const* busy = static_cast<por::event::rwlock_busy const*>(&e);
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			// write release that the observed state of the rwlock followed
+			por::event::event const* ew = busy->write_predecessor();
+			if(busy->is_write_locked()) {
+				if(ew->is_less_than_eq(*et)) {
+					return {}; // rwlock is write-acquired in [et], so every attempt fails
+				}
+				ew = ew->write_predecessor();
+			}
+
+			auto writes = rwlock_write_chain(ew, *et);
+			if(busy->is_write_attempt()) {
+				cex_rwlock_write_attempt(e, writes, result);
+			} else {
+				cex_rwlock_read_attempt(e, writes, result);
+			}
+			return result;
+		}
+
+		std::vector<por::unfolding::deduplication_result> cex_rwlock_release(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::rwlock_release);
+
+			std::vector<por::unfolding::deduplication_result> result;
+
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			auto const* rel = static_cast<por::event::rwlock_release const*>(&e);
+
+			if(et->is_cutoff() || rel->busy_predecessors().empty()) {
+				return {};
+			}
+
+			// all failed attempts in [e] \setminus [et] could also have happened after e (and then observed a different state)
+			por::comb busy;
+			for(auto& [tid, c] : e.cone()) {
+				if(tid == e.tid())
+					continue; // all events on this thread are in [et]
+
+				for(auto const* pred = c; pred != nullptr; pred = pred->thread_predecessor()) {
+					if(pred->is_less_than_eq(*et))
+						break; // pred and all its predecessors are in [et]
+
+					if(pred->kind() == por::event::event_kind::rwlock_busy && pred->rwid() == e.rwid()) {
+						busy.insert(*pred);
+					}
+				}
+			}
+
+			auto B = rel->busy_predecessors();
+			std::vector<por::event::event const*> max(B.begin(), B.end());
+
+			busy.concurrent_combinations([&](std::vector<por::event::event const*> M) {
+				if(M.size() == max.size()) {
+					std::sort(M.begin(), M.end());
+					if(M == max) {
+						return false; // this is e
+					}
+				}
+				result.emplace_back(_unfolding->deduplicate(por::event::rwlock_release::alloc(e.tid(), e.rwid(), *et,
+					*rel->acquire_predecessor(), std::move(M))));
+				_unfolding->stats_inc_event_created(por::event::event_kind::rwlock_release);
+				return false; // result of concurrent_combinations not needed
+			});
+
+			return result;
+		}
+
+		std::vector<por::unfolding::deduplication_result> cex_atomic_write(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::atomic_write);
+
+			std::vector<por::unfolding::deduplication_result> result;
+
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			// write overwritten by e
+			por::event::event const* ew = e.write_predecessor();
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			// writes that e could have overwritten: chain of writes from ew down to the maximal write in [et]
+			std::vector<por::event::event const*> writes{ew};
+			if(ew != nullptr && !ew->is_less_than_eq(*et)) {
+				por::event::event const* ep = ew->write_predecessor();
+				while(ep != nullptr && !ep->is_less_than_eq(*et)) {
+					writes.push_back(ep);
+					ep = ep->write_predecessor();
+				}
+				writes.push_back(ep);
+			}
+
+			// all reads of these writes are in [e], reads in [et] are always included
+			auto reads = atomic_reads_outside_of_thread_predecessor(e);
+
+			auto R = static_cast<por::event::atomic_write const*>(&e)->read_predecessors();
+			std::vector<por::event::event const*> max(R.begin(), R.end());
+
+			for(auto& w : writes) {
+				auto create = [&](std::vector<por::event::event const*> M) {
+					if(w == ew && M.size() == max.size()) {
+						std::sort(M.begin(), M.end());
+						if(M == max) {
+							return; // this is e
+						}
+					}
+					result.emplace_back(_unfolding->deduplicate(por::event::atomic_write::alloc(e.tid(), e.aid(), *et, w, std::move(M))));
+					_unfolding->stats_inc_event_created(por::event::event_kind::atomic_write);
+				};
+
+				// write following w and exactly the reads of w in [M] outside of [et] (M may be empty)
+				reads[w].concurrent_combinations([&](auto const& M) {
+					create(M);
+					return false; // result of concurrent_combinations not needed
+				});
+			}
+
+			return result;
+		}
+
+		// collects all semaphore_post events on the same semaphore as e in [e] \setminus [et], grouped by the event they follow
+		static std::map<por::event::event const*, por::comb> semaphore_posts_outside_of_thread_predecessor(por::event::event const& e) noexcept {
+			por::event::event const* et = e.thread_predecessor();
+			std::map<por::event::event const*, por::comb> posts;
+			for(auto& [tid, c] : e.cone()) {
+				if(tid == e.tid())
+					continue; // all events on this thread are in [et]
+
+				for(auto const* pred = c; pred != nullptr; pred = pred->thread_predecessor()) {
+					if(pred->is_less_than_eq(*et))
+						break; // pred and all its predecessors are in [et]
+
+					if(pred->kind() == por::event::event_kind::semaphore_post && pred->sid() == e.sid()) {
+						posts[pred->write_predecessor()].insert(*pred);
+					}
+				}
+			}
+			return posts;
+		}
+
+		// number of posts following w in [et] \cup [M]
+		static std::size_t semaphore_posts_following(
+			por::event::event const& w,
+			por::event::event const& et,
+			std::vector<por::event::event const*> const& M
+		) noexcept {
+			por::cone C(et);
+			for(auto const* m : M) {
+				C.insert(*m);
+			}
+
+			std::size_t posts = 0;
+			for(auto& [tid, c] : C) {
+				for(auto const* pred = c; pred != nullptr; pred = pred->thread_predecessor()) {
+					if(pred->is_less_than_eq(w))
+						break; // pred and all its predecessors precede w
+
+					if(pred->kind() == por::event::event_kind::semaphore_post && pred->write_predecessor() == &w) {
+						++posts;
+					}
+				}
+			}
+			return posts;
+		}
+
+		std::vector<por::unfolding::deduplication_result> cex_semaphore_post(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::semaphore_post);
+
+			std::vector<por::unfolding::deduplication_result> result;
+
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			// semaphore_wait or semaphore_create followed by e
+			por::event::event const* ew = e.write_predecessor();
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			if(ew->is_less_than_eq(*et)) {
+				// e follows the maximal semaphore_wait in [et]
+				return {};
+			}
+
+			// descend chain of waits until ep is in [et], e could have followed any of them
+			// (the chain ends with the creation of the semaphore, which e cannot precede)
+			for(auto const* ep = ew->write_predecessor(); ep != nullptr; ep = ep->write_predecessor()) {
+				result.emplace_back(_unfolding->deduplicate(por::event::semaphore_post::alloc(e.tid(), e.sid(), *et, *ep)));
+				_unfolding->stats_inc_event_created(por::event::event_kind::semaphore_post);
+				if(ep->is_less_than_eq(*et))
+					break;
+			}
+
+			return result;
+		}
+
+		std::vector<por::unfolding::deduplication_result> cex_semaphore_wait(por::event::event const& e) const noexcept {
+			assert(e.kind() == por::event::event_kind::semaphore_wait);
+
+			std::vector<por::unfolding::deduplication_result> result;
+
+			// immediate causal predecessor on same thread
+			por::event::event const* et = e.thread_predecessor();
+			// semaphore_wait or semaphore_create followed by e
+			por::event::event const* ew = e.write_predecessor();
+			auto operation = static_cast<por::event::semaphore_wait const*>(&e)->operation();
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			// events that e could have followed: chain of waits from ew down to the maximal one in [et]
+			std::vector<por::event::event const*> writes{ew};
+			if(!ew->is_less_than_eq(*et)) {
+				for(auto const* ep = ew->write_predecessor(); ep != nullptr; ep = ep->write_predecessor()) {
+					writes.push_back(ep);
+					if(ep->is_less_than_eq(*et))
+						break;
+				}
+			}
+
+			// all posts following these events are in [e], posts in [et] are always included
+			auto posts = semaphore_posts_outside_of_thread_predecessor(e);
+
+			auto P = static_cast<por::event::semaphore_wait const*>(&e)->post_predecessors();
+			std::vector<por::event::event const*> max(P.begin(), P.end());
+
+			for(auto& w : writes) {
+				posts[w].concurrent_combinations([&](std::vector<por::event::event const*> M) {
+					if(w == ew && M.size() == max.size()) {
+						std::sort(M.begin(), M.end());
+						if(M == max) {
+							return false; // this is e
+						}
+					}
+
+					std::size_t value = semaphore_value_of(*w) + semaphore_posts_following(*w, *et, M);
+					if(operation == por::event::semaphore_operation::wait && value == 0) {
+						return false; // wait would block
+					}
+
+					result.emplace_back(_unfolding->deduplicate(por::event::semaphore_wait::alloc(e.tid(), e.sid(), operation, value, *et, *w, std::move(M))));
+					_unfolding->stats_inc_event_created(por::event::event_kind::semaphore_wait);
+					return false; // result of concurrent_combinations not needed
+				});
+			}
+
+			return result;
+		}
+
+	public:
+		std::vector<por::event::event const*>
+		conflicting_extensions_deadlock(por::thread_id tid,
+		                                por::event::lock_id_t lid,
+		                                por::event::event_kind kind,
+		                                bool unknown_only = false) const noexcept {
+			por::event::event const* et = last_of_tid(tid);
+
+			if(et->is_cutoff()) {
+				return {};
+			}
+
+			por::event::event const* em = last_of_lid(lid);
+			por::event::event const* es = nullptr;
+
+			assert(em);
+
+			// P = [et]
+			por::cone P(*et);
 
 			if(kind == por::event::event_kind::wait2) {
 				assert(et->kind() == por::event::event_kind::wait1);
@@ -1282,22 +2376,29 @@ namespace por {
 				assert(kind == por::event::event_kind::lock_acquire);
 			}
 
-			por::cone C(*this);
-			por::comb A = C.setminus(P);
-			A.insert(*em);
-			por::comb X(A, [&lid](por::event::event const& e) {
-				return e.lid() == lid
-				       && !e.is_cutoff()
-				       && (e.kind() == por::event::event_kind::lock_release
-				           || e.kind() == por::event::event_kind::wait1
-				           || e.kind() == por::event::event_kind::lock_create);
-			});
+			// all events on lid are totally ordered by the lock chain, so the events
+			// on lid in (C \ P) \cup {em} are em and the lock events above P
+			auto in_P = [&P](por::event::event const& ev) {
+				auto it = P.find(ev.tid());
+				return it != P.end() && ev.depth() <= it->second->depth();
+			};
+			std::vector<por::event::event const*> X;
+			for(por::event::event const* ep = em; ep != nullptr; ep = ep->lock_predecessor()) {
+				if(ep != em && in_P(*ep)) {
+					break;
+				}
+				if(ep->is_cutoff()) {
+					continue;
+				}
+				if(ep->kind() == por::event::event_kind::lock_release
+				   || ep->kind() == por::event::event_kind::wait1
+				   || ep->kind() == por::event::event_kind::lock_create) {
+					X.push_back(ep);
+				}
+			}
 
 			std::vector<por::unfolding::deduplication_result> candidates;
 			for(auto& em : X) {
-				if(em->is_cutoff()) {
-					continue;
-				}
 				if(kind == por::event::event_kind::lock_acquire) {
 					candidates.emplace_back(_unfolding->deduplicate(por::event::lock_acquire::alloc(tid, lid, *et, em)));
 					_unfolding->stats_inc_event_created(por::event::event_kind::lock_acquire);
@@ -1321,10 +2422,36 @@ namespace por {
 			return result;
 		}
 
+		// events whose conflicting extensions have to be computed by the next call to conflicting_extensions():
+		// all events added after the watermark and those of the previous calls that depend on the configuration
+		std::vector<por::event::event const*> cex_candidates() const noexcept {
+			std::vector<por::event::event const*> candidates;
+			for(auto it = _thread_heads.rbegin(); it != _thread_heads.rend(); ++it) {
+				auto& watermark = _cex_watermark[it->first];
+				for(auto* e = it->second; e != nullptr && e != watermark; e = e->thread_predecessor()) {
+					candidates.push_back(e);
+				}
+				watermark = it->second;
+			}
+			std::size_t added = candidates.size();
+			_unfolding->stats_inc_cex_events_visited(added);
+
+			candidates.insert(candidates.end(), _cex_recompute.begin(), _cex_recompute.end());
+			for(std::size_t i = 0; i < added; ++i) {
+				auto kind = candidates[i]->kind();
+				if(kind == por::event::event_kind::wait1 || kind == por::event::event_kind::signal
+				   || kind == por::event::event_kind::broadcast) {
+					_cex_recompute.push_back(candidates[i]);
+				}
+			}
+			return candidates;
+		}
+
 		std::vector<por::event::event const*> conflicting_extensions(bool unknown_only = false) const noexcept {
+			auto start = std::chrono::steady_clock::now();
 			_unfolding->stats_inc_configuration();
 			std::vector<por::event::event const*> result;
-			for(auto* e : *this) {
+			for(auto* e : cex_candidates()) {
 				std::vector<por::unfolding::deduplication_result> candidates;
 				switch(e->kind()) {
 					case por::event::event_kind::lock_acquire: {
@@ -1352,6 +2479,78 @@ namespace por {
 					case por::event::event_kind::broadcast:
 						candidates = cex_notification(*e);
 						break;
+					case por::event::event_kind::atomic_read: {
+						auto read = static_cast<por::event::atomic_read const*>(e);
+						if(read->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_atomic_read(*e);
+						read->mark_all_cex_known();
+						break;
+					}
+					case por::event::event_kind::atomic_write: {
+						auto write = static_cast<por::event::atomic_write const*>(e);
+						if(write->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_atomic_write(*e);
+						write->mark_all_cex_known();
+						break;
+					}
+					case por::event::event_kind::rwlock_rdacquire: {
+						auto acq = static_cast<por::event::rwlock_rdacquire const*>(e);
+						if(acq->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_rwlock_rdacquire(*e);
+						acq->mark_all_cex_known();
+						break;
+					}
+					case por::event::event_kind::rwlock_wracquire: {
+						auto acq = static_cast<por::event::rwlock_wracquire const*>(e);
+						if(acq->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_rwlock_wracquire(*e);
+						acq->mark_all_cex_known();
+						break;
+					}
+					case por::event::event_kind::rwlock_release: {
+						auto rel = static_cast<por::event::rwlock_release const*>(e);
+						if(rel->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_rwlock_release(*e);
+						rel->mark_all_cex_known();
+						break;
+					}
+					case por::event::event_kind::rwlock_busy: {
+						auto busy = static_cast<por::event::rwlock_busy const*>(e);
+						if(busy->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_rwlock_busy(*e);
+						busy->mark_all_cex_known();
+						break;
+					}
+					case por::event::event_kind::semaphore_post: {
+						auto post = static_cast<por::event::semaphore_post const*>(e);
+						if(post->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_semaphore_post(*e);
+						post->mark_all_cex_known();
+						break;
+					}
+					case por::event::event_kind::semaphore_wait: {
+						auto wait = static_cast<por::event::semaphore_wait const*>(e);
+						if(wait->all_cex_known()) {
+							continue;
+						}
+						candidates = cex_semaphore_wait(*e);
+						wait->mark_all_cex_known();
+						break;
+					}
 					default:
 						continue;
 				}
@@ -1363,6 +2562,7 @@ namespace por {
 				});
 			}
 			_unfolding->stats_inc_cex_created(result.size());
+			_unfolding->stats_inc_cex_time(std::chrono::steady_clock::now() - start);
 			return result;
 		}
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "base.h"
+
+#include <array>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	class atomic_read final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2. atomic_write this read reads from (may be nullptr if the initial value is read)
+		std::array<event const*, 2> _predecessors;
+
+		atomic_id_t _aid;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		atomic_read(thread_id_t tid, atomic_id_t aid, event const& thread_predecessor, event const* write_predecessor)
+			: event(event_kind::atomic_read, tid, thread_predecessor, write_predecessor)
+			, _predecessors{&thread_predecessor, write_predecessor}
+			, _aid(aid)
+		{
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			if(this->write_predecessor()) {
+				assert(this->write_predecessor()->kind() == event_kind::atomic_write);
+				assert(this->write_predecessor()->aid() == this->aid());
+			}
+
+			assert(this->aid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			atomic_id_t aid,
+			event const& thread_predecessor,
+			event const* write_predecessor
+		) {
+			return std::make_unique<atomic_read>(atomic_read{
+				tid,
+				aid,
+				thread_predecessor,
+				write_predecessor
+			});
+		}
+
+		atomic_read(atomic_read&& that)
+		: event(std::move(that))
+		, _predecessors(that._predecessors)
+		, _aid(std::move(that._aid)) {
+			that._predecessors = {};
+		}
+
+		~atomic_read() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		atomic_read() = delete;
+		atomic_read(const atomic_read&) = delete;
+		atomic_read& operator=(const atomic_read&) = delete;
+		atomic_read& operator=(atomic_read&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: atomic_read aid: " + std::to_string(aid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "atomic_read";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			if(_predecessors[0] == nullptr) {
+				return util::make_iterator_range<event const* const*>(nullptr, nullptr); // only after move-ctor
+			} else if(_predecessors[0] != _predecessors[1] && _predecessors[1] != nullptr) {
+				return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + 2);
+			} else {
+				return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + 1);
+			}
+		}
+
+		immediate_predecessor_range_t immediate_predecessors() const noexcept override {
+			if(_predecessors[0] == nullptr) {
+				return make_immediate_predecessor_range(nullptr, nullptr); // only after move-ctor
+			} else if(_predecessors[1] == nullptr) {
+				// only thread_predecessor
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 1);
+			} else if(_predecessors[0]->is_less_than_eq(*_predecessors[1])) {
+				// only write_predecessor
+				return make_immediate_predecessor_range(_predecessors.data() + 1, _predecessors.data() + 2);
+			} else if(_predecessors[1]->is_less_than(*_predecessors[0])) {
+				// only thread_predecessor
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 1);
+			} else {
+				// both
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 2);
+			}
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// may return nullptr if the initial value is read
+		event const* write_predecessor() const noexcept override { return _predecessors[1]; }
+
+		atomic_id_t aid() const noexcept override { return _aid; }
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
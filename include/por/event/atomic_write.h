@@ -0,0 +1,146 @@
+#pragma once
+
+#include "base.h"
+
+#include "util/sso_array.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	class atomic_write final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2. previous atomic_write on same atomic (omitted if there is none or if it is the same-thread predecessor)
+		// 3+ maximal atomic_read events that read from the previous atomic_write and are not in [thread_predecessor]
+		util::sso_array<event const*, 2> _predecessors;
+
+		atomic_id_t _aid;
+
+		bool _has_write_predecessor;
+
+		// false if the write predecessor is the same-thread predecessor, which is only listed once
+		bool _stores_write_predecessor;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		atomic_write(thread_id_t tid,
+			atomic_id_t aid,
+			event const& thread_predecessor,
+			event const* write_predecessor,
+			util::iterator_range<event const* const*> read_predecessors
+		)
+			: event(event_kind::atomic_write, tid, thread_predecessor, write_predecessor, read_predecessors)
+			, _predecessors{util::create_uninitialized, 1ul + (write_predecessor && write_predecessor != &thread_predecessor ? 1ul : 0ul) + read_predecessors.size()}
+			, _aid(aid)
+			, _has_write_predecessor(write_predecessor != nullptr)
+			, _stores_write_predecessor(write_predecessor != nullptr && write_predecessor != &thread_predecessor)
+		{
+			_predecessors[0] = &thread_predecessor;
+			std::size_t index = 1;
+			if(_stores_write_predecessor) {
+				_predecessors[index++] = write_predecessor;
+			}
+			for(auto& r : read_predecessors) {
+				assert(r != nullptr && "no nullptr in read predecessors allowed");
+				_predecessors[index++] = r;
+			}
+
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			if(this->write_predecessor()) {
+				assert(this->write_predecessor()->kind() == event_kind::atomic_write);
+				assert(this->write_predecessor()->aid() == this->aid());
+			}
+
+			for(auto& r : this->read_predecessors()) {
+				assert(r->kind() == event_kind::atomic_read);
+				assert(r->aid() == this->aid());
+				assert(r->write_predecessor() == this->write_predecessor());
+				assert(r->tid() != this->tid());
+			}
+
+			assert(this->aid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			atomic_id_t aid,
+			event const& thread_predecessor,
+			event const* write_predecessor,
+			std::vector<event const*> read_predecessors
+		) {
+			std::sort(read_predecessors.begin(), read_predecessors.end());
+
+			return std::make_unique<atomic_write>(atomic_write{
+				tid,
+				aid,
+				thread_predecessor,
+				write_predecessor,
+				util::make_iterator_range<event const* const*>(read_predecessors.data(),
+				                                               read_predecessors.data() + read_predecessors.size())
+			});
+		}
+
+		atomic_write(atomic_write&& that)
+		: event(std::move(that))
+		, _predecessors(std::move(that._predecessors))
+		, _aid(std::move(that._aid))
+		, _has_write_predecessor(that._has_write_predecessor)
+		, _stores_write_predecessor(that._stores_write_predecessor)
+		{ }
+
+		~atomic_write() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		atomic_write() = delete;
+		atomic_write(const atomic_write&) = delete;
+		atomic_write& operator=(const atomic_write&) = delete;
+		atomic_write& operator=(atomic_write&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: atomic_write aid: " + std::to_string(aid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "atomic_write";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + _predecessors.size());
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// may return nullptr if this is the first write on this atomic
+		event const* write_predecessor() const noexcept override {
+			if(!_has_write_predecessor) {
+				return nullptr;
+			}
+			return _stores_write_predecessor ? _predecessors[1] : _predecessors[0];
+		}
+
+		// reads of the previous write that are contained in [thread_predecessor] are omitted
+		util::iterator_range<event const* const*> read_predecessors() const noexcept {
+			std::size_t first = _stores_write_predecessor ? 2 : 1;
+			return util::make_iterator_range<event const* const*>(_predecessors.data() + first, _predecessors.data() + _predecessors.size());
+		}
+
+		atomic_id_t aid() const noexcept override { return _aid; }
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "base.h"
+
+#include "util/sso_array.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	class barrier_wait final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2+ arrivals (i.e. the last event before the barrier) of all other threads taking part in
+		//    the same round of this barrier, even if they are already in [thread_predecessor]
+		util::sso_array<event const*, 2> _predecessors;
+
+		barrier_id_t _bid;
+
+	protected:
+		barrier_wait(thread_id_t tid,
+			barrier_id_t bid,
+			event const& thread_predecessor,
+			util::iterator_range<event const* const*> arrival_predecessors
+		)
+			: event(event_kind::barrier_wait, tid, thread_predecessor, arrival_predecessors)
+			, _predecessors{util::create_uninitialized, 1ul + arrival_predecessors.size()}
+			, _bid(bid)
+		{
+			_predecessors[0] = &thread_predecessor;
+			std::size_t index = 1;
+			for(auto& a : arrival_predecessors) {
+				assert(a != nullptr && "no nullptr in arrival predecessors allowed");
+				_predecessors[index++] = a;
+			}
+
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			for(auto& a : this->arrival_predecessors()) {
+				assert(a->tid() != this->tid());
+				assert(a->kind() != event_kind::thread_exit);
+			}
+
+			assert(this->bid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			barrier_id_t bid,
+			event const& thread_predecessor,
+			std::vector<event const*> arrival_predecessors
+		) {
+			std::sort(arrival_predecessors.begin(), arrival_predecessors.end());
+
+			return std::make_unique<barrier_wait>(barrier_wait{
+				tid,
+				bid,
+				thread_predecessor,
+				util::make_iterator_range<event const* const*>(arrival_predecessors.data(),
+				                                               arrival_predecessors.data() + arrival_predecessors.size())
+			});
+		}
+
+		barrier_wait(barrier_wait&& that)
+		: event(std::move(that))
+		, _predecessors(std::move(that._predecessors))
+		, _bid(std::move(that._bid))
+		{ }
+
+		~barrier_wait() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		barrier_wait() = delete;
+		barrier_wait(const barrier_wait&) = delete;
+		barrier_wait& operator=(const barrier_wait&) = delete;
+		barrier_wait& operator=(barrier_wait&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: barrier_wait bid: " + std::to_string(bid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "barrier_wait";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + _predecessors.size());
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// all events of a round have the same set of arrivals (including their thread predecessor)
+		util::iterator_range<event const* const*> arrival_predecessors() const noexcept {
+			return util::make_iterator_range<event const* const*>(_predecessors.data() + 1, _predecessors.data() + _predecessors.size());
+		}
+
+		// exactly one event of each round is the serial one: that of the participant with the smallest thread id
+		bool is_serial() const noexcept {
+			auto arrivals = arrival_predecessors();
+			return std::all_of(arrivals.begin(), arrivals.end(), [this](auto const* a) {
+				return tid() < a->tid();
+			});
+		}
+
+		barrier_id_t bid() const noexcept override { return _bid; }
+	};
+}
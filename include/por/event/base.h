@@ -24,12 +24,17 @@
 
 namespace por {
 	class unfolding;
+	class erv_cache;
 }
 
 namespace por::event {
 	using thread_id_t = por::thread_id;
 	using lock_id_t = std::uint64_t;
 	using cond_id_t = std::uint64_t;
+	using atomic_id_t = std::uint64_t;
+	using rwlock_id_t = std::uint64_t;
+	using semaphore_id_t = std::uint64_t;
+	using barrier_id_t = std::uint64_t;
 
 	class event {
 		friend class por::unfolding; // for caching of immediate_conflicts
@@ -83,6 +88,9 @@ namespace por::event {
 
 		mutable std::size_t _lc_size = 0; // FIXME: make private
 
+		// Foata normal form of [this] relative to a predecessor, computed on first use by compare_adequate_total_order()
+		mutable std::shared_ptr<por::erv_cache const> _erv_cache; // FIXME: make private
+
 		event_kind kind() const noexcept { return _kind; }
 		thread_id_t const& tid() const noexcept { return _tid; }
 		depth_t depth() const noexcept { return _depth; }
@@ -99,7 +107,8 @@ namespace por::event {
 		, _immediate_conflicts(std::move(that._immediate_conflicts))
 		, _metadata(std::move(that._metadata))
 		, _is_cutoff(that._is_cutoff)
-		, _lc_size(that._lc_size) {
+		, _lc_size(that._lc_size)
+		, _erv_cache(std::move(that._erv_cache)) {
 			assert(!has_successors());
 		}
 
@@ -368,6 +377,13 @@ namespace por::event {
 			return nullptr;
 		}
 
+		// atomic_write that an atomic access reads from or overwrites
+		// or write release of a rwlock that a critical section follows
+		// or semaphore_create / semaphore_wait that a semaphore operation follows
+		virtual event const* write_predecessor() const noexcept {
+			return nullptr;
+		}
+
 		virtual util::iterator_range<event const* const*> condition_variable_predecessors() const noexcept {
 			return util::make_iterator_range<event const* const*>(nullptr, nullptr);
 		}
@@ -422,6 +438,10 @@ namespace por::event {
 
 		virtual lock_id_t lid() const noexcept { return 0; }
 		virtual cond_id_t cid() const noexcept { return 0; }
+		virtual atomic_id_t aid() const noexcept { return 0; }
+		virtual rwlock_id_t rwid() const noexcept { return 0; }
+		virtual semaphore_id_t sid() const noexcept { return 0; }
+		virtual barrier_id_t bid() const noexcept { return 0; }
 
 		virtual bool ends_atomic_operation() const noexcept { return false; }
 		virtual event const* atomic_predecessor() const noexcept { return nullptr; }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "atomic_read.h"
+#include "atomic_write.h"
+#include "barrier_wait.h"
 #include "broadcast.h"
 #include "condition_variable_create.h"
 #include "condition_variable_destroy.h"
@@ -9,6 +12,13 @@
 #include "lock_destroy.h"
 #include "lock_release.h"
 #include "program_init.h"
+#include "rwlock_busy.h"
+#include "rwlock_rdacquire.h"
+#include "rwlock_release.h"
+#include "rwlock_wracquire.h"
+#include "semaphore_create.h"
+#include "semaphore_post.h"
+#include "semaphore_wait.h"
 #include "signal.h"
 #include "thread_create.h"
 #include "thread_exit.h"
@@ -20,6 +20,16 @@ namespace por::event {
 		wait2,
 		signal,
 		broadcast,
+		atomic_read,
+		atomic_write,
+		rwlock_rdacquire,
+		rwlock_wracquire,
+		rwlock_release,
+		rwlock_busy,
+		semaphore_create,
+		semaphore_post,
+		semaphore_wait,
+		barrier_wait,
 	};
 
 	template<typename OS>
@@ -43,6 +53,16 @@ namespace por::event {
 			case event_kind::wait2: os << "wait2"; break;
 			case event_kind::signal: os << "signal"; break;
 			case event_kind::broadcast: os << "broadcast"; break;
+			case event_kind::atomic_read: os << "atomic_read"; break;
+			case event_kind::atomic_write: os << "atomic_write"; break;
+			case event_kind::rwlock_rdacquire: os << "rwlock_rdacquire"; break;
+			case event_kind::rwlock_wracquire: os << "rwlock_wracquire"; break;
+			case event_kind::rwlock_release: os << "rwlock_release"; break;
+			case event_kind::rwlock_busy: os << "rwlock_busy"; break;
+			case event_kind::semaphore_create: os << "semaphore_create"; break;
+			case event_kind::semaphore_post: os << "semaphore_post"; break;
+			case event_kind::semaphore_wait: os << "semaphore_wait"; break;
+			case event_kind::barrier_wait: os << "barrier_wait"; break;
 		}
 
 		return os;
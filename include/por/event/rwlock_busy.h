@@ -0,0 +1,160 @@
+#pragma once
+
+#include "base.h"
+
+#include "util/sso_array.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	// failed attempt to acquire a rwlock without blocking (i.e. a trylock that returned EBUSY)
+	class rwlock_busy final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2+ maximal acquisitions and releases of this rwlock that are not in [thread_predecessor]
+		//    (i.e. the events that caused the rwlock to be held when it was observed)
+		util::sso_array<event const*, 2> _predecessors;
+
+		rwlock_id_t _rwid;
+
+		// wracquire that holds the rwlock if it was write-acquired, otherwise
+		// the write release followed by the current read acquisitions (may be nullptr)
+		event const* _write_predecessor;
+
+		// whether this was an attempt to acquire the rwlock in write mode
+		bool _write;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		rwlock_busy(thread_id_t tid,
+			rwlock_id_t rwid,
+			bool write,
+			event const& thread_predecessor,
+			event const* write_predecessor,
+			util::iterator_range<event const* const*> observed_predecessors
+		)
+			: event(event_kind::rwlock_busy, tid, thread_predecessor, observed_predecessors)
+			, _predecessors{util::create_uninitialized, 1ul + observed_predecessors.size()}
+			, _rwid(rwid)
+			, _write_predecessor(write_predecessor)
+			, _write(write)
+		{
+			_predecessors[0] = &thread_predecessor;
+			std::size_t index = 1;
+			for(auto& o : observed_predecessors) {
+				assert(o != nullptr && "no nullptr in observed predecessors allowed");
+				_predecessors[index++] = o;
+			}
+
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			for(auto& o : this->observed_predecessors()) {
+				assert(
+					o->kind() == event_kind::rwlock_rdacquire
+					|| o->kind() == event_kind::rwlock_wracquire
+					|| o->kind() == event_kind::rwlock_release
+				);
+				assert(o->rwid() == this->rwid());
+				assert(o->tid() != this->tid());
+			}
+
+			if(this->write_predecessor()) {
+				assert(
+					this->write_predecessor()->kind() == event_kind::rwlock_wracquire
+					|| this->write_predecessor()->kind() == event_kind::rwlock_release
+				);
+				assert(this->write_predecessor()->rwid() == this->rwid());
+			}
+			assert((write || is_write_locked()) && "read attempts only fail while the rwlock is write-acquired");
+
+			assert(this->rwid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			rwlock_id_t rwid,
+			bool write,
+			event const& thread_predecessor,
+			event const* write_predecessor,
+			std::vector<event const*> observed_predecessors
+		) {
+			std::sort(observed_predecessors.begin(), observed_predecessors.end());
+
+			return std::make_unique<rwlock_busy>(rwlock_busy{
+				tid,
+				rwid,
+				write,
+				thread_predecessor,
+				write_predecessor,
+				util::make_iterator_range<event const* const*>(observed_predecessors.data(),
+				                                               observed_predecessors.data() + observed_predecessors.size())
+			});
+		}
+
+		rwlock_busy(rwlock_busy&& that)
+		: event(std::move(that))
+		, _predecessors(std::move(that._predecessors))
+		, _rwid(std::move(that._rwid))
+		, _write_predecessor(that._write_predecessor)
+		, _write(that._write)
+		{ }
+
+		~rwlock_busy() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		rwlock_busy() = delete;
+		rwlock_busy(const rwlock_busy&) = delete;
+		rwlock_busy& operator=(const rwlock_busy&) = delete;
+		rwlock_busy& operator=(rwlock_busy&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: rwlock_busy"
+					+ (_write ? " (write)" : " (read)") + " rwid: " + std::to_string(rwid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "rwlock_busy";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + _predecessors.size());
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// wracquire holding the rwlock if it is write-acquired, otherwise the most recent write release (may be nullptr)
+		event const* write_predecessor() const noexcept override {
+			return _write_predecessor;
+		}
+
+		// acquisitions and releases that are contained in [thread_predecessor] are omitted
+		util::iterator_range<event const* const*> observed_predecessors() const noexcept {
+			return util::make_iterator_range<event const* const*>(_predecessors.data() + 1, _predecessors.data() + _predecessors.size());
+		}
+
+		rwlock_id_t rwid() const noexcept override { return _rwid; }
+
+		bool is_write_attempt() const noexcept { return _write; }
+
+		// whether the rwlock was held by a writer (otherwise, it was held by at least one reader)
+		bool is_write_locked() const noexcept {
+			return _write_predecessor != nullptr && _write_predecessor->kind() == event_kind::rwlock_wracquire;
+		}
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
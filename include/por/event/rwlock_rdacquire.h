@@ -0,0 +1,142 @@
+#pragma once
+
+#include "base.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace por::event {
+	// operations that acquire a rwlock
+	enum class rwlock_operation : std::uint8_t {
+		lock, // blocks until the rwlock can be acquired
+		trylock, // fails instead of blocking, which is recorded as rwlock_busy
+	};
+
+	class rwlock_rdacquire final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2. release of the most recent write acquisition of this rwlock (may be nullptr if there is none)
+		std::array<event const*, 2> _predecessors;
+
+		rwlock_id_t _rwid;
+
+		rwlock_operation _operation;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		rwlock_rdacquire(thread_id_t tid,
+			rwlock_id_t rwid,
+			rwlock_operation operation,
+			event const& thread_predecessor,
+			event const* write_predecessor
+		)
+			: event(event_kind::rwlock_rdacquire, tid, thread_predecessor, write_predecessor)
+			, _predecessors{&thread_predecessor, write_predecessor}
+			, _rwid(rwid)
+			, _operation(operation)
+		{
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			if(this->write_predecessor()) {
+				assert(this->write_predecessor()->kind() == event_kind::rwlock_release);
+				assert(this->write_predecessor()->rwid() == this->rwid());
+			}
+
+			assert(this->rwid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			rwlock_id_t rwid,
+			rwlock_operation operation,
+			event const& thread_predecessor,
+			event const* write_predecessor
+		) {
+			return std::make_unique<rwlock_rdacquire>(rwlock_rdacquire{
+				tid,
+				rwid,
+				operation,
+				thread_predecessor,
+				write_predecessor
+			});
+		}
+
+		rwlock_rdacquire(rwlock_rdacquire&& that)
+		: event(std::move(that))
+		, _predecessors(that._predecessors)
+		, _rwid(std::move(that._rwid))
+		, _operation(that._operation) {
+			that._predecessors = {};
+		}
+
+		~rwlock_rdacquire() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		rwlock_rdacquire() = delete;
+		rwlock_rdacquire(const rwlock_rdacquire&) = delete;
+		rwlock_rdacquire& operator=(const rwlock_rdacquire&) = delete;
+		rwlock_rdacquire& operator=(rwlock_rdacquire&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: rwlock_rdacquire"
+					+ (_operation == rwlock_operation::trylock ? " (try)" : "") + " rwid: " + std::to_string(rwid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "rwlock_rdacquire";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			if(_predecessors[0] == nullptr) {
+				return util::make_iterator_range<event const* const*>(nullptr, nullptr); // only after move-ctor
+			} else if(_predecessors[0] != _predecessors[1] && _predecessors[1] != nullptr) {
+				return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + 2);
+			} else {
+				return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + 1);
+			}
+		}
+
+		immediate_predecessor_range_t immediate_predecessors() const noexcept override {
+			if(_predecessors[0] == nullptr) {
+				return make_immediate_predecessor_range(nullptr, nullptr); // only after move-ctor
+			} else if(_predecessors[1] == nullptr) {
+				// only thread_predecessor
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 1);
+			} else if(_predecessors[0]->is_less_than_eq(*_predecessors[1])) {
+				// only write_predecessor
+				return make_immediate_predecessor_range(_predecessors.data() + 1, _predecessors.data() + 2);
+			} else if(_predecessors[1]->is_less_than(*_predecessors[0])) {
+				// only thread_predecessor
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 1);
+			} else {
+				// both
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 2);
+			}
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// may return nullptr if the rwlock has never been write-acquired
+		event const* write_predecessor() const noexcept override { return _predecessors[1]; }
+
+		rwlock_id_t rwid() const noexcept override { return _rwid; }
+
+		rwlock_operation operation() const noexcept { return _operation; }
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "base.h"
+
+#include "util/sso_array.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	class rwlock_release final : public event {
+		// predecessors:
+		// 1. acquisition (rwlock_rdacquire or rwlock_wracquire) of this rwlock released by this event
+		// 2. same-thread predecessor
+		// 3+ maximal rwlock_busy events of this rwlock that are not in [thread_predecessor]
+		util::sso_array<event const*, 2> _predecessors;
+
+		rwlock_id_t _rwid;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		rwlock_release(
+			thread_id_t tid,
+			rwlock_id_t rwid,
+			event const& thread_predecessor,
+			event const& acquire_predecessor,
+			util::iterator_range<event const* const*> busy_predecessors
+		)
+			: event(event_kind::rwlock_release, tid, thread_predecessor, &acquire_predecessor, busy_predecessors)
+			, _predecessors{util::create_uninitialized, 2ul + busy_predecessors.size()}
+			, _rwid(rwid)
+		{
+			_predecessors[0] = &acquire_predecessor;
+			_predecessors[1] = &thread_predecessor;
+			std::size_t index = 2;
+			for(auto& b : busy_predecessors) {
+				assert(b != nullptr && "no nullptr in busy predecessors allowed");
+				_predecessors[index++] = b;
+			}
+
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+			assert(this->acquire_predecessor());
+			assert(
+				this->acquire_predecessor()->kind() == event_kind::rwlock_rdacquire
+				|| this->acquire_predecessor()->kind() == event_kind::rwlock_wracquire
+			);
+			assert(this->acquire_predecessor()->tid() == this->tid());
+			assert(this->acquire_predecessor()->rwid() == this->rwid());
+			assert(this->acquire_predecessor()->is_less_than_eq(*this->thread_predecessor()));
+			for(auto& b : this->busy_predecessors()) {
+				assert(b->kind() == event_kind::rwlock_busy);
+				assert(b->rwid() == this->rwid());
+				assert(b->tid() != this->tid());
+			}
+			assert(this->rwid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			rwlock_id_t rwid,
+			event const& thread_predecessor,
+			event const& acquire_predecessor,
+			std::vector<event const*> busy_predecessors
+		) {
+			std::sort(busy_predecessors.begin(), busy_predecessors.end());
+
+			return std::make_unique<rwlock_release>(rwlock_release{
+				tid,
+				rwid,
+				thread_predecessor,
+				acquire_predecessor,
+				util::make_iterator_range<event const* const*>(busy_predecessors.data(),
+				                                               busy_predecessors.data() + busy_predecessors.size())
+			});
+		}
+
+		rwlock_release(rwlock_release&& that)
+		: event(std::move(that))
+		, _predecessors(std::move(that._predecessors))
+		, _rwid(std::move(that._rwid))
+		{ }
+
+		~rwlock_release() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		rwlock_release() = delete;
+		rwlock_release(const rwlock_release&) = delete;
+		rwlock_release& operator=(const rwlock_release&) = delete;
+		rwlock_release& operator=(rwlock_release&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: rwlock_release"
+					+ (is_read_release() ? " (read)" : " (write)") + " rwid: " + std::to_string(rwid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "rwlock_release";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			if(_predecessors.size() >= 2 && _predecessors[0] == _predecessors[1]) {
+				return util::make_iterator_range<event const* const*>(_predecessors.data() + 1, _predecessors.data() + _predecessors.size());
+			}
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + _predecessors.size());
+		}
+
+		immediate_predecessor_range_t immediate_predecessors() const noexcept override {
+			if(_predecessors.size() != 2) {
+				return event::immediate_predecessors(); // busy predecessors or after move-ctor
+			}
+			// acquire_predecessor is always in [thread_predecessor]
+			return make_immediate_predecessor_range(_predecessors.data() + 1, _predecessors.data() + 2);
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[1];
+		}
+
+		event const* acquire_predecessor() const noexcept { return _predecessors[0]; }
+
+		// busy events that are contained in [thread_predecessor] are omitted
+		util::iterator_range<event const* const*> busy_predecessors() const noexcept {
+			return util::make_iterator_range<event const* const*>(_predecessors.data() + 2, _predecessors.data() + _predecessors.size());
+		}
+
+		bool is_read_release() const noexcept {
+			return acquire_predecessor()->kind() == event_kind::rwlock_rdacquire;
+		}
+
+		// write release that the released critical section followed (may be nullptr if there is none)
+		// for write releases, this is the previous write release of this rwlock
+		event const* write_predecessor() const noexcept override {
+			return acquire_predecessor()->write_predecessor();
+		}
+
+		rwlock_id_t rwid() const noexcept override { return _rwid; }
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "base.h"
+#include "rwlock_rdacquire.h"
+
+#include "util/sso_array.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	class rwlock_wracquire final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2. release of the most recent write acquisition of this rwlock (omitted if there is none)
+		// 3+ maximal read releases following that write release that are not in [thread_predecessor]
+		util::sso_array<event const*, 2> _predecessors;
+
+		rwlock_id_t _rwid;
+
+		rwlock_operation _operation;
+
+		bool _has_write_predecessor;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		rwlock_wracquire(thread_id_t tid,
+			rwlock_id_t rwid,
+			rwlock_operation operation,
+			event const& thread_predecessor,
+			event const* write_predecessor,
+			util::iterator_range<event const* const*> read_predecessors
+		)
+			: event(event_kind::rwlock_wracquire, tid, thread_predecessor, write_predecessor, read_predecessors)
+			, _predecessors{util::create_uninitialized, 1ul + (write_predecessor ? 1ul : 0ul) + read_predecessors.size()}
+			, _rwid(rwid)
+			, _operation(operation)
+			, _has_write_predecessor(write_predecessor != nullptr)
+		{
+			_predecessors[0] = &thread_predecessor;
+			std::size_t index = 1;
+			if(write_predecessor) {
+				_predecessors[index++] = write_predecessor;
+			}
+			for(auto& r : read_predecessors) {
+				assert(r != nullptr && "no nullptr in read predecessors allowed");
+				_predecessors[index++] = r;
+			}
+
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			if(this->write_predecessor()) {
+				assert(this->write_predecessor()->kind() == event_kind::rwlock_release);
+				assert(this->write_predecessor()->rwid() == this->rwid());
+			}
+
+			for(auto& r : this->read_predecessors()) {
+				assert(r->kind() == event_kind::rwlock_release);
+				assert(r->rwid() == this->rwid());
+				assert(r->write_predecessor() == this->write_predecessor());
+				assert(r->tid() != this->tid());
+			}
+
+			assert(this->rwid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			rwlock_id_t rwid,
+			rwlock_operation operation,
+			event const& thread_predecessor,
+			event const* write_predecessor,
+			std::vector<event const*> read_predecessors
+		) {
+			std::sort(read_predecessors.begin(), read_predecessors.end());
+
+			return std::make_unique<rwlock_wracquire>(rwlock_wracquire{
+				tid,
+				rwid,
+				operation,
+				thread_predecessor,
+				write_predecessor,
+				util::make_iterator_range<event const* const*>(read_predecessors.data(),
+				                                               read_predecessors.data() + read_predecessors.size())
+			});
+		}
+
+		rwlock_wracquire(rwlock_wracquire&& that)
+		: event(std::move(that))
+		, _predecessors(std::move(that._predecessors))
+		, _rwid(std::move(that._rwid))
+		, _operation(that._operation)
+		, _has_write_predecessor(that._has_write_predecessor)
+		{ }
+
+		~rwlock_wracquire() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		rwlock_wracquire() = delete;
+		rwlock_wracquire(const rwlock_wracquire&) = delete;
+		rwlock_wracquire& operator=(const rwlock_wracquire&) = delete;
+		rwlock_wracquire& operator=(rwlock_wracquire&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: rwlock_wracquire"
+					+ (_operation == rwlock_operation::trylock ? " (try)" : "") + " rwid: " + std::to_string(rwid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "rwlock_wracquire";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + _predecessors.size());
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// may return nullptr if this is the first write acquisition of this rwlock
+		event const* write_predecessor() const noexcept override {
+			return _has_write_predecessor ? _predecessors[1] : nullptr;
+		}
+
+		// read releases that are contained in [thread_predecessor] are omitted
+		util::iterator_range<event const* const*> read_predecessors() const noexcept {
+			std::size_t first = _has_write_predecessor ? 2 : 1;
+			return util::make_iterator_range<event const* const*>(_predecessors.data() + first, _predecessors.data() + _predecessors.size());
+		}
+
+		rwlock_id_t rwid() const noexcept override { return _rwid; }
+
+		rwlock_operation operation() const noexcept { return _operation; }
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
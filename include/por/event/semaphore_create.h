@@ -0,0 +1,98 @@
+#pragma once
+
+#include "base.h"
+
+#include <array>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	class semaphore_create final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		std::array<event const*, 1> _predecessors;
+
+		semaphore_id_t _sid;
+
+		std::size_t _value;
+
+	protected:
+		semaphore_create(thread_id_t tid, semaphore_id_t sid, std::size_t value, event const& thread_predecessor)
+			: event(event_kind::semaphore_create, tid, thread_predecessor)
+			, _predecessors{&thread_predecessor}
+			, _sid(sid)
+			, _value(value)
+		{
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+			assert(this->sid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			semaphore_id_t sid,
+			std::size_t value,
+			event const& thread_predecessor
+		) {
+			return std::make_unique<semaphore_create>(semaphore_create{
+				tid,
+				sid,
+				value,
+				thread_predecessor
+			});
+		}
+
+		semaphore_create(semaphore_create&& that)
+		: event(std::move(that))
+		, _predecessors(that._predecessors)
+		, _sid(std::move(that._sid))
+		, _value(that._value) {
+			that._predecessors = {};
+			assert(_predecessors.size() == 1);
+			assert(thread_predecessor() != nullptr);
+		}
+
+		~semaphore_create() {
+			assert(!has_successors());
+			if(thread_predecessor() != nullptr) {
+				remove_from_successors_of(*thread_predecessor());
+			}
+		}
+
+		semaphore_create() = delete;
+		semaphore_create(const semaphore_create&) = delete;
+		semaphore_create& operator=(const semaphore_create&) = delete;
+		semaphore_create& operator=(semaphore_create&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: semaphore_create sid: " + std::to_string(sid())
+					+ " value: " + std::to_string(value()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "semaphore_create";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			if(_predecessors[0] == nullptr) {
+				return util::make_iterator_range<event const* const*>(nullptr, nullptr); // only after move-ctor
+			}
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + _predecessors.size());
+		}
+
+		immediate_predecessor_range_t immediate_predecessors() const noexcept override {
+			return make_immediate_predecessor_range(predecessors());
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		semaphore_id_t sid() const noexcept override { return _sid; }
+
+		// initial value of the semaphore
+		std::size_t value() const noexcept { return _value; }
+	};
+}
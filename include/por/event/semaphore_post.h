@@ -0,0 +1,119 @@
+#pragma once
+
+#include "base.h"
+
+#include <array>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	class semaphore_post final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2. semaphore_create or most recent semaphore_wait of this semaphore
+		std::array<event const*, 2> _predecessors;
+
+		semaphore_id_t _sid;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		semaphore_post(thread_id_t tid, semaphore_id_t sid, event const& thread_predecessor, event const& write_predecessor)
+			: event(event_kind::semaphore_post, tid, thread_predecessor, &write_predecessor)
+			, _predecessors{&thread_predecessor, &write_predecessor}
+			, _sid(sid)
+		{
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			assert(this->write_predecessor());
+			assert(
+				this->write_predecessor()->kind() == event_kind::semaphore_create
+				|| this->write_predecessor()->kind() == event_kind::semaphore_wait
+			);
+			assert(this->write_predecessor()->sid() == this->sid());
+
+			assert(this->sid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			semaphore_id_t sid,
+			event const& thread_predecessor,
+			event const& write_predecessor
+		) {
+			return std::make_unique<semaphore_post>(semaphore_post{
+				tid,
+				sid,
+				thread_predecessor,
+				write_predecessor
+			});
+		}
+
+		semaphore_post(semaphore_post&& that)
+		: event(std::move(that))
+		, _predecessors(that._predecessors)
+		, _sid(std::move(that._sid)) {
+			that._predecessors = {};
+		}
+
+		~semaphore_post() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		semaphore_post() = delete;
+		semaphore_post(const semaphore_post&) = delete;
+		semaphore_post& operator=(const semaphore_post&) = delete;
+		semaphore_post& operator=(semaphore_post&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: semaphore_post sid: " + std::to_string(sid()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "semaphore_post";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			if(_predecessors[0] == nullptr) {
+				return util::make_iterator_range<event const* const*>(nullptr, nullptr); // only after move-ctor
+			} else if(_predecessors[0] == _predecessors[1]) {
+				return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + 1);
+			}
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + 2);
+		}
+
+		immediate_predecessor_range_t immediate_predecessors() const noexcept override {
+			if(_predecessors[0] == nullptr) {
+				return make_immediate_predecessor_range(nullptr, nullptr); // only after move-ctor
+			} else if(_predecessors[0]->is_less_than_eq(*_predecessors[1])) {
+				// only write_predecessor
+				return make_immediate_predecessor_range(_predecessors.data() + 1, _predecessors.data() + 2);
+			} else if(_predecessors[1]->is_less_than(*_predecessors[0])) {
+				// only thread_predecessor
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 1);
+			} else {
+				// both
+				return make_immediate_predecessor_range(_predecessors.data(), _predecessors.data() + 2);
+			}
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// semaphore_create or semaphore_wait whose value this post increments
+		event const* write_predecessor() const noexcept override { return _predecessors[1]; }
+
+		semaphore_id_t sid() const noexcept override { return _sid; }
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
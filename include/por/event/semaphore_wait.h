@@ -0,0 +1,170 @@
+#pragma once
+
+#include "base.h"
+
+#include "util/sso_array.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
+namespace por::event {
+	// semaphore operations that observe the value of the semaphore
+	enum class semaphore_operation : std::uint8_t {
+		wait, // blocks until the value is positive, then decrements it
+		trywait, // decrements the value if it is positive
+		getvalue, // only reads the value
+	};
+
+	class semaphore_wait final : public event {
+		// predecessors:
+		// 1. same-thread predecessor
+		// 2. semaphore_create or most recent semaphore_wait of this semaphore
+		// 3+ maximal posts following that event that are not in [thread_predecessor]
+		util::sso_array<event const*, 2> _predecessors;
+
+		semaphore_id_t _sid;
+
+		semaphore_operation _operation;
+
+		// value of the semaphore before this operation
+		std::size_t _value_before;
+
+		mutable bool _all_cex_known = false;
+
+	protected:
+		semaphore_wait(thread_id_t tid,
+			semaphore_id_t sid,
+			semaphore_operation operation,
+			std::size_t value_before,
+			event const& thread_predecessor,
+			event const& write_predecessor,
+			util::iterator_range<event const* const*> post_predecessors
+		)
+			: event(event_kind::semaphore_wait, tid, thread_predecessor, &write_predecessor, post_predecessors)
+			, _predecessors{util::create_uninitialized, 2ul + post_predecessors.size()}
+			, _sid(sid)
+			, _operation(operation)
+			, _value_before(value_before)
+		{
+			_predecessors[0] = &thread_predecessor;
+			_predecessors[1] = &write_predecessor;
+			std::size_t index = 2;
+			for(auto& p : post_predecessors) {
+				assert(p != nullptr && "no nullptr in post predecessors allowed");
+				_predecessors[index++] = p;
+			}
+
+			assert(this->thread_predecessor());
+			assert(this->thread_predecessor()->tid());
+			assert(this->thread_predecessor()->tid() == this->tid());
+			assert(this->thread_predecessor()->kind() != event_kind::program_init);
+			assert(this->thread_predecessor()->kind() != event_kind::thread_exit);
+
+			assert(this->write_predecessor());
+			assert(
+				this->write_predecessor()->kind() == event_kind::semaphore_create
+				|| this->write_predecessor()->kind() == event_kind::semaphore_wait
+			);
+			assert(this->write_predecessor()->sid() == this->sid());
+
+			for(auto& p : this->post_predecessors()) {
+				assert(p->kind() == event_kind::semaphore_post);
+				assert(p->sid() == this->sid());
+				assert(p->write_predecessor() == this->write_predecessor());
+				assert(p->tid() != this->tid());
+			}
+
+			assert(operation != semaphore_operation::wait || value_before > 0);
+			assert(this->sid());
+		}
+
+	public:
+		static std::unique_ptr<por::event::event> alloc(
+			thread_id_t tid,
+			semaphore_id_t sid,
+			semaphore_operation operation,
+			std::size_t value_before,
+			event const& thread_predecessor,
+			event const& write_predecessor,
+			std::vector<event const*> post_predecessors
+		) {
+			std::sort(post_predecessors.begin(), post_predecessors.end());
+
+			return std::make_unique<semaphore_wait>(semaphore_wait{
+				tid,
+				sid,
+				operation,
+				value_before,
+				thread_predecessor,
+				write_predecessor,
+				util::make_iterator_range<event const* const*>(post_predecessors.data(),
+				                                               post_predecessors.data() + post_predecessors.size())
+			});
+		}
+
+		semaphore_wait(semaphore_wait&& that)
+		: event(std::move(that))
+		, _predecessors(std::move(that._predecessors))
+		, _sid(std::move(that._sid))
+		, _operation(that._operation)
+		, _value_before(that._value_before)
+		{ }
+
+		~semaphore_wait() {
+			assert(!has_successors());
+			for(auto& pred : immediate_predecessors_from_cone()) {
+				assert(pred != nullptr);
+				remove_from_successors_of(*pred);
+			}
+		}
+
+		semaphore_wait() = delete;
+		semaphore_wait(const semaphore_wait&) = delete;
+		semaphore_wait& operator=(const semaphore_wait&) = delete;
+		semaphore_wait& operator=(semaphore_wait&&) = delete;
+
+		std::string to_string(bool details) const noexcept override {
+			if(details)
+				return "[tid: " + tid().to_string() + " depth: " + std::to_string(depth()) + " kind: semaphore_wait"
+					+ (_operation == semaphore_operation::trywait ? " (try)" : (_operation == semaphore_operation::getvalue ? " (getvalue)" : ""))
+					+ " sid: " + std::to_string(sid()) + " value: " + std::to_string(value()) + (is_cutoff() ? " CUTOFF" : "") + "]";
+			return "semaphore_wait";
+		}
+
+		util::iterator_range<event const* const*> predecessors() const noexcept override {
+			return util::make_iterator_range<event const* const*>(_predecessors.data(), _predecessors.data() + _predecessors.size());
+		}
+
+		event const* thread_predecessor() const noexcept override {
+			return _predecessors[0];
+		}
+
+		// semaphore_create or previous semaphore_wait of this semaphore
+		event const* write_predecessor() const noexcept override {
+			return _predecessors[1];
+		}
+
+		// posts that are contained in [thread_predecessor] are omitted
+		util::iterator_range<event const* const*> post_predecessors() const noexcept {
+			return util::make_iterator_range<event const* const*>(_predecessors.data() + 2, _predecessors.data() + _predecessors.size());
+		}
+
+		semaphore_id_t sid() const noexcept override { return _sid; }
+
+		semaphore_operation operation() const noexcept { return _operation; }
+
+		// whether this operation decremented the value of the semaphore
+		bool is_consuming() const noexcept {
+			return _operation != semaphore_operation::getvalue && _value_before > 0;
+		}
+
+		std::size_t value_before() const noexcept { return _value_before; }
+
+		// value of the semaphore after this operation
+		std::size_t value() const noexcept { return is_consuming() ? _value_before - 1 : _value_before; }
+
+		bool all_cex_known() const noexcept { return _all_cex_known; }
+		void mark_all_cex_known() const noexcept { _all_cex_known = true; }
+	};
+}
@@ -2,6 +2,8 @@
 
 #include "por/configuration.h"
 
+#include "util/persistent_stack.h"
+
 #include <cassert>
 #include <cstdint>
 #include <deque>
@@ -27,7 +29,9 @@ namespace por {
 		class event;
 	}
 
-	using event_set_t = std::vector<por::event::event const*>;
+	// shared between nodes: left children have the same set as their parent,
+	// right children additionally contain the event of their parent
+	using event_set_t = util::persistent_stack<por::event::event const*>;
 
 	struct leaf {
 		node* start;
@@ -111,18 +115,22 @@ namespace por {
 		}
 
 		std::unique_ptr<node> allocate_right_child(event_set_t D) {
-			return std::make_unique<node>(passkey{}, this, _C, D);
+			return std::make_unique<node>(passkey{}, this, _C, std::move(D));
 		}
 
 	public:
 		node(passkey, node* parent, std::shared_ptr<por::configuration> C, event_set_t D)
-		: _parent(parent), _C(std::move(C)), _D(D) { }
+		: _parent(parent), _C(std::move(C)), _D(std::move(D)) { }
 
 		node(passkey, node* parent, event_set_t D)
-		: _parent(parent), _D(D) { }
+		: _parent(parent), _D(std::move(D)) { }
 
 		// root constructor
-		explicit node() : _C(std::make_shared<por::configuration>()), _D({}), _is_sweep_node(true) { }
+		explicit node() : _C(std::make_shared<por::configuration>()), _is_sweep_node(true) { }
+
+		// nodes are allocated from a pool of equally sized blocks that are reused
+		static void* operator new(std::size_t size);
+		static void operator delete(void* ptr) noexcept;
 
 		node(const node&) = delete;
 		node(node&&) = delete;
@@ -232,6 +240,10 @@ namespace por {
 
 		void backtrack();
 
+		// events of the configurations, D sets and events of all nodes in this subtree,
+		// i.e. events that the exploration of this subtree may still refer to
+		std::vector<por::event::event const*> live_events() const noexcept;
+
 		auto branch_begin() const noexcept { return node_branch_iterator<node const*>(*this); }
 		auto branch_end() const noexcept { return node_branch_iterator<node const*>(*this, true); }
 
@@ -3,6 +3,7 @@
 #include "event/base.h"
 #include "thread_id.h"
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <type_traits>
@@ -36,14 +37,19 @@ namespace por {
 		std::map<key_t, value_t> _events;
 		por::event::event const* _root;
 
-		std::size_t _size;
+		// number of events currently stored
+		std::size_t _size = 0;
+
+		// number of events ever stored (used as event id)
+		std::size_t _stored = 0;
 
 		por::event::event const* store_event(std::unique_ptr<por::event::event>&& event) {
 			key_t key = std::make_tuple(event->tid(), event->depth(), event->kind());
 			auto ptr = _events[std::move(key)].emplace_back(std::move(event)).get();
 			stats_inc_unique_event(ptr->kind());
 			++_size;
-			ptr->_metadata.id = _size;
+			++_stored;
+			ptr->_metadata.id = _stored;
 			return ptr;
 		}
 
@@ -86,6 +92,8 @@ namespace por {
 		static bool compare_events(por::event::event const& a, por::event::event const& b);
 
 		deduplication_result deduplicate(std::unique_ptr<por::event::event>&& e) {
+			using clock = std::chrono::steady_clock;
+			auto const start = _measure_time ? clock::now() : clock::time_point{};
 			auto it = _events.find(std::make_tuple(e->tid(), e->depth(), e->kind()));
 			if(it != _events.end()) {
 				for(auto& v : it->second) {
@@ -95,7 +103,12 @@ namespace por {
 							v->mark_as_cutoff();
 						}
 						if(v->metadata() == por::event::metadata{}) {
+							auto id = v->_metadata.id;
 							v->set_metadata(std::move(e->_metadata)); // FIXME: improve this
+							v->_metadata.id = id; // keep id assigned by store_event()
+						}
+						if(_measure_time) {
+							_deduplication_time += clock::now() - start;
 						}
 						return {false, *v.get()};
 					}
@@ -105,6 +118,11 @@ namespace por {
 			auto ptr = store_event(std::move(e));
 			ptr->add_to_successors();
 
+			auto const imm_cfl_start = _measure_time ? clock::now() : clock::time_point{};
+			if(_measure_time) {
+				_deduplication_time += imm_cfl_start - start;
+			}
+
 			ptr->_immediate_conflicts = ptr->compute_immediate_conflicts();
 			for(auto const* other : ptr->_immediate_conflicts) {
 #ifdef LIBPOR_CHECKED
@@ -113,6 +131,9 @@ namespace por {
 #endif
 				other->_immediate_conflicts.push_back(ptr);
 			}
+			if(_measure_time) {
+				_immediate_conflicts_time += clock::now() - imm_cfl_start;
+			}
 			return {true, *ptr};
 		}
 
@@ -135,9 +156,17 @@ namespace por {
 					--_size;
 					return true;
 				}), events.end());
+				if(events.empty()) {
+					_events.erase(it);
+				}
 			}
 		}
 
+		// Removes all events that are neither in live, in immediate conflict with
+		// an event in live, nor a causal predecessor of one of those.
+		// Returns the number of removed events.
+		std::size_t prune(std::vector<por::event::event const*> const& live);
+
 		por::event::event const& root() {
 			return *_root;
 		}
@@ -146,18 +175,28 @@ namespace por {
 			return _size;
 		}
 
+		std::size_t stored() const noexcept {
+			return _stored;
+		}
+
 		por::event::event const* compute_alternative(por::configuration const& C,
 		                                             std::vector<por::event::event const*> D) const noexcept;
 
 		// statistics
 	private:
-		std::array<std::size_t, 16> _events_created{};
-		std::array<std::size_t, 16> _unique_events{};
-		std::array<std::size_t, 16> _cutoff_events{};
+		std::array<std::size_t, 26> _events_created{};
+		std::array<std::size_t, 26> _unique_events{};
+		std::array<std::size_t, 26> _cutoff_events{};
 		std::size_t _events_deduplicated = 0; // total number of deduplicated events
 		std::size_t _cex_created = 0; // number of conflicting extensions generated
 		std::size_t _cex_inserted = 0; // number of actual conflicting extensions inserted
 		std::size_t _configurations = 0; // number of times cex generation was called (NOT necessarily maximal)
+		std::size_t _events_pruned = 0; // number of events removed by prune()
+		std::size_t _cex_events_visited = 0; // number of events added since the previous cex generation of their configuration
+		std::chrono::steady_clock::duration _cex_time{}; // total time spent in cex generation
+		std::chrono::steady_clock::duration _deduplication_time{}; // total time spent looking up and storing events in deduplicate()
+		std::chrono::steady_clock::duration _immediate_conflicts_time{}; // total time spent computing immediate conflicts of new events
+		bool _measure_time = false; // whether deduplicate() measures the two times above, reading the clock is not free
 
 		constexpr std::uint8_t kind_index(por::event::event_kind kind) const noexcept {
 			switch(kind) {
@@ -193,6 +232,26 @@ namespace por {
 					return 14;
 				case por::event::event_kind::broadcast:
 					return 15;
+				case por::event::event_kind::atomic_read:
+					return 16;
+				case por::event::event_kind::atomic_write:
+					return 17;
+				case por::event::event_kind::rwlock_rdacquire:
+					return 18;
+				case por::event::event_kind::rwlock_wracquire:
+					return 19;
+				case por::event::event_kind::rwlock_release:
+					return 20;
+				case por::event::event_kind::semaphore_create:
+					return 21;
+				case por::event::event_kind::semaphore_post:
+					return 22;
+				case por::event::event_kind::semaphore_wait:
+					return 23;
+				case por::event::event_kind::barrier_wait:
+					return 24;
+				case por::event::event_kind::rwlock_busy:
+					return 25;
 				default:
 					assert(0 && "unknown event_kind");
 					return 255;
@@ -224,6 +283,29 @@ namespace por {
 		void stats_inc_configuration() noexcept {
 			++_configurations;
 		}
+		void stats_inc_events_pruned(std::size_t inc) noexcept {
+			_events_pruned += inc;
+		}
+		void stats_inc_cex_events_visited(std::size_t inc) noexcept {
+			_cex_events_visited += inc;
+		}
+		void stats_inc_cex_time(std::chrono::steady_clock::duration inc) noexcept {
+			_cex_time += inc;
+		}
+
+		void set_measure_time(bool measure_time) noexcept {
+			_measure_time = measure_time;
+		}
+
+		std::size_t events_deduplicated() const noexcept {
+			return _events_deduplicated;
+		}
+		std::chrono::steady_clock::duration deduplication_time() const noexcept {
+			return _deduplication_time;
+		}
+		std::chrono::steady_clock::duration immediate_conflicts_time() const noexcept {
+			return _immediate_conflicts_time;
+		}
 
 		void print_statistics() {
 			std::cout.flush();
@@ -251,6 +333,16 @@ namespace por {
 			std::cout << "  wait2: " << _events_created[kind_index(por::event::event_kind::wait2)] << "\n";
 			std::cout << "  signal: " << _events_created[kind_index(por::event::event_kind::signal)] << "\n";
 			std::cout << "  broadcast: " << _events_created[kind_index(por::event::event_kind::broadcast)] << "\n";
+			std::cout << "  atomic_read: " << _events_created[kind_index(por::event::event_kind::atomic_read)] << "\n";
+			std::cout << "  atomic_write: " << _events_created[kind_index(por::event::event_kind::atomic_write)] << "\n";
+			std::cout << "  rwlock_rdacquire: " << _events_created[kind_index(por::event::event_kind::rwlock_rdacquire)] << "\n";
+			std::cout << "  rwlock_wracquire: " << _events_created[kind_index(por::event::event_kind::rwlock_wracquire)] << "\n";
+			std::cout << "  rwlock_release: " << _events_created[kind_index(por::event::event_kind::rwlock_release)] << "\n";
+			std::cout << "  rwlock_busy: " << _events_created[kind_index(por::event::event_kind::rwlock_busy)] << "\n";
+			std::cout << "  semaphore_create: " << _events_created[kind_index(por::event::event_kind::semaphore_create)] << "\n";
+			std::cout << "  semaphore_post: " << _events_created[kind_index(por::event::event_kind::semaphore_post)] << "\n";
+			std::cout << "  semaphore_wait: " << _events_created[kind_index(por::event::event_kind::semaphore_wait)] << "\n";
+			std::cout << "  barrier_wait: " << _events_created[kind_index(por::event::event_kind::barrier_wait)] << "\n";
 			std::cout << "Unique Events: ";
 			std::size_t unique_events = 0;
 			for (std::size_t count : _unique_events) {
@@ -273,6 +365,16 @@ namespace por {
 			std::cout << ". wait2: " << _unique_events[kind_index(por::event::event_kind::wait2)] << "\n";
 			std::cout << ". signal: " << _unique_events[kind_index(por::event::event_kind::signal)] << "\n";
 			std::cout << ". broadcast: " << _unique_events[kind_index(por::event::event_kind::broadcast)] << "\n";
+			std::cout << ". atomic_read: " << _unique_events[kind_index(por::event::event_kind::atomic_read)] << "\n";
+			std::cout << ". atomic_write: " << _unique_events[kind_index(por::event::event_kind::atomic_write)] << "\n";
+			std::cout << ". rwlock_rdacquire: " << _unique_events[kind_index(por::event::event_kind::rwlock_rdacquire)] << "\n";
+			std::cout << ". rwlock_wracquire: " << _unique_events[kind_index(por::event::event_kind::rwlock_wracquire)] << "\n";
+			std::cout << ". rwlock_release: " << _unique_events[kind_index(por::event::event_kind::rwlock_release)] << "\n";
+			std::cout << ". rwlock_busy: " << _unique_events[kind_index(por::event::event_kind::rwlock_busy)] << "\n";
+			std::cout << ". semaphore_create: " << _unique_events[kind_index(por::event::event_kind::semaphore_create)] << "\n";
+			std::cout << ". semaphore_post: " << _unique_events[kind_index(por::event::event_kind::semaphore_post)] << "\n";
+			std::cout << ". semaphore_wait: " << _unique_events[kind_index(por::event::event_kind::semaphore_wait)] << "\n";
+			std::cout << ". barrier_wait: " << _unique_events[kind_index(por::event::event_kind::barrier_wait)] << "\n";
 			std::cout << "Cutoff Events: ";
 			std::size_t cutoff_events = 0;
 			for (std::size_t count : _cutoff_events) {
@@ -295,10 +397,33 @@ namespace por {
 			std::cout << "x wait2: " << _cutoff_events[kind_index(por::event::event_kind::wait2)] << "\n";
 			std::cout << "x signal: " << _cutoff_events[kind_index(por::event::event_kind::signal)] << "\n";
 			std::cout << "x broadcast: " << _cutoff_events[kind_index(por::event::event_kind::broadcast)] << "\n";
+			std::cout << "x atomic_read: " << _cutoff_events[kind_index(por::event::event_kind::atomic_read)] << "\n";
+			std::cout << "x atomic_write: " << _cutoff_events[kind_index(por::event::event_kind::atomic_write)] << "\n";
+			std::cout << "x rwlock_rdacquire: " << _cutoff_events[kind_index(por::event::event_kind::rwlock_rdacquire)] << "\n";
+			std::cout << "x rwlock_wracquire: " << _cutoff_events[kind_index(por::event::event_kind::rwlock_wracquire)] << "\n";
+			std::cout << "x rwlock_release: " << _cutoff_events[kind_index(por::event::event_kind::rwlock_release)] << "\n";
+			std::cout << "x rwlock_busy: " << _cutoff_events[kind_index(por::event::event_kind::rwlock_busy)] << "\n";
+			std::cout << "x semaphore_create: " << _cutoff_events[kind_index(por::event::event_kind::semaphore_create)] << "\n";
+			std::cout << "x semaphore_post: " << _cutoff_events[kind_index(por::event::event_kind::semaphore_post)] << "\n";
+			std::cout << "x semaphore_wait: " << _cutoff_events[kind_index(por::event::event_kind::semaphore_wait)] << "\n";
+			std::cout << "x barrier_wait: " << _cutoff_events[kind_index(por::event::event_kind::barrier_wait)] << "\n";
+			std::cout << "Events resident: " << std::to_string(_size) << " of " << std::to_string(_stored) << "\n";
+			std::cout << "Events pruned: " << std::to_string(_events_pruned) << "\n";
 			std::cout << "Events deduplicated: " << std::to_string(_events_deduplicated) << "\n";
 			std::cout << "CEX created: " << std::to_string(_cex_created) << "\n";
 			std::cout << "CEX inserted: " << std::to_string(_cex_inserted) << "\n";
 			std::cout << "Configurations: " << std::to_string(_configurations) << "\n";
+			std::cout << "CEX events visited: " << std::to_string(_cex_events_visited) << "\n";
+			auto cex_us = std::chrono::duration_cast<std::chrono::microseconds>(_cex_time).count();
+			std::cout << "CEX time: " << std::to_string(cex_us / 1000) << " ms";
+			if(_configurations > 0) {
+				std::cout << " (" << std::to_string(cex_us / _configurations) << " us per configuration)";
+			}
+			std::cout << "\n";
+			auto dedup_us = std::chrono::duration_cast<std::chrono::microseconds>(_deduplication_time).count();
+			std::cout << "Deduplication time: " << std::to_string(dedup_us / 1000) << " ms\n";
+			auto imm_cfl_us = std::chrono::duration_cast<std::chrono::microseconds>(_immediate_conflicts_time).count();
+			std::cout << "Immediate conflicts time: " << std::to_string(imm_cfl_us / 1000) << " ms\n";
 			std::cout << "==========================\n";
 			std::cout.flush();
 		}
@@ -5,9 +5,8 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
-#include <initializer_list>
+#include <iterator>
 #include <limits>
-#include <map>
 #include <memory>
 #include <ostream>
 #include <set>
@@ -251,6 +250,43 @@ namespace pseudoalloc {
 				}
 				return std::any_of(_data.get(), _data.get() + _capacity, predicate);
 			}
+
+			template <typename F> void for_each(F function) const {
+				if(_data) {
+					std::for_each(_data.get(), _data.get() + _capacity, function);
+				}
+			}
+		};
+
+		/// Shares its value between copies until one of them is modified, so that copying an allocator only copies the
+		/// state of those suballocators that are used afterwards.
+		template <typename T> class cow_t {
+			std::shared_ptr<T> _ptr = std::make_shared<T>();
+
+		public:
+			cow_t() = default;
+			cow_t(cow_t const&) = default;
+			cow_t& operator=(cow_t const&) = default;
+			cow_t(cow_t&&) = default;
+			cow_t& operator=(cow_t&&) = default;
+
+			[[nodiscard]] T const& get() const noexcept {
+				_pa_check(_ptr);
+				return *_ptr;
+			}
+
+			[[nodiscard]] T const* operator->() const noexcept { return &get(); }
+
+			/// Returns an exclusively owned version of the value, copying it if it is currently shared
+			[[nodiscard]] T& mut() {
+				_pa_check(_ptr);
+				if(_ptr.use_count() > 1) {
+					_ptr = std::make_shared<T>(*_ptr);
+				}
+				return *_ptr;
+			}
+
+			[[nodiscard]] bool is_shared() const noexcept { return _ptr.use_count() > 1; }
 		};
 	} // namespace util
 
@@ -399,26 +435,160 @@ namespace pseudoalloc {
 		/// each unallocated region and its actual size. The implemented algorithm performs allocations in the middle of
 		/// the largest available unallocated region. Allocations are guaranteed to be aligned to 4096 bytes.
 		class large_object_heap_t : public util::tagged_logger_t<large_object_heap_t> {
-			/// The first direction of the mapping, `map1`, maps the size of each free region to its location. It is inversely
-			/// sorted by size, so that `map1.begin()` always returns the largest free region.
-			/// As it is possible that two free ranges have the same size, there is a need to provide a deterministic
-			/// tie-breaker between those. To this end, we use a vector that effectively uses insertion order as a
-			/// tie-breaker.
-			std::map<std::size_t, std::vector<char*>, std::greater<std::size_t>> map1;
-
-			/// The second direction of the mapping, `map2`, maps the position of each free region to its size. Its ordering
-			/// is ascending, so that a lookup for the position of an allocated object is able to return the previous and the
-			/// following unallocated region.
-			std::map<char*, std::size_t> map2;
+			struct range_t {
+				char* pos;
+				std::size_t size;
+			};
+
+			/// A sorted run of free ranges. Blocks are stored contiguously and hold their ranges inline, so that the whole
+			/// index can be copied without following any pointers.
+			struct block_t {
+				static constexpr const std::size_t capacity = 64;
+
+				std::size_t count = 0;
+				std::array<range_t, capacity> ranges;
+
+				[[nodiscard]] range_t* begin() noexcept { return ranges.data(); }
+				[[nodiscard]] range_t* end() noexcept { return ranges.data() + count; }
+				[[nodiscard]] range_t const& back() const noexcept { return ranges[count - 1]; }
+			};
+
+			struct position_t {
+				std::size_t block;
+				std::size_t index;
+			};
+
+			/// All free ranges, sorted by position and split into blocks (none of which is empty), i.e. a flat B-tree of
+			/// height two. Free ranges and allocated objects alternate, which is why free ranges of size zero are kept as
+			/// well: every allocated object always has a free range directly before and after it.
+			std::vector<block_t> _blocks;
+
+			/// A max-heap of (non-empty) free ranges, ordered by size and, as a deterministic tie-breaker, by inverse
+			/// position, so that the lowest of several largest free ranges is at its top. Entries are not removed when
+			/// their range is split or merged. Instead, stale entries (that no longer match a range in `_blocks`) are
+			/// skipped when they reach the top and the heap is rebuilt when too many of them accumulate.
+			std::vector<range_t> _largest;
+
+			std::size_t _range_count = 0;
 
 			util::quarantine_t<std::pair<void*, std::size_t>> _quarantine;
 
+			static bool lower_priority(range_t const& lhs, range_t const& rhs) noexcept {
+				return lhs.size < rhs.size || (lhs.size == rhs.size && lhs.pos > rhs.pos);
+			}
+
+			/// Returns the position of the first free range that is located after `pos`, which may be one past the end of
+			/// the last block.
+			[[nodiscard]] position_t upper_bound(char* pos) noexcept {
+				auto block = std::upper_bound(_blocks.begin(), _blocks.end(), pos,
+				                              [](char* pos, block_t const& block) { return pos < block.back().pos; });
+				if(block == _blocks.end()) {
+					return {_blocks.size(), 0};
+				}
+				auto range = std::upper_bound(block->begin(), block->end(), pos,
+				                              [](char* pos, range_t const& range) { return pos < range.pos; });
+				return {static_cast<std::size_t>(block - _blocks.begin()), static_cast<std::size_t>(range - block->begin())};
+			}
+
+			/// Returns the position of the first free range that is not located before `pos`, which may be one past the
+			/// end of the last block.
+			[[nodiscard]] position_t lower_bound(char* pos) noexcept {
+				auto block = std::lower_bound(_blocks.begin(), _blocks.end(), pos,
+				                              [](block_t const& block, char* pos) { return block.back().pos < pos; });
+				if(block == _blocks.end()) {
+					return {_blocks.size(), 0};
+				}
+				auto range = std::lower_bound(block->begin(), block->end(), pos,
+				                              [](range_t const& range, char* pos) { return range.pos < pos; });
+				return {static_cast<std::size_t>(block - _blocks.begin()), static_cast<std::size_t>(range - block->begin())};
+			}
+
+			[[nodiscard]] position_t previous(position_t position) const noexcept {
+				if(position.index > 0) {
+					--position.index;
+				} else {
+					_pa_check(position.block > 0);
+					--position.block;
+					position.index = _blocks[position.block].count - 1;
+				}
+				return position;
+			}
+
+			[[nodiscard]] range_t& at(position_t const& position) noexcept {
+				_pa_check(position.block < _blocks.size());
+				_pa_check(position.index < _blocks[position.block].count);
+				return _blocks[position.block].ranges[position.index];
+			}
+
+			/// Inserts `range` directly after the free range at `position`
+			void insert_after(position_t position, range_t const& range) {
+				auto* block = &_blocks[position.block];
+				if(block->count == block_t::capacity) {
+					auto const half = block_t::capacity / 2;
+					_blocks.emplace(std::next(_blocks.begin(), position.block + 1));
+					block = &_blocks[position.block];
+					auto& next = _blocks[position.block + 1];
+					std::copy(block->begin() + half, block->end(), next.begin());
+					next.count = block->count - half;
+					block->count = half;
+					if(position.index >= half) {
+						position.index -= half;
+						++position.block;
+						block = &next;
+					}
+				}
+				std::copy_backward(block->begin() + position.index + 1, block->end(), block->end() + 1);
+				block->ranges[position.index + 1] = range;
+				++block->count;
+				++_range_count;
+			}
+
+			void erase(position_t position) {
+				auto& block = _blocks[position.block];
+				std::copy(block.begin() + position.index + 1, block.end(), block.begin() + position.index);
+				--block.count;
+				--_range_count;
+
+				if(position.block + 1 < _blocks.size()) {
+					auto& next = _blocks[position.block + 1];
+					if(block.count + next.count <= block_t::capacity / 2) {
+						std::copy(next.begin(), next.end(), block.end());
+						block.count += next.count;
+						next.count = 0;
+						_blocks.erase(std::next(_blocks.begin(), position.block + 1));
+					}
+				}
+				if(block.count == 0) {
+					_blocks.erase(std::next(_blocks.begin(), position.block));
+				}
+			}
+
+			void push_largest(range_t const& range) {
+				if(range.size == 0) {
+					return;
+				}
+				_largest.emplace_back(range);
+				std::push_heap(_largest.begin(), _largest.end(), &lower_priority);
+			}
+
+			void rebuild_largest() {
+				_largest.clear();
+				for(auto& block : _blocks) {
+					std::copy_if(block.begin(), block.end(), std::back_inserter(_largest),
+					             [](range_t const& range) { return range.size > 0; });
+				}
+				std::make_heap(_largest.begin(), _largest.end(), &lower_priority);
+			}
+
 		public:
 			inline std::ostream& log_tag(std::ostream& out) const noexcept { return out << "[LOH] "; }
 
 			void initialize(void* base, std::size_t size, std::uint32_t const quarantine_size) {
-				map1.emplace(size, std::initializer_list<char*>{static_cast<char*>(base)});
-				map2.emplace(static_cast<char*>(base), size);
+				_blocks.emplace_back();
+				_blocks.back().ranges[0] = {static_cast<char*>(base), size};
+				_blocks.back().count = 1;
+				_range_count = 1;
+				rebuild_largest();
 
 				_quarantine.initialize(quarantine_size);
 
@@ -434,62 +604,42 @@ namespace pseudoalloc {
 
 				size = quantized_size;
 
-				_pa_check(!map1.empty());
-				auto largest_free_range_it = map1.begin();
-				std::size_t const range_size = largest_free_range_it->first;
-				assert(range_size + 2 * 4096 >= size && "Zero (or below) red zone size!");
-				char* const range_pos = largest_free_range_it->second.back();
-				largest_free_range_it->second.pop_back();
-				decltype(map1)::node_type node;
-				if(largest_free_range_it->second.empty()) {
-					node = map1.extract(largest_free_range_it);
+				if(_largest.size() > 2 * _range_count + 16) {
+					rebuild_largest();
+				}
+				position_t position;
+				while(true) {
+					_pa_check(!_largest.empty());
+					auto const& top = _largest.front();
+					position = lower_bound(top.pos);
+					if(position.block < _blocks.size() && at(position).pos == top.pos && at(position).size == top.size) {
+						break;
+					}
+					std::pop_heap(_largest.begin(), _largest.end(), &lower_priority);
+					_largest.pop_back();
 				}
+				auto const [range_pos, range_size] = _largest.front();
+				std::pop_heap(_largest.begin(), _largest.end(), &lower_priority);
+				_largest.pop_back();
+				assert(range_size + 2 * 4096 >= size && "Zero (or below) red zone size!");
 
 				auto offset = (range_size - size) / 2;
 				offset = util::round_up_to_multiple_of_4096(offset);
-				auto const left_size = offset;
-				auto const left_pos = range_pos;
-				auto const right_size = range_size - offset - size;
-				auto const right_pos = range_pos + offset + size;
-
-				// left subrange
-				{
-					decltype(map1)::iterator it1;
-					if(!node.empty()) {
-						node.key() = left_size;
-						_pa_check(node.mapped().empty());
-						it1 = map1.insert(std::move(node)).position;
-					} else {
-						it1 = std::get<0>(map1.try_emplace(left_size));
-					}
-					auto& v1 = it1->second;
-					v1.emplace_back(left_pos);
-					if(left_size == right_size) {
-						v1.emplace_back(right_pos);
-					}
-				}
-				auto finger = map2.find(range_pos);
-				_pa_check(finger != map2.end());
-				_pa_check(finger->second == range_size);
-				_pa_check(finger->first == left_pos);
-				finger->second = left_size;
+				range_t const left{range_pos, offset};
+				range_t const right{range_pos + offset + size, range_size - offset - size};
 
-				// right subrange
-				if(left_size != right_size) {
-					auto it1 = std::get<0>(map1.try_emplace(right_size));
-					it1->second.emplace_back(right_pos);
-				}
-				map2.emplace_hint(std::next(finger), right_pos, right_size);
+				at(position) = left;
+				insert_after(position, right);
+
+				push_largest(left);
+				push_largest(right);
 
 				return range_pos + offset;
 			}
 
 			[[nodiscard]] bool may_deallocate(void* ptr, std::size_t size) {
-				{
-					auto last = map2.cend();
-					--last;
-					_pa_check(ptr >= map2.cbegin()->first && ptr < last->first + last->second);
-				}
+				_pa_check(!_blocks.empty());
+				_pa_check(ptr >= _blocks.front().ranges[0].pos && ptr < _blocks.back().back().pos + _blocks.back().back().size);
 				_pa_check(size > 4096);
 
 				return true; // FIXME: not yet implemented!
@@ -513,103 +663,30 @@ namespace pseudoalloc {
 				size = quantized_size;
 				trace_contents();
 
-				auto right_it = map2.upper_bound(static_cast<char*>(ptr));
-				auto left_it = std::prev(right_it);
-				auto const left_pos = left_it->first;
-				auto const left_size = left_it->second;
-				auto const right_pos = right_it->first;
-				auto const right_size = right_it->second;
-				_pa_check(left_pos + left_size == static_cast<char*>(ptr));
-				_pa_check(left_pos + left_size + size == right_pos);
-
-				decltype(map1)::node_type node;
-
-				{
-					auto it1 = map1.find(left_size);
-					_pa_check(it1 != map1.end());
-					if(left_size == right_size) {
-						_pa_check(it1->second.size() >= 2);
-						auto it1v = std::find_if(it1->second.begin(), it1->second.end(),
-						                         [left_pos, right_pos](char* ptr) { return ptr == left_pos || ptr == right_pos; });
-						_pa_check(it1v != it1->second.end());
-						if(*it1v == left_pos) {
-							*it1v = it1->second.back();
-							it1v = std::find(it1v, std::prev(it1->second.end()), right_pos);
-						} else {
-							_pa_check(*it1v == right_pos);
-							*it1v = it1->second.back();
-							it1v = std::find(it1v, std::prev(it1->second.end()), left_pos);
-						}
-						_pa_check(it1v < std::prev(it1->second.end()));
-						*it1v = it1->second[it1->second.size() - 2];
-						it1->second.pop_back();
-						it1->second.pop_back();
-						if(it1->second.empty()) {
-							node = map1.extract(it1);
-						}
-					} else {
-						auto it1v = std::find(it1->second.begin(), it1->second.end(), left_pos);
-						_pa_check(it1v != it1->second.end());
-						*it1v = it1->second.back();
-						it1->second.pop_back();
-						if(it1->second.empty()) {
-							node = map1.extract(it1);
-						}
+				auto const right_position = upper_bound(static_cast<char*>(ptr));
+				auto& left = at(previous(right_position));
+				auto const& right = at(right_position);
+				_pa_check(left.pos + left.size == static_cast<char*>(ptr));
+				_pa_check(left.pos + left.size + size == right.pos);
 
-						it1 = map1.find(right_size);
-						_pa_check(it1 != map1.end());
-						it1v = std::find(it1->second.begin(), it1->second.end(), right_pos);
-						_pa_check(it1v != it1->second.end());
-						*it1v = it1->second.back();
-						it1->second.pop_back();
-						if(it1->second.empty()) {
-							node = map1.extract(it1);
-						}
-					}
-				}
-
-				std::size_t const combined_size = left_size + size + right_size;
-				if(!node.empty()) {
-					node.key() = combined_size;
-					_pa_check(node.mapped().empty());
-					auto it1 = map1.insert(::std::move(node)).position;
-					it1->second.emplace_back(left_pos);
-				} else {
-					auto it1 = std::get<0>(map1.try_emplace(combined_size));
-					it1->second.emplace_back(left_it->first);
-				}
-
-				left_it->second = combined_size;
-				map2.erase(right_it);
+				left.size += size + right.size;
+				push_largest(left);
+				erase(right_position);
 			}
 
 			void trace_contents() const noexcept {
-				if(map1.empty()) {
-					traceln("map1 is empty");
+				if(_blocks.empty()) {
+					traceln("no free ranges");
 				} else {
 #if PSEUDOALLOC_TRACE >= 2
-					traceln("map1:");
-					for(auto const& x : map1) {
-						traceln("  ", x.first);
-						for(auto const& y : x.second) {
-							traceln("    ", static_cast<void*>(y));
+					traceln("free ranges:");
+					for(auto const& block : _blocks) {
+						for(std::size_t i = 0; i < block.count; ++i) {
+							traceln("  ", static_cast<void*>(block.ranges[i].pos), " ", block.ranges[i].size);
 						}
 					}
 #else
-					traceln("map1 has ", map1.size(), " entries");
-#endif
-				}
-
-				if(map2.empty()) {
-					traceln("map2 is empty");
-				} else {
-#if PSEUDOALLOC_TRACE >= 2
-					traceln("map2:");
-					for(auto const& x : map2) {
-						traceln("  ", static_cast<void*>(x.first), x.second);
-					}
-#else
-					traceln("map2 has ", map2.size(), " entries");
+					traceln(_range_count, " free ranges in ", _blocks.size(), " blocks (", _largest.size(), " heap entries)");
 #endif
 				}
 			}
@@ -635,8 +712,10 @@ namespace pseudoalloc {
 
 	private:
 		mapping_t* _mapping = nullptr;
-		std::array<suballocators::sized_heap_t, _meta.size()> _sized_bins;
-		suballocators::large_object_heap_t _loh;
+
+		/// Copies of an allocator share the state of each suballocator until it is modified by one of them.
+		std::array<util::cow_t<suballocators::sized_heap_t>, _meta.size()> _sized_bins;
+		util::cow_t<suballocators::large_object_heap_t> _loh;
 
 		[[nodiscard]] static inline int size2bin(std::size_t const size) noexcept {
 			for(std::size_t i = 0; i < _meta.size(); ++i) {
@@ -664,7 +743,7 @@ namespace pseudoalloc {
 			for(std::size_t i = 0; i < _meta.size(); ++i) {
 				static_assert(_meta.size() == std::tuple_size_v<decltype(_sized_bins)>);
 
-				_sized_bins[i].initialize(base + total_size, bin_size, _meta[i], quarantine_size);
+				_sized_bins[i].mut().initialize(base + total_size, bin_size, _meta[i], quarantine_size);
 
 				total_size += bin_size;
 				assert(total_size <= _mapping->size() && "Mapping too small");
@@ -672,7 +751,7 @@ namespace pseudoalloc {
 
 			auto loh_size = mapping.size() - total_size;
 			assert(loh_size > 0);
-			_loh.initialize(base + total_size, loh_size, quarantine_size);
+			_loh.mut().initialize(base + total_size, loh_size, quarantine_size);
 		}
 
 		allocator_t(allocator_t const&) = default;
@@ -690,9 +769,9 @@ namespace pseudoalloc {
 
 			void* result = nullptr;
 			if(bin < static_cast<int>(_sized_bins.size())) {
-				result = _sized_bins[bin].allocate();
+				result = _sized_bins[bin].mut().allocate();
 			} else {
-				result = _loh.allocate(size);
+				result = _loh.mut().allocate(size);
 			}
 			traceln("Allocated ", result);
 			return result;
@@ -706,12 +785,140 @@ namespace pseudoalloc {
 			traceln("Freeing ", ptr, " of size ", size, " in bin ", bin);
 
 			if(bin < static_cast<int>(_sized_bins.size())) {
-				return _sized_bins[bin].deallocate(ptr);
+				return _sized_bins[bin].mut().deallocate(ptr);
 			} else {
-				return _loh.deallocate(ptr, size);
+				return _loh.mut().deallocate(ptr, size);
 			}
 		}
 	};
 
-	using stack_allocator_t = allocator_t;
+	/// Allocates the objects on a thread stack, which are always freed in reverse order of their allocation. Objects are
+	/// placed directly after one another (separated only by a red zone), so that the address of each object only depends
+	/// on the sequence of allocations and deallocations that were performed on this stack before. The memory of the most
+	/// recently freed objects is quarantined like on the heap, so that accesses to a popped frame are not hidden by the
+	/// next frame being placed at the same addresses.
+	class stack_allocator_t : public util::tagged_logger_t<stack_allocator_t> {
+		static constexpr const std::size_t max_alignment = 4096;
+		static constexpr const std::size_t max_red_zone = 4096;
+
+	public:
+		static const std::uint32_t unlimited_quarantine = util::quarantine_base_t::unlimited;
+
+	private:
+		char* _base = nullptr;
+		std::size_t _size = 0;
+
+		/// Offset of the first unused byte
+		std::size_t _top = 0;
+
+		/// The value of `_top` before and the offset of each allocation that has not been freed yet
+		std::vector<std::pair<std::size_t, std::size_t>> _live;
+
+		/// Offset and end offset (including the red zone) of the most recently freed objects, which are not reused
+		util::quarantine_t<std::pair<std::size_t, std::size_t>> _quarantine;
+
+		/// Highest end offset of all freed objects, only used with an unlimited quarantine
+		std::size_t _freed_top = 0;
+
+		/// Objects are aligned to the largest power of two not above their size (but at most to `max_alignment`), which
+		/// satisfies the alignment that was requested (the size passed in is never below that alignment)
+		[[nodiscard]] static std::size_t alignment_of(std::size_t const size) noexcept {
+			_pa_check(size > 0);
+			if(size >= max_alignment) {
+				return max_alignment;
+			}
+			return static_cast<std::size_t>(1) << (std::numeric_limits<std::size_t>::digits - 1 - util::clz(size));
+		}
+
+		[[nodiscard]] static std::size_t object_offset(std::size_t const boundary, std::size_t const size) noexcept {
+			auto const alignment = alignment_of(size);
+			return (boundary + alignment - 1) & ~(alignment - 1);
+		}
+
+		[[nodiscard]] static std::size_t object_end(std::size_t const offset, std::size_t const size) noexcept {
+			return offset + size + std::min(size, max_red_zone);
+		}
+
+		/// Lowest offset not below `offset` at which [offset, end) does not overlap any quarantined object, or `offset`
+		/// itself if there is no such overlap
+		[[nodiscard]] std::size_t skip_quarantine(std::size_t const offset, std::size_t const end) const noexcept {
+			if(_quarantine.capacity() == unlimited_quarantine) {
+				return std::max(offset, _freed_top);
+			}
+			std::size_t result = offset;
+			_quarantine.for_each([&](std::pair<std::size_t, std::size_t> const& entry) {
+				if(entry.first < end && offset < entry.second) {
+					result = std::max(result, entry.second);
+				}
+			});
+			return result;
+		}
+
+	public:
+		std::ostream& log_tag(std::ostream& out) const noexcept { return out << "[stack] "; }
+
+		stack_allocator_t() = default;
+
+		stack_allocator_t(mapping_t& mapping, std::uint32_t const quarantine_size)
+		  : _base(static_cast<char*>(mapping.begin()))
+		  , _size(mapping.size()) {
+			assert(mapping && "Invalid mapping");
+			_quarantine.initialize(quarantine_size);
+		}
+
+		stack_allocator_t(stack_allocator_t const&) = default;
+		stack_allocator_t& operator=(stack_allocator_t const&) = default;
+		stack_allocator_t(stack_allocator_t&&) = default;
+		stack_allocator_t& operator=(stack_allocator_t&&) = default;
+
+		explicit operator bool() const noexcept { return _base != nullptr; }
+
+		[[nodiscard]] void* allocate(std::size_t size) {
+			assert(*this && "Invalid allocator");
+			size = std::max(size, static_cast<std::size_t>(1));
+
+			std::size_t start = _top;
+			std::size_t offset;
+			std::size_t end;
+			for(;;) {
+				offset = object_offset(start, size);
+				end = object_end(offset, size);
+				if(offset < start || end < offset || end > _size) {
+					traceln("Unable to allocate ", size, " bytes");
+					return nullptr;
+				}
+				auto const next = skip_quarantine(offset, end);
+				if(next == offset) {
+					break;
+				}
+				start = next;
+			}
+
+			_live.emplace_back(_top, offset);
+			_top = end;
+			traceln("Allocated ", size, " bytes at ", static_cast<void*>(_base + offset));
+			return _base + offset;
+		}
+
+		void free(void* ptr, std::size_t size) {
+			assert(*this && "Invalid allocator");
+			assert(ptr && "Freeing nullptrs is not supported"); // we are not ::free!
+			size = std::max(size, static_cast<std::size_t>(1));
+			traceln("Freeing ", ptr, " of size ", size);
+
+			_pa_check(!_live.empty() && "Invalid free");
+			auto const [previous_top, offset] = _live.back();
+			_pa_check(_base + offset == ptr && "Stack objects must be freed in reverse order");
+
+			auto const end = object_end(offset, size);
+			traceln("Quarantining ", ptr, " for ", _quarantine.capacity(), " deallocations");
+			_quarantine.deallocate({offset, end});
+			if(_quarantine.capacity() == unlimited_quarantine) {
+				_freed_top = std::max(_freed_top, end);
+			}
+
+			_top = previous_top;
+			_live.pop_back();
+		}
+	};
 } // namespace pseudoalloc
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace util {
+	// Immutable singly linked stack: push() returns a new stack that shares
+	// all existing entries with the old one, so copies are cheap.
+	template<typename T>
+	class persistent_stack {
+		struct entry {
+			T value;
+			std::shared_ptr<entry> next;
+		};
+
+		std::shared_ptr<entry> _head;
+		std::size_t _size = 0;
+
+	public:
+		class iterator {
+			entry const* _entry = nullptr;
+
+		public:
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T const*;
+			using reference = T const&;
+			using iterator_category = std::forward_iterator_tag;
+
+			iterator() = default;
+			explicit iterator(entry const* e) : _entry(e) { }
+
+			reference operator*() const noexcept { return _entry->value; }
+			pointer operator->() const noexcept { return &_entry->value; }
+
+			iterator& operator++() noexcept {
+				_entry = _entry->next.get();
+				return *this;
+			}
+			iterator operator++(int) noexcept {
+				iterator tmp = *this;
+				++(*this);
+				return tmp;
+			}
+
+			bool operator==(const iterator& rhs) const noexcept { return _entry == rhs._entry; }
+			bool operator!=(const iterator& rhs) const noexcept { return _entry != rhs._entry; }
+		};
+
+		persistent_stack() = default;
+		persistent_stack(persistent_stack const&) = default;
+		persistent_stack(persistent_stack&& other) noexcept
+		: _head(std::move(other._head))
+		, _size(std::exchange(other._size, 0))
+		{ }
+
+		// the previous value is released by the destructor of other
+		persistent_stack& operator=(persistent_stack other) noexcept {
+			std::swap(_head, other._head);
+			std::swap(_size, other._size);
+			return *this;
+		}
+
+		~persistent_stack() {
+			// avoid deep recursion when releasing the last reference to a long stack
+			std::shared_ptr<entry> e = std::move(_head);
+			while(e && e.use_count() == 1) {
+				std::shared_ptr<entry> next = std::move(e->next);
+				e = std::move(next);
+			}
+		}
+
+		persistent_stack push(T value) const {
+			persistent_stack result;
+			result._head = std::make_shared<entry>(entry{std::move(value), _head});
+			result._size = _size + 1;
+			return result;
+		}
+
+		std::size_t size() const noexcept { return _size; }
+		bool empty() const noexcept { return _size == 0; }
+
+		// iterates from the most recently pushed element
+		iterator begin() const noexcept { return iterator(_head.get()); }
+		iterator end() const noexcept { return iterator(); }
+
+		// elements in the order they were pushed
+		std::vector<T> to_vector() const {
+			std::vector<T> result(_size);
+			std::size_t i = _size;
+			for(auto const& value : *this) {
+				result[--i] = value;
+			}
+			return result;
+		}
+	};
+}
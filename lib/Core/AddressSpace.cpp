@@ -17,18 +17,40 @@
 #include "klee/PorCmdLine.h"
 #include "klee/TimerStatIncrementer.h"
 
+#include <cstdint>
+#include <vector>
+
 using namespace klee;
 
 ///
 
+void ResolutionCache::update(const MemoryObject *mo, const ObjectState *os) {
+  // entries for mo can only be located in the slots of the lines it covers
+  uint64_t first = mo->address >> lineBits;
+  uint64_t last = mo->size == 0 ? first
+                                : (mo->address + mo->size - 1) >> lineBits;
+  uint64_t count = std::min<uint64_t>(last - first + 1, numEntries);
+  for (uint64_t i = 0; i < count; ++i) {
+    ObjectPair &entry = entries[(first + i) % numEntries];
+    if (entry.first == mo) {
+      if (os)
+        entry.second = os;
+      else
+        entry = ObjectPair();
+    }
+  }
+}
+
 void AddressSpace::bindObject(const MemoryObject *mo, ObjectState *os) {
   assert(os->copyOnWriteOwner==0 && "object already has owner");
   os->copyOnWriteOwner = cowKey;
   objects = objects.replace(std::make_pair(mo, os));
+  resolutionCache.update(mo, os);
 }
 
 void AddressSpace::unbindObject(const MemoryObject *mo) {
   objects = objects.remove(mo);
+  resolutionCache.update(mo, nullptr);
 }
 
 const ObjectState *AddressSpace::findObject(const MemoryObject *mo) const {
@@ -48,6 +70,7 @@ ObjectState *AddressSpace::getWriteable(const MemoryObject *mo,
   ref<ObjectState> newObjectState(new ObjectState(*os));
   newObjectState->copyOnWriteOwner = cowKey;
   objects = objects.replace(std::make_pair(mo, newObjectState));
+  resolutionCache.update(mo, newObjectState.get());
   return newObjectState.get();
 }
 
@@ -56,6 +79,12 @@ ObjectState *AddressSpace::getWriteable(const MemoryObject *mo,
 bool AddressSpace::resolveOne(const ref<ConstantExpr> &addr, 
                               ObjectPair &result) const {
   uint64_t address = addr->getZExtValue();
+
+  if (const ObjectPair *cached = resolutionCache.lookup(address)) {
+    result = *cached;
+    return true;
+  }
+
   MemoryObject hack(address);
 
   if (const auto res = objects.lookup_previous(&hack)) {
@@ -66,6 +95,7 @@ bool AddressSpace::resolveOne(const ref<ConstantExpr> &addr,
         (address - mo->address < mo->size)) {
       result.first = res->first;
       result.second = res->second.get();
+      resolutionCache.insert(address, result);
       return true;
     }
   }
@@ -91,16 +121,10 @@ bool AddressSpace::resolveOne(ExecutionState &state,
       return false;
     uint64_t example = cex->getZExtValue();
     MemoryObject hack(example);
-    const auto res = objects.lookup_previous(&hack);
 
-    if (res) {
-      const MemoryObject *mo = res->first;
-      if (example - mo->address < mo->size) {
-        result.first = res->first;
-        result.second = res->second.get();
-        success = true;
-        return true;
-      }
+    if (resolveOne(cex, result) && result.first->size > 0) {
+      success = true;
+      return true;
     }
 
     // didn't work, now we have to search
@@ -301,7 +325,7 @@ void AddressSpace::copyOutConcretes() {
       auto address = reinterpret_cast<std::uint8_t*>(mo->address);
 
       if (!os->readOnly)
-        memcpy(address, os->concreteStore, mo->size);
+        os->copyConcreteStoreTo(address);
     }
   }
 }
@@ -309,7 +333,7 @@ void AddressSpace::copyOutConcretes() {
 bool AddressSpace::copyInConcrete(ExecutionState &state, const MemoryObject *mo,
                                   const ObjectState *os, uint64_t src_address) {
   auto address = reinterpret_cast<std::uint8_t*>(src_address);
-  if (memcmp(address, os->concreteStore, mo->size) != 0) {
+  if (!os->concreteStoreEquals(address)) {
     if (os->readOnly) {
       return false;
     } else {
@@ -317,7 +341,7 @@ bool AddressSpace::copyInConcrete(ExecutionState &state, const MemoryObject *mo,
         state.memoryState.unregisterWrite(*mo, *os);
       }
       ObjectState *wos = getWriteable(mo, os);
-      memcpy(wos->concreteStore, address, mo->size);
+      wos->copyConcreteStoreFrom(address);
       if (EnableCutoffEvents) {
         state.memoryState.registerWrite(*mo, *wos);
       }
@@ -328,6 +352,8 @@ bool AddressSpace::copyInConcrete(ExecutionState &state, const MemoryObject *mo,
 
 bool AddressSpace::checkAndCopyInConcretes(ExecutionState &state,
   std::function<bool(const MemoryObject&, const std::uint8_t*, const ObjectState&)> func) {
+  // contiguous copy of the (paged) concrete store, shared by all objects
+  std::vector<std::uint8_t> store;
   for (MemoryMap::iterator it = objects.begin(), ie = objects.end();
        it != ie; ++it) {
     const MemoryObject *mo = it->first;
@@ -338,11 +364,13 @@ bool AddressSpace::checkAndCopyInConcretes(ExecutionState &state,
 
     auto address = reinterpret_cast<std::uint8_t*>(mo->address);
     const auto &os = it->second;
-    if (memcmp(address, os->concreteStore, mo->size) == 0) {
+    if (os->concreteStoreEquals(address)) {
       continue;
     }
 
-    bool valid = func(*mo, os->concreteStore, *os);
+    store.resize(mo->size);
+    os->copyConcreteStoreTo(store.data());
+    bool valid = func(*mo, store.data(), *os);
     if (!valid) {
       return false;
     }
@@ -351,7 +379,7 @@ bool AddressSpace::checkAndCopyInConcretes(ExecutionState &state,
       state.memoryState.unregisterWrite(*mo, *os);
     }
     ObjectState *wos = getWriteable(mo, os.get());
-    std::memcpy(wos->concreteStore, address, mo->size);
+    wos->copyConcreteStoreFrom(address);
     if (EnableCutoffEvents) {
       state.memoryState.registerWrite(*mo, *wos);
     }
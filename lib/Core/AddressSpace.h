@@ -15,6 +15,8 @@
 #include "klee/Internal/ADT/ImmutableMap.h"
 #include "klee/Internal/System/Time.h"
 
+#include <array>
+
 namespace klee {
   class ExecutionState;
   class MemoryObject;
@@ -34,6 +36,42 @@ namespace klee {
   typedef ImmutableMap<const MemoryObject *, ref<ObjectState>, MemoryObjectLT>
       MemoryMap;
 
+  /// Direct-mapped cache of concrete address resolutions, indexed by the
+  /// 64-byte line of the resolved address. It only contains objects that are
+  /// bound in the owning address space, together with their current state, so
+  /// that a hit makes a lookup in the MemoryMap unnecessary.
+  class ResolutionCache {
+    static constexpr unsigned lineBits = 6;
+    static constexpr std::size_t numEntries = 256;
+
+    std::array<ObjectPair, numEntries> entries{};
+
+    static std::size_t slotOf(uint64_t address) {
+      return (address >> lineBits) % numEntries;
+    }
+
+  public:
+    /// Returns the cached object containing \a address, if any.
+    const ObjectPair *lookup(uint64_t address) const {
+      const ObjectPair &entry = entries[slotOf(address)];
+      const MemoryObject *mo = entry.first;
+      if (mo && ((mo->size == 0 && address == mo->address) ||
+                 address - mo->address < mo->size)) {
+        return &entry;
+      }
+      return nullptr;
+    }
+
+    /// Remember that \a address resolved to \a op.
+    void insert(uint64_t address, const ObjectPair &op) {
+      entries[slotOf(address)] = op;
+    }
+
+    /// Replace the state of all entries for \a mo by \a os or remove them
+    /// if \a os is null.
+    void update(const MemoryObject *mo, const ObjectState *os);
+  };
+
   class AddressSpace {
   private:
     /// Epoch counter used to control ownership of objects.
@@ -42,6 +80,10 @@ namespace klee {
     /// Unsupported, use copy constructor
     AddressSpace &operator=(const AddressSpace &);
 
+    /// Recent results of concrete resolutions, kept consistent with
+    /// `objects` by bindObject, unbindObject and getWriteable.
+    mutable ResolutionCache resolutionCache;
+
     /// Check if pointer `p` can point to the memory object in the
     /// given object pair.  If so, add it to the given resolution list.
     ///
@@ -64,7 +106,9 @@ namespace klee {
     MemoryMap objects;
 
     AddressSpace() : cowKey(1) {}
-    AddressSpace(const AddressSpace &b) : cowKey(++b.cowKey), objects(b.objects) { }
+    AddressSpace(const AddressSpace &b)
+      : cowKey(++b.cowKey), resolutionCache(b.resolutionCache),
+        objects(b.objects) { }
     ~AddressSpace() {}
 
     /// Resolve address to an ObjectPair in result.
@@ -28,6 +28,8 @@ Statistic stats::states("States", "States");
 Statistic stats::trueBranches("TrueBranches", "Bt");
 Statistic stats::uncoveredInstructions("UncoveredInstructions", "Iuncov");
 
+Statistic stats::concreteInstructions("ConcreteInstructions", "Icon");
+
 Statistic stats::catchUpInstructions("CatchUpInstructions", "Icup");
 Statistic stats::standbyStates("StandbyStates", "Standby");
 Statistic stats::cutoffEvents("CutoffEvents", "coE");
@@ -42,3 +44,16 @@ Statistic stats::dataraceConfigurations("DataraceConfigurations", "drConf");
 Statistic stats::cexAboveCsdLimit("CexAboveCsdLimit", "cexCsd");
 Statistic stats::csdThreads("CsdThreads", "csdTh");
 Statistic stats::cutoffThreads("CsdThreads", "coTh");
+
+Statistic stats::porRegistrationTime("PorRegistrationTime", "PRtime");
+Statistic stats::porRegistrations("PorRegistrations", "PR");
+Statistic stats::porCexTime("PorCexTime", "PCtime");
+Statistic stats::porCexComputations("PorCexComputations", "PC");
+Statistic stats::porCsdTime("PorCsdTime", "PCsdtime");
+Statistic stats::porCsdChecks("PorCsdChecks", "PCsd");
+Statistic stats::porFingerprintTime("PorFingerprintTime", "PFtime");
+Statistic stats::porFingerprints("PorFingerprints", "PF");
+Statistic stats::porCutoffTime("PorCutoffTime", "PCotime");
+Statistic stats::porCutoffLookups("PorCutoffLookups", "PCo");
+Statistic stats::porStandbyTime("PorStandbyTime", "PStime");
+Statistic stats::porCatchUpTime("PorCatchUpTime", "PCUtime");
@@ -47,6 +47,9 @@ namespace stats {
   /// distance to a function return.
   extern Statistic minDistToReturn;
 
+  /// Instructions that were executed natively on concrete operands.
+  extern Statistic concreteInstructions;
+
   extern Statistic catchUpInstructions;
   extern Statistic standbyStates;
   extern Statistic cutoffEvents;
@@ -61,6 +64,22 @@ namespace stats {
   extern Statistic cexAboveCsdLimit;
   extern Statistic csdThreads;
   extern Statistic cutoffThreads;
+
+  /// Time (in microseconds) spent in and number of executions of phases of
+  /// partial-order reduction. Phases may be nested, e.g. registration includes
+  /// fingerprint computation, standby creation and cutoff lookups.
+  extern Statistic porRegistrationTime;
+  extern Statistic porRegistrations;
+  extern Statistic porCexTime;
+  extern Statistic porCexComputations;
+  extern Statistic porCsdTime;
+  extern Statistic porCsdChecks;
+  extern Statistic porFingerprintTime;
+  extern Statistic porFingerprints;
+  extern Statistic porCutoffTime;
+  extern Statistic porCutoffLookups;
+  extern Statistic porStandbyTime;
+  extern Statistic porCatchUpTime;
 }
 }
 
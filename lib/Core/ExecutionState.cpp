@@ -20,12 +20,14 @@
 #include "klee/OptionCategories.h"
 #include "klee/PorCmdLine.h"
 #include "klee/Thread.h"
+#include "klee/TimerStatIncrementer.h"
 
 #include "CoreStats.h"
 #include "Memory.h"
 #include "MemoryState.h"
 #include "MemoryManager.h"
 #include "PTree.h"
+#include "StatsTracker.h"
 
 #include "llvm/IR/Function.h"
 #include "llvm/Support/CommandLine.h"
@@ -40,6 +42,7 @@
 #include <cstdarg>
 #include <iomanip>
 #include <map>
+#include <optional>
 #include <set>
 #include <sstream>
 
@@ -228,6 +231,14 @@ void ExecutionState::blockThread(Thread &thread, Thread::waiting_t blockOn) {
         os << "wait_cv_2_t{" << w.cond << ", " << w.lock << "}";
       } else if constexpr (std::is_same_v<T, Thread::wait_join_t>) {
         os << "wait_join_t{" << w.thread.to_string() << "}";
+      } else if constexpr (std::is_same_v<T, Thread::wait_rdlock_t>) {
+        os << "wait_rdlock_t{" << w.lock << "}";
+      } else if constexpr (std::is_same_v<T, Thread::wait_wrlock_t>) {
+        os << "wait_wrlock_t{" << w.lock << "}";
+      } else if constexpr (std::is_same_v<T, Thread::wait_semaphore_t>) {
+        os << "wait_semaphore_t{" << w.semaphore << "}";
+      } else if constexpr (std::is_same_v<T, Thread::wait_barrier_t>) {
+        os << "wait_barrier_t{" << w.barrier << "}";
       } else {
         assert(0);
       }
@@ -280,6 +291,10 @@ Thread::waiting_t ExecutionState::runThread(Thread &thread) {
         memoryState.registerAcquiredLock(w.lock, tid);
       } else if constexpr (std::is_same_v<T, Thread::wait_cv_2_t>) {
         memoryState.registerAcquiredLock(w.lock, tid);
+      } else if constexpr (std::is_same_v<T, Thread::wait_rdlock_t> || std::is_same_v<T, Thread::wait_wrlock_t>) {
+        memoryState.registerAcquiredLock(w.lock, tid);
+      } else if constexpr (std::is_same_v<T, Thread::wait_semaphore_t>) {
+        memoryState.registerSemaphoreChange(w.semaphore, tid, -1);
       }
     }, previous);
   } else if (thread.state != ThreadState::Runnable) {
@@ -297,7 +312,15 @@ std::set<ThreadId> ExecutionState::runnableThreads() {
   for (auto &[tid, thread] : threads) {
     if (thread.isRunnable(cfg)) {
       assert(cfg.last_of_tid(tid));
-      bool overCsd = !UnlimitedContextSwitchDegree && por::is_above_csd_limit(*cfg.last_of_tid(tid), MaxContextSwitchDegree);
+      bool overCsd = false;
+      if (!UnlimitedContextSwitchDegree) {
+        ++stats::porCsdChecks;
+        // only read the clock if the time is written to the statistics
+        std::optional<TimerStatIncrementer> timer;
+        if (StatsTracker::useStatistics())
+          timer.emplace(stats::porCsdTime);
+        overCsd = por::is_above_csd_limit(*cfg.last_of_tid(tid), MaxContextSwitchDegree);
+      }
       bool isCutoff = cfg.last_of_tid(tid)->is_cutoff();
       if (isCutoff || overCsd) {
         if (!needsCatchUp()) {
@@ -353,6 +376,14 @@ void ExecutionState::dumpSchedulingInfo(llvm::raw_ostream &out) const {
           out << "wait_cv_2_t{" << w.cond << ", " << w.lock << "}";
         } else if constexpr (std::is_same_v<T, Thread::wait_join_t>) {
           out << "wait_join_t{" << w.thread.to_string() << "}";
+        } else if constexpr (std::is_same_v<T, Thread::wait_rdlock_t>) {
+          out << "wait_rdlock_t{" << w.lock << "}";
+        } else if constexpr (std::is_same_v<T, Thread::wait_wrlock_t>) {
+          out << "wait_wrlock_t{" << w.lock << "}";
+        } else if constexpr (std::is_same_v<T, Thread::wait_semaphore_t>) {
+          out << "wait_semaphore_t{" << w.semaphore << "}";
+        } else if constexpr (std::is_same_v<T, Thread::wait_barrier_t>) {
+          out << "wait_barrier_t{" << w.barrier << (w.arrivals.empty() ? "" : ", released") << "}";
         } else {
           assert(0 && "unknown waiting handle");
         }
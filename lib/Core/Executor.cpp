@@ -52,6 +52,7 @@
 #include "klee/Solver/SolverCmdLine.h"
 #include "klee/Solver/SolverStats.h"
 #include "klee/TimerStatIncrementer.h"
+#include "klee/util/Bits.h"
 #include "klee/util/GetElementPtrTypeIterator.h"
 
 #include "llvm/ADT/SmallPtrSet.h"
@@ -117,6 +118,9 @@ cl::OptionCategory
 cl::OptionCategory TestGenCat("Test generation options",
                               "These options impact test generation.");
 
+cl::OptionCategory ExecCat("Execution options",
+                           "These options impact how instructions are executed.");
+
 cl::OptionCategory MultithreadingCat("Multithreading options",
                                      "These are options that impact the exploration of multithreaded programs, "
                                      "along with partial order reduction and fingerprinting.");
@@ -131,15 +135,16 @@ cl::opt<std::string> MaxTime(
 } // namespace klee
 
 namespace {
-  cl::opt<bool> LogStateJSON(
-      "log-state-json-files",
-      cl::desc("Creates two files (states.json, states_fork.json) in output directory that record relevant information about states (default=false)"),
+  cl::opt<bool> LogStateTrace(
+      "log-state-trace",
+      cl::desc("Creates two files (states.trace, states_fork.json) in output directory that record relevant information about states. "
+               "The binary states.trace can be converted to JSON using klee-state-trace (default=false)"),
       cl::init(false));
 
 #ifdef HAVE_ZLIB_H
-  cl::opt<bool> CompressLogStateJSON(
-      "compress-log-state-json-files",
-      cl::desc("Compress the files created by -log-state-json-files in gzip format."),
+  cl::opt<bool> CompressLogStateTrace(
+      "compress-log-state-trace",
+      cl::desc("Compress the files created by -log-state-trace in gzip format."),
       cl::init(false));
 #endif
 
@@ -413,6 +418,14 @@ llvm::cl::opt<bool> DebugPrintCalls("debug-print-calls", cl::init(false), cl::ca
 
 llvm::cl::opt<bool> DebugPrintPorStats("debug-print-por-statistics", cl::init(false), cl::cat(DebugCat));
 
+cl::opt<bool> ConcreteFastPath(
+    "concrete-fast-path",
+    cl::init(true),
+    cl::desc("Evaluate integer arithmetic, comparisons and casts on concrete "
+             "operands natively instead of through the expression library "
+             "(default=true)"),
+    cl::cat(ExecCat));
+
 cl::opt<bool> EnableDataRaceDetection("data-race-detection",
     cl::init(true),
     cl::desc("Check memory accesses for races between threads"),
@@ -479,6 +492,14 @@ cl::opt<std::uint64_t> ExploreSchedulesInstructions(
     cl::init(10000),
     cl::cat(MultithreadingCat));
 
+cl::opt<unsigned> PruneUnfolding(
+    "prune-unfolding",
+    cl::desc("Remove events that cannot be referred to anymore from the "
+             "unfolding after every N maximal configurations (0 to disable, "
+             "default=0)"),
+    cl::init(0),
+    cl::cat(MultithreadingCat));
+
 cl::opt<bool> DebugAlternatives(
   "debug-alternative-schedules",
   cl::init(false),
@@ -616,31 +637,35 @@ Executor::Executor(LLVMContext &ctx, const InterpreterOptions &opts,
     }
   }
 
-  if (LogStateJSON) {
+  if (LogStateTrace) {
     size_t stateLoggingOverhead = util::GetTotalMallocUsage();
 
     std::string states_file_name =
-      interpreterHandler->getOutputFilename("states.json");
+      interpreterHandler->getOutputFilename("states.trace");
 
     std::string error;
 #ifdef HAVE_ZLIB_H
-    if (!CompressLogStateJSON) {
+    if (!CompressLogStateTrace) {
 #endif
-      statesJSONFile = klee_open_output_file(states_file_name, error);
+      stateTraceFile = klee_open_output_file(states_file_name, error);
 #ifdef HAVE_ZLIB_H
     } else {
       states_file_name.append(".gz");
-      statesJSONFile = klee_open_compressed_output_file(states_file_name, error);
+      stateTraceFile = klee_open_compressed_output_file(states_file_name, error);
     }
 #endif
 
-    if (statesJSONFile) {
-      (*statesJSONFile) << "[\n";
-      (*statesJSONFile) << "  {\n";
-      (*statesJSONFile) << "    \"functionpointer_size\": "
-                        << sizeof(llvm::Function *) << ",\n";
-      (*statesJSONFile) << "    \"memory_state_size\": "
-                        << sizeof(MemoryState) << ",\n";
+    if (stateTraceFile) {
+      // records are small, avoid flushing after every few of them
+      stateTraceFile->SetBufferSize(1 << 20);
+
+      stateTraceHeader = {};
+      std::copy(std::begin(StateTraceMagic), std::end(StateTraceMagic),
+                stateTraceHeader.magic);
+      stateTraceHeader.version = StateTraceVersion;
+      stateTraceHeader.recordSize = sizeof(StateTraceRecord);
+      stateTraceHeader.functionPointerSize = sizeof(llvm::Function *);
+      stateTraceHeader.memoryStateSize = sizeof(MemoryState);
     } else {
       klee_error("Could not open file %s : %s",
                  states_file_name.c_str(),
@@ -653,7 +678,7 @@ Executor::Executor(LLVMContext &ctx, const InterpreterOptions &opts,
     error = "";
 
 #ifdef HAVE_ZLIB_H
-    if (!CompressLogStateJSON) {
+    if (!CompressLogStateTrace) {
 #endif
       forkJSONFile = klee_open_output_file(fork_file_name, error);
 #ifdef HAVE_ZLIB_H
@@ -670,10 +695,7 @@ Executor::Executor(LLVMContext &ctx, const InterpreterOptions &opts,
 
     stateLoggingOverhead = util::GetTotalMallocUsage() - stateLoggingOverhead;
 
-    if (statesJSONFile) {
-      (*statesJSONFile) << "    \"logging_overhead\": "
-                        << stateLoggingOverhead << ",\n";
-    }
+    stateTraceHeader.loggingOverhead = stateLoggingOverhead;
   }
 }
 
@@ -745,6 +767,18 @@ Executor::setModule(std::vector<std::unique_ptr<llvm::Module>> &modules,
   if (EnableCutoffEvents)
     MemoryState::setKModule(kmodule.get());
 
+  if (stateTraceFile) {
+    // the function lists do not change after this point; write the header
+    // right away so that even a trace of an aborted run can be read
+    stateTraceHeader.functionListsLength =
+        MemoryState::getFunctionListsLength();
+    stateTraceHeader.functionListsCapacity =
+        MemoryState::getFunctionListsCapacity();
+    stateTraceFile->write(reinterpret_cast<const char *>(&stateTraceHeader),
+                          sizeof(stateTraceHeader));
+    stateTraceFile->flush();
+  }
+
   return kmodule->module.get();
 }
 
@@ -754,9 +788,6 @@ Executor::~Executor() {
   delete specialFunctionHandler;
   delete statsTracker;
   delete solver;
-  if (statesJSONFile) {
-    (*statesJSONFile) << "\n]\n";
-  }
   if (forkJSONFile) {
     (*forkJSONFile) << "\n]\n";
   }
@@ -1057,6 +1088,7 @@ void Executor::branch(ExecutionState &state,
                       const std::vector<std::pair<std::size_t, ref<Expr>>> &conditions,
                       std::vector<ExecutionState*> &result) {
   TimerStatIncrementer timer(stats::forkTime);
+  TimingSolver::OriginScope origin(*solver, QueryOrigin::Fork);
   unsigned N = conditions.size();
   assert(N);
 
@@ -1165,6 +1197,7 @@ void Executor::branch(ExecutionState &state,
 
 Executor::StatePair 
 Executor::fork(ExecutionState &current, ref<Expr> condition, bool isInternal) {
+  TimingSolver::OriginScope origin(*solver, QueryOrigin::Fork);
   Solver::Validity res;
   std::map< ExecutionState*, std::vector<SeedInfo> >::iterator it = 
     seedMap.find(&current);
@@ -1546,6 +1579,7 @@ void Executor::bindArgument(KFunction *kf, unsigned index,
 
 ref<Expr> Executor::toUnique(const ExecutionState &state, 
                              ref<Expr> &e) {
+  TimingSolver::OriginScope origin(*solver, QueryOrigin::GetValue);
   ref<Expr> result = e;
 
   if (!isa<ConstantExpr>(e)) {
@@ -1576,6 +1610,8 @@ Executor::toConstant(ExecutionState &state,
   if (ConstantExpr *CE = dyn_cast<ConstantExpr>(e))
     return CE;
 
+  TimingSolver::OriginScope origin(*solver, QueryOrigin::GetValue);
+
   ref<ConstantExpr> value;
   bool success = solver->getValue(state, e, value);
   assert(success && "FIXME: Unhandled solver failure");
@@ -1601,6 +1637,7 @@ Executor::toConstant(ExecutionState &state,
 void Executor::executeGetValue(ExecutionState &state,
                                ref<Expr> e,
                                KInstruction *target) {
+  TimingSolver::OriginScope origin(*solver, QueryOrigin::GetValue);
   e = state.constraints.simplifyExpr(e);
   std::map< ExecutionState*, std::vector<SeedInfo> >::iterator it = 
     seedMap.find(&state);
@@ -1827,8 +1864,8 @@ void Executor::executeCall(ExecutionState &state,
       klee_error("unknown intrinsic: %s", f->getName().data());
     }
 
-    if (InvokeInst *ii = dyn_cast<InvokeInst>(i)) {
-      transferToBasicBlock(ii->getNormalDest(), i->getParent(), state);
+    if (isa<InvokeInst>(i)) {
+      transferToBasicBlock(ki->targets[0], i->getParent(), state);
     }
   } else {
     // Check if maximum stack size was reached.
@@ -1847,7 +1884,7 @@ void Executor::executeCall(ExecutionState &state,
     Thread &thread = state.thread();
     state.pushFrame(state.prevPc(), kf);
     thread.pc = kf->instructions;
-    thread.liveSet = kf->getLiveLocals(&kf->function->front());
+    thread.liveSet = kf->getLiveLocalsAt(0);
     if (EnableCutoffEvents) {
       state.memoryState.registerPushFrame(state.tid(), state.stackFrameIndex(),
                                           kf, state.prevPc());
@@ -1984,19 +2021,23 @@ void Executor::transferToBasicBlock(BasicBlock *dst, BasicBlock *src,
   // With that done we simply set an index in the state so that PHI
   // instructions know which argument to eval, set the pc, and continue.
 
+  KFunction *kf = state.thread().stack.back().kf;
+  transferToBasicBlock(kf->basicBlockEntry[dst], src, state);
+}
+
+void Executor::transferToBasicBlock(unsigned dstEntry, BasicBlock *src,
+                                    ExecutionState &state) {
   Thread &thread = state.thread();
 
-  // XXX this lookup has to go ?
   KFunction *kf = thread.stack.back().kf;
-  unsigned entry = kf->basicBlockEntry[dst];
-  thread.pc = &kf->instructions[entry];
-  if (thread.pc->inst->getOpcode() == Instruction::PHI) {
+  thread.pc = &kf->instructions[dstEntry];
+  if (thread.pc->opcode == Instruction::PHI) {
     // set incomingBBIndex (only needed for PHI-Nodes)
     PHINode *first = static_cast<PHINode*>(thread.pc->inst);
     thread.incomingBBIndex = first->getBasicBlockIndex(src);
   } else {
     // more precise information of what is live after this instruction
-    thread.liveSet = kf->getLiveLocals(dst);
+    thread.liveSet = kf->getLiveLocalsAt(dstEntry);
   }
 }
 
@@ -2030,6 +2071,144 @@ Function* Executor::getTargetFunction(Value *calledVal, ExecutionState &state) {
   }
 }
 
+namespace {
+/// Booleans and small values of the common integer widths are interned, so
+/// that binding a concrete result usually does not need to allocate.
+ref<Expr> createConcreteResult(uint64_t value, Expr::Width width) {
+  static constexpr uint64_t internedValues = 256;
+  static ref<klee::ConstantExpr> interned[5][internedValues];
+
+  unsigned index;
+  switch (width) {
+  case Expr::Bool:  index = 0; break;
+  case Expr::Int8:  index = 1; break;
+  case Expr::Int16: index = 2; break;
+  case Expr::Int32: index = 3; break;
+  case Expr::Int64: index = 4; break;
+  default:
+    return klee::ConstantExpr::create(value, width);
+  }
+
+  if (value >= internedValues)
+    return klee::ConstantExpr::create(value, width);
+
+  ref<klee::ConstantExpr> &result = interned[index][value];
+  if (result.isNull())
+    result = klee::ConstantExpr::create(value, width);
+  return result;
+}
+
+int64_t signExtend(uint64_t value, Expr::Width width) {
+  if (width == 64)
+    return static_cast<int64_t>(value);
+  uint64_t sign = 1ull << (width - 1);
+  return static_cast<int64_t>((value ^ sign) - sign);
+}
+} // namespace
+
+bool Executor::executeConcreteInstruction(ExecutionState &state,
+                                          KInstruction *ki) {
+  Instruction *i = ki->inst;
+  unsigned opcode = ki->opcode;
+
+  if (opcode == Instruction::Trunc || opcode == Instruction::ZExt ||
+      opcode == Instruction::SExt) {
+    const auto *arg = dyn_cast<klee::ConstantExpr>(eval(ki, 0, state).value.get());
+    Expr::Width to = ki->width;
+    if (!arg || arg->getWidth() > 64 || to > 64)
+      return false;
+
+    uint64_t value = arg->getZExtValue();
+    if (opcode == Instruction::SExt)
+      value = static_cast<uint64_t>(signExtend(value, arg->getWidth()));
+    bindLocal(ki, state, createConcreteResult(bits64::truncateToNBits(value, to), to));
+    return true;
+  }
+
+  if (!Instruction::isBinaryOp(opcode) && opcode != Instruction::ICmp)
+    return false;
+
+  // only look at the cells, as copying the refs is a large part of the cost
+  const auto *left = dyn_cast<klee::ConstantExpr>(eval(ki, 0, state).value.get());
+  if (!left || left->getWidth() > 64)
+    return false;
+  const auto *right = dyn_cast<klee::ConstantExpr>(eval(ki, 1, state).value.get());
+  if (!right)
+    return false;
+  assert(left->getWidth() == right->getWidth() && "operand width mismatch");
+
+  Expr::Width width = left->getWidth();
+  uint64_t l = left->getZExtValue();
+  uint64_t r = right->getZExtValue();
+
+  if (opcode == Instruction::ICmp) {
+    bool result;
+    switch (cast<ICmpInst>(i)->getPredicate()) {
+    case ICmpInst::ICMP_EQ:  result = l == r; break;
+    case ICmpInst::ICMP_NE:  result = l != r; break;
+    case ICmpInst::ICMP_UGT: result = l > r; break;
+    case ICmpInst::ICMP_UGE: result = l >= r; break;
+    case ICmpInst::ICMP_ULT: result = l < r; break;
+    case ICmpInst::ICMP_ULE: result = l <= r; break;
+    case ICmpInst::ICMP_SGT: result = signExtend(l, width) > signExtend(r, width); break;
+    case ICmpInst::ICMP_SGE: result = signExtend(l, width) >= signExtend(r, width); break;
+    case ICmpInst::ICMP_SLT: result = signExtend(l, width) < signExtend(r, width); break;
+    case ICmpInst::ICMP_SLE: result = signExtend(l, width) <= signExtend(r, width); break;
+    default:
+      return false;
+    }
+    bindLocal(ki, state, createConcreteResult(result, Expr::Bool));
+    return true;
+  }
+
+  uint64_t result;
+  switch (opcode) {
+  case Instruction::Add: result = l + r; break;
+  case Instruction::Sub: result = l - r; break;
+  case Instruction::Mul: result = l * r; break;
+  case Instruction::And: result = l & r; break;
+  case Instruction::Or:  result = l | r; break;
+  case Instruction::Xor: result = l ^ r; break;
+
+  // division by zero, signed overflow and oversized shifts are left to the
+  // generic path, which reproduces the exact behavior of the expression library
+  case Instruction::UDiv:
+  case Instruction::URem:
+    if (r == 0)
+      return false;
+    result = opcode == Instruction::UDiv ? l / r : l % r;
+    break;
+  case Instruction::SDiv:
+  case Instruction::SRem: {
+    int64_t sl = signExtend(l, width);
+    int64_t sr = signExtend(r, width);
+    if (sr == 0 || (sr == -1 && sl == signExtend(1ull << (width - 1), width)))
+      return false;
+    result = static_cast<uint64_t>(opcode == Instruction::SDiv ? sl / sr : sl % sr);
+    break;
+  }
+  case Instruction::Shl:
+  case Instruction::LShr:
+  case Instruction::AShr:
+    if (r >= width)
+      return false;
+    if (opcode == Instruction::Shl)
+      result = l << r;
+    else if (opcode == Instruction::LShr)
+      result = l >> r;
+    else
+      result = static_cast<uint64_t>(signExtend(l, width) >> r);
+    break;
+
+  default:
+    // floating point operations
+    return false;
+  }
+
+  bindLocal(ki, state, createConcreteResult(bits64::truncateToNBits(result, width), width));
+  return true;
+}
+
 void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   Instruction *i = ki->inst;
   Thread &thread = state.thread();
@@ -2037,7 +2216,12 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
 
   assert(state.threadState() == ThreadState::Runnable);
 
-  switch (i->getOpcode()) {
+  if (ConcreteFastPath && executeConcreteInstruction(state, ki)) {
+    ++stats::concreteInstructions;
+    return;
+  }
+
+  switch (ki->opcode) {
     // Control flow
   case Instruction::Ret: {
     ReturnInst *ri = cast<ReturnInst>(i);
@@ -2086,8 +2270,8 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
       if (statsTracker)
         statsTracker->framePopped(state);
 
-      if (InvokeInst *ii = dyn_cast<InvokeInst>(caller)) {
-        transferToBasicBlock(ii->getNormalDest(), caller->getParent(), state);
+      if (isa<InvokeInst>(caller)) {
+        transferToBasicBlock(kcaller->targets[0], caller->getParent(), state);
       } else {
         thread.pc = kcaller;
         ++thread.pc;
@@ -2134,7 +2318,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   case Instruction::Br: {
     BranchInst *bi = cast<BranchInst>(i);
     if (bi->isUnconditional()) {
-      transferToBasicBlock(bi->getSuccessor(0), bi->getParent(), state);
+      transferToBasicBlock(ki->targets[0], bi->getParent(), state);
     } else {
       // FIXME: Find a way that we don't have this hidden dependency.
       assert(bi->getCondition() == bi->getOperand(0) &&
@@ -2152,9 +2336,9 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
         statsTracker->markBranchVisited(branches.first, branches.second);
 
       if (branches.first)
-        transferToBasicBlock(bi->getSuccessor(0), bi->getParent(), *branches.first);
+        transferToBasicBlock(ki->targets[0], bi->getParent(), *branches.first);
       if (branches.second)
-        transferToBasicBlock(bi->getSuccessor(1), bi->getParent(), *branches.second);
+        transferToBasicBlock(ki->targets[1], bi->getParent(), *branches.second);
     }
     break;
   }
@@ -2247,7 +2431,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
 #else
       unsigned index = si->findCaseValue(ci).getSuccessorIndex();
 #endif
-      transferToBasicBlock(si->getSuccessor(index), si->getParent(), state);
+      transferToBasicBlock(ki->targets[index], si->getParent(), state);
     } else {
       // Handle possible different branch targets
 
@@ -2726,38 +2910,33 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
 
     // Conversion
   case Instruction::Trunc: {
-    CastInst *ci = cast<CastInst>(i);
     ref<Expr> result = ExtractExpr::create(eval(ki, 0, state).value,
                                            0,
-                                           getWidthForLLVMType(ci->getType()));
+                                           ki->width);
     bindLocal(ki, state, result);
     break;
   }
   case Instruction::ZExt: {
-    CastInst *ci = cast<CastInst>(i);
     ref<Expr> result = ZExtExpr::create(eval(ki, 0, state).value,
-                                        getWidthForLLVMType(ci->getType()));
+                                        ki->width);
     bindLocal(ki, state, result);
     break;
   }
   case Instruction::SExt: {
-    CastInst *ci = cast<CastInst>(i);
     ref<Expr> result = SExtExpr::create(eval(ki, 0, state).value,
-                                        getWidthForLLVMType(ci->getType()));
+                                        ki->width);
     bindLocal(ki, state, result);
     break;
   }
 
   case Instruction::IntToPtr: {
-    CastInst *ci = cast<CastInst>(i);
-    Expr::Width pType = getWidthForLLVMType(ci->getType());
+    Expr::Width pType = ki->width;
     ref<Expr> arg = eval(ki, 0, state).value;
     bindLocal(ki, state, ZExtExpr::create(arg, pType));
     break;
   }
   case Instruction::PtrToInt: {
-    CastInst *ci = cast<CastInst>(i);
-    Expr::Width iType = getWidthForLLVMType(ci->getType());
+    Expr::Width iType = ki->width;
     ref<Expr> arg = eval(ki, 0, state).value;
     bindLocal(ki, state, ZExtExpr::create(arg, iType));
     break;
@@ -2846,8 +3025,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   }
 
   case Instruction::FPTrunc: {
-    FPTruncInst *fi = cast<FPTruncInst>(i);
-    Expr::Width resultType = getWidthForLLVMType(fi->getType());
+    Expr::Width resultType = ki->width;
     ref<ConstantExpr> arg = toConstant(state, eval(ki, 0, state).value,
                                        "floating point");
     if (!fpWidthToSemantics(arg->getWidth()) || resultType > arg->getWidth())
@@ -2863,8 +3041,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   }
 
   case Instruction::FPExt: {
-    FPExtInst *fi = cast<FPExtInst>(i);
-    Expr::Width resultType = getWidthForLLVMType(fi->getType());
+    Expr::Width resultType = ki->width;
     ref<ConstantExpr> arg = toConstant(state, eval(ki, 0, state).value,
                                         "floating point");
     if (!fpWidthToSemantics(arg->getWidth()) || arg->getWidth() > resultType)
@@ -2879,8 +3056,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   }
 
   case Instruction::FPToUI: {
-    FPToUIInst *fi = cast<FPToUIInst>(i);
-    Expr::Width resultType = getWidthForLLVMType(fi->getType());
+    Expr::Width resultType = ki->width;
     ref<ConstantExpr> arg = toConstant(state, eval(ki, 0, state).value,
                                        "floating point");
     if (!fpWidthToSemantics(arg->getWidth()) || resultType > 64)
@@ -2901,8 +3077,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   }
 
   case Instruction::FPToSI: {
-    FPToSIInst *fi = cast<FPToSIInst>(i);
-    Expr::Width resultType = getWidthForLLVMType(fi->getType());
+    Expr::Width resultType = ki->width;
     ref<ConstantExpr> arg = toConstant(state, eval(ki, 0, state).value,
                                        "floating point");
     if (!fpWidthToSemantics(arg->getWidth()) || resultType > 64)
@@ -2923,8 +3098,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   }
 
   case Instruction::UIToFP: {
-    UIToFPInst *fi = cast<UIToFPInst>(i);
-    Expr::Width resultType = getWidthForLLVMType(fi->getType());
+    Expr::Width resultType = ki->width;
     ref<ConstantExpr> arg = toConstant(state, eval(ki, 0, state).value,
                                        "floating point");
     const llvm::fltSemantics *semantics = fpWidthToSemantics(resultType);
@@ -2939,8 +3113,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
   }
 
   case Instruction::SIToFP: {
-    SIToFPInst *fi = cast<SIToFPInst>(i);
-    Expr::Width resultType = getWidthForLLVMType(fi->getType());
+    Expr::Width resultType = ki->width;
     ref<ConstantExpr> arg = toConstant(state, eval(ki, 0, state).value,
                                        "floating point");
     const llvm::fltSemantics *semantics = fpWidthToSemantics(resultType);
@@ -3069,7 +3242,7 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
 
     ref<Expr> agg = eval(ki, 0, state).value;
 
-    ref<Expr> result = ExtractExpr::create(agg, kgepi->offset*8, getWidthForLLVMType(i->getType()));
+    ref<Expr> result = ExtractExpr::create(agg, kgepi->offset*8, ki->width);
 
     bindLocal(ki, state, result);
     break;
@@ -3172,12 +3345,13 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
       }
     }
 
-    if (!porEventManager.registerLockAcquire(state, memLoc->first->getId(), false)) {
+    // NOTE: no standby state, as the memory access has not been performed yet
+    if (!porEventManager.registerAtomicWrite(state, memLoc->first->getId(), false)) {
       terminateStateSilently(state);
       break;
     }
 
-    auto oldValue = executeMemoryRead(state, memLoc.value(), memValWidth);
+    auto oldValue = executeMemoryRead(state, memLoc.value(), memValWidth, true);
     ref<Expr> result;
 
     bool failed = false;
@@ -3247,15 +3421,10 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
     }
 
     // Write the new result back to the pointer
-    executeMemoryWrite(state, memLoc.value(), pointer, result);
+    executeMemoryWrite(state, memLoc.value(), pointer, result, true);
 
     // Every AtomicRMW returns the old value
     bindLocal(ki, state, oldValue);
-
-    if (!porEventManager.registerLockRelease(state, memLoc->first->getId(), true, true)) {
-      terminateStateSilently(state);
-      break;
-    }
     break;
   }
 
@@ -3284,17 +3453,18 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
       }
     }
 
-    if (!porEventManager.registerLockAcquire(state, src->first->getId(), false)) {
+    // NOTE: a failing cmpxchg only reads, but whether it fails may depend on symbolic values
+    if (!porEventManager.registerAtomicWrite(state, src->first->getId(), false)) {
       terminateStateSilently(state);
       break;
     }
 
-    auto oldValue = executeMemoryRead(state, src.value(), readWidth);
+    auto oldValue = executeMemoryRead(state, src.value(), readWidth, true);
 
     auto equal = EqExpr::create(oldValue, compare);
     auto write = SelectExpr::create(equal, newValue, oldValue);
 
-    executeMemoryWrite(state, src.value(), pointer, write);
+    executeMemoryWrite(state, src.value(), pointer, write, true);
 
     // The return value is a struct containing the oldValue and a bool,
     // that indicates whether the replace was successful
@@ -3302,11 +3472,6 @@ void Executor::executeInstruction(ExecutionState &state, KInstruction *ki) {
     //          but in the ConcatExpr it has to be the last in order to work correctly
     // FIXME: this is totally broken, but there is no easy fix at the moment
     bindLocal(ki, state, ConcatExpr::create(equal, oldValue));
-
-    if (!porEventManager.registerLockRelease(state, src->first->getId(), true, true)) {
-      terminateStateSilently(state);
-      break;
-    }
     break;
   }
 
@@ -3573,12 +3738,24 @@ void Executor::run(ExecutionState &initialState) {
   std::vector<ExecutionState *> newStates(states.begin(), states.end());
   searcher->update(0, newStates, std::vector<ExecutionState *>());
 
-  bool firstInstruction = true;
+  // the clock is only read when switching between states that are catching up
+  // and states that are not
+  bool catchingUp = false;
+  time::Point catchUpStart;
 
   while (!states.empty() && !haltExecution) {
     ExecutionState &state = searcher->selectState();
     KInstruction *ki = state.pc();
 
+    if (state.needsCatchUp() != catchingUp) {
+      catchingUp = !catchingUp;
+      if (catchingUp) {
+        catchUpStart = time::getWallTime();
+      } else {
+        stats::porCatchUpTime += (time::getWallTime() - catchUpStart).toMicroseconds();
+      }
+    }
+
     stepInstruction(state);
 
     if (DebugLiveSet) {
@@ -3594,14 +3771,7 @@ void Executor::run(ExecutionState &initialState) {
     }
 
     timers.invoke();
-    if (firstInstruction && statesJSONFile) {
-      (*statesJSONFile) << "    \"functionlists_length\": "
-                        << state.memoryState.getFunctionListsLength() << ",\n";
-      (*statesJSONFile) << "    \"functionlists_capacity\": "
-                        << state.memoryState.getFunctionListsCapacity() << "\n";
-      (*statesJSONFile) << "  }";
-    }
-    updateStatesJSON(ki, state);
+    updateStateTrace(ki, state);
 
     if (::dumpStates) dumpStates();
     if (::dumpPTree) dumpPTree();
@@ -3614,10 +3784,11 @@ void Executor::run(ExecutionState &initialState) {
       exploreSchedules(state);
       updateStates(nullptr);
     }
-
-    firstInstruction = false;
   }
 
+  if (catchingUp)
+    stats::porCatchUpTime += (time::getWallTime() - catchUpStart).toMicroseconds();
+
   delete searcher;
   searcher = nullptr;
 
@@ -3630,36 +3801,50 @@ void Executor::exploreSchedules(ExecutionState &state, bool maximalConfiguration
   }
   por::configuration const& cfg = state.porNode->configuration();
 
-  std::vector<const por::event::event *> conflicting_extensions = cfg.conflicting_extensions(true);
+  std::vector<const por::event::event *> conflicting_extensions;
+  {
+    TimerStatIncrementer timer(stats::porCexTime);
+    ++stats::porCexComputations;
 
-  if (maximalConfiguration) {
-    for (auto &[tid, thread] : state.threads) {
-      if (thread.isRunnable(cfg)) {
-        continue;
-      }
-      if (thread.state == ThreadState::Waiting) {
-        por::event::lock_id_t lid;
-        por::event::event_kind kind;
-
-        if (auto lock = thread.isWaitingOn<Thread::wait_lock_t>()) {
-          lid = lock->lock;
-          kind = por::event::event_kind::lock_acquire;
-        } else if (auto wait = thread.isWaitingOn<Thread::wait_cv_2_t>()) {
-          lid = wait->lock;
-          kind = por::event::event_kind::wait2;
-        } else {
+    conflicting_extensions = cfg.conflicting_extensions(true);
+
+    if (maximalConfiguration) {
+      for (auto &[tid, thread] : state.threads) {
+        if (thread.isRunnable(cfg)) {
           continue;
         }
+        if (thread.state == ThreadState::Waiting) {
+          por::event::lock_id_t lid;
+          por::event::event_kind kind;
+
+          if (auto lock = thread.isWaitingOn<Thread::wait_lock_t>()) {
+            lid = lock->lock;
+            kind = por::event::event_kind::lock_acquire;
+          } else if (auto wait = thread.isWaitingOn<Thread::wait_cv_2_t>()) {
+            lid = wait->lock;
+            kind = por::event::event_kind::wait2;
+          } else {
+            continue;
+          }
 
-        auto dlcex = cfg.conflicting_extensions_deadlock(tid, lid, kind, true);
-        conflicting_extensions.insert(conflicting_extensions.end(), dlcex.begin(), dlcex.end());
+          auto dlcex = cfg.conflicting_extensions_deadlock(tid, lid, kind, true);
+          conflicting_extensions.insert(conflicting_extensions.end(), dlcex.begin(), dlcex.end());
+        }
       }
     }
   }
 
   for (por::event::event const *cex : conflicting_extensions) {
     assert(!cex->is_cutoff());
-    if (!UnlimitedContextSwitchDegree && por::is_above_csd_limit(*cex, MaxContextSwitchDegree)) {
+    bool aboveCsdLimit = false;
+    if (!UnlimitedContextSwitchDegree) {
+      ++stats::porCsdChecks;
+      std::optional<TimerStatIncrementer> timer;
+      if (StatsTracker::useStatistics())
+        timer.emplace(stats::porCsdTime);
+      aboveCsdLimit = por::is_above_csd_limit(*cex, MaxContextSwitchDegree);
+    }
+    if (aboveCsdLimit) {
       ++stats::cexAboveCsdLimit;
       //klee_warning("Context Switch Degree of conflicting extension above limit.");
       cfg.unfolding()->remove_event(*cex);
@@ -3693,49 +3878,72 @@ void Executor::exploreSchedules(ExecutionState &state, bool maximalConfiguration
   }
 
   if (maximalConfiguration && !state.porNode->has_children()) {
+    por::node *root = nullptr;
+    if (PruneUnfolding && ++maximalConfigurationsSincePruning >= PruneUnfolding) {
+      maximalConfigurationsSincePruning = 0;
+      root = state.porNode;
+      while (root->parent())
+        root = root->parent();
+    }
+
     state.porNode->backtrack();
+
+    if (root)
+      pruneUnfolding(*root);
   }
 }
 
-void Executor::updateStatesJSON(KInstruction *ki, const ExecutionState &state,
-                                std::string ktest, std::string error) {
-  if (statesJSONFile) {
-    auto time = std::chrono::steady_clock::now() - executorStartTime;
-    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time);
-    auto milliseconds =
-      std::chrono::duration_cast<std::chrono::milliseconds>(time) - seconds;
+void Executor::pruneUnfolding(const por::node &root) {
+  std::vector<const por::event::event *> live = root.live_events();
 
-    static size_t lastStateId = 0;
+  auto fingerprintEvents = porEventManager.fingerprintEvents();
+  live.insert(live.end(), fingerprintEvents.begin(), fingerprintEvents.end());
 
-    if (lastStateId != state.id
-        || !ktest.empty()
-        || !error.empty()
-    ) {
-      (*statesJSONFile) << ",\n  {\n";
-      (*statesJSONFile) << "    \"state_id\": " << state.id << ",\n";
-      if (!ktest.empty()) {
-        (*statesJSONFile) << "    \"ktest\": \"" << ktest << "\",\n";
-      }
-      if (!error.empty()) {
-        (*statesJSONFile) << "    \"error\": \"" << error << "\",\n";
-      }
-      (*statesJSONFile) << "    \"heap\": " << util::GetTotalMallocUsage()
-                        << ",\n";
-      (*statesJSONFile) << "    \"timestamp\": " << seconds.count()
-                        << "." << milliseconds.count() << ",\n";
-      if (ki != nullptr) {
-        (*statesJSONFile) << "    \"instructions\": " << stats::instructions
-                          << ",\n";
-        (*statesJSONFile) << "    \"instruction_id\": " << ki->info->id << "\n";
-      } else {
-        (*statesJSONFile) << "    \"instructions\": " << stats::instructions
-                          << "\n";
-      }
-      (*statesJSONFile) << "  }";
+  // states added in this step (e.g. the leaves of the alternatives) are not
+  // yet contained in states, but their catch-up events must be kept as well
+  for (const ExecutionState *es : states)
+    live.insert(live.end(), es->catchUp.begin(), es->catchUp.end());
+  for (const ExecutionState *es : addedStates)
+    live.insert(live.end(), es->catchUp.begin(), es->catchUp.end());
 
-      lastStateId = state.id;
-    }
-  }
+  root.configuration().unfolding()->prune(live);
+}
+
+void Executor::updateStateTrace(KInstruction *ki, const ExecutionState &state,
+                                llvm::StringRef ktest, llvm::StringRef error) {
+  if (!stateTraceFile)
+    return;
+
+  if (stateTraceLastStateId == state.id && ktest.empty() && error.empty())
+    return;
+
+  auto time = std::chrono::steady_clock::now() - executorStartTime;
+
+  // GetTotalMallocUsage() is too expensive to call for every record, so the
+  // heap usage is only sampled every 0x10000 instructions (cf. checkMemoryUsage)
+  if (stats::instructions >= stateTraceNextHeapSample) {
+    stateTraceHeap = util::GetTotalMallocUsage();
+    stateTraceNextHeapSample = stats::instructions + 0x10000;
+  }
+
+  StateTraceRecord record;
+  record.stateId = state.id;
+  record.heap = stateTraceHeap;
+  record.timestamp =
+      std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+  record.instructions = stats::instructions;
+  record.instructionId = ki ? ki->info->id : StateTraceNoInstruction;
+  record.ktestLength = static_cast<std::uint16_t>(
+      std::min<std::size_t>(ktest.size(), UINT16_MAX));
+  record.errorLength = static_cast<std::uint16_t>(
+      std::min<std::size_t>(error.size(), UINT16_MAX));
+
+  stateTraceFile->write(reinterpret_cast<const char *>(&record),
+                        sizeof(record));
+  stateTraceFile->write(ktest.data(), record.ktestLength);
+  stateTraceFile->write(error.data(), record.errorLength);
+
+  stateTraceLastStateId = state.id;
 }
 
 void Executor::updateForkJSON(const ExecutionState &current,
@@ -3864,7 +4072,7 @@ void Executor::terminateStateEarly(ExecutionState &state,
     ktest = interpreterHandler->processTestCase(state,
                                                 (message + "\n").str().c_str(),
                                                 "early");
-  updateStatesJSON(nullptr, state, ktest, "early");
+  updateStateTrace(nullptr, state, ktest, "early");
   terminateState(state);
 }
 
@@ -3874,7 +4082,7 @@ void Executor::terminateStateOnExit(ExecutionState &state) {
       (AlwaysOutputSeeds && seedMap.count(&state)))
     ktest = interpreterHandler->processTestCase(state, 0, 0);
 
-  updateStatesJSON(nullptr, state, ktest);
+  updateStateTrace(nullptr, state, ktest);
   ++stats::maxConfigurations;
   terminateState(state);
 }
@@ -4000,7 +4208,7 @@ void Executor::terminateStateOnError(ExecutionState &state,
                                                 suffix);
   }
 
-  updateStatesJSON(nullptr, state, ktest, TerminateReasonNames[termReason]);
+  updateStateTrace(nullptr, state, ktest, TerminateReasonNames[termReason]);
   terminateState(state);
 
   ++stats::maxConfigurations;
@@ -4465,6 +4673,7 @@ void Executor::resolveExact(ExecutionState &state,
                             ref<Expr> p,
                             ExactResolutionList &results, 
                             const std::string &name) {
+  TimingSolver::OriginScope origin(*solver, QueryOrigin::Resolution);
   p = optimizer.optimizeExpr(p, true);
   // XXX we may want to be capping this?
   ResolutionList rl;
@@ -4589,7 +4798,8 @@ Executor::extractMemoryObject(ExecutionState &state, ref<Expr> address, Expr::Wi
 void Executor::executeMemoryWrite(ExecutionState& state,
                                   const MemoryLocation& memLoc,
                                   ref<Expr> address,
-                                  ref<Expr> value) {
+                                  ref<Expr> value,
+                                  bool isAtomic) {
   auto bytes = Expr::getMinBytesForWidth(value->getWidth());
 
   if (SimplifySymIndices && !isa<ConstantExpr>(value)) {
@@ -4606,7 +4816,13 @@ void Executor::executeMemoryWrite(ExecutionState& state,
     return;
   }
 
-  processMemoryAccess(state, mo, offset, bytes, AccessType::WRITE);
+  // Atomic accesses are exempt from data race detection: the access happens
+  // after its atomic_read/atomic_write event and nothing orders it against
+  // the atomic accesses of other threads.
+  // NOTE: this also hides races between atomic and non-atomic accesses
+  if (!isAtomic) {
+    processMemoryAccess(state, mo, offset, bytes, AccessType::WRITE);
+  }
 
   auto* wos = state.addressSpace.getWriteable(mo, os);
 
@@ -4624,7 +4840,8 @@ void Executor::executeMemoryWrite(ExecutionState& state,
 
 ref<Expr> Executor::executeMemoryRead(ExecutionState& state,
                                  const MemoryLocation& memLoc,
-                                 Expr::Width bitWidth) {
+                                 Expr::Width bitWidth,
+                                 bool isAtomic) {
   auto bytes = Expr::getMinBytesForWidth(bitWidth);
 
   auto mo = memLoc.first;
@@ -4634,7 +4851,9 @@ ref<Expr> Executor::executeMemoryRead(ExecutionState& state,
   assert(os != nullptr);
 
   ref<Expr> result = os->read(offset, bitWidth);
-  processMemoryAccess(state, mo, offset, bytes, AccessType::READ);
+  if (!isAtomic) {
+    processMemoryAccess(state, mo, offset, bytes, AccessType::READ);
+  }
 
   return result;
 }
@@ -4645,15 +4864,19 @@ void Executor::executeMemoryOperation(ExecutionState &state,
                                       ref<Expr> value /* undef if read */,
                                       KInstruction *target /* undef if write */,
                                       bool isAtomic) {
-
   Expr::Width width = 0;
   if (isWrite) {
     width = value->getWidth();
   } else {
-    width = getWidthForLLVMType(target->inst->getType());
+    width = target->width;
   }
 
-  auto memRegion = extractMemoryObject(state, address, width);
+  std::optional<MemoryLocation> memRegion;
+  {
+    // the access itself is checked for data races, which is a separate origin
+    TimingSolver::OriginScope origin(*solver, QueryOrigin::Resolution);
+    memRegion = extractMemoryObject(state, address, width);
+  }
   if (!memRegion.has_value()) {
     return;
   }
@@ -4666,25 +4889,22 @@ void Executor::executeMemoryOperation(ExecutionState &state,
   }
 
   if (isAtomic) {
-    if (!porEventManager.registerLockAcquire(state, memRegion->first->getId(), false)) {
+    // NOTE: no standby state, as the memory access has not been performed yet
+    auto aId = memRegion->first->getId();
+    bool success = isWrite ? porEventManager.registerAtomicWrite(state, aId, false)
+                           : porEventManager.registerAtomicRead(state, aId, false);
+    if (!success) {
       terminateStateSilently(state);
       return;
     }
   }
 
   if (isWrite) {
-    executeMemoryWrite(state, memRegion.value(), address, value);
+    executeMemoryWrite(state, memRegion.value(), address, value, isAtomic);
   } else {
-    auto res = executeMemoryRead(state, memRegion.value(), width);
+    auto res = executeMemoryRead(state, memRegion.value(), width, isAtomic);
     bindLocal(target, state, res);
   }
-
-  if (isAtomic) {
-    if (!porEventManager.registerLockRelease(state, memRegion->first->getId(), true, true)) {
-      terminateStateSilently(state);
-      return;
-    }
-  }
 }
 
 void Executor::executeMakeSymbolic(ExecutionState &state,
@@ -4815,6 +5035,7 @@ void Executor::runFunctionAsMain(Function *f,
   auto *state = new ExecutionState(kmodule->functionMap[f]);
 
   // By default the state creates and executes the main thread
+  state->thread().segmentLease = memory->acquireThreadSegments(state->tid());
   state->thread().threadHeapAlloc = memory->createThreadHeapAllocator(state->tid());
   state->thread().threadStackAlloc = memory->createThreadStackAllocator(state->tid());
 
@@ -4919,12 +5140,13 @@ void Executor::runFunctionAsMain(Function *f,
   auto rootNode = std::make_unique<por::node>();
   state->porNode = rootNode.get();
 
+  unfolding = rootNode->configuration().unfolding();
+  unfolding->set_measure_time(StatsTracker::useStatistics() || DebugPrintPorStats);
+
   // register thread_init event for main thread at last possible moment
   // to ensure that all data structures are properly set up
   porEventManager.registerThreadInit(*state, state->tid());
 
-  auto unfolding = rootNode->configuration().unfolding();
-
   run(*state);
   processTree = nullptr;
 
@@ -4961,6 +5183,8 @@ void Executor::runFunctionAsMain(Function *f,
     llvm::outs() << "KLEE: done: states = " << states.size() << "\n";
     llvm::outs().flush();
   }
+
+  unfolding.reset();
 }
 
 unsigned Executor::getPathStreamID(const ExecutionState &state) {
@@ -5012,6 +5236,7 @@ bool Executor::getSymbolicSolution(const ExecutionState &state,
                                    std::pair<std::string,
                                    std::vector<unsigned char> > >
                                    &res) {
+  TimingSolver::OriginScope origin(*solver, QueryOrigin::TestGeneration);
   solver->setTimeout(coreSolverTimeout);
 
   ExecutionState tmp(state);
@@ -5190,6 +5415,7 @@ bool Executor::createThread(ExecutionState &state,
   threadStartFrame->locals[startRoutine->getArgRegister(0)].value = runtimeStructPtr;
 
   // If we create a thread, then we also have to create the memory region and the TLS objects
+  thread.segmentLease = memory->acquireThreadSegments(thread.getThreadId());
   thread.threadHeapAlloc = memory->createThreadHeapAllocator(thread.getThreadId());
   thread.threadStackAlloc = memory->createThreadStackAllocator(thread.getThreadId());
 
@@ -5559,6 +5785,54 @@ std::optional<ThreadId> Executor::selectThreadForScheduling(ExecutionState &stat
               exEvent = std::move(C.broadcast_threads(d->tid(), d->cid(), std::move(notified)).event);
               break;
             }
+            case por::event::event_kind::atomic_read: {
+              exEvent = std::move(C.atomic_read(d->tid(), d->aid()).event);
+              break;
+            }
+            case por::event::event_kind::atomic_write: {
+              exEvent = std::move(C.atomic_write(d->tid(), d->aid()).event);
+              break;
+            }
+            case por::event::event_kind::rwlock_rdacquire: {
+              if (!C.can_rdacquire_rwlock(d->rwid())) {
+                continue; // go to next event
+              }
+              auto operation = static_cast<const por::event::rwlock_rdacquire*>(d)->operation();
+              exEvent = std::move(C.rdacquire_rwlock(d->tid(), d->rwid(), operation).event);
+              break;
+            }
+            case por::event::event_kind::rwlock_wracquire: {
+              if (!C.can_wracquire_rwlock(d->rwid())) {
+                continue; // go to next event
+              }
+              auto operation = static_cast<const por::event::rwlock_wracquire*>(d)->operation();
+              exEvent = std::move(C.wracquire_rwlock(d->tid(), d->rwid(), operation).event);
+              break;
+            }
+            case por::event::event_kind::rwlock_busy: {
+              bool write = static_cast<const por::event::rwlock_busy*>(d)->is_write_attempt();
+              if (write ? C.can_wracquire_rwlock(d->rwid()) : C.can_rdacquire_rwlock(d->rwid())) {
+                continue; // go to next event
+              }
+              exEvent = std::move(C.busy_rwlock(d->tid(), d->rwid(), write).event);
+              break;
+            }
+            case por::event::event_kind::rwlock_release: {
+              exEvent = std::move(C.release_rwlock(d->tid(), d->rwid()).event);
+              break;
+            }
+            case por::event::event_kind::semaphore_post: {
+              exEvent = std::move(C.post_semaphore(d->tid(), d->sid()).event);
+              break;
+            }
+            case por::event::event_kind::semaphore_wait: {
+              auto operation = static_cast<const por::event::semaphore_wait*>(d)->operation();
+              if (operation == por::event::semaphore_operation::wait && !C.can_wait_semaphore(d->sid())) {
+                continue; // go to next event
+              }
+              exEvent = std::move(C.wait_semaphore(d->tid(), d->sid(), operation).event);
+              break;
+            }
             default: {
               assert(0 && "unhandled event kind");
             }
@@ -5653,6 +5927,24 @@ bool Executor::scheduleNextThread(ExecutionState &state, const ThreadId &tid) {
         succ = porEventManager.registerCondVarWait2(state, w.cond, w.lock);
       } else if constexpr (std::is_same_v<T, Thread::wait_join_t>) {
         succ = porEventManager.registerThreadJoin(state, w.thread);
+      } else if constexpr (std::is_same_v<T, Thread::wait_rdlock_t>) {
+        succ = porEventManager.registerRwLockRdAcquire(state, w.lock);
+      } else if constexpr (std::is_same_v<T, Thread::wait_wrlock_t>) {
+        succ = porEventManager.registerRwLockWrAcquire(state, w.lock);
+      } else if constexpr (std::is_same_v<T, Thread::wait_semaphore_t>) {
+        succ = porEventManager.registerSemaphoreWait(state, w.semaphore, por::event::semaphore_operation::wait);
+      } else if constexpr (std::is_same_v<T, Thread::wait_barrier_t>) {
+        std::vector<const por::event::event *> arrivals = w.arrivals;
+        if (arrivals.empty()) {
+          // during catch-up, the thread that completed this round may not have arrived at the barrier yet
+          assert(state.needsCatchUp() && state.peekCatchUp()->kind() == por::event::event_kind::barrier_wait);
+          auto barrier = static_cast<const por::event::barrier_wait *>(state.peekCatchUp());
+          arrivals.push_back(barrier->thread_predecessor());
+          for (const auto &a : barrier->arrival_predecessors()) {
+            arrivals.push_back(a);
+          }
+        }
+        succ = porEventManager.registerBarrierWait(state, w.barrier, arrivals);
       } else {
         assert(0 && "thread cannot be woken up!");
       }
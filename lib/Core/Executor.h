@@ -17,6 +17,7 @@
 
 #include "klee/ExecutionState.h"
 #include "klee/Expr/ArrayCache.h"
+#include "klee/Internal/ADT/StateTrace.h"
 #include "klee/Internal/Module/Cell.h"
 #include "klee/Internal/Module/KInstruction.h"
 #include "klee/Internal/Module/KModule.h"
@@ -133,6 +134,10 @@ private:
   std::unique_ptr<PTree> processTree;
 
   PorEventManager porEventManager;
+  /// Unfolding of the current run, used for statistics
+  std::shared_ptr<por::unfolding> unfolding;
+  /// Number of maximal configurations since the unfolding was last pruned
+  unsigned maximalConfigurationsSincePruning = 0;
   /// Used to track states that have been added during the current
   /// instructions step. 
   /// \invariant \ref addedStates is a subset of \ref states. 
@@ -217,8 +222,19 @@ private:
   // measure time to error since start of Executor
   std::chrono::steady_clock::time_point executorStartTime;
 
-  /// JSON file to print state info to
-  std::unique_ptr<llvm::raw_ostream> statesJSONFile;
+  /// Binary trace of state info (see klee/Internal/ADT/StateTrace.h)
+  std::unique_ptr<llvm::raw_ostream> stateTraceFile;
+
+  /// Header of the state trace, written as soon as the module is set
+  StateTraceHeader stateTraceHeader;
+
+  /// State of the last record written to the state trace
+  std::uint64_t stateTraceLastStateId = 0;
+
+  /// Heap usage reported in state trace records and the instruction count at
+  /// which it is sampled next
+  std::size_t stateTraceHeap = 0;
+  std::uint64_t stateTraceNextHeapSample = 0;
 
   /// JSON file to print state forking info to
   std::unique_ptr<llvm::raw_ostream> forkJSONFile;
@@ -231,16 +247,22 @@ private:
   
   void executeInstruction(ExecutionState &state, KInstruction *ki);
 
+  /// Executes integer arithmetic, comparisons and casts whose operands are
+  /// all concrete without going through the expression library. Returns
+  /// false if the instruction has to be executed by executeInstruction.
+  bool executeConcreteInstruction(ExecutionState &state, KInstruction *ki);
+
   void run(ExecutionState &initialState);
 
   void exploreSchedules(ExecutionState &state, bool maximalConfiguration = false);
+  void pruneUnfolding(const por::node &root);
 
   std::optional<ThreadId> selectThreadForScheduling(ExecutionState &state, std::set<ThreadId> &runnable);
 
   bool scheduleNextThread(ExecutionState &state, const ThreadId &tid);
 
-  void updateStatesJSON(KInstruction *ki, const ExecutionState &state,
-                        std::string ktest = "", std::string error = "");
+  void updateStateTrace(KInstruction *ki, const ExecutionState &state,
+                        llvm::StringRef ktest = "", llvm::StringRef error = "");
   void updateForkJSON(const ExecutionState &current,
                       const ExecutionState &trueState,
                       const ExecutionState &falseState);
@@ -259,6 +281,11 @@ private:
   void transferToBasicBlock(llvm::BasicBlock *dst, 
 			    llvm::BasicBlock *src,
 			    ExecutionState &state);
+  /// Same as above, but with dst given by the index of its first instruction,
+  /// as pre-decoded in KInstruction::targets.
+  void transferToBasicBlock(unsigned dstEntry,
+                            llvm::BasicBlock *src,
+                            ExecutionState &state);
 
   void callExternalFunction(ExecutionState &state,
                             KInstruction *target,
@@ -330,11 +357,13 @@ private:
   void executeMemoryWrite(ExecutionState& state,
                           const MemoryLocation& memLoc,
                           ref<Expr> address,
-                          ref<Expr> value);
+                          ref<Expr> value,
+                          bool isAtomic);
 
   ref<Expr> executeMemoryRead(ExecutionState& state,
                               const MemoryLocation& memLoc,
-                              Expr::Width bitWidth);
+                              Expr::Width bitWidth,
+                              bool isAtomic);
                    
   // do address resolution / object binding / out of bounds checking
   // and perform the operation
@@ -25,6 +25,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 
@@ -72,13 +73,33 @@ void MemoryObject::getAllocInfo(std::string &result) const {
 
 /***/
 
+ObjectStatePage::ObjectStatePage(unsigned size, uint8_t value)
+  : size(size),
+    concreteStore(new uint8_t[size]) {
+  memset(concreteStore.get(), value, size);
+}
+
+ObjectStatePage::ObjectStatePage(const ObjectStatePage &page)
+  : size(page.size),
+    concreteStore(new uint8_t[page.size]),
+    concreteMask(page.concreteMask ? new BitArray(*page.concreteMask, page.size) : nullptr),
+    flushMask(page.flushMask ? new BitArray(*page.flushMask, page.size) : nullptr) {
+  if (page.knownSymbolics) {
+    knownSymbolics.reset(new ref<Expr>[size]);
+    for (unsigned i=0; i<size; i++)
+      knownSymbolics[i] = page.knownSymbolics[i];
+  }
+
+  memcpy(concreteStore.get(), page.concreteStore.get(), size);
+}
+
+ObjectStatePage::~ObjectStatePage() = default;
+
+/***/
+
 ObjectState::ObjectState(const MemoryObject *mo)
   : copyOnWriteOwner(0),
     object(mo),
-    concreteStore(new uint8_t[mo->size]),
-    concreteMask(0),
-    flushMask(0),
-    knownSymbolics(0),
     updates(0, 0),
     size(mo->size),
     readOnly(false) {
@@ -88,50 +109,31 @@ ObjectState::ObjectState(const MemoryObject *mo)
         getArrayCache()->CreateArray("tmp_arr" + llvm::utostr(++id), size);
     updates = UpdateList(array, 0);
   }
-  memset(concreteStore, 0, size);
+  fill(0);
 }
 
 
 ObjectState::ObjectState(const MemoryObject *mo, const Array *array)
   : copyOnWriteOwner(0),
     object(mo),
-    concreteStore(new uint8_t[mo->size]),
-    concreteMask(0),
-    flushMask(0),
-    knownSymbolics(0),
     updates(array, 0),
     size(mo->size),
     readOnly(false) {
+  fill(0);
   makeSymbolic();
-  memset(concreteStore, 0, size);
 }
 
 ObjectState::ObjectState(const ObjectState &os) 
   : copyOnWriteOwner(0),
     object(os.object),
-    concreteStore(new uint8_t[os.size]),
-    concreteMask(os.concreteMask ? new BitArray(*os.concreteMask, os.size) : 0),
-    flushMask(os.flushMask ? new BitArray(*os.flushMask, os.size) : 0),
-    knownSymbolics(0),
+    pages(os.pages),
     updates(os.updates),
     size(os.size),
     readOnly(false) {
   assert(!os.readOnly && "no need to copy read only object?");
-  if (os.knownSymbolics) {
-    knownSymbolics = new ref<Expr>[size];
-    for (unsigned i=0; i<size; i++)
-      knownSymbolics[i] = os.knownSymbolics[i];
-  }
-
-  memcpy(concreteStore, os.concreteStore, size*sizeof(*concreteStore));
 }
 
-ObjectState::~ObjectState() {
-  delete concreteMask;
-  delete flushMask;
-  delete[] knownSymbolics;
-  delete[] concreteStore;
-}
+ObjectState::~ObjectState() = default;
 
 ArrayCache *ObjectState::getArrayCache() const {
   assert(!object.isNull() && "object was NULL");
@@ -201,18 +203,58 @@ void ObjectState::flushToConcreteStore(TimingSolver *solver,
                      "byte %p+%u will have random value",
                      (void *)object->address, i);
       else
-        ce->toMemory(concreteStore + i);
+        ce->toMemory(getWriteablePage(i).concreteStore.get() + pageOffset(i));
     }
   }
 }
 
-void ObjectState::makeConcrete() {
-  delete concreteMask;
-  delete flushMask;
-  delete[] knownSymbolics;
-  concreteMask = 0;
-  flushMask = 0;
-  knownSymbolics = 0;
+void ObjectState::copyConcreteStoreTo(uint8_t *dst) const {
+  for (unsigned i = 0; i < pages.size(); i++) {
+    memcpy(dst + (i << pageBits), pages[i]->concreteStore.get(), pages[i]->size);
+  }
+}
+
+bool ObjectState::concreteStoreEquals(const uint8_t *src) const {
+  for (unsigned i = 0; i < pages.size(); i++) {
+    if (memcmp(src + (i << pageBits), pages[i]->concreteStore.get(), pages[i]->size) != 0)
+      return false;
+  }
+  return true;
+}
+
+void ObjectState::copyConcreteStoreFrom(const uint8_t *src) {
+  for (unsigned i = 0; i < pages.size(); i++) {
+    unsigned base = i << pageBits;
+    if (memcmp(src + base, pages[i]->concreteStore.get(), pages[i]->size) != 0) {
+      ObjectStatePage &page = getWriteablePage(base);
+      memcpy(page.concreteStore.get(), src + base, page.size);
+    }
+  }
+}
+
+ObjectStatePage &ObjectState::getWriteablePage(unsigned offset) const {
+  ref<ObjectStatePage> &page = pages[offset >> pageBits];
+  if (page->isShared())
+    page = new ObjectStatePage(*page);
+  return *page;
+}
+
+void ObjectState::fill(uint8_t value) {
+  pages.clear();
+  pages.reserve((size + pageSize - 1) / pageSize);
+
+  // all full pages can share the same contents until they are written to
+  ref<ObjectStatePage> fullPage;
+  for (unsigned base = 0; base < size; base += pageSize) {
+    unsigned pageLength = std::min(pageSize, size - base);
+    if (pageLength == pageSize) {
+      if (fullPage.isNull())
+        fullPage = new ObjectStatePage(pageSize, value);
+      pages.push_back(fullPage);
+    } else {
+      pages.push_back(new ObjectStatePage(pageLength, value));
+    }
+  }
 }
 
 void ObjectState::makeSymbolic() {
@@ -228,16 +270,12 @@ void ObjectState::makeSymbolic() {
 }
 
 void ObjectState::initializeToZero() {
-  makeConcrete();
-  memset(concreteStore, 0, size);
+  fill(0);
 }
 
 void ObjectState::initializeToRandom() {  
-  makeConcrete();
-  for (unsigned i=0; i<size; i++) {
-    // randomly selected by 256 sided die
-    concreteStore[i] = 0xAB;
-  }
+  // randomly selected by 256 sided die
+  fill(0xAB);
 }
 
 /*
@@ -257,42 +295,40 @@ void ObjectState::fastRangeCheckOffset(ref<Expr> offset,
 
 void ObjectState::flushRangeForRead(unsigned rangeBase, 
                                     unsigned rangeSize) const {
-  if (!flushMask) flushMask = new BitArray(size, true);
- 
   for (unsigned offset=rangeBase; offset<rangeBase+rangeSize; offset++) {
     if (!isByteFlushed(offset)) {
+      const ObjectStatePage &page = getPage(offset);
       if (isByteConcrete(offset)) {
         updates.extend(ConstantExpr::create(offset, Expr::Int32),
-                       ConstantExpr::create(concreteStore[offset], Expr::Int8));
+                       ConstantExpr::create(page.concreteStore[pageOffset(offset)], Expr::Int8));
       } else {
         assert(isByteKnownSymbolic(offset) && "invalid bit set in flushMask");
         updates.extend(ConstantExpr::create(offset, Expr::Int32),
-                       knownSymbolics[offset]);
+                       page.knownSymbolics[pageOffset(offset)]);
       }
 
-      flushMask->unset(offset);
+      markByteFlushed(offset);
     }
   } 
 }
 
 void ObjectState::flushRangeForWrite(unsigned rangeBase, 
                                      unsigned rangeSize) {
-  if (!flushMask) flushMask = new BitArray(size, true);
-
   for (unsigned offset=rangeBase; offset<rangeBase+rangeSize; offset++) {
     if (!isByteFlushed(offset)) {
+      const ObjectStatePage &page = getPage(offset);
       if (isByteConcrete(offset)) {
         updates.extend(ConstantExpr::create(offset, Expr::Int32),
-                       ConstantExpr::create(concreteStore[offset], Expr::Int8));
+                       ConstantExpr::create(page.concreteStore[pageOffset(offset)], Expr::Int8));
         markByteSymbolic(offset);
       } else {
         assert(isByteKnownSymbolic(offset) && "invalid bit set in flushMask");
         updates.extend(ConstantExpr::create(offset, Expr::Int32),
-                       knownSymbolics[offset]);
+                       page.knownSymbolics[pageOffset(offset)]);
         setKnownSymbolic(offset, 0);
       }
 
-      flushMask->unset(offset);
+      markByteFlushed(offset);
     } else {
       // flushed bytes that are written over still need
       // to be marked out
@@ -306,49 +342,53 @@ void ObjectState::flushRangeForWrite(unsigned rangeBase,
 }
 
 bool ObjectState::isByteConcrete(unsigned offset) const {
-  return !concreteMask || concreteMask->get(offset);
+  const ObjectStatePage &page = getPage(offset);
+  return !page.concreteMask || page.concreteMask->get(pageOffset(offset));
 }
 
 bool ObjectState::isByteFlushed(unsigned offset) const {
-  return flushMask && !flushMask->get(offset);
+  const ObjectStatePage &page = getPage(offset);
+  return page.flushMask && !page.flushMask->get(pageOffset(offset));
 }
 
 bool ObjectState::isByteKnownSymbolic(unsigned offset) const {
-  return knownSymbolics && knownSymbolics[offset].get();
+  const ObjectStatePage &page = getPage(offset);
+  return page.knownSymbolics && page.knownSymbolics[pageOffset(offset)].get();
 }
 
 void ObjectState::markByteConcrete(unsigned offset) {
-  if (concreteMask)
-    concreteMask->set(offset);
+  if (!isByteConcrete(offset))
+    getWriteablePage(offset).concreteMask->set(pageOffset(offset));
 }
 
 void ObjectState::markByteSymbolic(unsigned offset) {
-  if (!concreteMask)
-    concreteMask = new BitArray(size, true);
-  concreteMask->unset(offset);
+  ObjectStatePage &page = getWriteablePage(offset);
+  if (!page.concreteMask)
+    page.concreteMask.reset(new BitArray(page.size, true));
+  page.concreteMask->unset(pageOffset(offset));
 }
 
 void ObjectState::markByteUnflushed(unsigned offset) {
-  if (flushMask)
-    flushMask->set(offset);
+  if (isByteFlushed(offset))
+    getWriteablePage(offset).flushMask->set(pageOffset(offset));
 }
 
-void ObjectState::markByteFlushed(unsigned offset) {
-  if (!flushMask) {
-    flushMask = new BitArray(size, false);
-  } else {
-    flushMask->unset(offset);
-  }
+void ObjectState::markByteFlushed(unsigned offset) const {
+  ObjectStatePage &page = getWriteablePage(offset);
+  if (!page.flushMask)
+    page.flushMask.reset(new BitArray(page.size, true));
+  page.flushMask->unset(pageOffset(offset));
 }
 
 void ObjectState::setKnownSymbolic(unsigned offset, 
                                    Expr *value /* can be null */) {
-  if (knownSymbolics) {
-    knownSymbolics[offset] = value;
+  if (getPage(offset).knownSymbolics) {
+    getWriteablePage(offset).knownSymbolics[pageOffset(offset)] = value;
   } else {
     if (value) {
-      knownSymbolics = new ref<Expr>[size];
-      knownSymbolics[offset] = value;
+      ObjectStatePage &page = getWriteablePage(offset);
+      page.knownSymbolics.reset(new ref<Expr>[page.size]);
+      page.knownSymbolics[pageOffset(offset)] = value;
     }
   }
 }
@@ -357,9 +397,9 @@ void ObjectState::setKnownSymbolic(unsigned offset,
 
 ref<Expr> ObjectState::read8(unsigned offset) const {
   if (isByteConcrete(offset)) {
-    return ConstantExpr::create(concreteStore[offset], Expr::Int8);
+    return ConstantExpr::create(getPage(offset).concreteStore[pageOffset(offset)], Expr::Int8);
   } else if (isByteKnownSymbolic(offset)) {
-    return knownSymbolics[offset];
+    return getPage(offset).knownSymbolics[pageOffset(offset)];
   } else {
     assert(isByteFlushed(offset) && "unflushed byte without cache value");
     
@@ -387,7 +427,7 @@ ref<Expr> ObjectState::read8(ref<Expr> offset) const {
 
 void ObjectState::write8(unsigned offset, uint8_t value) {
   //assert(read_only == false && "writing to read-only object!");
-  concreteStore[offset] = value;
+  getWriteablePage(offset).concreteStore[pageOffset(offset)] = value;
   setKnownSymbolic(offset, 0);
 
   markByteConcrete(offset);
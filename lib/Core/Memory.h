@@ -16,9 +16,11 @@
 #include "klee/Expr/Expr.h"
 #include "klee/ThreadId.h"
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringExtras.h"
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -190,11 +192,45 @@ public:
   }
 };
 
+/// A page of the contents of an ObjectState. Pages are shared between copies
+/// of an ObjectState until one of them writes to the page. The side tables
+/// are only allocated once a byte of the page becomes symbolic or flushed.
+class ObjectStatePage {
+  friend class ref<ObjectStatePage>;
+
+  /// @brief Required by klee::ref-managed objects
+  class ReferenceCounter _refCount;
+
+public:
+  unsigned size;
+
+  std::unique_ptr<uint8_t[]> concreteStore;
+
+  // XXX cleanup name of flushMask (its backwards or something)
+  /// null iff all bytes are concrete
+  std::unique_ptr<BitArray> concreteMask;
+
+  /// null iff no byte is flushed
+  std::unique_ptr<BitArray> flushMask;
+
+  /// null iff no byte is known symbolic
+  std::unique_ptr<ref<Expr>[]> knownSymbolics;
+
+  ObjectStatePage(unsigned size, uint8_t value);
+  ObjectStatePage(const ObjectStatePage &page);
+  ~ObjectStatePage();
+
+  bool isShared() { return _refCount.getCount() > 1; }
+};
+
 class ObjectState {
 private:
   friend class AddressSpace;
   friend class ref<ObjectState>;
 
+  static constexpr unsigned pageBits = 12;
+  static constexpr unsigned pageSize = 1u << pageBits;
+
   unsigned copyOnWriteOwner; // exclusively for AddressSpace
 
   /// @brief Required by klee::ref-managed objects
@@ -202,15 +238,8 @@ private:
 
   ref<const MemoryObject> object;
 
-  uint8_t *concreteStore;
-
-  // XXX cleanup name of flushMask (its backwards or something)
-  BitArray *concreteMask;
-
-  // mutable because may need flushed during read of const
-  mutable BitArray *flushMask;
-
-  ref<Expr> *knownSymbolics;
+  // mutable because pages may need to be flushed during read of const
+  mutable llvm::SmallVector<ref<ObjectStatePage>, 1> pages;
 
   // mutable because we may need flush during read of const
   mutable UpdateList updates;
@@ -263,10 +292,37 @@ public:
   void flushToConcreteStore(TimingSolver *solver,
                             const ExecutionState &state) const;
 
+  /// Copy the concrete store (the cached concrete values) to \a dst.
+  void copyConcreteStoreTo(uint8_t *dst) const;
+
+  /// Compare the concrete store with the object-sized buffer at \a src.
+  bool concreteStoreEquals(const uint8_t *src) const;
+
+  /// Overwrite the concrete store with \a src, only unsharing the pages
+  /// that actually change.
+  void copyConcreteStoreFrom(const uint8_t *src);
+
+  /// Whether the page containing \a offset is shared with \a os.
+  bool sharesPageWith(const ObjectState &os, unsigned offset) const {
+    return pages[offset >> pageBits].get() == os.pages[offset >> pageBits].get();
+  }
+
 private:
   const UpdateList &getUpdates() const;
 
-  void makeConcrete();
+  /// Fill the whole object with \a value, sharing the pages among each other.
+  void fill(uint8_t value);
+
+  const ObjectStatePage &getPage(unsigned offset) const {
+    return *pages[offset >> pageBits];
+  }
+
+  /// Returns the page containing \a offset, copying it first if it is shared.
+  ObjectStatePage &getWriteablePage(unsigned offset) const;
+
+  static unsigned pageOffset(unsigned offset) {
+    return offset & (pageSize - 1);
+  }
 
   void makeSymbolic();
 
@@ -285,7 +341,7 @@ private:
 
   void markByteConcrete(unsigned offset);
   void markByteSymbolic(unsigned offset);
-  void markByteFlushed(unsigned offset);
+  void markByteFlushed(unsigned offset) const;
   void markByteUnflushed(unsigned offset);
   void setKnownSymbolic(unsigned offset, Expr *value);
 
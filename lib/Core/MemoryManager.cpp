@@ -67,9 +67,16 @@ llvm::cl::opt<std::string> ThreadSegmentsFile(
 
 llvm::cl::opt<std::uint32_t> QuarantineSize(
       "allocate-quarantine",
-      llvm::cl::desc("Size of quarantine queues in allocator (default=8, also see -allocate-quarantine-unlimited)"),
+      llvm::cl::desc("Size of quarantine queues in heap and stack allocators (default=8, also see -allocate-quarantine-unlimited)"),
       llvm::cl::init(8), llvm::cl::cat(MemoryCat));
 
+llvm::cl::opt<bool> RecycleThreadSegments(
+      "allocate-recycle-thread-segments",
+      llvm::cl::desc("Give the memory segments of thread ids that no longer exist in any state to new thread ids. "
+                     "A thread id that is recreated afterwards (e.g. during catch-up) may then be placed at different "
+                     "addresses than before (default=off)"),
+      llvm::cl::init(false), llvm::cl::cat(MemoryCat));
+
 llvm::cl::opt<bool> UnlimitedQuarantine(
       "allocate-quarantine-unlimited",
       llvm::cl::desc("Never reuse free'd addresses. (default=off)"),
@@ -80,7 +87,7 @@ std::uint32_t MemoryManager::quarantine;
 
 /***/
 MemoryManager::MemoryManager(ArrayCache *_arrayCache)
-    : arrayCache(_arrayCache) {
+    : arrayCache(_arrayCache), leaseOwner(std::make_shared<MemoryManager *>(this)) {
 
   auto pageSize = sysconf(_SC_PAGE_SIZE);
 
@@ -123,6 +130,15 @@ MemoryManager::MemoryManager(ArrayCache *_arrayCache)
 }
 
 MemoryManager::~MemoryManager() {
+  // leases that outlive the manager must not call back into it
+  leaseOwner.reset();
+
+  if (threadSegmentStats.created > 0) {
+    klee_message("Thread memory segments: %zu created, %zu reused, %zu released, at most %zu in use",
+                 threadSegmentStats.created, threadSegmentStats.reused, threadSegmentStats.released,
+                 threadSegmentStats.maxLeased);
+  }
+
   globalObjectsMap.clear();
   while (!objects.empty()) {
     MemoryObject *mo = *objects.begin();
@@ -321,16 +337,28 @@ pseudoalloc::mapping_t MemoryManager::createMapping(std::size_t size, std::uintp
 void MemoryManager::initThreadMemoryMapping(const ThreadId& tid, std::uintptr_t reqHeap, std::uintptr_t reqStack) {
   assert(threadMemoryMappings.find(tid) == threadMemoryMappings.end() && "Do not reinit a threads memory mapping");
 
-  ThreadMemorySegments segment{
-    .heap = createMapping(threadHeapSize, reqHeap),
-    .stack = createMapping(threadStackSize, reqStack)
-  };
+  bool requested = reqHeap != 0 || reqStack != 0;
+  bool reused = !requested && !threadSegmentPool.empty();
+
+  ThreadMemorySegments segment;
+  if (reused) {
+    // the pool is used in LIFO order, which keeps the placement deterministic for a given exploration
+    segment = std::move(threadSegmentPool.back());
+    threadSegmentPool.pop_back();
+    ++threadSegmentStats.reused;
+  } else {
+    segment.heap = createMapping(threadHeapSize, reqHeap);
+    segment.stack = createMapping(threadStackSize, reqStack);
+    segment.requested = requested;
+    ++threadSegmentStats.created;
+  }
 
   auto [it, res] = threadMemoryMappings.emplace(tid, std::move(segment));
   assert(res && "Mapping should always be able to be registered");
 
   klee_message(
-    "Created thread memory mapping for thread %s at heap=%p stack=%p",
+    "%s thread memory mapping for thread %s at heap=%p stack=%p",
+    reused ? "Reused" : "Created",
     tid.to_string().c_str(),
     it->second.heap.begin(),
     it->second.stack.begin()
@@ -517,11 +545,54 @@ std::unique_ptr<pseudoalloc::stack_allocator_t> MemoryManager::createThreadStack
   return std::make_unique<pseudoalloc::stack_allocator_t>(seg.stack, quarantine);
 }
 
+std::shared_ptr<ThreadSegmentLease> MemoryManager::acquireThreadSegments(const ThreadId &tid) {
+  auto& lease = threadSegmentLeases[tid];
+  if (auto existing = lease.lock()) {
+    return existing;
+  }
+
+  getThreadSegments(tid);
+
+  auto result = std::make_shared<ThreadSegmentLease>(leaseOwner, tid);
+  lease = result;
+  threadSegmentStats.maxLeased = std::max(threadSegmentStats.maxLeased, threadSegmentLeases.size());
+  return result;
+}
+
+void MemoryManager::releaseThreadSegments(const ThreadId& tid) {
+  threadSegmentLeases.erase(tid);
+
+  auto it = threadMemoryMappings.find(tid);
+  if (it == threadMemoryMappings.end()) {
+    return;
+  }
+
+  it->second.heap.clear();
+  it->second.stack.clear();
+  ++threadSegmentStats.released;
+
+  if (RecycleThreadSegments && !it->second.requested) {
+    threadSegmentPool.emplace_back(std::move(it->second));
+    threadMemoryMappings.erase(it);
+  }
+}
+
+ThreadSegmentLease::~ThreadSegmentLease() {
+  if (auto manager = owner.lock()) {
+    (*manager)->releaseThreadSegments(tid);
+  }
+}
+
 void MemoryManager::markMemoryRegionsAsUnneeded() {
   for (auto& it : threadMemoryMappings) {
     it.second.heap.clear();
     it.second.stack.clear();
   }
 
+  for (auto& segment : threadSegmentPool) {
+    segment.heap.clear();
+    segment.stack.clear();
+  }
+
   globalMemorySegment.clear();
 }
@@ -18,8 +18,10 @@
 #include "pseudoalloc/pseudoalloc.h"
 
 #include <cstddef>
+#include <memory>
 #include <set>
 #include <map>
+#include <vector>
 
 namespace llvm {
 class Value;
@@ -28,14 +30,37 @@ class Value;
 namespace klee {
 class MemoryObject;
 class ArrayCache;
+class MemoryManager;
+
+/// Keeps the memory segments of a thread id from being released for as long
+/// as a thread with that id exists in any state (including standby states).
+class ThreadSegmentLease {
+  friend class MemoryManager;
+
+  std::weak_ptr<MemoryManager *> owner;
+  ThreadId tid;
+
+public:
+  ThreadSegmentLease(std::weak_ptr<MemoryManager *> owner, ThreadId tid)
+      : owner(std::move(owner)), tid(std::move(tid)) {}
+  ThreadSegmentLease(const ThreadSegmentLease &) = delete;
+  ThreadSegmentLease &operator=(const ThreadSegmentLease &) = delete;
+  ~ThreadSegmentLease();
+};
 
 class MemoryManager {
+  friend class ThreadSegmentLease;
+
 private:
   typedef std::set<MemoryObject *> objects_ty;
 
   struct ThreadMemorySegments {
     pseudoalloc::mapping_t heap;
     pseudoalloc::mapping_t stack;
+
+    /// Whether the placement was requested via -allocate-thread-segments-file,
+    /// in which case the segments are never given to another thread
+    bool requested = false;
   };
 
   objects_ty objects;
@@ -43,6 +68,22 @@ private:
 
   std::map<ThreadId, ThreadMemorySegments> threadMemoryMappings;
 
+  /// Leases of all thread ids for which a thread currently exists
+  std::map<ThreadId, std::weak_ptr<ThreadSegmentLease>> threadSegmentLeases;
+
+  /// Released segments that can be given to threads without a mapping
+  std::vector<ThreadMemorySegments> threadSegmentPool;
+
+  /// Referenced by the leases to detect that the manager is already gone
+  std::shared_ptr<MemoryManager *> leaseOwner;
+
+  struct {
+    std::size_t created = 0;
+    std::size_t reused = 0;
+    std::size_t released = 0;
+    std::size_t maxLeased = 0;
+  } threadSegmentStats;
+
   /// Map of globals to their bound address. This also includes
   /// globals that have no representative object (i.e. functions).
   GlobalObjectsMap globalObjectsMap;
@@ -75,6 +116,9 @@ private:
 
   ThreadMemorySegments& getThreadSegments(const ThreadId& tid);
 
+  /// Called once no thread with id `tid` exists in any state anymore
+  void releaseThreadSegments(const ThreadId& tid);
+
   MemoryObject *allocateGlobal(std::uint64_t size, const llvm::Value *allocSite,
                                const ThreadId& byTid, std::size_t alignment, bool readOnly);
 
@@ -121,6 +165,10 @@ public:
   std::unique_ptr<pseudoalloc::allocator_t> createThreadHeapAllocator(const ThreadId &tid);
   std::unique_ptr<pseudoalloc::stack_allocator_t> createThreadStackAllocator(const ThreadId &tid);
 
+  // Reserves the memory segments of `tid` for as long as the returned lease
+  // (which is shared by all threads with this id) is alive.
+  std::shared_ptr<ThreadSegmentLease> acquireThreadSegments(const ThreadId &tid);
+
   void markMemoryRegionsAsUnneeded();
 
   // Forwards to the Global Object Map
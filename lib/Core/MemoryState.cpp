@@ -328,6 +328,39 @@ void MemoryState::unregisterAcquiredLock(por::event::lock_id_t lock_id, const Th
   fingerprint.removeFromFingerprint();
 }
 
+void MemoryState::registerSemaphoreChange(por::event::semaphore_id_t semaphore_id,
+                                          const ThreadId &tid,
+                                          std::int64_t change) {
+  if (disableMemoryState) {
+    return;
+  }
+
+  if (DebugFingerprints) {
+    llvm::errs() << "MemoryState: registering change of semaphore (" << semaphore_id << ")"
+                 << " by " << change << " by thread " << tid << "\n";
+  }
+
+  assert(tid && semaphore_id > 0 && "Must be set");
+  assert(executionState->tid() == tid);
+
+  // The value of a semaphore is not part of the memory of the program, so each
+  // thread fingerprint contains the sum of its changes to the semaphore instead
+  auto &fingerprint = executionState->threadFingerprint();
+  auto &balance = semaphoreBalances[std::make_pair(semaphore_id, tid)];
+  if (balance != 0) {
+    fingerprint.updateSemaphoreBalanceFragment(semaphore_id, tid, balance);
+    fingerprint.removeFromFingerprint();
+  }
+
+  balance += change;
+  if (balance != 0) {
+    fingerprint.updateSemaphoreBalanceFragment(semaphore_id, tid, balance);
+    fingerprint.addToFingerprint();
+  } else {
+    semaphoreBalances.erase(std::make_pair(semaphore_id, tid));
+  }
+}
+
 void MemoryState::applyWriteFragment(ref<Expr> address, const MemoryObject &mo,
                                      const ObjectState &os, std::size_t bytes,
                                      bool remove) {
@@ -10,6 +10,8 @@
 #include "por/event/event.h"
 
 #include <cstdint>
+#include <map>
+#include <utility>
 #include <vector>
 
 namespace llvm {
@@ -51,6 +53,10 @@ class MemoryState {
     std::size_t bytes = 0;
   } memoryFunction;
 
+  /// @brief per semaphore and thread: number of posts minus number of consuming
+  /// operations (plus the initial value for the creating thread)
+  std::map<std::pair<por::event::semaphore_id_t, ThreadId>, std::int64_t> semaphoreBalances;
+
   static KModule *kmodule;
   static std::vector<llvm::Function *> outputFunctionsWhitelist;
   static std::vector<llvm::Function *> libraryFunctionsList;
@@ -121,13 +127,13 @@ public:
     return !disableMemoryState;
   }
 
-  std::size_t getFunctionListsLength() const {
+  static std::size_t getFunctionListsLength() {
     return MemoryState::outputFunctionsWhitelist.size()
         + MemoryState::libraryFunctionsList.size()
         + MemoryState::memoryFunctionsList.size();
   }
 
-  std::size_t getFunctionListsCapacity() const {
+  static std::size_t getFunctionListsCapacity() {
     return MemoryState::outputFunctionsWhitelist.capacity()
         + MemoryState::libraryFunctionsList.capacity()
         + MemoryState::memoryFunctionsList.capacity();
@@ -169,6 +175,8 @@ public:
 
   void registerAcquiredLock(por::event::lock_id_t lock_id, const ThreadId &tid);
   void unregisterAcquiredLock(por::event::lock_id_t lock_id, const ThreadId &tid);
+
+  void registerSemaphoreChange(por::event::semaphore_id_t semaphore_id, const ThreadId &tid, std::int64_t change);
 };
 }
 
@@ -0,0 +1,96 @@
+#include "AccessShadow.h"
+
+#include "por/cone.h"
+#include "por/event/event.h"
+
+#include <algorithm>
+
+using namespace klee;
+
+VectorClock::VectorClock(const por::event::event& head)
+  : tid(head.tid())
+  , cone(head.cone())
+{ }
+
+bool VectorClock::isOrderedBefore(const Epoch& epoch) const {
+  if (epoch.tid == tid) {
+    return true;
+  }
+
+  // The epoch ends with the thread successor of the event at `epoch.depth`,
+  // which is a causal predecessor iff the maximal predecessor on that thread is deeper.
+  auto it = cone.find(epoch.tid);
+  return it != cone.end() && it->second->depth() > epoch.depth;
+}
+
+void AccessShadow::pruneDataForMemoryObject(const MemoryObject* obj, const Epoch& epoch) {
+  auto it = objects.find(obj->address);
+  if (it == objects.end()) {
+    return;
+  }
+
+  auto& shadow = it->second;
+  auto isPrunable = [&epoch](const ShadowEpoch& e) {
+    return e.tid == epoch.tid && e.depth == epoch.depth && !e.subsumesOthers;
+  };
+  shadow.reads.erase(std::remove_if(shadow.reads.begin(), shadow.reads.end(), isPrunable), shadow.reads.end());
+  shadow.writes.erase(std::remove_if(shadow.writes.begin(), shadow.writes.end(), isPrunable), shadow.writes.end());
+
+  if (shadow.reads.empty() && shadow.writes.empty()) {
+    objects.erase(it);
+  }
+}
+
+void AccessShadow::trackMemoryOperation(const MemoryOperation& op, std::size_t depth, const VectorClock& clock) {
+  assert(!isFree(op.type));
+
+  auto& shadow = objects[op.object->address];
+  auto isOrderedBefore = [&clock](const Epoch& e) { return clock.isOrderedBefore(e); };
+
+  if (isRead(op.type)) {
+    // same epoch: nothing changed since the last read by this thread
+    if (!shadow.reads.empty() && shadow.reads.back().tid == op.tid && shadow.reads.back().depth == depth) {
+      return;
+    }
+
+    // reads ordered before this one are subsumed by it, as any later access
+    // that is not ordered after this read is checked against it anyway
+    auto readsBefore = shadow.reads.size();
+    shadow.reads.erase(std::remove_if(shadow.reads.begin(), shadow.reads.end(), isOrderedBefore), shadow.reads.end());
+    shadow.reads.push_back(ShadowEpoch{{op.tid, depth}, shadow.reads.size() != readsBefore});
+  } else {
+    // same epoch: exclusively written by this thread in its current epoch
+    if (shadow.reads.empty() && shadow.writes.size() == 1
+        && shadow.writes.front().tid == op.tid && shadow.writes.front().depth == depth) {
+      return;
+    }
+
+    // a write subsumes all accesses that are ordered before it
+    auto accessesBefore = shadow.reads.size() + shadow.writes.size();
+    shadow.reads.erase(std::remove_if(shadow.reads.begin(), shadow.reads.end(), isOrderedBefore), shadow.reads.end());
+    shadow.writes.erase(std::remove_if(shadow.writes.begin(), shadow.writes.end(), isOrderedBefore), shadow.writes.end());
+    bool subsumesOthers = shadow.reads.size() + shadow.writes.size() != accessesBefore;
+    shadow.writes.push_back(ShadowEpoch{{op.tid, depth}, subsumesOthers});
+  }
+}
+
+bool AccessShadow::mayRace(const MemoryOperation& op, const VectorClock& clock) const {
+  auto it = objects.find(op.object->address);
+  if (it == objects.end()) {
+    return false;
+  }
+
+  auto& shadow = it->second;
+  auto isConcurrent = [&clock](const Epoch& e) { return !clock.isOrderedBefore(e); };
+
+  if (std::any_of(shadow.writes.begin(), shadow.writes.end(), isConcurrent)) {
+    return true;
+  }
+
+  if (isRead(op.type)) {
+    // read-shared: concurrent reads never race with each other
+    return false;
+  }
+
+  return std::any_of(shadow.reads.begin(), shadow.reads.end(), isConcurrent);
+}
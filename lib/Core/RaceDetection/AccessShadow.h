@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CommonTypes.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace por {
+  namespace event {
+    class event;
+  }
+  class cone;
+}
+
+namespace klee {
+  /// An epoch identifies the accesses that a thread performed after one of its
+  /// events (and before the next one). It is represented by the depth of that event.
+  struct Epoch {
+    ThreadId tid;
+    std::size_t depth = 0;
+  };
+
+  /// Vector clock of the current event of a thread, derived from its cone in the
+  /// POR configuration: the clock entry of another thread is the depth of the
+  /// maximal event of that thread that is a causal predecessor.
+  class VectorClock {
+    private:
+      ThreadId tid;
+      const por::cone& cone;
+
+    public:
+      explicit VectorClock(const por::event::event& head);
+
+      /// Whether all accesses of the given epoch happen before the accesses
+      /// performed by this clock's thread in its current epoch.
+      [[nodiscard]] bool isOrderedBefore(const Epoch& epoch) const;
+  };
+
+  /// Summarizes the accesses to each memory object in the spirit of FastTrack:
+  /// per object, the last write (incl. alloc) epochs and the last read epochs are
+  /// kept, and epochs that are ordered before a more recent access are dropped.
+  /// This is a conservative over-approximation of the accesses recorded in the
+  /// per-thread @class{EpochMemoryAccesses}: if no summarized epoch is concurrent
+  /// to an operation, then neither is any recorded access.
+  class AccessShadow {
+    private:
+      struct ShadowEpoch : Epoch {
+        // whether epochs ordered before this one were dropped in favor of it
+        bool subsumesOthers = false;
+      };
+
+      struct ObjectShadow {
+        std::vector<ShadowEpoch> writes;
+        std::vector<ShadowEpoch> reads;
+      };
+
+      // Keys are the addresses of @class{MemoryObject} objects (like in @class{EpochMemoryAccesses})
+      std::unordered_map<std::uint64_t, ObjectShadow> objects;
+
+    public:
+      /// Forgets the accesses to the object in the given epoch, mirroring the pruning
+      /// of that epoch's @class{EpochMemoryAccesses} when the object is freed.
+      /// Epochs that subsume others are kept, as the accesses they stand for are
+      /// still recorded in the epochs of other threads.
+      void pruneDataForMemoryObject(const MemoryObject* obj, const Epoch& epoch);
+
+      void trackMemoryOperation(const MemoryOperation& op, std::size_t depth, const VectorClock& clock);
+
+      /// Returns false if no access of another thread to the same object can race
+      /// with `op`, i.e. all of them happen before it or are read-read pairs.
+      [[nodiscard]] bool mayRace(const MemoryOperation& op, const VectorClock& clock) const;
+  };
+}
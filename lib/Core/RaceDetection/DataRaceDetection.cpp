@@ -1,5 +1,7 @@
 #include "DataRaceDetection.h"
 
+#include "klee/Config/Version.h"
+#include "klee/Internal/Support/ErrorHandling.h"
 #include "klee/OptionCategories.h"
 
 #include "por/event/event.h"
@@ -22,6 +24,20 @@ namespace {
                                llvm::cl::init(false),
                                llvm::cl::cat(DebugCat));
 
+  llvm::cl::opt<DataRaceDetection::Backend> DataRaceDetectionBackend(
+      "data-race-detection-backend",
+      llvm::cl::desc("Specify how happens-before is determined during data race detection"),
+      llvm::cl::values(
+          clEnumValN(DataRaceDetection::Backend::EventChain, "event-chain",
+                     "Walk the thread predecessor chains of the configuration (default)"),
+          clEnumValN(DataRaceDetection::Backend::VectorClock, "vector-clock",
+                     "Use per-object epoch summaries and vector clocks derived from the configuration"),
+          clEnumValN(DataRaceDetection::Backend::Differential, "differential",
+                     "Run both backends and abort if their results differ")
+              KLEE_LLVM_CL_VAL_END),
+      llvm::cl::init(DataRaceDetection::Backend::EventChain),
+      llvm::cl::cat(MultithreadingCat));
+
   DataRaceDetection::Stats globalStats;
 }
 
@@ -44,10 +60,12 @@ llvm::raw_ostream &klee::operator<<(llvm::raw_ostream &os, const DataRaceDetecti
     << "  \"numTrackedAccesses\": " << stats.numTrackedAccesses << ",\n"
 
     << "  \"numDataRacesChecks\": " << stats.numDataRacesChecks << ",\n"
+    << "  \"numShadowRaceChecks\": " << stats.numShadowRaceChecks << ",\n"
     << "  \"numFastPathRaceChecks\": " << stats.numFastPathRaceChecks << ",\n"
     << "  \"numSolverRaceChecks\": " << stats.numSolverRaceChecks << ",\n"
 
     << "  \"timeDataRaceChecks\": " << stats.timeDataRaceChecks << ",\n"
+    << "  \"timeShadowChecks\": " << stats.timeShadowChecks << ",\n"
     << "  \"timeFastPathChecks\": " << stats.timeFastPathChecks << ",\n"
     << "  \"timeSolverChecks\": " << stats.timeSolverChecks << "\n"
     << "}";
@@ -86,26 +104,96 @@ void DataRaceDetection::trackAccess(const por::node& node, MemoryOperation&& op)
   // -> we can prune all data that we tracked for that object
   if (isFree(op.type)) {
     acc.pruneDataForMemoryObject(op.object);
+    shadow.pruneDataForMemoryObject(op.object, Epoch{op.tid, evtIt->second->depth()});
   } else {
+    if (DataRaceDetectionBackend != Backend::EventChain) {
+      shadow.trackMemoryOperation(op, evtIt->second->depth(), VectorClock(*evtIt->second));
+    }
     acc.trackMemoryOperation(std::move(op));
     stats.numTrackedAccesses++;
     globalStats.numTrackedAccesses++;
   }
 }
 
+static bool isSameResult(const std::optional<RaceDetectionResult>& a, const std::optional<RaceDetectionResult>& b) {
+  if (!a.has_value() || !b.has_value()) {
+    return a.has_value() == b.has_value();
+  }
+
+  return a->isRace == b->isRace
+      && a->racingInstruction == b->racingInstruction
+      && a->racingThread == b->racingThread
+      && a->canBeSafe == b->canBeSafe
+      && a->conditionToBeSafe == b->conditionToBeSafe
+      && a->hasNewConstraints == b->hasNewConstraints
+      && a->newConstraints == b->newConstraints;
+}
+
 std::optional<RaceDetectionResult>
 DataRaceDetection::isDataRace(const por::node& node,
                               const SolverInterface &interface,
                               const MemoryOperation& operation) {
-  RaceDetectionResult finalResult;
+  if (DataRaceDetectionBackend != Backend::Differential) {
+    return isDataRace(node, interface, operation, DataRaceDetectionBackend);
+  }
+
+  auto expected = isDataRace(node, interface, operation, Backend::EventChain);
+  auto actual = isDataRace(node, interface, operation, Backend::VectorClock);
+  if (!isSameResult(expected, actual)) {
+    klee_error("Data race detection backends disagree on access to %s by thread %s",
+               getDebugInfo(operation.object).c_str(), operation.tid.to_string().c_str());
+  }
+  return expected;
+}
+
+std::optional<RaceDetectionResult>
+DataRaceDetection::isDataRace(const por::node& node,
+                              const SolverInterface &interface,
+                              const MemoryOperation& operation,
+                              Backend backend) {
+  assert(backend != Backend::Differential);
 
   stats.numDataRacesChecks++;
   globalStats.numDataRacesChecks++;
 
   auto clockStart = std::chrono::steady_clock::now();
 
+  if (backend == Backend::VectorClock) {
+    auto evtIt = node.configuration().thread_heads().find(operation.tid);
+    assert(evtIt != node.configuration().thread_heads().end());
+
+    // If the summary of all accesses to the object contains no epoch that is
+    // concurrent to this operation, the per-epoch access lists need not be consulted
+    if (!shadow.mayRace(operation, VectorClock(*evtIt->second))) {
+      if (DebugDrd) {
+        llvm::errs() << "DRD: @" << node.configuration().size()
+                     << " check> mo=" << getDebugInfo(operation.object)
+                     << " tid=" << operation.tid
+                     << " type=" << operation.type
+                     << " race=0 [shadow]"
+                     << "\n";
+      }
+
+      stats.numShadowRaceChecks++;
+      globalStats.numShadowRaceChecks++;
+
+      auto end = std::chrono::steady_clock::now();
+      auto dur = std::chrono::duration_cast<std::chrono::nanoseconds>(end - clockStart).count();
+
+      stats.timeDataRaceChecks += dur;
+      stats.timeShadowChecks += dur;
+      globalStats.timeDataRaceChecks += dur;
+      globalStats.timeShadowChecks += dur;
+
+      RaceDetectionResult result;
+      result.isRace = false;
+      result.hasNewConstraints = false;
+      return result;
+    }
+  }
+
   // Test if we can try a fast path -> races with a concrete offset or alloc/free
-  const auto easyResult = FastPath(node, operation);
+  const auto easyResult = FastPath(node, operation, backend);
 
   if (easyResult.has_value()) {
     // So if the fast path could produce any definite claims, then either
@@ -136,7 +224,7 @@ DataRaceDetection::isDataRace(const por::node& node,
     return easyResult;
   }
 
-  const auto& solverResult = SolverPath(node, interface, operation);
+  const auto& solverResult = SolverPath(node, interface, operation, backend);
 
   stats.numSolverRaceChecks++;
   globalStats.numSolverRaceChecks++;
@@ -181,74 +269,39 @@ DataRaceDetection::isDataRace(const por::node& node,
 std::optional<RaceDetectionResult>
 DataRaceDetection::SolverPath(const por::node& node,
                               const SolverInterface &interface,
-                              const MemoryOperation &operation) {
-  // So we have to check if we have potentially raced with any thread
-  const auto& threadsToCheck = node.configuration().thread_heads();
-  auto it = threadsToCheck.find(operation.tid);
-  assert(it != threadsToCheck.end());
-  auto* curEventOfOperatingThread = it->second;
-
+                              const MemoryOperation &operation,
+                              Backend backend) {
   std::vector<std::tuple<ThreadId, ref<Expr>, MemoryOperation::Offset, KInstruction*>> accessesToCheck;
 
-  for (auto const &pair : threadsToCheck) {
-    ThreadId const& tid = pair.first;
-    if (tid == operation.tid) {
-      continue;
-    }
+  forEachUnsynchronizedEpoch(node, operation.tid, backend, [&](const ThreadId& tid, const EpochMemoryAccesses& memAccesses) {
+    if (auto* accessed = memAccesses.getMemoryAccessesOfThread(operation.object)) {
+      assert(!accessed->isAllocOrFree() && "Should have caused a datarace on the fastpath");
 
-    por::event::event const *evt = pair.second;
-    assert(evt != nullptr);
-    // The `succ` event has the `evt` as the thread predecessor.
-    // -> It is the direct thread successor of `evt`.
-    por::event::event const *succ = nullptr;
-
-    const auto& accessList = getAccessListOfThread(tid);
-    for (auto accessListIt = accessList.rbegin(), accessListEnd = accessList.rend(); accessListIt != accessListEnd; ++accessListIt) {
-      // skip all events that do not have any registered memory accesses
-      while (evt != nullptr && evt != accessListIt->first) {
-        succ = evt;
-        evt = evt->thread_predecessor();
-      }
-      if (evt == nullptr) {
-        break;
-      }
+      if (isa<ConstantExpr>(operation.offset)) {
+        // Any operation that happens at a concrete offset will have been checked against all other concrete operations
+        // on the fastpath pass. Thus, we can omit iterating over `accessed->getConcreteAccesses`.
 
-      // Since accesses are associated with the event that happened *before* they did, the memory accesses associated with
-      // the first event that is less than the one we are looking at still need to be checked. Any accesses happening even
-      // before that are synchronized.
-      if (succ && succ->is_less_than(*curEventOfOperatingThread)) {
-        break;
-      }
-
-      const auto& memAccesses = accessListIt->second;
-      if (auto* accessed = memAccesses.getMemoryAccessesOfThread(operation.object)) {
-        assert(!accessed->isAllocOrFree() && "Should have caused a datarace on the fastpath");
-
-        if (isa<ConstantExpr>(operation.offset)) {
-          // Any operation that happens at a concrete offset will have been checked against all other concrete operations
-          // on the fastpath pass. Thus, we can omit iterating over `accessed->getConcreteAccesses`.
-
-          for (const auto& [accessOffset, access] : accessed->getSymbolicAccesses()) {
-            if (isWrite(operation.type) || isWrite(access.type)) {
-              accessesToCheck.emplace_back(tid, accessOffset, access.numBytes, access.instruction);
-            }
+        for (const auto& [accessOffset, access] : accessed->getSymbolicAccesses()) {
+          if (isWrite(operation.type) || isWrite(access.type)) {
+            accessesToCheck.emplace_back(tid, accessOffset, access.numBytes, access.instruction);
           }
-        } else {
-          for (const auto& [accessOffset, access] : accessed->getConcreteAccesses()) {
-            if (isWrite(operation.type) || isWrite(access.type)) {
-              accessesToCheck.emplace_back(tid, Expr::createPointer(accessOffset), access.numBytes, access.instruction);
-            }
+        }
+      } else {
+        for (const auto& [accessOffset, access] : accessed->getConcreteAccesses()) {
+          if (isWrite(operation.type) || isWrite(access.type)) {
+            accessesToCheck.emplace_back(tid, Expr::createPointer(accessOffset), access.numBytes, access.instruction);
           }
-          for (const auto& [accessOffset, access] : accessed->getSymbolicAccesses()) {
-            if (isWrite(operation.type) || isWrite(access.type)) {
-              assert(operation.offset != accessOffset && "checked in fastpath");
-              accessesToCheck.emplace_back(tid, accessOffset, access.numBytes, access.instruction);
-            }
+        }
+        for (const auto& [accessOffset, access] : accessed->getSymbolicAccesses()) {
+          if (isWrite(operation.type) || isWrite(access.type)) {
+            assert(operation.offset != accessOffset && "checked in fastpath");
+            accessesToCheck.emplace_back(tid, accessOffset, access.numBytes, access.instruction);
           }
         }
       }
     }
-  }
+    return false;
+  });
 
   assert(!accessesToCheck.empty() && "We have to have at least one pair to check");
 
@@ -342,20 +395,166 @@ DataRaceDetection::SolverPath(const por::node& node,
 
 std::optional<RaceDetectionResult>
 DataRaceDetection::FastPath(const por::node& node,
-                            const MemoryOperation& operation) {
+                            const MemoryOperation& operation,
+                            Backend backend) {
+  std::optional<RaceDetectionResult> result{std::in_place_t{}};
+  result->isRace = false;
+  result->hasNewConstraints = false;
+
+  forEachUnsynchronizedEpoch(node, operation.tid, backend, [&](const ThreadId& tid, const EpochMemoryAccesses& memAccesses) {
+    auto* accessed = memAccesses.getMemoryAccessesOfThread(operation.object);
+    if (!accessed) {
+      return false;
+    }
+
+    if (isAllocOrFree(operation.type) || accessed->isAllocOrFree()) {
+      result.emplace();
+      // We race with every other access, therefore simply pick the first
+      result->racingInstruction = accessed->isAllocOrFree()
+                                ? accessed->getAllocFreeInstruction()
+                                : !accessed->getConcreteAccesses().empty()
+                                  ? accessed->getConcreteAccesses().begin()->second.instruction
+                                  : accessed->getSymbolicAccesses().begin()->second.instruction;
+
+      result->racingThread = tid;
+      result->isRace = true;
+      result->canBeSafe = false;
+      return true;
+    }
+
+    // So we now know for sure that only standard accesses are inside here
+    if (auto operationOffsetExpr = dyn_cast<ConstantExpr>(operation.offset)) {
+      auto operationOffset = operationOffsetExpr->getZExtValue();
+      // for operations with concrete offset, we can only check against other concrete offsets
+      auto it = accessed->getConcreteAccesses().lower_bound(operationOffset);
+      if (!(it != accessed->getConcreteAccesses().end() && it->first == operationOffset)
+        && it != accessed->getConcreteAccesses().begin()) {
+        auto prev = std::prev(it);
+        if (isWrite(operation.type) || isWrite(prev->second.type)) {
+          // assert(prev->first < operationOffset);
+          if(prev->first + prev->second.numBytes > operationOffset) {
+            result.emplace();
+            result->racingInstruction = prev->second.instruction;
+            result->racingThread = tid;
+            result->isRace = true;
+            result->canBeSafe = false;
+            return true;
+          }
+        }
+      }
+      for (; it != accessed->getConcreteAccesses().end()
+        && it->first < operationOffset + operation.numBytes; ++it) {
+        // assert(it->first >= operationOffset);
+        if (isWrite(operation.type) || isWrite(it->second.type)) {
+          result.emplace();
+          result->racingInstruction = it->second.instruction;
+          result->racingThread = tid;
+          result->isRace = true;
+          result->canBeSafe = false;
+          return true;
+        }
+      }
+
+      if (result.has_value()) {
+        for (auto &[accessOffset, access] : accessed->getSymbolicAccesses()) {
+          if (isWrite(operation.type) || isWrite(access.type)) {
+            result.reset();
+            break;
+          }
+        }
+      }
+    } else {
+      auto [begin, end] = accessed->getSymbolicAccesses().equal_range(operation.offset);
+      // for operations with symbolic offset, we can only check against other symbolic offsets
+      for (const auto& [offset, access] : util::make_iterator_range(begin, end)) {
+        if (isRead(operation.type) && isRead(access.type)) {
+          continue;
+        }
+
+        // all operations overlap at this point, as their offset expressions are equal
+        // and they always have more than one byte each
+        // assert(offset == incoming.offset);
+        // assert(incoming.numBytes > 0 && operation.numBytes > 0);
+        result.emplace();
+        result->racingInstruction = access.instruction;
+        result->racingThread = tid;
+        result->isRace = true;
+        result->canBeSafe = false;
+        return true;
+      }
+      if (result.has_value()) {
+        for (auto &[accessOffset, access] : util::make_iterator_range(accessed->getSymbolicAccesses().begin(), begin)) {
+          if (isWrite(operation.type) || isWrite(access.type)) {
+            result.reset();
+            break;
+          }
+        }
+      }
+      if (result.has_value()) {
+        for (auto &[accessOffset, access] : util::make_iterator_range(end, accessed->getSymbolicAccesses().end())) {
+          if (isWrite(operation.type) || isWrite(access.type)) {
+            result.reset();
+            break;
+          }
+        }
+      }
+
+      if (result.has_value()) {
+        for (auto &[accessOffset, access] : accessed->getConcreteAccesses()) {
+          if (isWrite(operation.type) || isWrite(access.type)) {
+            result.reset();
+            break;
+          }
+        }
+      }
+    }
+    return false;
+  });
+
+  return result;
+}
+
+template<typename F>
+void DataRaceDetection::forEachUnsynchronizedEpoch(const por::node& node,
+                                                   const ThreadId& operatingThread,
+                                                   Backend backend,
+                                                   F&& callback) {
+  assert(backend != Backend::Differential);
+
   // So we have to check if we have potentially raced with any thread
   const auto& threadsToCheck = node.configuration().thread_heads();
-  auto it = threadsToCheck.find(operation.tid);
+  auto it = threadsToCheck.find(operatingThread);
   assert(it != threadsToCheck.end());
-  auto& curEventOfOperatingThread = it->second;
+  auto* curEventOfOperatingThread = it->second;
 
-  std::optional<RaceDetectionResult> result{std::in_place_t{}};
-  result->isRace = false;
-  result->hasNewConstraints = false;
+  if (backend == Backend::VectorClock) {
+    VectorClock clock(*curEventOfOperatingThread);
+
+    for (auto const &pair : threadsToCheck) {
+      ThreadId const& tid = pair.first;
+      if (tid == operatingThread) {
+        continue;
+      }
+
+      // Epochs are ordered by depth, so we can stop at the first one that is
+      // ordered before the current event without visiting any events in between
+      const auto& accessList = getAccessListOfThread(tid);
+      for (auto accessListIt = accessList.rbegin(), accessListEnd = accessList.rend(); accessListIt != accessListEnd; ++accessListIt) {
+        if (clock.isOrderedBefore(Epoch{tid, accessListIt->first->depth()})) {
+          break;
+        }
+
+        if (callback(tid, accessListIt->second)) {
+          return;
+        }
+      }
+    }
+    return;
+  }
 
   for (auto const &pair : threadsToCheck) {
     ThreadId const& tid = pair.first;
-    if (tid == operation.tid) {
+    if (tid == operatingThread) {
       continue;
     }
 
@@ -365,7 +564,7 @@ DataRaceDetection::FastPath(const por::node& node,
     // -> It is the direct thread successor of `evt`.
     por::event::event const *succ = nullptr;
 
-    auto& accessList = getAccessListOfThread(tid);
+    const auto& accessList = getAccessListOfThread(tid);
     for (auto accessListIt = accessList.rbegin(), accessListEnd = accessList.rend(); accessListIt != accessListEnd; ++accessListIt) {
       // skip all events that do not have any registered memory accesses
       while (evt != nullptr && evt != accessListIt->first) {
@@ -383,112 +582,9 @@ DataRaceDetection::FastPath(const por::node& node,
         break;
       }
 
-      const auto& memAccesses = accessListIt->second;
-      if (auto* accessed = memAccesses.getMemoryAccessesOfThread(operation.object)) {
-        if (isAllocOrFree(operation.type) || accessed->isAllocOrFree()) {
-          result.emplace();
-          // We race with every other access, therefore simply pick the first
-          result->racingInstruction = accessed->isAllocOrFree()
-                                    ? accessed->getAllocFreeInstruction()
-                                    : !accessed->getConcreteAccesses().empty()
-                                      ? accessed->getConcreteAccesses().begin()->second.instruction
-                                      : accessed->getSymbolicAccesses().begin()->second.instruction;
-
-          result->racingThread = tid;
-          result->isRace = true;
-          result->canBeSafe = false;
-          return result;
-        }
-
-        // So we now know for sure that only standard accesses are inside here
-        if (auto operationOffsetExpr = dyn_cast<ConstantExpr>(operation.offset)) {
-          auto operationOffset = operationOffsetExpr->getZExtValue();
-          // for operations with concrete offset, we can only check against other concrete offsets
-          auto it = accessed->getConcreteAccesses().lower_bound(operationOffset);
-          if (!(it != accessed->getConcreteAccesses().end() && it->first == operationOffset) 
-            && it != accessed->getConcreteAccesses().begin()) {
-            auto prev = std::prev(it);
-            if (isWrite(operation.type) || isWrite(prev->second.type)) {
-              // assert(prev->first < operationOffset);
-              if(prev->first + prev->second.numBytes > operationOffset) {
-                result.emplace();
-                result->racingInstruction = prev->second.instruction;
-                result->racingThread = tid;
-                result->isRace = true;
-                result->canBeSafe = false;
-                return result;
-              }
-            }
-          }
-          for (; it != accessed->getConcreteAccesses().end()
-            && it->first < operationOffset + operation.numBytes; ++it) {
-            // assert(it->first >= operationOffset);
-            if (isWrite(operation.type) || isWrite(it->second.type)) {
-              result.emplace();
-              result->racingInstruction = it->second.instruction;
-              result->racingThread = tid;
-              result->isRace = true;
-              result->canBeSafe = false;
-              return result;
-            }
-          }
-
-          if (result.has_value()) {
-            for (auto &[accessOffset, access] : accessed->getSymbolicAccesses()) {
-              if (isWrite(operation.type) || isWrite(access.type)) {
-                result.reset();
-                break;
-              }
-            }
-          }
-        } else {
-          auto [begin, end] = accessed->getSymbolicAccesses().equal_range(operation.offset);
-          // for operations with symbolic offset, we can only check against other symbolic offsets
-          for (const auto& [offset, access] : util::make_iterator_range(begin, end)) {
-            if (isRead(operation.type) && isRead(access.type)) {
-              continue;
-            }
-
-            // all operations overlap at this point, as their offset expressions are equal
-            // and they always have more than one byte each
-            // assert(offset == incoming.offset);
-            // assert(incoming.numBytes > 0 && operation.numBytes > 0);
-            result.emplace();
-            result->racingInstruction = access.instruction;
-            result->racingThread = tid;
-            result->isRace = true;
-            result->canBeSafe = false;
-            return result;
-          }
-          if (result.has_value()) {
-            for (auto &[accessOffset, access] : util::make_iterator_range(accessed->getSymbolicAccesses().begin(), begin)) {
-              if (isWrite(operation.type) || isWrite(access.type)) {
-                result.reset();
-                break;
-              }
-            }
-          }
-          if (result.has_value()) {
-            for (auto &[accessOffset, access] : util::make_iterator_range(end, accessed->getSymbolicAccesses().end())) {
-              if (isWrite(operation.type) || isWrite(access.type)) {
-                result.reset();
-                break;
-              }
-            }
-          }
-          
-          if (result.has_value()) {
-            for (auto &[accessOffset, access] : accessed->getConcreteAccesses()) {
-              if (isWrite(operation.type) || isWrite(access.type)) {
-                result.reset();
-                break;
-              }
-            }
-          }
-        }
+      if (callback(tid, accessListIt->second)) {
+        return;
       }
     }
   }
-
-  return result;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AccessShadow.h"
 #include "CommonTypes.h"
 #include "EpochMemoryAccesses.h"
 
@@ -20,17 +21,32 @@ namespace klee {
         std::size_t numTrackedAccesses = 0;
 
         std::size_t numDataRacesChecks = 0;
+        std::size_t numShadowRaceChecks = 0;
         std::size_t numFastPathRaceChecks = 0;
         std::size_t numSolverRaceChecks = 0;
 
         std::uint64_t timeDataRaceChecks = 0;
+        std::uint64_t timeShadowChecks = 0;
         std::uint64_t timeFastPathChecks = 0;
         std::uint64_t timeSolverChecks = 0;
       };
 
+      /// How happens-before between memory accesses is determined
+      enum class Backend {
+        /// Walk the thread predecessor chains of the configuration
+        EventChain,
+        /// Compare epochs against vector clocks and consult a per-object shadow first
+        VectorClock,
+        /// Run both backends and abort if their results differ
+        Differential
+      };
+
     private:
       std::map<ThreadId, std::deque<std::pair<const por::event::event*, EpochMemoryAccesses>>> accesses;
 
+      // only maintained for Backend::VectorClock and Backend::Differential
+      AccessShadow shadow;
+
       Stats stats;
 
     public:
@@ -46,15 +62,32 @@ namespace klee {
       static const Stats& getGlobalStats();
 
     private:
+      std::optional<RaceDetectionResult>
+      isDataRace(const por::node& node,
+                 const SolverInterface &interface,
+                 const MemoryOperation &operation,
+                 Backend backend);
+
       std::optional<RaceDetectionResult>
       SolverPath(const por::node& node,
                  const SolverInterface &interface,
-                 const MemoryOperation& operation);
+                 const MemoryOperation& operation,
+                 Backend backend);
 
       /// The fast-path tries to check if the access is safe without using the solver
       std::optional<RaceDetectionResult>
       FastPath(const por::node& node,
-               const MemoryOperation& operation);
+               const MemoryOperation& operation,
+               Backend backend);
+
+      /// Calls `callback(tid, memAccesses)` for the accesses of every other thread that are
+      /// not ordered before the current event of the operating thread, most recent epoch first.
+      /// Stops as soon as the callback returns true.
+      template<typename F>
+      void forEachUnsynchronizedEpoch(const por::node& node,
+                                      const ThreadId& operatingThread,
+                                      Backend backend,
+                                      F&& callback);
 
       auto& getAccessListOfThread(const ThreadId& tid) {
         return accesses[tid];
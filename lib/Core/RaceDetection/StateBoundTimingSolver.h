@@ -12,11 +12,14 @@ namespace klee {
       ExecutionState& state;
       TimingSolver& solver;
       time::Span timeout;
+      QueryOrigin origin;
 
     public:
-      StateBoundTimingSolver(ExecutionState& st, TimingSolver& s, time::Span t) : state(st), solver(s), timeout(t) {};
+      StateBoundTimingSolver(ExecutionState& st, TimingSolver& s, time::Span t, QueryOrigin o = QueryOrigin::DataRace)
+        : state(st), solver(s), timeout(t), origin(o) {};
 
       [[nodiscard]] std::optional<bool> mustBeTrue(ref<Expr> expr) const override {
+        TimingSolver::OriginScope scope(solver, origin);
         solver.setTimeout(timeout);
         bool result = true;
         bool success = solver.mustBeTrue(state, expr, result);
@@ -30,6 +33,7 @@ namespace klee {
       };
 
       [[nodiscard]] std::optional<bool> mustBeFalse(ref<Expr> expr) const override {
+        TimingSolver::OriginScope scope(solver, origin);
         solver.setTimeout(timeout);
         bool result = true;
         bool success = solver.mustBeFalse(state, expr, result);
@@ -43,6 +47,7 @@ namespace klee {
       };
 
       [[nodiscard]] std::optional<bool> mayBeTrue(ref<Expr> expr) const override {
+        TimingSolver::OriginScope scope(solver, origin);
         solver.setTimeout(timeout);
         bool result = true;
         bool success = solver.mayBeTrue(state, expr, result);
@@ -56,6 +61,7 @@ namespace klee {
       };
 
       [[nodiscard]] std::optional<bool> mayBeFalse(ref<Expr> expr) const override {
+        TimingSolver::OriginScope scope(solver, origin);
         solver.setTimeout(timeout);
         bool result = true;
         bool success = solver.mayBeFalse(state, expr, result);
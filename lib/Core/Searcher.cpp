@@ -30,6 +30,8 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Support/CommandLine.h"
 
+#include "por/node.h"
+
 #include <cassert>
 #include <climits>
 #include <cmath>
@@ -299,6 +301,64 @@ bool RandomPathSearcher::empty() {
 
 ///
 
+std::size_t MinCatchUpSearcher::getStandbyState(const ExecutionState &state) {
+  const por::node *n = state.porNode;
+  while (n && !n->standby_state())
+    n = n->parent();
+  return n ? n->standby_state()->id : noStandby;
+}
+
+std::size_t MinCatchUpSearcher::estimateCatchUp(const ExecutionState &state) {
+  // the catch-up sequence of a state created from a por::leaf already starts
+  // at the standby state it was copied from
+  return state.needsCatchUp() ? state.catchUp.size() : 0;
+}
+
+ExecutionState &MinCatchUpSearcher::selectState() {
+  if (selected)
+    return *selected;
+
+  // prefer newer states on ties, like DFS
+  auto best = states.rbegin();
+  bool bestShared = best->standby == selectedStandby;
+  std::size_t bestCost = estimateCatchUp(*best->state);
+  for (auto it = std::next(best), ie = states.rend(); it != ie; ++it) {
+    bool shared = it->standby == selectedStandby;
+    if (bestShared && !shared)
+      continue;
+    std::size_t cost = estimateCatchUp(*it->state);
+    if ((shared && !bestShared) || cost < bestCost) {
+      best = it;
+      bestShared = shared;
+      bestCost = cost;
+    }
+  }
+
+  selected = best->state;
+  selectedStandby = best->standby;
+  return *selected;
+}
+
+void MinCatchUpSearcher::update(
+    ExecutionState *current, const std::vector<ExecutionState *> &addedStates,
+    const std::vector<ExecutionState *> &removedStates) {
+  for (ExecutionState *es : addedStates)
+    states.push_back({es, getStandbyState(*es)});
+
+  for (ExecutionState *es : removedStates) {
+    auto it = std::find_if(states.rbegin(), states.rend(),
+                           [es](const Entry &e) { return e.state == es; });
+    assert(it != states.rend() && "invalid state removed");
+    states.erase(std::next(it).base());
+
+    // keep selectedStandby to prefer the siblings of the removed state
+    if (es == selected)
+      selected = nullptr;
+  }
+}
+
+///
+
 BatchingSearcher::BatchingSearcher(Searcher *_baseSearcher,
                                    time::Span _timeBudget,
                                    unsigned _instructionBudget) 
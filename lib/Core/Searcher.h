@@ -14,6 +14,8 @@
 
 #include "llvm/Support/raw_ostream.h"
 
+#include <cstddef>
+#include <limits>
 #include <map>
 #include <queue>
 #include <set>
@@ -74,6 +76,7 @@ namespace klee {
       BFS,
       RandomState,
       RandomPath,
+      MinCatchUp,
       NURS_CovNew,
       NURS_MD2U,
       NURS_Depth,
@@ -186,6 +189,40 @@ namespace klee {
     }
   };
 
+  /// Searcher for partial order reduction that keeps executing the selected
+  /// state until it terminates. Then it prefers states that start from the
+  /// same standby state as the previous one, and among those the ones with the
+  /// fewest events to catch up. Exploring all alternatives based on a standby
+  /// state in a row allows its part of the POR tree to be backtracked early.
+  class MinCatchUpSearcher : public Searcher {
+    // standby states are identified by id, as they may be freed (and their
+    // address reused) while states created from them are still queued
+    static constexpr std::size_t noStandby = std::numeric_limits<std::size_t>::max();
+
+    struct Entry {
+      ExecutionState *state;
+      // id of the closest standby state the state was created from (if any)
+      std::size_t standby;
+    };
+
+    std::vector<Entry> states;
+    ExecutionState *selected = nullptr;
+    std::size_t selectedStandby = noStandby;
+
+    static std::size_t getStandbyState(const ExecutionState &state);
+    static std::size_t estimateCatchUp(const ExecutionState &state);
+
+  public:
+    ExecutionState &selectState();
+    void update(ExecutionState *current,
+                const std::vector<ExecutionState *> &addedStates,
+                const std::vector<ExecutionState *> &removedStates);
+    bool empty() { return states.empty(); }
+    void printName(llvm::raw_ostream &os) {
+      os << "MinCatchUpSearcher\n";
+    }
+  };
+
   class BatchingSearcher : public Searcher {
     Searcher *baseSearcher;
     time::Span timeBudget;
@@ -121,6 +121,18 @@ static SpecialFunctionHandler::HandlerInfo handlerInfo[] = {
   add("klee_cond_wait", handleCondWait, false),
   add("klee_cond_signal", handleCondSignal, false),
   add("klee_cond_broadcast", handleCondBroadcast, false),
+  add("klee_rwlock_rdlock", handleRwLockRdLock, true),
+  add("klee_rwlock_wrlock", handleRwLockWrLock, true),
+  add("klee_rwlock_tryrdlock", handleRwLockTryRdLock, true),
+  add("klee_rwlock_trywrlock", handleRwLockTryWrLock, true),
+  add("klee_rwlock_unlock", handleRwLockUnlock, true),
+  add("klee_semaphore_init", handleSemaphoreInit, false),
+  add("klee_semaphore_post", handleSemaphorePost, true),
+  add("klee_semaphore_wait", handleSemaphoreWait, false),
+  add("klee_semaphore_trywait", handleSemaphoreTryWait, true),
+  add("klee_semaphore_getvalue", handleSemaphoreGetValue, true),
+  add("klee_barrier_wait", handleBarrierWait, false),
+  add("klee_barrier_is_serial", handleBarrierIsSerial, true),
 
   add("malloc", handleMalloc, true),
   add("memalign", handleMemalign, true),
@@ -1201,6 +1213,400 @@ void SpecialFunctionHandler::handleCondBroadcast(ExecutionState &state,
   }
 }
 
+void SpecialFunctionHandler::handleRwLockRdLock(ExecutionState &state,
+                                                KInstruction *target,
+                                                std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_rwlock_rdlock - expected 1");
+
+  ref<Expr> rwidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(rwidExpr)) {
+    executor.terminateStateOnError(state, "klee_rwlock_rdlock", Executor::User);
+    return;
+  }
+
+  auto rwid = cast<ConstantExpr>(rwidExpr)->getZExtValue();
+
+  // Recursive read acquisitions are handled by the runtime, so we only have to detect
+  // a read acquisition while holding the write lock
+  if (state.porNode->configuration().rwlock_acquisition_of_tid(rwid, state.tid())) {
+    executor.bindLocal(target, state, ConstantExpr::create(EDEADLK, Expr::Int32));
+    return;
+  }
+
+  executor.bindLocal(target, state, ConstantExpr::create(0, Expr::Int32));
+  state.blockThread(Thread::wait_rdlock_t{rwid});
+}
+
+void SpecialFunctionHandler::handleRwLockWrLock(ExecutionState &state,
+                                                KInstruction *target,
+                                                std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_rwlock_wrlock - expected 1");
+
+  ref<Expr> rwidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(rwidExpr)) {
+    executor.terminateStateOnError(state, "klee_rwlock_wrlock", Executor::User);
+    return;
+  }
+
+  auto rwid = cast<ConstantExpr>(rwidExpr)->getZExtValue();
+
+  if (state.porNode->configuration().rwlock_acquisition_of_tid(rwid, state.tid())) {
+    // We would wait for ourselves
+    executor.bindLocal(target, state, ConstantExpr::create(EDEADLK, Expr::Int32));
+    return;
+  }
+
+  executor.bindLocal(target, state, ConstantExpr::create(0, Expr::Int32));
+  state.blockThread(Thread::wait_wrlock_t{rwid});
+}
+
+void SpecialFunctionHandler::handleRwLockTryRdLock(ExecutionState &state,
+                                                   KInstruction *target,
+                                                   std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_rwlock_tryrdlock - expected 1");
+
+  ref<Expr> rwidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(rwidExpr)) {
+    executor.terminateStateOnError(state, "klee_rwlock_tryrdlock", Executor::User);
+    return;
+  }
+
+  auto rwid = cast<ConstantExpr>(rwidExpr)->getZExtValue();
+  const auto &cfg = state.porNode->configuration();
+
+  if (cfg.rwlock_acquisition_of_tid(rwid, state.tid())) {
+    executor.bindLocal(target, state, ConstantExpr::create(EDEADLK, Expr::Int32));
+    return;
+  }
+
+  // A failing attempt is registered as well, as it observes that the rwlock is held
+  bool succ;
+  if (cfg.can_rdacquire_rwlock(rwid)) {
+    executor.bindLocal(target, state, ConstantExpr::create(0, Expr::Int32));
+    state.memoryState.registerAcquiredLock(rwid, state.tid());
+    succ = executor.porEventManager.registerRwLockRdAcquire(state, rwid, por::event::rwlock_operation::trylock);
+  } else {
+    executor.bindLocal(target, state, ConstantExpr::create(EBUSY, Expr::Int32));
+    succ = executor.porEventManager.registerRwLockBusy(state, rwid, false);
+  }
+
+  if (!succ) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleRwLockTryWrLock(ExecutionState &state,
+                                                   KInstruction *target,
+                                                   std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_rwlock_trywrlock - expected 1");
+
+  ref<Expr> rwidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(rwidExpr)) {
+    executor.terminateStateOnError(state, "klee_rwlock_trywrlock", Executor::User);
+    return;
+  }
+
+  auto rwid = cast<ConstantExpr>(rwidExpr)->getZExtValue();
+  const auto &cfg = state.porNode->configuration();
+
+  if (cfg.rwlock_acquisition_of_tid(rwid, state.tid())) {
+    // We would wait for ourselves
+    executor.bindLocal(target, state, ConstantExpr::create(EDEADLK, Expr::Int32));
+    return;
+  }
+
+  // A failing attempt is registered as well, as it observes that the rwlock is held
+  bool succ;
+  if (cfg.can_wracquire_rwlock(rwid)) {
+    executor.bindLocal(target, state, ConstantExpr::create(0, Expr::Int32));
+    state.memoryState.registerAcquiredLock(rwid, state.tid());
+    succ = executor.porEventManager.registerRwLockWrAcquire(state, rwid, por::event::rwlock_operation::trylock);
+  } else {
+    executor.bindLocal(target, state, ConstantExpr::create(EBUSY, Expr::Int32));
+    succ = executor.porEventManager.registerRwLockBusy(state, rwid, true);
+  }
+
+  if (!succ) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleRwLockUnlock(ExecutionState &state,
+                                                KInstruction *target,
+                                                std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_rwlock_unlock - expected 1");
+
+  ref<Expr> rwidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(rwidExpr)) {
+    executor.terminateStateOnError(state, "klee_rwlock_unlock", Executor::User);
+    return;
+  }
+
+  auto rwid = cast<ConstantExpr>(rwidExpr)->getZExtValue();
+  const auto& ownTid = state.tid();
+
+  if (!state.porNode->configuration().rwlock_acquisition_of_tid(rwid, ownTid)) {
+    // The rwlock is not held by this thread, neither for reading nor for writing
+    executor.bindLocal(target, state, ConstantExpr::create(EPERM, Expr::Int32));
+    return;
+  }
+
+  executor.bindLocal(target, state, ConstantExpr::create(0, Expr::Int32));
+  state.memoryState.unregisterAcquiredLock(rwid, ownTid);
+  if (!executor.porEventManager.registerRwLockRelease(state, rwid)) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleSemaphoreInit(ExecutionState &state,
+                                                 KInstruction *target,
+                                                 std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 2 && "invalid number of arguments to klee_semaphore_init - expected 2");
+
+  ref<Expr> sidExpr = executor.toUnique(state, arguments[0]);
+  ref<Expr> valueExpr = executor.toUnique(state, arguments[1]);
+
+  if (!isa<ConstantExpr>(sidExpr) || !isa<ConstantExpr>(valueExpr)) {
+    executor.terminateStateOnError(state, "klee_semaphore_init", Executor::User);
+    return;
+  }
+
+  auto sid = cast<ConstantExpr>(sidExpr)->getZExtValue();
+  auto value = cast<ConstantExpr>(valueExpr)->getZExtValue();
+
+  state.memoryState.registerSemaphoreChange(sid, state.tid(), static_cast<std::int64_t>(value));
+  if (!executor.porEventManager.registerSemaphoreCreate(state, sid, value)) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleSemaphorePost(ExecutionState &state,
+                                                 KInstruction *target,
+                                                 std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 2 && "invalid number of arguments to klee_semaphore_post - expected 2");
+
+  ref<Expr> sidExpr = executor.toUnique(state, arguments[0]);
+  ref<Expr> maxExpr = executor.toUnique(state, arguments[1]);
+
+  if (!isa<ConstantExpr>(sidExpr) || !isa<ConstantExpr>(maxExpr)) {
+    executor.terminateStateOnError(state, "klee_semaphore_post", Executor::User);
+    return;
+  }
+
+  auto sid = cast<ConstantExpr>(sidExpr)->getZExtValue();
+  auto max = cast<ConstantExpr>(maxExpr)->getZExtValue();
+  const auto &cfg = state.porNode->configuration();
+
+  if (!cfg.last_write_of_sid(sid)) {
+    executor.terminateStateOnError(state, "klee_semaphore_post: semaphore was not initialized", Executor::User);
+    return;
+  }
+
+  if (cfg.semaphore_value(sid) >= max) {
+    executor.bindLocal(target, state, ConstantExpr::create(EOVERFLOW, Expr::Int32));
+    return;
+  }
+
+  executor.bindLocal(target, state, ConstantExpr::create(0, Expr::Int32));
+  state.memoryState.registerSemaphoreChange(sid, state.tid(), 1);
+  if (!executor.porEventManager.registerSemaphorePost(state, sid)) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleSemaphoreWait(ExecutionState &state,
+                                                 KInstruction *target,
+                                                 std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_semaphore_wait - expected 1");
+
+  ref<Expr> sidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(sidExpr)) {
+    executor.terminateStateOnError(state, "klee_semaphore_wait", Executor::User);
+    return;
+  }
+
+  auto sid = cast<ConstantExpr>(sidExpr)->getZExtValue();
+
+  if (!state.porNode->configuration().last_write_of_sid(sid)) {
+    executor.terminateStateOnError(state, "klee_semaphore_wait: semaphore was not initialized", Executor::User);
+    return;
+  }
+
+  // The event is registered once the thread is scheduled again, which
+  // may happen immediately if the semaphore is positive
+  state.blockThread(Thread::wait_semaphore_t{sid});
+}
+
+void SpecialFunctionHandler::handleSemaphoreTryWait(ExecutionState &state,
+                                                    KInstruction *target,
+                                                    std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_semaphore_trywait - expected 1");
+
+  ref<Expr> sidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(sidExpr)) {
+    executor.terminateStateOnError(state, "klee_semaphore_trywait", Executor::User);
+    return;
+  }
+
+  auto sid = cast<ConstantExpr>(sidExpr)->getZExtValue();
+  const auto &cfg = state.porNode->configuration();
+
+  if (!cfg.last_write_of_sid(sid)) {
+    executor.terminateStateOnError(state, "klee_semaphore_trywait: semaphore was not initialized", Executor::User);
+    return;
+  }
+
+  // A failing attempt is registered as well, as it observes the value of the semaphore
+  if (cfg.semaphore_value(sid) > 0) {
+    executor.bindLocal(target, state, ConstantExpr::create(0, Expr::Int32));
+    state.memoryState.registerSemaphoreChange(sid, state.tid(), -1);
+  } else {
+    executor.bindLocal(target, state, ConstantExpr::create(EAGAIN, Expr::Int32));
+  }
+
+  if (!executor.porEventManager.registerSemaphoreWait(state, sid, por::event::semaphore_operation::trywait)) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleSemaphoreGetValue(ExecutionState &state,
+                                                     KInstruction *target,
+                                                     std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_semaphore_getvalue - expected 1");
+
+  ref<Expr> sidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(sidExpr)) {
+    executor.terminateStateOnError(state, "klee_semaphore_getvalue", Executor::User);
+    return;
+  }
+
+  auto sid = cast<ConstantExpr>(sidExpr)->getZExtValue();
+  const auto &cfg = state.porNode->configuration();
+
+  if (!cfg.last_write_of_sid(sid)) {
+    executor.terminateStateOnError(state, "klee_semaphore_getvalue: semaphore was not initialized", Executor::User);
+    return;
+  }
+
+  executor.bindLocal(target, state, ConstantExpr::create(cfg.semaphore_value(sid), Expr::Int32));
+  if (!executor.porEventManager.registerSemaphoreWait(state, sid, por::event::semaphore_operation::getvalue)) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleBarrierWait(ExecutionState &state,
+                                               KInstruction *target,
+                                               std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 2 && "invalid number of arguments to klee_barrier_wait - expected 2");
+
+  ref<Expr> bidExpr = executor.toUnique(state, arguments[0]);
+  ref<Expr> countExpr = executor.toUnique(state, arguments[1]);
+
+  if (!isa<ConstantExpr>(bidExpr) || !isa<ConstantExpr>(countExpr)) {
+    executor.terminateStateOnError(state, "klee_barrier_wait", Executor::User);
+    return;
+  }
+
+  auto bid = cast<ConstantExpr>(bidExpr)->getZExtValue();
+  auto count = cast<ConstantExpr>(countExpr)->getZExtValue();
+  const auto &cfg = state.porNode->configuration();
+
+  std::vector<const por::event::event *> arrivals;
+
+  if (state.needsCatchUp()) {
+    // The round may be completed by another thread than in the execution
+    // the catch-up events stem from, so the barrier_wait event determines it
+    const por::event::event *event = state.peekCatchUp();
+    assert(event->kind() == por::event::event_kind::barrier_wait && event->tid() == state.tid());
+    auto barrier = static_cast<const por::event::barrier_wait *>(event);
+    arrivals.push_back(barrier->thread_predecessor());
+    for (const auto &a : barrier->arrival_predecessors()) {
+      arrivals.push_back(a);
+    }
+  } else {
+    std::size_t waiting = 0;
+    for (auto &[tid, thread] : state.threads) {
+      auto w = thread.isWaitingOn<Thread::wait_barrier_t>();
+      if (w && w->barrier == bid && w->arrivals.empty()) {
+        arrivals.push_back(cfg.last_of_tid(tid));
+        ++waiting;
+      }
+    }
+
+    if (waiting + 1 < count) {
+      state.blockThread(Thread::wait_barrier_t{bid, {}});
+      return;
+    }
+
+    arrivals.push_back(cfg.last_of_tid(state.tid()));
+
+    if (!cfg.barrier_arrivals_follow_last_round(bid, arrivals)) {
+      // a thread of this round could have taken part in the previous round instead,
+      // which would require a choice of participants that is not modeled by barrier_wait events
+      executor.terminateStateOnError(state, "klee_barrier_wait: barrier used by more threads than its count - unsupported", Executor::User);
+      return;
+    }
+  }
+
+  // Release all other threads of this round, the last thread to arrive continues without blocking
+  for (const auto &a : arrivals) {
+    if (a->tid() == state.tid()) {
+      continue;
+    }
+    auto &thread = state.getThreadById(a->tid()).value().get();
+    auto w = thread.isWaitingOn<Thread::wait_barrier_t>();
+    if (w && w->barrier == bid && w->arrivals.empty()) {
+      state.blockThread(thread, Thread::wait_barrier_t{bid, arrivals});
+    }
+  }
+
+  if (!executor.porEventManager.registerBarrierWait(state, bid, arrivals)) {
+    executor.terminateStateSilently(state);
+    return;
+  }
+}
+
+void SpecialFunctionHandler::handleBarrierIsSerial(ExecutionState &state,
+                                                   KInstruction *target,
+                                                   std::vector<ref<Expr>> &arguments) {
+  assert(arguments.size() == 1 && "invalid number of arguments to klee_barrier_is_serial - expected 1");
+
+  ref<Expr> bidExpr = executor.toUnique(state, arguments[0]);
+
+  if (!isa<ConstantExpr>(bidExpr)) {
+    executor.terminateStateOnError(state, "klee_barrier_is_serial", Executor::User);
+    return;
+  }
+
+  auto bid = cast<ConstantExpr>(bidExpr)->getZExtValue();
+  const por::event::event *event = state.porNode->configuration().last_of_tid(state.tid());
+
+  if (event->kind() != por::event::event_kind::barrier_wait || event->bid() != bid) {
+    executor.terminateStateOnError(state, "klee_barrier_is_serial: thread did not just pass this barrier", Executor::User);
+    return;
+  }
+
+  // The serial thread is derived from the event, as the thread completing the
+  // round may differ between executions of the same configuration
+  bool serial = static_cast<const por::event::barrier_wait *>(event)->is_serial();
+  executor.bindLocal(target, state, ConstantExpr::create(serial ? 1 : 0, Expr::Int32));
+}
+
 void SpecialFunctionHandler::handleOutput(klee::ExecutionState &state,
                                           klee::KInstruction *target,
                                           std::vector<klee::ref<klee::Expr>> &arguments) {
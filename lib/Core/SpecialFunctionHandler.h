@@ -161,6 +161,21 @@ namespace klee {
     HANDLER(handleCondWait);
     HANDLER(handleCondSignal);
     HANDLER(handleCondBroadcast);
+
+    HANDLER(handleRwLockRdLock);
+    HANDLER(handleRwLockWrLock);
+    HANDLER(handleRwLockTryRdLock);
+    HANDLER(handleRwLockTryWrLock);
+    HANDLER(handleRwLockUnlock);
+
+    HANDLER(handleSemaphoreInit);
+    HANDLER(handleSemaphorePost);
+    HANDLER(handleSemaphoreWait);
+    HANDLER(handleSemaphoreTryWait);
+    HANDLER(handleSemaphoreGetValue);
+
+    HANDLER(handleBarrierWait);
+    HANDLER(handleBarrierIsSerial);
 #undef HANDLER
   };
 } // End klee namespace
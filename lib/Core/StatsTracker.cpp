@@ -24,8 +24,11 @@
 #include "CoreStats.h"
 #include "Executor.h"
 #include "MemoryManager.h"
+#include "TimingSolver.h"
 #include "UserSearcher.h"
 
+#include "por/unfolding.h"
+
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CFG.h"
@@ -301,6 +304,7 @@ StatsTracker::~StatsTracker() {
     sqlite3_finalize(transactionBeginStmt);
     sqlite3_finalize(transactionEndStmt);
     sqlite3_finalize(insertStmt);
+    sqlite3_finalize(insertOriginStmt);
     sqlite3_close(statsFile);
   }
 }
@@ -452,7 +456,24 @@ void StatsTracker::writeStatsHeader() {
 #ifdef KLEE_ARRAY_DEBUG
 	           << "ArrayHashTime INTEGER,"
 #endif
-             << "QueryCexCacheHits INTEGER"
+             << "QueryCexCacheHits INTEGER,"
+             << "PorRegistrationTime INTEGER,"
+             << "PorRegistrations INTEGER,"
+             << "PorDeduplicationTime INTEGER,"
+             << "PorEventsDeduplicated INTEGER,"
+             << "PorImmediateConflictTime INTEGER,"
+             << "PorCexTime INTEGER,"
+             << "PorCexComputations INTEGER,"
+             << "PorCsdTime INTEGER,"
+             << "PorCsdChecks INTEGER,"
+             << "PorFingerprintTime INTEGER,"
+             << "PorFingerprints INTEGER,"
+             << "PorCutoffTime INTEGER,"
+             << "PorCutoffLookups INTEGER,"
+             << "PorStandbyTime INTEGER,"
+             << "StandbyStates INTEGER,"
+             << "PorCatchUpTime INTEGER,"
+             << "CatchUpInstructions INTEGER"
              << ")";
   char *zErrMsg = nullptr;
   if(sqlite3_exec(statsFile, create.str().c_str(), nullptr, nullptr, &zErrMsg)) {
@@ -488,7 +509,24 @@ void StatsTracker::writeStatsHeader() {
 #ifdef KLEE_ARRAY_DEBUG
              << "ArrayHashTime,"
 #endif
-             << "QueryCexCacheHits "
+             << "QueryCexCacheHits ,"
+             << "PorRegistrationTime ,"
+             << "PorRegistrations ,"
+             << "PorDeduplicationTime ,"
+             << "PorEventsDeduplicated ,"
+             << "PorImmediateConflictTime ,"
+             << "PorCexTime ,"
+             << "PorCexComputations ,"
+             << "PorCsdTime ,"
+             << "PorCsdChecks ,"
+             << "PorFingerprintTime ,"
+             << "PorFingerprints ,"
+             << "PorCutoffTime ,"
+             << "PorCutoffLookups ,"
+             << "PorStandbyTime ,"
+             << "StandbyStates ,"
+             << "PorCatchUpTime ,"
+             << "CatchUpInstructions "
              << ") VALUES ( "
              << "?, "
              << "?, "
@@ -512,12 +550,53 @@ void StatsTracker::writeStatsHeader() {
 #ifdef KLEE_ARRAY_DEBUG
              << "?, "
 #endif
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
+             << "?, "
              << "? "
              << ")";
 
   if(sqlite3_prepare_v2(statsFile, insert.str().c_str(), -1, &insertStmt, nullptr) != SQLITE_OK) {
     klee_error("Cannot create prepared statement: %s", sqlite3_errmsg(statsFile));
   }
+
+  // one row per query origin and stats line, see writeStatsLine()
+  std::ostringstream createOrigins, insertOrigins;
+  createOrigins << "CREATE TABLE query_origins "
+                << "(WallTime REAL,"
+                << "Origin TEXT,"
+                << "Queries INTEGER,"
+                << "CacheHits INTEGER,"
+                << "CoreQueries INTEGER,"
+                << "QueryTime INTEGER";
+  insertOrigins << "INSERT OR FAIL INTO query_origins VALUES (?, ?, ?, ?, ?, ?";
+  for (std::uint64_t bound : QueryOriginStats::latencyBounds) {
+    createOrigins << ",Latency" << bound << "us INTEGER";
+    insertOrigins << ", ?";
+  }
+  createOrigins << ",LatencyOver" << QueryOriginStats::latencyBounds.back()
+                << "us INTEGER)";
+  insertOrigins << ", ?)";
+  if(sqlite3_exec(statsFile, createOrigins.str().c_str(), nullptr, nullptr, &zErrMsg)) {
+    klee_error("%s", sqlite3ErrToStringAndFree("ERROR creating table: ", zErrMsg).c_str());
+  }
+  if(sqlite3_prepare_v2(statsFile, insertOrigins.str().c_str(), -1, &insertOriginStmt, nullptr) != SQLITE_OK) {
+    klee_error("Cannot create prepared statement: %s", sqlite3_errmsg(statsFile));
+  }
 }
 
 time::Span StatsTracker::elapsed() {
@@ -547,11 +626,62 @@ void StatsTracker::writeStatsLine() {
   sqlite3_bind_int64(insertStmt, 20, stats::queryCexCacheHits);
 #ifdef KLEE_ARRAY_DEBUG
   sqlite3_bind_int64(insertStmt, 21, stats::arrayHashTime);
+  int column = 22;
+#else
+  int column = 21;
 #endif
+  std::uint64_t deduplicationTime = 0, eventsDeduplicated = 0;
+  std::uint64_t immediateConflictTime = 0;
+  if (executor.unfolding) {
+    using namespace std::chrono;
+    deduplicationTime = duration_cast<microseconds>(
+        executor.unfolding->deduplication_time()).count();
+    eventsDeduplicated = executor.unfolding->events_deduplicated();
+    immediateConflictTime = duration_cast<microseconds>(
+        executor.unfolding->immediate_conflicts_time()).count();
+  }
+  sqlite3_bind_int64(insertStmt, column++, stats::porRegistrationTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::porRegistrations);
+  sqlite3_bind_int64(insertStmt, column++, deduplicationTime);
+  sqlite3_bind_int64(insertStmt, column++, eventsDeduplicated);
+  sqlite3_bind_int64(insertStmt, column++, immediateConflictTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::porCexTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::porCexComputations);
+  sqlite3_bind_int64(insertStmt, column++, stats::porCsdTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::porCsdChecks);
+  sqlite3_bind_int64(insertStmt, column++, stats::porFingerprintTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::porFingerprints);
+  sqlite3_bind_int64(insertStmt, column++, stats::porCutoffTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::porCutoffLookups);
+  sqlite3_bind_int64(insertStmt, column++, stats::porStandbyTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::standbyStates);
+  sqlite3_bind_int64(insertStmt, column++, stats::porCatchUpTime);
+  sqlite3_bind_int64(insertStmt, column++, stats::catchUpInstructions);
   int errCode = sqlite3_step(insertStmt);
   if(errCode != SQLITE_DONE) klee_error("Error writing stats data: %s", sqlite3_errmsg(statsFile));
   sqlite3_reset(insertStmt);
 
+  std::int64_t wallTime = elapsed().toMicroseconds();
+  for (std::size_t i = 0; i < numQueryOrigins; ++i) {
+    QueryOrigin origin = static_cast<QueryOrigin>(i);
+    const QueryOriginStats &originStats = executor.solver->getOriginStats(origin);
+    if (originStats.queries == 0)
+      continue;
+
+    sqlite3_bind_int64(insertOriginStmt, 1, wallTime);
+    sqlite3_bind_text(insertOriginStmt, 2, getQueryOriginName(origin), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(insertOriginStmt, 3, originStats.queries);
+    sqlite3_bind_int64(insertOriginStmt, 4, originStats.cacheHits);
+    sqlite3_bind_int64(insertOriginStmt, 5, originStats.coreQueries);
+    sqlite3_bind_int64(insertOriginStmt, 6, originStats.time);
+    int column = 7;
+    for (std::uint64_t count : originStats.latency)
+      sqlite3_bind_int64(insertOriginStmt, column++, count);
+    errCode = sqlite3_step(insertOriginStmt);
+    if(errCode != SQLITE_DONE) klee_error("Error writing stats data: %s", sqlite3_errmsg(statsFile));
+    sqlite3_reset(insertOriginStmt);
+  }
+
   statsWriteCount++;
   if(statsWriteCount == statsCommitEvery) {
     errCode = sqlite3_step(transactionEndStmt);
@@ -44,6 +44,7 @@ namespace klee {
     ::sqlite3_stmt *transactionBeginStmt = nullptr;
     ::sqlite3_stmt *transactionEndStmt = nullptr;
     ::sqlite3_stmt *insertStmt = nullptr;
+    ::sqlite3_stmt *insertOriginStmt = nullptr;
     std::uint32_t statsCommitEvery;
     std::uint32_t statsWriteCount = 0;
     time::Point startWallTime;
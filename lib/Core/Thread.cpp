@@ -83,6 +83,7 @@ Thread::Thread(const Thread &t)
           errnoMo(t.errnoMo),
           pathSincePorLocal(t.pathSincePorLocal),
           spawnedThreads(t.spawnedThreads),
+          segmentLease(t.segmentLease),
           fingerprint(t.fingerprint),
           unsynchronizedFrees(t.unsynchronizedFrees),
           symArrayIndex(t.symArrayIndex) {
@@ -105,6 +106,14 @@ bool Thread::isRunnable(const por::configuration &configuration) const noexcept
         return configuration.can_acquire_lock(w.lock);
       } else if constexpr (std::is_same_v<T, wait_join_t>) {
         return configuration.last_of_tid(w.thread)->kind() == por::event::event_kind::thread_exit;
+      } else if constexpr (std::is_same_v<T, wait_rdlock_t>) {
+        return configuration.can_rdacquire_rwlock(w.lock);
+      } else if constexpr (std::is_same_v<T, wait_wrlock_t>) {
+        return configuration.can_wracquire_rwlock(w.lock);
+      } else if constexpr (std::is_same_v<T, wait_semaphore_t>) {
+        return configuration.can_wait_semaphore(w.semaphore);
+      } else if constexpr (std::is_same_v<T, wait_barrier_t>) {
+        return !w.arrivals.empty();
       } else {
         return false;
       }
@@ -138,6 +147,14 @@ MemoryFingerprintDelta Thread::getFingerprintDelta() const {
         copy.updateThreadWaitingOnCV_2Fragment(threadId, w.cond, w.lock);
       } else if constexpr (std::is_same_v<T, Thread::wait_join_t>) {
         copy.updateThreadWaitingOnJoinFragment(threadId, w.thread);
+      } else if constexpr (std::is_same_v<T, Thread::wait_rdlock_t>) {
+        copy.updateThreadWaitingOnRwLockFragment(threadId, w.lock, false);
+      } else if constexpr (std::is_same_v<T, Thread::wait_wrlock_t>) {
+        copy.updateThreadWaitingOnRwLockFragment(threadId, w.lock, true);
+      } else if constexpr (std::is_same_v<T, Thread::wait_semaphore_t>) {
+        copy.updateThreadWaitingOnSemaphoreFragment(threadId, w.semaphore);
+      } else if constexpr (std::is_same_v<T, Thread::wait_barrier_t>) {
+        copy.updateThreadWaitingOnBarrierFragment(threadId, w.barrier, !w.arrivals.empty());
       } else {
         return false;
       }
@@ -12,16 +12,63 @@
 #include "klee/Config/Version.h"
 #include "klee/ExecutionState.h"
 #include "klee/Solver/Solver.h"
+#include "klee/Solver/SolverStats.h"
 #include "klee/Statistics.h"
 #include "klee/TimerStatIncrementer.h"
 
 #include "CoreStats.h"
 
+#include <cassert>
+
 using namespace klee;
 using namespace llvm;
 
 /***/
 
+const char *klee::getQueryOriginName(QueryOrigin origin) {
+  switch (origin) {
+  case QueryOrigin::Other:
+    return "Other";
+  case QueryOrigin::Fork:
+    return "Fork";
+  case QueryOrigin::Resolution:
+    return "Resolution";
+  case QueryOrigin::CatchUp:
+    return "CatchUp";
+  case QueryOrigin::DataRace:
+    return "DataRace";
+  case QueryOrigin::GetValue:
+    return "GetValue";
+  case QueryOrigin::TestGeneration:
+    return "TestGeneration";
+  }
+  assert(0 && "unknown query origin");
+  return "Unknown";
+}
+
+void TimingSolver::recordQuery(const ExecutionState &state, time::Span elapsed,
+                               std::uint64_t coreQueriesBefore) {
+  state.queryCost += elapsed;
+
+  QueryOrigin o = state.needsCatchUp() ? QueryOrigin::CatchUp : origin;
+  QueryOriginStats &s = originStats[static_cast<std::size_t>(o)];
+
+  std::uint64_t coreQueries = stats::queries - coreQueriesBefore;
+  std::uint64_t us = elapsed.toMicroseconds();
+
+  ++s.queries;
+  if (coreQueries == 0)
+    ++s.cacheHits;
+  s.coreQueries += coreQueries;
+  s.time += us;
+
+  std::size_t bucket = 0;
+  while (bucket < QueryOriginStats::latencyBounds.size() &&
+         us >= QueryOriginStats::latencyBounds[bucket])
+    ++bucket;
+  ++s.latency[bucket];
+}
+
 bool TimingSolver::evaluate(const ExecutionState& state, ref<Expr> expr,
                             Solver::Validity &result) {
   // Fast path, to avoid timer and OS overhead.
@@ -31,13 +78,14 @@ bool TimingSolver::evaluate(const ExecutionState& state, ref<Expr> expr,
   }
 
   TimerStatIncrementer timer(stats::solverTime);
+  std::uint64_t coreQueries = stats::queries;
 
   if (simplifyExprs)
     expr = state.constraints.simplifyExpr(expr);
 
   bool success = solver->evaluate(Query(state.constraints, expr), result);
 
-  state.queryCost += timer.delta();
+  recordQuery(state, timer.delta(), coreQueries);
 
   return success;
 }
@@ -51,13 +99,14 @@ bool TimingSolver::mustBeTrue(const ExecutionState& state, ref<Expr> expr,
   }
 
   TimerStatIncrementer timer(stats::solverTime);
+  std::uint64_t coreQueries = stats::queries;
 
   if (simplifyExprs)
     expr = state.constraints.simplifyExpr(expr);
 
   bool success = solver->mustBeTrue(Query(state.constraints, expr), result);
 
-  state.queryCost += timer.delta();
+  recordQuery(state, timer.delta(), coreQueries);
 
   return success;
 }
@@ -94,13 +143,14 @@ bool TimingSolver::getValue(const ExecutionState& state, ref<Expr> expr,
   }
   
   TimerStatIncrementer timer(stats::solverTime);
+  std::uint64_t coreQueries = stats::queries;
 
   if (simplifyExprs)
     expr = state.constraints.simplifyExpr(expr);
 
   bool success = solver->getValue(Query(state.constraints, expr), result);
 
-  state.queryCost += timer.delta();
+  recordQuery(state, timer.delta(), coreQueries);
 
   return success;
 }
@@ -115,12 +165,13 @@ TimingSolver::getInitialValues(const ExecutionState& state,
     return true;
 
   TimerStatIncrementer timer(stats::solverTime);
+  std::uint64_t coreQueries = stats::queries;
 
   bool success = solver->getInitialValues(Query(state.constraints,
                                                 ConstantExpr::alloc(0, Expr::Bool)), 
                                           objects, result);
   
-  state.queryCost += timer.delta();
+  recordQuery(state, timer.delta(), coreQueries);
   
   return success;
 }
@@ -14,12 +14,49 @@
 #include "klee/Solver/Solver.h"
 #include "klee/Internal/System/Time.h"
 
+#include <array>
+#include <cstdint>
 #include <vector>
 
 namespace klee {
   class ExecutionState;
   class Solver;  
 
+  /// Reason for which a query is issued, used to attribute solver costs
+  enum class QueryOrigin : std::uint8_t {
+    Other,
+    /// Branches, switches and other forks
+    Fork,
+    /// Pointer resolution and bounds checks
+    Resolution,
+    /// Any query of a state that is catching up
+    CatchUp,
+    /// Data race detection
+    DataRace,
+    /// klee_get_value and other concretizations of symbolic values
+    GetValue,
+    /// Solving for the inputs of a test case
+    TestGeneration,
+  };
+  constexpr std::size_t numQueryOrigins = 7;
+
+  const char *getQueryOriginName(QueryOrigin origin);
+
+  /// Solver statistics of all queries with the same origin
+  struct QueryOriginStats {
+    /// Upper bounds (exclusive, in microseconds) of the latency histogram
+    /// buckets, the last bucket is unbounded
+    static constexpr std::array<std::uint64_t, 6> latencyBounds = {
+        10, 100, 1000, 10000, 100000, 1000000};
+
+    std::uint64_t queries = 0;
+    /// Queries answered without involving the core solver, e.g. by caches
+    std::uint64_t cacheHits = 0;
+    std::uint64_t coreQueries = 0;
+    std::uint64_t time = 0; // microseconds
+    std::array<std::uint64_t, latencyBounds.size() + 1> latency{};
+  };
+
   /// TimingSolver - A simple class which wraps a solver and handles
   /// tracking the statistics that we care about.
   class TimingSolver {
@@ -27,6 +64,13 @@ namespace klee {
     Solver *solver;
     bool simplifyExprs;
 
+  private:
+    QueryOrigin origin = QueryOrigin::Other;
+    std::array<QueryOriginStats, numQueryOrigins> originStats;
+
+    void recordQuery(const ExecutionState &state, time::Span elapsed,
+                     std::uint64_t coreQueriesBefore);
+
   public:
     /// TimingSolver - Construct a new timing solver.
     ///
@@ -42,6 +86,25 @@ namespace klee {
     void setTimeout(time::Span t) {
       solver->setCoreSolverTimeout(t);
     }
+
+    /// OriginScope - Attributes all queries issued during its lifetime to an
+    /// origin, unless an enclosing scope already set one.
+    class OriginScope {
+      TimingSolver &solver;
+      QueryOrigin previous;
+
+    public:
+      OriginScope(TimingSolver &solver, QueryOrigin origin)
+          : solver(solver), previous(solver.origin) {
+        if (previous == QueryOrigin::Other)
+          solver.origin = origin;
+      }
+      ~OriginScope() { solver.origin = previous; }
+    };
+
+    const QueryOriginStats &getOriginStats(QueryOrigin origin) const {
+      return originStats[static_cast<std::size_t>(origin)];
+    }
     
     char *getConstraintLog(const Query& query) {
       return solver->getConstraintLog(query);
@@ -6,6 +6,7 @@
 #include "klee/Internal/Support/ErrorHandling.h"
 #include "klee/OptionCategories.h"
 #include "klee/PorCmdLine.h"
+#include "klee/TimerStatIncrementer.h"
 
 #include "por/configuration.h"
 #include "por/event/event.h"
@@ -58,6 +59,7 @@ bool PorEventManager::shouldRegisterStandbyState(const ExecutionState &state, po
 
 std::shared_ptr<const ExecutionState> PorEventManager::createStandbyState(const ExecutionState &s, por::event::event_kind kind) {
   if (shouldRegisterStandbyState(s, kind)) {
+    TimerStatIncrementer timer(stats::porStandbyTime);
     auto standby = std::make_shared<const ExecutionState>(s);
     ++stats::standbyStates;
     return standby;
@@ -66,6 +68,9 @@ std::shared_ptr<const ExecutionState> PorEventManager::createStandbyState(const
 }
 
 bool PorEventManager::registerNonLocal(ExecutionState &state, por::extension &&ex, bool snapshotsAllowed) {
+  TimerStatIncrementer timer(stats::porRegistrationTime);
+  ++stats::porRegistrations;
+
   if (DebugEventRegistration) {
     llvm::errs() << "[state id: " << state.id << "] ";
     llvm::errs() << "POR event: " << ex.event->to_string(true) << "\n";
@@ -124,6 +129,9 @@ bool PorEventManager::registerNonLocal(ExecutionState &state, por::extension &&e
 bool PorEventManager::registerLocal(ExecutionState &state,
                                     const std::vector<ExecutionState *> &addedStates,
                                     bool snapshotsAllowed) {
+  TimerStatIncrementer timer(stats::porRegistrationTime);
+  ++stats::porRegistrations;
+
   if (DebugEventRegistration) {
     logEventThreadAndKind(state, por::event::event_kind::local);
 
@@ -499,11 +507,143 @@ bool PorEventManager::registerCondVarWait2(ExecutionState &state, std::uint64_t
   return registerNonLocal(state, std::move(ex));
 }
 
+
+bool PorEventManager::registerAtomicRead(ExecutionState &state, std::uint64_t aId, bool snapshotsAllowed) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::atomic_read);
+
+    llvm::errs() << " on atomic " << aId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().atomic_read(state.tid(), aId);
+  return registerNonLocal(state, std::move(ex), snapshotsAllowed);
+}
+
+bool PorEventManager::registerAtomicWrite(ExecutionState &state, std::uint64_t aId, bool snapshotsAllowed) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::atomic_write);
+
+    llvm::errs() << " on atomic " << aId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().atomic_write(state.tid(), aId);
+  return registerNonLocal(state, std::move(ex), snapshotsAllowed);
+}
+
+bool PorEventManager::registerRwLockRdAcquire(ExecutionState &state, std::uint64_t rwId,
+                                              por::event::rwlock_operation operation) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::rwlock_rdacquire);
+
+    if (operation == por::event::rwlock_operation::trylock) {
+      llvm::errs() << " (try)";
+    }
+    llvm::errs() << " on rwlock " << rwId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().rdacquire_rwlock(state.tid(), rwId, operation);
+  return registerNonLocal(state, std::move(ex));
+}
+
+bool PorEventManager::registerRwLockWrAcquire(ExecutionState &state, std::uint64_t rwId,
+                                              por::event::rwlock_operation operation) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::rwlock_wracquire);
+
+    if (operation == por::event::rwlock_operation::trylock) {
+      llvm::errs() << " (try)";
+    }
+    llvm::errs() << " on rwlock " << rwId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().wracquire_rwlock(state.tid(), rwId, operation);
+  return registerNonLocal(state, std::move(ex));
+}
+
+bool PorEventManager::registerRwLockBusy(ExecutionState &state, std::uint64_t rwId, bool write) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::rwlock_busy);
+
+    llvm::errs() << (write ? " (write)" : " (read)") << " on rwlock " << rwId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().busy_rwlock(state.tid(), rwId, write);
+  return registerNonLocal(state, std::move(ex));
+}
+
+bool PorEventManager::registerRwLockRelease(ExecutionState &state, std::uint64_t rwId) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::rwlock_release);
+
+    llvm::errs() << " on rwlock " << rwId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().release_rwlock(state.tid(), rwId);
+  return registerNonLocal(state, std::move(ex));
+}
+
+bool PorEventManager::registerSemaphoreCreate(ExecutionState &state, std::uint64_t sId, std::size_t value) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::semaphore_create);
+
+    llvm::errs() << " on semaphore " << sId << " with value " << value << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().create_semaphore(state.tid(), sId, value);
+  return registerNonLocal(state, std::move(ex));
+}
+
+bool PorEventManager::registerSemaphorePost(ExecutionState &state, std::uint64_t sId) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::semaphore_post);
+
+    llvm::errs() << " on semaphore " << sId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().post_semaphore(state.tid(), sId);
+  return registerNonLocal(state, std::move(ex));
+}
+
+bool PorEventManager::registerSemaphoreWait(ExecutionState &state, std::uint64_t sId, por::event::semaphore_operation operation) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::semaphore_wait);
+
+    switch (operation) {
+      case por::event::semaphore_operation::wait:
+        break;
+      case por::event::semaphore_operation::trywait:
+        llvm::errs() << " (try)";
+        break;
+      case por::event::semaphore_operation::getvalue:
+        llvm::errs() << " (getvalue)";
+        break;
+    }
+    llvm::errs() << " on semaphore " << sId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().wait_semaphore(state.tid(), sId, operation);
+  return registerNonLocal(state, std::move(ex));
+}
+
+bool PorEventManager::registerBarrierWait(ExecutionState &state, std::uint64_t bId, const std::vector<const por::event::event *> &arrivals) {
+  if (DebugEventRegistration) {
+    logEventThreadAndKind(state, por::event::event_kind::barrier_wait);
+
+    llvm::errs() << " on barrier " << bId << "\n";
+  }
+
+  por::extension ex = state.porNode->configuration().wait_barrier(state.tid(), bId, arrivals);
+  return registerNonLocal(state, std::move(ex));
+}
+
 void PorEventManager::attachMetadata(ExecutionState &state, por::event::event &event) {
   if (!EnableCutoffEvents) {
     return;
   }
 
+  TimerStatIncrementer timer(stats::porFingerprintTime);
+  ++stats::porFingerprints;
+
   MemoryFingerprintValue fingerprint;
   MemoryFingerprintDelta delta;
   std::tie(fingerprint, delta) = computeFingerprintAndDelta(state, event);
@@ -569,6 +709,9 @@ void PorEventManager::findNewCutoff(ExecutionState &state) {
     return;
   }
 
+  TimerStatIncrementer timer(stats::porCutoffTime);
+  ++stats::porCutoffLookups;
+
   assert(!state.porNode->has_event() && state.porNode->parent()->has_event());
   const por::event::event &event = *state.porNode->parent()->event();
 
@@ -616,3 +759,12 @@ void PorEventManager::findNewCutoff(ExecutionState &state) {
     event.mark_as_cutoff();
   }
 }
+
+std::vector<const por::event::event *> PorEventManager::fingerprintEvents() const {
+  std::vector<const por::event::event *> result;
+  result.reserve(fingerprints.size());
+  for (auto &[fingerprint, event] : fingerprints) {
+    result.push_back(event);
+  }
+  return result;
+}
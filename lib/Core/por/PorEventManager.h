@@ -43,7 +43,26 @@ namespace klee {
       bool registerCondVarWait1(ExecutionState &state, std::uint64_t cId, std::uint64_t mId);
       bool registerCondVarWait2(ExecutionState &state, std::uint64_t cId, std::uint64_t mId);
 
+      bool registerAtomicRead(ExecutionState &state, std::uint64_t aId, bool snapshotsAllowed = true);
+      bool registerAtomicWrite(ExecutionState &state, std::uint64_t aId, bool snapshotsAllowed = true);
+
+      bool registerRwLockRdAcquire(ExecutionState &state, std::uint64_t rwId,
+                                   por::event::rwlock_operation operation = por::event::rwlock_operation::lock);
+      bool registerRwLockWrAcquire(ExecutionState &state, std::uint64_t rwId,
+                                   por::event::rwlock_operation operation = por::event::rwlock_operation::lock);
+      bool registerRwLockBusy(ExecutionState &state, std::uint64_t rwId, bool write);
+      bool registerRwLockRelease(ExecutionState &state, std::uint64_t rwId);
+
+      bool registerSemaphoreCreate(ExecutionState &state, std::uint64_t sId, std::size_t value);
+      bool registerSemaphorePost(ExecutionState &state, std::uint64_t sId);
+      bool registerSemaphoreWait(ExecutionState &state, std::uint64_t sId, por::event::semaphore_operation operation);
+
+      bool registerBarrierWait(ExecutionState &state, std::uint64_t bId, const std::vector<const por::event::event *> &arrivals);
+
       void findNewCutoff(ExecutionState &state);
+
+      // events that new events are compared with to detect cutoffs
+      std::vector<const por::event::event *> fingerprintEvents() const;
   };
 };
 
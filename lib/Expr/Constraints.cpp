@@ -11,13 +11,16 @@
 
 #include "klee/Expr/ExprPPrinter.h"
 #include "klee/Expr/ExprVisitor.h"
+#include "klee/Expr/IndependenceIndex.h"
 #include "klee/Internal/Module/KModule.h"
 #include "klee/OptionCategories.h"
 
 #include "llvm/IR/Function.h"
 #include "llvm/Support/CommandLine.h"
 
+#include <algorithm>
 #include <map>
+#include <unordered_map>
 
 using namespace klee;
 
@@ -77,6 +80,7 @@ public:
 bool ConstraintManager::rewriteConstraints(ExprVisitor &visitor) {
   ConstraintManager::constraints_ty old;
   bool changed = false;
+  std::size_t unchangedPrefix = 0;
 
   constraints.swap(old);
   for (ConstraintManager::constraints_ty::iterator 
@@ -85,6 +89,8 @@ bool ConstraintManager::rewriteConstraints(ExprVisitor &visitor) {
     ref<Expr> e = visitor.visit(ce);
 
     if (e!=ce) {
+      if (!changed)
+        unchangedPrefix = constraints.size();
       addConstraintInternal(e); // enable further reductions
       changed = true;
     } else {
@@ -92,9 +98,74 @@ bool ConstraintManager::rewriteConstraints(ExprVisitor &visitor) {
     }
   }
 
+  if (changed && independence &&
+      independence->constraintCount() > unchangedPrefix) {
+    // constraints after the prefix have moved and will be registered again
+    if (independence.use_count() > 1)
+      independence = std::make_shared<IndependenceIndex>(*independence);
+    independence->truncate(unchangedPrefix);
+  }
+
   return changed;
 }
 
+const IndependenceIndex &ConstraintManager::getIndependence() const {
+  if (!independence) {
+    independence = std::make_shared<IndependenceIndex>();
+  } else if (independence->constraintCount() == constraints.size()) {
+    return *independence;
+  } else if (independence.use_count() > 1) {
+    independence = std::make_shared<IndependenceIndex>(*independence);
+  }
+
+  for (std::size_t i = independence->constraintCount(); i < constraints.size(); ++i)
+    independence->addConstraint(constraints[i]);
+  return *independence;
+}
+
+void ConstraintManager::getIndependentConstraints(
+    const ref<Expr> &e, std::vector<ref<Expr>> &result) const {
+  const IndependenceIndex &index = getIndependence();
+  std::vector<unsigned> roots = index.getRoots(e);
+  if (roots.empty())
+    return;
+
+  for (std::size_t i = 0; i < constraints.size(); ++i) {
+    int root = index.getConstraintRoot(i);
+    if (root != IndependenceIndex::noNode &&
+        std::binary_search(roots.begin(), roots.end(), root))
+      result.push_back(constraints[i]);
+  }
+}
+
+std::vector<std::vector<ref<Expr>>>
+ConstraintManager::getIndependentFactors(const ref<Expr> &e) const {
+  const IndependenceIndex &index = getIndependence();
+  std::vector<std::vector<ref<Expr>>> factors;
+  std::unordered_map<unsigned, std::size_t> factorOfRoot;
+
+  if (!e.isNull()) {
+    factors.emplace_back(1, e);
+    for (unsigned root : index.getRoots(e))
+      factorOfRoot[root] = 0;
+  }
+
+  for (std::size_t i = 0; i < constraints.size(); ++i) {
+    int root = index.getConstraintRoot(i);
+    if (root == IndependenceIndex::noNode)
+      continue;
+
+    auto it = factorOfRoot.find(root);
+    if (it == factorOfRoot.end()) {
+      it = factorOfRoot.emplace(root, factors.size()).first;
+      factors.emplace_back();
+    }
+    factors[it->second].push_back(constraints[i]);
+  }
+
+  return factors;
+}
+
 void ConstraintManager::simplifyForValidConstraint(ref<Expr> e) {
   // XXX 
 }
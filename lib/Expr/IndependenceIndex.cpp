@@ -0,0 +1,138 @@
+//===-- IndependenceIndex.cpp ---------------------------------------------===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "klee/Expr/IndependenceIndex.h"
+
+#include "klee/Expr/ExprUtil.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace klee;
+
+namespace {
+// Reads of a constant array without updates don't alias.
+bool isIndependentRead(const ReadExpr &re) {
+  return re.updates.root->isConstantArray() && re.updates.head.isNull();
+}
+} // namespace
+
+unsigned IndependenceIndex::createNode() {
+  unsigned node = parent.size();
+  parent.push_back(node);
+  size.push_back(1);
+  return node;
+}
+
+unsigned IndependenceIndex::find(unsigned node) const {
+  while (parent[node] != node) {
+    parent[node] = parent[parent[node]];
+    node = parent[node];
+  }
+  return node;
+}
+
+unsigned IndependenceIndex::unite(unsigned a, unsigned b) {
+  a = find(a);
+  b = find(b);
+  if (a == b)
+    return a;
+  if (size[a] < size[b])
+    std::swap(a, b);
+  parent[b] = a;
+  size[a] += size[b];
+  return a;
+}
+
+unsigned IndependenceIndex::getElementNode(const Array *array, unsigned index) {
+  ArrayNodes &nodes = arrays[array];
+  if (nodes.whole != noNode)
+    return nodes.whole;
+
+  auto it = nodes.elements.find(index);
+  if (it != nodes.elements.end())
+    return it->second;
+
+  unsigned node = createNode();
+  nodes.elements.insert(std::make_pair(index, node));
+  return node;
+}
+
+unsigned IndependenceIndex::getWholeNode(const Array *array) {
+  ArrayNodes &nodes = arrays[array];
+  if (nodes.whole != noNode)
+    return nodes.whole;
+
+  // a symbolic read may access any of the elements read so far
+  unsigned node = createNode();
+  for (const auto &element : nodes.elements)
+    node = unite(node, element.second);
+  nodes.elements.clear();
+  nodes.whole = node;
+  return node;
+}
+
+void IndependenceIndex::addConstraint(const ref<Expr> &e) {
+  std::vector<ref<ReadExpr>> reads;
+  findReads(e, /* visitUpdates= */ true, reads);
+
+  int node = noNode;
+  for (const auto &re : reads) {
+    if (isIndependentRead(*re))
+      continue;
+
+    const Array *array = re->updates.root;
+    unsigned read;
+    if (const auto *CE = dyn_cast<ConstantExpr>(re->index)) {
+      read = getElementNode(array, static_cast<unsigned>(CE->getZExtValue(32)));
+    } else {
+      read = getWholeNode(array);
+    }
+    node = node == noNode ? read : unite(node, read);
+  }
+
+  constraintNodes.push_back(node);
+}
+
+void IndependenceIndex::truncate(std::size_t count) {
+  assert(count <= constraintNodes.size());
+  constraintNodes.resize(count);
+}
+
+std::vector<unsigned> IndependenceIndex::getRoots(const ref<Expr> &e) const {
+  std::vector<ref<ReadExpr>> reads;
+  findReads(e, /* visitUpdates= */ true, reads);
+
+  std::vector<unsigned> roots;
+  for (const auto &re : reads) {
+    if (isIndependentRead(*re))
+      continue;
+
+    auto it = arrays.find(re->updates.root);
+    if (it == arrays.end())
+      continue;
+    const ArrayNodes &nodes = it->second;
+
+    if (nodes.whole != noNode) {
+      roots.push_back(find(nodes.whole));
+    } else if (const auto *CE = dyn_cast<ConstantExpr>(re->index)) {
+      auto element =
+          nodes.elements.find(static_cast<unsigned>(CE->getZExtValue(32)));
+      if (element != nodes.elements.end())
+        roots.push_back(find(element->second));
+    } else {
+      for (const auto &element : nodes.elements)
+        roots.push_back(find(element.second));
+    }
+  }
+
+  std::sort(roots.begin(), roots.end());
+  roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+  return roots;
+}
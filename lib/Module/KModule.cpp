@@ -524,6 +524,24 @@ KFunction::KFunction(llvm::Function *_function,
       Instruction *inst = &*it;
       ki->inst = inst;
       ki->dest = registerMap[inst];
+      ki->opcode = inst->getOpcode();
+      ki->width = inst->getType()->isSized()
+                      ? km->targetData->getTypeSizeInBits(inst->getType())
+                      : 0;
+
+      ki->targets = nullptr;
+      if (auto *bi = dyn_cast<BranchInst>(inst)) {
+        ki->targets = new unsigned[bi->getNumSuccessors()];
+        for (unsigned j = 0; j < bi->getNumSuccessors(); ++j)
+          ki->targets[j] = basicBlockEntry[bi->getSuccessor(j)];
+      } else if (auto *si = dyn_cast<SwitchInst>(inst)) {
+        ki->targets = new unsigned[si->getNumSuccessors()];
+        for (unsigned j = 0; j < si->getNumSuccessors(); ++j)
+          ki->targets[j] = basicBlockEntry[si->getSuccessor(j)];
+      } else if (auto *ii = dyn_cast<InvokeInst>(inst)) {
+        ki->targets = new unsigned[1];
+        ki->targets[0] = basicBlockEntry[ii->getNormalDest()];
+      }
 
       if (isa<CallInst>(it) || isa<InvokeInst>(it)) {
         CallSite cs(inst);
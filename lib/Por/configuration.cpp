@@ -151,6 +151,36 @@ void configuration::to_dotgraph(std::ostream& os) const noexcept {
 				case por::event::event_kind::broadcast:
 					os << "bro";
 					break;
+				case por::event::event_kind::atomic_read:
+					os << "rd";
+					break;
+				case por::event::event_kind::atomic_write:
+					os << "wr";
+					break;
+				case por::event::event_kind::rwlock_rdacquire:
+					os << "rdl";
+					break;
+				case por::event::event_kind::rwlock_wracquire:
+					os << "wrl";
+					break;
+				case por::event::event_kind::rwlock_release:
+					os << "unl";
+					break;
+				case por::event::event_kind::rwlock_busy:
+					os << "busy";
+					break;
+				case por::event::event_kind::semaphore_create:
+					os << "+S";
+					break;
+				case por::event::event_kind::semaphore_post:
+					os << "post";
+					break;
+				case por::event::event_kind::semaphore_wait:
+					os << "swait";
+					break;
+				case por::event::event_kind::barrier_wait:
+					os << "bar";
+					break;
 				default:
 					assert(0 && "unhandled event_kind!");
 			}
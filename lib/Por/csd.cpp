@@ -128,6 +128,23 @@ namespace por {
 						return has_run(advancement, ev);
 					});
 				} break;
+				case event_kind::semaphore_create: return true;
+				case event_kind::atomic_read:
+				case event_kind::atomic_write:
+				case event_kind::rwlock_rdacquire:
+				case event_kind::rwlock_wracquire:
+				case event_kind::rwlock_release:
+				case event_kind::rwlock_busy:
+				case event_kind::semaphore_post:
+				case event_kind::semaphore_wait:
+				case event_kind::barrier_wait: {
+					// all events this one reads from, overwrites, follows or waits for
+					// (e.g. conflicting critical sections) must have happened before
+					auto preds = ev->predecessors();
+					return std::all_of(preds.begin(), preds.end(), [&advancement, ev](event const* pred) {
+						return pred->tid() == ev->tid() || has_run(advancement, pred);
+					});
+				} break;
 			}
 			assert(false && "unreachable");
 			std::abort();
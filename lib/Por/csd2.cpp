@@ -129,6 +129,27 @@ namespace por {
 							return enabled_t::PREEMPTING_DISABLED;
 						}
 					} break;
+					case event_kind::semaphore_create: return enabled_t::ENABLED;
+					case event_kind::atomic_read:
+					case event_kind::atomic_write:
+					case event_kind::rwlock_rdacquire:
+					case event_kind::rwlock_wracquire:
+					case event_kind::rwlock_release:
+					case event_kind::rwlock_busy:
+					case event_kind::semaphore_post:
+					case event_kind::semaphore_wait:
+					case event_kind::barrier_wait: {
+						// all events this one reads from, overwrites, follows or waits for
+						// (e.g. conflicting critical sections) must have happened before
+						auto preds = ev->predecessors();
+						if(std::all_of(preds.begin(), preds.end(), [this, ev](event const* pred) {
+							return pred->tid() == ev->tid() || has_run(pred);
+						})) {
+							return enabled_t::ENABLED;
+						} else {
+							return enabled_t::PREEMPTING_DISABLED;
+						}
+					} break;
 				}
 				assert(false && "unreachable");
 				std::abort();
@@ -189,6 +210,23 @@ namespace por {
 							return has_run(ev);
 						});
 					} break;
+					case event_kind::semaphore_create: return true;
+					case event_kind::atomic_read:
+					case event_kind::atomic_write:
+					case event_kind::rwlock_rdacquire:
+					case event_kind::rwlock_wracquire:
+					case event_kind::rwlock_release:
+					case event_kind::rwlock_busy:
+					case event_kind::semaphore_post:
+					case event_kind::semaphore_wait:
+					case event_kind::barrier_wait: {
+						// all events this one reads from, overwrites, follows or waits for
+						// (e.g. conflicting critical sections) must have happened before
+						auto preds = ev->predecessors();
+						return std::all_of(preds.begin(), preds.end(), [this, ev](event const* pred) {
+							return pred->tid() == ev->tid() || has_run(pred);
+						});
+					} break;
 				}
 				assert(false && "unreachable");
 				std::abort();
@@ -390,6 +428,16 @@ namespace por {
 					return std::any_of(cond_preds.begin(), cond_preds.end(), [thread_pred](auto const* cond_pred) {
 						return !cond_pred->is_less_than_eq(*thread_pred);
 					});
+				} else if(kind == event_kind::atomic_read || kind == event_kind::atomic_write
+					|| kind == event_kind::rwlock_rdacquire || kind == event_kind::rwlock_wracquire
+					|| kind == event_kind::rwlock_release || kind == event_kind::rwlock_busy
+					|| kind == event_kind::semaphore_post || kind == event_kind::semaphore_wait
+					|| kind == event_kind::barrier_wait) {
+					auto const* thread_pred = ev->thread_predecessor();
+					auto preds = ev->predecessors();
+					return std::any_of(preds.begin(), preds.end(), [thread_pred](auto const* pred) {
+						return !pred->is_less_than_eq(*thread_pred);
+					});
 				} else {
 					return false;
 				}
@@ -4,7 +4,10 @@
 #include "por/event/event.h"
 
 #include <algorithm>
+#include <cassert>
 #include <functional>
+#include <iterator>
+#include <memory>
 #include <vector>
 
 namespace {
@@ -44,83 +47,184 @@ namespace {
 		return a->metadata().id < b->metadata().id ? -1 : 1; // we already checked a == b
 	}
 
-	class parikh_vector {
-		std::vector<por::event::event const*> vector;
+	bool less_event_total_order(por::event::event const* a, por::event::event const* b) {
+		return comp_event_total_order(a, b) < 0;
+	}
+}
 
+namespace por {
+	class erv_cache {
 	public:
-		template<typename T>
-		parikh_vector(T begin, T end) : vector(begin, end) {
-			std::sort(vector.begin(), vector.end(), [](auto a, auto b) {
-				return comp_event_total_order(a, b) < 0;
-			});
+		using layer_t = std::vector<por::event::event const*>;
+
+		// cache of the predecessor of e with the highest depth (nullptr if e has no predecessors)
+		std::shared_ptr<erv_cache const> parent;
+
+		// Foata layers (which are the depths of their events) of [e] that differ from those of [parent],
+		// sorted by layer; the events of each layer are sorted by comp_event_total_order
+		// layers are shared with other caches whenever possible, the last one is always {e}
+		std::vector<std::pair<std::size_t, std::shared_ptr<layer_t const>>> deltas;
+
+		std::size_t depth() const noexcept { return deltas.back().first; }
+	};
+}
+
+namespace {
+	using layer_ref = std::shared_ptr<por::erv_cache::layer_t const> const*;
+
+	// collects all Foata layers of [e] by walking the parent chain of its cache
+	std::vector<layer_ref> layers_of(por::erv_cache const& cache) {
+		std::vector<layer_ref> layers(cache.depth() + 1, nullptr);
+		std::size_t missing = layers.size();
+		for(auto const* c = &cache; c != nullptr && missing > 0; c = c->parent.get()) {
+			for(auto const& [i, layer] : c->deltas) {
+				if(layers[i] == nullptr) {
+					layers[i] = &layer;
+					--missing;
+				}
+			}
 		}
+		assert(missing == 0);
+		return layers;
+	}
+
+	// requires the caches of all predecessors of event
+	std::shared_ptr<por::erv_cache const> make_erv_cache(por::event::event const& event) {
+		auto cache = std::make_shared<por::erv_cache>();
 
-		parikh_vector(std::vector<por::event::event const*>&& v) : vector(std::move(v)) {
-			std::sort(vector.begin(), vector.end(), [](auto a, auto b) {
-				return comp_event_total_order(a, b) < 0;
+		auto preds = event.predecessors();
+		if(preds.begin() != preds.end()) {
+			// [event] consists of event and the union of [p] for all predecessors p,
+			// which are all of lower depth than event
+			auto const* parent = *std::max_element(preds.begin(), preds.end(), [](auto const* a, auto const* b) {
+				return a->depth() < b->depth();
 			});
+			assert(parent->depth() + 1 == event.depth());
+			cache->parent = parent->_erv_cache;
+
+			auto layers = layers_of(*cache->parent);
+			std::vector<std::shared_ptr<por::erv_cache::layer_t const>> merged(layers.size());
+			for(auto const* p : preds) {
+				if(p == parent) {
+					continue;
+				}
+				auto other = layers_of(*p->_erv_cache);
+				for(std::size_t i = 0; i < other.size(); ++i) {
+					auto const& current = merged[i] ? merged[i] : *layers[i];
+					if(current == *other[i]) {
+						continue;
+					}
+					por::erv_cache::layer_t layer;
+					layer.reserve(current->size() + (*other[i])->size());
+					std::set_union(current->begin(), current->end(), (*other[i])->begin(), (*other[i])->end(),
+					               std::back_inserter(layer), less_event_total_order);
+					if(layer.size() == (*other[i])->size()) {
+						merged[i] = *other[i];
+					} else if(layer.size() != current->size()) {
+						merged[i] = std::make_shared<por::erv_cache::layer_t const>(std::move(layer));
+					}
+				}
+			}
+			for(std::size_t i = 0; i < merged.size(); ++i) {
+				if(merged[i]) {
+					cache->deltas.emplace_back(i, std::move(merged[i]));
+				}
+			}
 		}
+		cache->deltas.emplace_back(event.depth(), std::make_shared<por::erv_cache::layer_t const>(por::erv_cache::layer_t{&event}));
 
-		parikh_vector(por::event::event const& lc)
-		: parikh_vector(lc.local_configuration_begin(), lc.local_configuration_end()) { }
+		return cache;
+	}
 
-		auto begin() const noexcept { return vector.cbegin(); }
-		auto end() const noexcept { return vector.cend(); }
-		std::size_t size() const noexcept { return vector.size(); }
+	por::erv_cache const& erv_cache_of(por::event::event const& event) {
+		if(event._erv_cache) {
+			return *event._erv_cache;
+		}
 
-		friend int compare(parikh_vector const& lhs, parikh_vector const& rhs) noexcept {
-			return lex_compare(
-				lhs.begin(), lhs.end(),
-				rhs.begin(), rhs.end(),
-				comp_event_total_order);
+		// fill the caches of all predecessors first (without recursion, as [event] may be deep)
+		std::vector<por::event::event const*> stack{&event};
+		while(!stack.empty()) {
+			auto const* e = stack.back();
+			if(e->_erv_cache) {
+				stack.pop_back();
+				continue;
+			}
+			bool ready = true;
+			for(auto const* p : e->predecessors()) {
+				if(!p->_erv_cache) {
+					stack.push_back(p);
+					ready = false;
+				}
+			}
+			if(ready) {
+				e->_erv_cache = make_erv_cache(*e);
+				stack.pop_back();
+			}
 		}
-	};
 
-	class foata_normal_form {
-		std::vector<parikh_vector> fnf;
+		return *event._erv_cache;
+	}
+
+	// enumerates the Parikh vector of [e] (all its events, sorted by comp_event_total_order)
+	// by merging its Foata layers
+	class parikh_cursor {
+		using range_t = std::pair<por::erv_cache::layer_t::const_iterator, por::erv_cache::layer_t::const_iterator>;
+
+		std::vector<range_t> _heap;
+
+		static bool greater(range_t const& a, range_t const& b) {
+			return less_event_total_order(*b.first, *a.first);
+		}
 
 	public:
-		foata_normal_form(por::event::event const& event) {
-			por::comb C(event.local_configuration());
-			C.sort();
+		explicit parikh_cursor(std::vector<layer_ref> const& layers) {
+			_heap.reserve(layers.size());
+			for(auto const* layer : layers) {
+				_heap.emplace_back((*layer)->begin(), (*layer)->end());
+			}
+			std::make_heap(_heap.begin(), _heap.end(), greater);
+		}
 
-			while(!C.empty()) {
-				fnf.emplace_back(C.min());
-				C.remove(fnf.back().begin(), fnf.back().end());
+		bool done() const noexcept { return _heap.empty(); }
+
+		por::event::event const* next() {
+			std::pop_heap(_heap.begin(), _heap.end(), greater);
+			auto& range = _heap.back();
+			auto const* e = *range.first++;
+			if(range.first == range.second) {
+				_heap.pop_back();
+			} else {
+				std::push_heap(_heap.begin(), _heap.end(), greater);
 			}
+			return e;
 		}
+	};
 
-		bool operator<(foata_normal_form const& rhs) const noexcept {
-			std::size_t num = std::min(fnf.size(), rhs.fnf.size());
-			for(std::size_t i = 0; i < num; ++i) {
-				parikh_vector const& C1j = fnf[i];
-				parikh_vector const& C2j = rhs.fnf[i];
-				if(int res = compare(C1j, C2j); res != 0) {
-					return res < 0;
-				}
+	int compare_parikh(std::vector<layer_ref> const& lhs, std::vector<layer_ref> const& rhs) {
+		parikh_cursor lc(lhs);
+		parikh_cursor rc(rhs);
+		while(!lc.done() && !rc.done()) {
+			if(int res = comp_event_total_order(lc.next(), rc.next()); res != 0) {
+				return res;
 			}
-			return false;
 		}
+		if(lc.done()) {
+			return rc.done() ? 0 : -1;
+		}
+		return 1;
+	}
 
-		std::string to_string() const noexcept {
-			std::stringstream ss;
-			for(auto const& set : fnf) {
-				ss << "{";
-				std::size_t remaining = set.size();
-				std::size_t depth = 0;
-				for(auto const* event : set) {
-					if(!depth) {
-						depth = event->depth();
-					} else {
-						assert(depth == event->depth());
-					}
-					ss << event->to_string(true) << (--remaining ? ", " : "");
-				}
-				ss << "}\n";
+	bool less_foata(std::vector<layer_ref> const& lhs, std::vector<layer_ref> const& rhs) {
+		std::size_t num = std::min(lhs.size(), rhs.size());
+		for(std::size_t i = 0; i < num; ++i) {
+			auto const& C1j = **lhs[i];
+			auto const& C2j = **rhs[i];
+			if(int res = lex_compare(C1j.begin(), C1j.end(), C2j.begin(), C2j.end(), comp_event_total_order); res != 0) {
+				return res < 0;
 			}
-			return ss.str();
 		}
-	};
+		return false;
+	}
 }
 
 namespace por {
@@ -128,14 +232,10 @@ namespace por {
 		std::size_t asize = a.local_configuration_size();
 		std::size_t bsize = b.local_configuration_size();
 		if(asize == bsize) {
-			parikh_vector apv(a), bpv(b);
-			if(int res = compare(apv, bpv); res == 0) {
-				foata_normal_form afnf(a), bfnf(b);
-				if(afnf < bfnf) {
-					return true;
-				} else {
-					return false;
-				}
+			auto ac = layers_of(erv_cache_of(a));
+			auto bc = layers_of(erv_cache_of(b));
+			if(int res = compare_parikh(ac, bc); res == 0) {
+				return less_foata(ac, bc);
 			} else if(res < 0) {
 				return true;
 			} else {
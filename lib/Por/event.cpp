@@ -69,6 +69,78 @@ namespace {
 		return lost->cid() != other->cid();
 	}
 
+	bool atomic_is_independent(por::event::event const* atomic_event, por::event::event const* other) noexcept {
+		assert(atomic_event->kind() == por::event::event_kind::atomic_read
+			|| atomic_event->kind() == por::event::event_kind::atomic_write);
+
+		// dependent iff events access same atomic and at least one of them is a write
+
+		assert(atomic_event->aid());
+
+		if(atomic_event->aid() != other->aid()) {
+			return true;
+		}
+
+		return atomic_event->kind() == por::event::event_kind::atomic_read
+			&& other->kind() == por::event::event_kind::atomic_read;
+	}
+
+	bool rwlock_is_read_mode(por::event::event const* rwlock_event) noexcept {
+		if(rwlock_event->kind() == por::event::event_kind::rwlock_rdacquire) {
+			return true;
+		} else if(rwlock_event->kind() == por::event::event_kind::rwlock_release) {
+			return static_cast<por::event::rwlock_release const*>(rwlock_event)->is_read_release();
+		}
+		return false;
+	}
+
+	bool rwlock_is_independent(por::event::event const* rwlock_event, por::event::event const* other) noexcept {
+		assert(rwlock_event->kind() == por::event::event_kind::rwlock_rdacquire
+			|| rwlock_event->kind() == por::event::event_kind::rwlock_wracquire
+			|| rwlock_event->kind() == por::event::event_kind::rwlock_release
+			|| rwlock_event->kind() == por::event::event_kind::rwlock_busy);
+
+		// dependent iff events operate on same rwlock and at least one of them is in write mode
+		// failed attempts (rwlock_busy) only depend on releases and write acquisitions, which may free
+		// the rwlock or are ordered after them, but neither on read acquisitions nor on each other
+
+		assert(rwlock_event->rwid());
+
+		if(rwlock_event->rwid() != other->rwid()) {
+			return true;
+		}
+
+		if(rwlock_event->kind() == por::event::event_kind::rwlock_busy || other->kind() == por::event::event_kind::rwlock_busy) {
+			auto const* o = rwlock_event->kind() == por::event::event_kind::rwlock_busy ? other : rwlock_event;
+			return o->kind() == por::event::event_kind::rwlock_rdacquire || o->kind() == por::event::event_kind::rwlock_busy;
+		}
+
+		return rwlock_is_read_mode(rwlock_event) && rwlock_is_read_mode(other);
+	}
+
+	bool semaphore_is_independent(por::event::event const* semaphore_event, por::event::event const* other) noexcept {
+		assert(semaphore_event->kind() == por::event::event_kind::semaphore_create
+			|| semaphore_event->kind() == por::event::event_kind::semaphore_post
+			|| semaphore_event->kind() == por::event::event_kind::semaphore_wait);
+
+		// dependent iff events operate on same semaphore and at least one of them is a semaphore_wait
+		// semaphore_create is only ordered by causality, as all operations on the semaphore follow it
+
+		assert(semaphore_event->sid());
+
+		if(semaphore_event->sid() != other->sid()) {
+			return true;
+		}
+
+		if(semaphore_event->kind() == por::event::event_kind::semaphore_create
+			|| other->kind() == por::event::event_kind::semaphore_create) {
+			return true;
+		}
+
+		return semaphore_event->kind() == por::event::event_kind::semaphore_post
+			&& other->kind() == por::event::event_kind::semaphore_post;
+	}
+
 	bool thread_is_independent(por::event::event const* a, por::event::event const* b) {
 		// dependencies besides same-thread:
 		// i:thread_create(j) is dependent on j:thread_init()
@@ -358,6 +430,26 @@ namespace por::event {
 				return thread_is_independent(this, other);
 			}
 
+			case event_kind::atomic_read:
+			case event_kind::atomic_write: {
+				return atomic_is_independent(this, other);
+			}
+			case event_kind::rwlock_rdacquire:
+			case event_kind::rwlock_wracquire:
+			case event_kind::rwlock_release:
+			case event_kind::rwlock_busy: {
+				return rwlock_is_independent(this, other);
+			}
+			case event_kind::semaphore_create:
+			case event_kind::semaphore_post:
+			case event_kind::semaphore_wait: {
+				return semaphore_is_independent(this, other);
+			}
+			case event_kind::barrier_wait: {
+				// all dependencies of a barrier are expressed by its arrival predecessors
+				return true;
+			}
+
 			default: {
 				assert(0 && "not implemented");
 				return false;
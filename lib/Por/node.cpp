@@ -7,7 +7,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
+#include <set>
 #include <sstream>
+#include <type_traits>
+#include <vector>
 
 namespace klee {
 	std::size_t klee_state_id(klee::ExecutionState const*);
@@ -16,6 +20,41 @@ namespace klee {
 using namespace por;
 
 namespace {
+	// free list of node-sized blocks, allocated in chunks
+	class node_pool {
+		static constexpr std::size_t chunk_size = 256;
+
+		using block_t = std::aligned_storage_t<sizeof(node), alignof(node)>;
+
+		std::vector<std::unique_ptr<block_t[]>> _chunks;
+		std::vector<void*> _free;
+
+	public:
+		void* allocate() {
+			if(_free.empty()) {
+				auto& chunk = _chunks.emplace_back(std::make_unique<block_t[]>(chunk_size));
+				// deallocate() must not need to grow _free
+				_free.reserve(_chunks.size() * chunk_size);
+				for(std::size_t i = chunk_size; i > 0; --i) {
+					_free.push_back(&chunk[i - 1]);
+				}
+			}
+			void* ptr = _free.back();
+			_free.pop_back();
+			return ptr;
+		}
+
+		void deallocate(void* ptr) noexcept {
+			_free.push_back(ptr);
+		}
+	};
+
+	node_pool& pool() {
+		// never destroyed, nodes may outlive other static objects
+		static node_pool* p = new node_pool();
+		return *p;
+	}
+
 	using atomic_pair_map_t = std::map<por::event::event const*, por::event::event const*>;
 
 	static void extract_atomic_pairs(por::comb& comb, atomic_pair_map_t& map) {
@@ -37,6 +76,17 @@ namespace {
 	}
 }
 
+void* node::operator new(std::size_t size) {
+	assert(size == sizeof(node));
+	return pool().allocate();
+}
+
+void node::operator delete(void* ptr) noexcept {
+	if(ptr) {
+		pool().deallocate(ptr);
+	}
+}
+
 node* node::make_left_child(por::event::event const* event) {
 	assert(!_left && "node already has left child");
 	assert(!_event && "node must not have an event yet");
@@ -108,9 +158,7 @@ node* node::make_right_child() {
 	assert(!_right && "node already has right child");
 	assert(_event && "no event attached to node");
 
-	auto D = _D;
-	D.emplace_back(_event);
-	_right = allocate_right_child(D);
+	_right = allocate_right_child(_D.push(_event));
 
 	_right->_standby_state = _standby_state;
 
@@ -169,12 +217,15 @@ por::leaf node::make_right_branch(por::comb A) {
 	}
 	assert(s != nullptr);
 
+	// catch up on the events of rschedule() that follow s
 	auto s_last = s->last_included_event();
-	for(auto& r : rschedule()) {
-		if(r == s_last) {
-			break;
-		}
-		catch_up.push_front(r);
+	auto it = branch_begin();
+	assert(it != branch_end() && *it == this);
+	for(++it; it != branch_end() && (*it)->_event != s_last; ++it) {
+		catch_up.push_front((*it)->_event);
+	}
+	if(it == branch_end() && s_last != &_C->unfolding()->root()) {
+		catch_up.push_front(&_C->unfolding()->root());
 	}
 
 	atomic_pair_map_t atomic_pairs;
@@ -240,7 +291,7 @@ std::vector<por::leaf> node::create_right_branches(std::vector<node*> B) {
 
 		assert(n->_event != nullptr);
 		por::configuration const& cfg = n->configuration();
-		auto D = n->_D;
+		auto D = n->_D.to_vector();
 		D.push_back(n->_event);
 		por::event::event const* j = cfg.compute_alternative(std::move(D));
 
@@ -325,6 +376,42 @@ void node::backtrack() {
 	n->update_sweep_bit();
 }
 
+std::vector<por::event::event const*> node::live_events() const noexcept {
+	std::vector<por::event::event const*> result;
+	std::set<por::event::event const*> visited;
+
+	std::stack<node const*> S;
+	S.push(this);
+	while(!S.empty()) {
+		node const* n = S.top();
+		S.pop();
+
+		if(n->_event) {
+			result.push_back(n->_event);
+		}
+		result.insert(result.end(), n->_D.begin(), n->_D.end());
+
+		if(n->_C) {
+			for(auto& [tid, head] : n->_C->thread_heads()) {
+				// configurations of nodes share most of their events: stop at the
+				// first event already visited, its predecessors were visited as well
+				for(auto* e = head; e != nullptr && visited.insert(e).second; e = e->thread_predecessor()) {
+					result.push_back(e);
+				}
+			}
+		}
+
+		if(n->_left) {
+			S.push(n->_left.get());
+		}
+		if(n->_right) {
+			S.push(n->_right.get());
+		}
+	}
+
+	return result;
+}
+
 std::string node::to_string(bool with_schedule) const noexcept {
 	std::ostringstream result;
 	result << "node " << this << "\n";
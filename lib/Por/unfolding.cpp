@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <unordered_set>
 
 using namespace por;
 
@@ -12,6 +13,51 @@ unfolding::unfolding() {
 	_root = store_event(std::make_unique<por::event::program_init>(por::event::program_init{}));
 }
 
+std::size_t unfolding::prune(std::vector<por::event::event const*> const& live) {
+	std::unordered_set<por::event::event const*> keep;
+	keep.insert(_root);
+	for(auto* e : live) {
+		keep.insert(e);
+		for(auto* c : e->immediate_conflicts()) {
+			keep.insert(c);
+		}
+	}
+
+	// causal predecessors of kept events always have successors, so only
+	// maximal events have to be considered, starting a new round for their
+	// predecessors once all successors are removed
+	std::vector<por::event::event const*> worklist;
+	for(auto& [key, events] : _events) {
+		for(auto& e : events) {
+			if(!e->has_successors() && keep.count(e.get()) == 0) {
+				worklist.push_back(e.get());
+			}
+		}
+	}
+
+	std::size_t removed = 0;
+	while(!worklist.empty()) {
+		por::event::event const* e = worklist.back();
+		worklist.pop_back();
+
+		std::vector<por::event::event const*> preds(e->predecessors().begin(), e->predecessors().end());
+		std::sort(preds.begin(), preds.end());
+		preds.erase(std::unique(preds.begin(), preds.end()), preds.end());
+
+		remove_event(*e); // also removes e from the successors of its predecessors
+		++removed;
+
+		for(auto* p : preds) {
+			if(p != nullptr && !p->has_successors() && keep.count(p) == 0) {
+				worklist.push_back(p);
+			}
+		}
+	}
+
+	stats_inc_events_pruned(removed);
+	return removed;
+}
+
 // NOTE: shallow compare, only compares pointers of predecessors
 bool unfolding::compare_events(por::event::event const& a, por::event::event const& b) {
 	if(&a == &b)
@@ -32,6 +78,18 @@ bool unfolding::compare_events(por::event::event const& a, por::event::event con
 	if(a.cid() != b.cid())
 		return false;
 
+	if(a.aid() != b.aid())
+		return false;
+
+	if(a.rwid() != b.rwid())
+		return false;
+
+	if(a.sid() != b.sid())
+		return false;
+
+	if(a.bid() != b.bid())
+		return false;
+
 	if(a.atomic_predecessor() != b.atomic_predecessor())
 		return false;
 
@@ -45,6 +103,39 @@ bool unfolding::compare_events(por::event::event const& a, por::event::event con
 		if(!a.has_same_local_path(b)) {
 			return false;
 		}
+	} else if(a.kind() == por::event::event_kind::semaphore_create) {
+		auto create_a = static_cast<por::event::semaphore_create const*>(&a);
+		auto create_b = static_cast<por::event::semaphore_create const*>(&b);
+		if(create_a->value() != create_b->value()) {
+			return false;
+		}
+	} else if(a.kind() == por::event::event_kind::semaphore_wait) {
+		auto wait_a = static_cast<por::event::semaphore_wait const*>(&a);
+		auto wait_b = static_cast<por::event::semaphore_wait const*>(&b);
+		if(wait_a->operation() != wait_b->operation()) {
+			return false;
+		}
+	} else if(a.kind() == por::event::event_kind::rwlock_rdacquire) {
+		auto acq_a = static_cast<por::event::rwlock_rdacquire const*>(&a);
+		auto acq_b = static_cast<por::event::rwlock_rdacquire const*>(&b);
+		if(acq_a->operation() != acq_b->operation()) {
+			return false;
+		}
+	} else if(a.kind() == por::event::event_kind::rwlock_wracquire) {
+		auto acq_a = static_cast<por::event::rwlock_wracquire const*>(&a);
+		auto acq_b = static_cast<por::event::rwlock_wracquire const*>(&b);
+		if(acq_a->operation() != acq_b->operation()) {
+			return false;
+		}
+	} else if(a.kind() == por::event::event_kind::rwlock_busy) {
+		auto busy_a = static_cast<por::event::rwlock_busy const*>(&a);
+		auto busy_b = static_cast<por::event::rwlock_busy const*>(&b);
+		if(busy_a->is_write_attempt() != busy_b->is_write_attempt()) {
+			return false;
+		}
+		if(busy_a->write_predecessor() != busy_b->write_predecessor()) {
+			return false;
+		}
 	}
 
 	auto a_preds = a.predecessors();
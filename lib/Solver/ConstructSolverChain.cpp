@@ -40,6 +40,12 @@ Solver *constructSolverChain(Solver *coreSolver,
                  baseSolverQuerySMT2LogPath.c_str());
   }
 
+  // outside of the loggers above, which should only see queries that are
+  // actually solved
+  if (!SolverCacheFile.empty())
+    solver = createPersistentCachingSolver(
+        solver, SolverCacheFile, std::uint64_t(SolverCacheSize) << 20);
+
   if (UseAssignmentValidatingSolver)
     solver = createAssignmentValidatingSolver(solver);
 
@@ -0,0 +1,78 @@
+//===-- IncrementalFrames.h -------------------------------------*- C++ -*-===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef KLEE_INCREMENTALFRAMES_H
+#define KLEE_INCREMENTALFRAMES_H
+
+#include "klee/Expr/Constraints.h"
+#include "klee/Expr/Expr.h"
+#include "klee/Solver/SolverStats.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace klee {
+
+/// Bookkeeping for core solvers that keep constraints asserted between
+/// queries (-solver-incremental). The constraints of each query that were not
+/// yet asserted are asserted together in a new push/pop frame of the solver,
+/// so consecutive queries sharing a prefix of their constraints (e.g. those of
+/// one state) only assert the constraints added since the previous query.
+class IncrementalFrames {
+  std::vector<ref<Expr>> asserted;
+  /// Number of asserted constraints at the end of each frame
+  std::vector<std::size_t> frameEnds;
+
+public:
+  /// Number of frames that have to be popped so that the remaining frames
+  /// only contain a prefix of \a constraints. The frames are considered
+  /// popped afterwards.
+  std::size_t align(const ConstraintManager &constraints) {
+    std::size_t prefix = 0;
+    auto it = constraints.begin();
+    while (prefix < asserted.size() && it != constraints.end() &&
+           asserted[prefix].get() == it->get()) {
+      ++prefix;
+      ++it;
+    }
+
+    std::size_t popped = 0;
+    while (!frameEnds.empty() && frameEnds.back() > prefix) {
+      frameEnds.pop_back();
+      ++popped;
+    }
+    asserted.resize(frameEnds.empty() ? 0 : frameEnds.back());
+
+    stats::queryConstraintsReused += asserted.size();
+    stats::queryConstraintsAsserted += constraints.size() - asserted.size();
+    return popped;
+  }
+
+  /// Constraints from this index on have to be asserted in a new frame
+  std::size_t assertedCount() const noexcept { return asserted.size(); }
+
+  /// Record that all constraints not yet asserted were asserted in a new frame
+  void pushFrame(const ConstraintManager &constraints) {
+    asserted.insert(asserted.end(), constraints.begin() + asserted.size(),
+                    constraints.end());
+    frameEnds.push_back(asserted.size());
+  }
+
+  /// Forget all frames, returning how many have to be popped
+  std::size_t popAll() {
+    std::size_t popped = frameEnds.size();
+    asserted.clear();
+    frameEnds.clear();
+    return popped;
+  }
+};
+
+} // namespace klee
+
+#endif /* KLEE_INCREMENTALFRAMES_H */
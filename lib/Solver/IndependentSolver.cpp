@@ -19,85 +19,86 @@
 
 #include "llvm/Support/raw_ostream.h"
 
-#include <list>
+#include <algorithm>
+#include <cstdint>
 #include <map>
+#include <set>
 #include <ostream>
 #include <vector>
 
 using namespace klee;
 using namespace llvm;
 
-template<class T>
+/// Set of array indices, stored as a bitset
 class DenseSet {
-  typedef std::set<T> set_ty;
-  set_ty s;
+  std::vector<uint64_t> words;
 
 public:
   DenseSet() {}
 
-  void add(T x) {
-    s.insert(x);
+  void add(unsigned x) {
+    if (x / 64 >= words.size())
+      words.resize(x / 64 + 1, 0);
+    words[x / 64] |= static_cast<uint64_t>(1) << (x % 64);
   }
-  void add(T start, T end) {
+  void add(unsigned start, unsigned end) {
     for (; start<end; start++)
-      s.insert(start);
+      add(start);
   }
 
   // returns true iff set is changed by addition
   bool add(const DenseSet &b) {
+    if (b.words.size() > words.size())
+      words.resize(b.words.size(), 0);
     bool modified = false;
-    for (typename set_ty::const_iterator it = b.s.begin(), ie = b.s.end(); 
-         it != ie; ++it) {
-      if (modified || !s.count(*it)) {
+    for (std::size_t i = 0; i < b.words.size(); ++i) {
+      if (b.words[i] & ~words[i]) {
         modified = true;
-        s.insert(*it);
+        words[i] |= b.words[i];
       }
     }
     return modified;
   }
 
-  bool intersects(const DenseSet &b) {
-    for (typename set_ty::iterator it = s.begin(), ie = s.end(); 
-         it != ie; ++it)
-      if (b.s.count(*it))
+  bool intersects(const DenseSet &b) const {
+    std::size_t n = std::min(words.size(), b.words.size());
+    for (std::size_t i = 0; i < n; ++i)
+      if (words[i] & b.words[i])
         return true;
     return false;
   }
 
-  std::set<unsigned>::iterator begin(){
-    return s.begin();
-  }
-
-  std::set<unsigned>::iterator end(){
-    return s.end();
+  template <typename Callback> void forEach(Callback &&callback) const {
+    for (std::size_t i = 0; i < words.size(); ++i) {
+      for (uint64_t word = words[i]; word != 0; word &= word - 1)
+        callback(static_cast<unsigned>(i * 64 + __builtin_ctzll(word)));
+    }
   }
 
   void print(llvm::raw_ostream &os) const {
     bool first = true;
     os << "{";
-    for (typename set_ty::iterator it = s.begin(), ie = s.end(); 
-         it != ie; ++it) {
+    forEach([&](unsigned x) {
       if (first) {
         first = false;
       } else {
         os << ",";
       }
-      os << *it;
-    }
+      os << x;
+    });
     os << "}";
   }
 };
 
-template <class T>
 inline llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
-                                     const ::DenseSet<T> &dis) {
+                                     const ::DenseSet &dis) {
   dis.print(os);
   return os;
 }
 
 class IndependentElementSet {
 public:
-  typedef std::map<const Array*, ::DenseSet<unsigned> > elements_ty;
+  typedef std::map<const Array*, ::DenseSet > elements_ty;
   elements_ty elements;                 // Represents individual elements of array accesses (arr[1])
   std::set<const Array*> wholeObjects;  // Represents symbolically accessed arrays (arr[x])
   std::vector<ref<Expr> > exprs;        // All expressions that are associated with this factor
@@ -127,7 +128,7 @@ public:
         if (ConstantExpr *CE = dyn_cast<ConstantExpr>(re->index)) {
           // if index constant, then add to set of constraints operating
           // on that array (actually, don't add constraint, just set index)
-          ::DenseSet<unsigned> &dis = elements[array];
+          ::DenseSet &dis = elements[array];
           dis.add((unsigned) CE->getZExtValue(32));
         } else {
           elements_ty::iterator it2 = elements.find(array);
@@ -168,7 +169,7 @@ public:
     for (elements_ty::const_iterator it = elements.begin(), ie = elements.end();
          it != ie; ++it) {
       const Array *array = it->first;
-      const ::DenseSet<unsigned> &dis = it->second;
+      const ::DenseSet &dis = it->second;
 
       if (first) {
         first = false;
@@ -181,32 +182,6 @@ public:
     os << "}";
   }
 
-  // more efficient when this is the smaller set
-  bool intersects(const IndependentElementSet &b) {
-    // If there are any symbolic arrays in our query that b accesses
-    for (std::set<const Array*>::iterator it = wholeObjects.begin(), 
-           ie = wholeObjects.end(); it != ie; ++it) {
-      const Array *array = *it;
-      if (b.wholeObjects.count(array) || 
-          b.elements.find(array) != b.elements.end())
-        return true;
-    }
-    for (elements_ty::iterator it = elements.begin(), ie = elements.end();
-         it != ie; ++it) {
-      const Array *array = it->first;
-      // if the array we access is symbolic in b
-      if (b.wholeObjects.count(array))
-        return true;
-      elements_ty::const_iterator it2 = b.elements.find(array);
-      // if any of the elements we access are also accessed by b
-      if (it2 != b.elements.end()) {
-        if (it->second.intersects(it2->second))
-          return true;
-      }
-    }
-    return false;
-  }
-
   // returns true iff set is changed by addition
   bool add(const IndependentElementSet &b) {
     for(unsigned i = 0; i < b.exprs.size(); i ++){
@@ -257,97 +232,31 @@ inline llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
 
 // Breaks down a constraint into all of it's individual pieces, returning a
 // list of IndependentElementSets or the independent factors.
-//
-// Caller takes ownership of returned std::list.
-static std::list<IndependentElementSet>*
+static std::vector<IndependentElementSet>
 getAllIndependentConstraintsSets(const Query &query) {
-  std::list<IndependentElementSet> *factors = new std::list<IndependentElementSet>();
+  ref<Expr> neg;
   ConstantExpr *CE = dyn_cast<ConstantExpr>(query.expr);
   if (CE) {
     assert(CE && CE->isFalse() && "the expr should always be false and "
                                   "therefore not included in factors");
   } else {
-    ref<Expr> neg = Expr::createIsZero(query.expr);
-    factors->push_back(IndependentElementSet(neg));
+    neg = Expr::createIsZero(query.expr);
   }
 
-  for (ConstraintManager::const_iterator it = query.constraints.begin(),
-                                         ie = query.constraints.end();
-       it != ie; ++it) {
-    // iterate through all the previously separated constraints.  Until we
-    // actually return, factors is treated as a queue of expressions to be
-    // evaluated.  If the queue property isn't maintained, then the exprs
-    // could be returned in an order different from how they came it, negatively
-    // affecting later stages.
-    factors->push_back(IndependentElementSet(*it));
+  std::vector<IndependentElementSet> factors;
+  for (const auto &exprs : query.constraints.getIndependentFactors(neg)) {
+    IndependentElementSet factor(exprs.front());
+    for (std::size_t i = 1; i < exprs.size(); ++i)
+      factor.add(IndependentElementSet(exprs[i]));
+    factors.push_back(std::move(factor));
   }
 
-  bool doneLoop = false;
-  do {
-    doneLoop = true;
-    std::list<IndependentElementSet> *done =
-        new std::list<IndependentElementSet>;
-    while (factors->size() > 0) {
-      IndependentElementSet current = factors->front();
-      factors->pop_front();
-      // This list represents the set of factors that are separate from current.
-      // Those that are not inserted into this list (queue) intersect with
-      // current.
-      std::list<IndependentElementSet> *keep =
-          new std::list<IndependentElementSet>;
-      while (factors->size() > 0) {
-        IndependentElementSet compare = factors->front();
-        factors->pop_front();
-        if (current.intersects(compare)) {
-          if (current.add(compare)) {
-            // Means that we have added (z=y)added to (x=y)
-            // Now need to see if there are any (z=?)'s
-            doneLoop = false;
-          }
-        } else {
-          keep->push_back(compare);
-        }
-      }
-      done->push_back(current);
-      delete factors;
-      factors = keep;
-    }
-    delete factors;
-    factors = done;
-  } while (!doneLoop);
-
   return factors;
 }
 
-static 
-IndependentElementSet getIndependentConstraints(const Query& query,
-                                                std::vector< ref<Expr> > &result) {
-  IndependentElementSet eltsClosure(query.expr);
-  std::vector< std::pair<ref<Expr>, IndependentElementSet> > worklist;
-
-  for (ConstraintManager::const_iterator it = query.constraints.begin(), 
-         ie = query.constraints.end(); it != ie; ++it)
-    worklist.push_back(std::make_pair(*it, IndependentElementSet(*it)));
-
-  // XXX This should be more efficient (in terms of low level copy stuff).
-  bool done = false;
-  do {
-    done = true;
-    std::vector< std::pair<ref<Expr>, IndependentElementSet> > newWorklist;
-    for (std::vector< std::pair<ref<Expr>, IndependentElementSet> >::iterator
-           it = worklist.begin(), ie = worklist.end(); it != ie; ++it) {
-      if (it->second.intersects(eltsClosure)) {
-        if (eltsClosure.add(it->second))
-          done = false;
-        result.push_back(it->first);
-        // Means that we have added (z=y)added to (x=y)
-        // Now need to see if there are any (z=?)'s
-      } else {
-        newWorklist.push_back(*it);
-      }
-    }
-    worklist.swap(newWorklist);
-  } while (!done);
+static void getIndependentConstraints(const Query &query,
+                                      std::vector<ref<Expr>> &result) {
+  query.constraints.getIndependentConstraints(query.expr, result);
 
   KLEE_DEBUG(
     std::set< ref<Expr> > reqset(result.begin(), result.end());
@@ -361,11 +270,7 @@ IndependentElementSet getIndependentConstraints(const Query& query,
       errs() << " " << (reqset.count(*it) ? "(required)" : "(independent)") << "\n";
       errs() << "\telts: " << IndependentElementSet(*it) << "\n";
     }
-    errs() << "elts closure: " << eltsClosure << "\n";
  );
-
-
-  return eltsClosure;
 }
 
 
@@ -375,7 +280,7 @@ static
 void calculateArrayReferences(const IndependentElementSet & ie,
                               std::vector<const Array *> &returnVector){
   std::set<const Array*> thisSeen;
-  for(std::map<const Array*, ::DenseSet<unsigned> >::const_iterator it = ie.elements.begin();
+  for(std::map<const Array*, ::DenseSet >::const_iterator it = ie.elements.begin();
       it != ie.elements.end(); it ++){
     thisSeen.insert(it->first);
   }
@@ -413,8 +318,7 @@ public:
 bool IndependentSolver::computeValidity(const Query& query,
                                         Solver::Validity &result) {
   std::vector< ref<Expr> > required;
-  IndependentElementSet eltsClosure =
-    getIndependentConstraints(query, required);
+  getIndependentConstraints(query, required);
   ConstraintManager tmp(required);
   return solver->impl->computeValidity(Query(tmp, query.expr), 
                                        result);
@@ -422,8 +326,7 @@ bool IndependentSolver::computeValidity(const Query& query,
 
 bool IndependentSolver::computeTruth(const Query& query, bool &isValid) {
   std::vector< ref<Expr> > required;
-  IndependentElementSet eltsClosure = 
-    getIndependentConstraints(query, required);
+  getIndependentConstraints(query, required);
   ConstraintManager tmp(required);
   return solver->impl->computeTruth(Query(tmp, query.expr), 
                                     isValid);
@@ -431,8 +334,7 @@ bool IndependentSolver::computeTruth(const Query& query, bool &isValid) {
 
 bool IndependentSolver::computeValue(const Query& query, ref<Expr> &result) {
   std::vector< ref<Expr> > required;
-  IndependentElementSet eltsClosure = 
-    getIndependentConstraints(query, required);
+  getIndependentConstraints(query, required);
   ConstraintManager tmp(required);
   return solver->impl->computeValue(Query(tmp, query.expr), result);
 }
@@ -481,14 +383,11 @@ bool IndependentSolver::computeInitialValues(const Query& query,
   // This is important in case we don't have any constraints but
   // we need initial values for requested array objects.
   hasSolution = true;
-  // FIXME: When we switch to C++11 this should be a std::unique_ptr so we don't need
-  // to remember to manually call delete
-  std::list<IndependentElementSet> *factors = getAllIndependentConstraintsSets(query);
+  std::vector<IndependentElementSet> factors = getAllIndependentConstraintsSets(query);
 
   //Used to rearrange all of the answers into the correct order
   std::map<const Array*, std::vector<unsigned char> > retMap;
-  for (std::list<IndependentElementSet>::iterator it = factors->begin();
-       it != factors->end(); ++it) {
+  for (auto it = factors.begin(); it != factors.end(); ++it) {
     std::vector<const Array*> arraysInFactor;
     calculateArrayReferences(*it, arraysInFactor);
     // Going to use this as the "fresh" expression for the Query() invocation below
@@ -501,11 +400,9 @@ bool IndependentSolver::computeInitialValues(const Query& query,
     if (!solver->impl->computeInitialValues(Query(tmp, ConstantExpr::alloc(0, Expr::Bool)),
                                             arraysInFactor, tempValues, hasSolution)){
       values.clear();
-      delete factors;
       return false;
     } else if (!hasSolution){
       values.clear();
-      delete factors;
       return true;
     } else {
       assert(tempValues.size() == arraysInFactor.size() &&
@@ -518,11 +415,9 @@ bool IndependentSolver::computeInitialValues(const Query& query,
           std::vector<unsigned char> * tempPtr = &retMap[arraysInFactor[i]];
           assert(tempPtr->size() == tempValues[i].size() &&
                  "we're talking about the same array here");
-          ::DenseSet<unsigned> * ds = &(it->elements[arraysInFactor[i]]);
-          for (std::set<unsigned>::iterator it2 = ds->begin(); it2 != ds->end(); it2++){
-            unsigned index = * it2;
+          it->elements[arraysInFactor[i]].forEach([&](unsigned index) {
             (* tempPtr)[index] = tempValues[i][index];
-          }
+          });
         } else {
           // Dump all the new values into the array
           retMap[arraysInFactor[i]] = tempValues[i];
@@ -544,7 +439,6 @@ bool IndependentSolver::computeInitialValues(const Query& query,
     }
   }
   assert(assertCreatedPointEvaluatesToTrue(query, objects, values, retMap) && "should satisfy the equation");
-  delete factors;
   return true;
 }
 
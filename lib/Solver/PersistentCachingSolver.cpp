@@ -0,0 +1,548 @@
+//===-- PersistentCachingSolver.cpp ---------------------------------------===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// A query cache that is stored in a memory-mapped file and thus survives the
+// process, so that repeated runs on the same (or a slightly changed) program
+// can reuse the results of the core solver.
+//
+// Queries are identified by a 128-bit hash of their structure. Arrays are
+// hashed without their name (like ArrayHashWithoutNameFn) but numbered in the
+// order of their first occurrence, so that the hash does not depend on the
+// names KLEE chose for the arrays in a particular run.
+//
+// The file consists of a FileHeader, an open addressing hash table of Slots
+// and a data area holding the Records. A slot is published by atomically
+// setting its offset, after which it is never changed again. Readers do not
+// take any locks; writers (of any process) are serialized with flock().
+//
+//===----------------------------------------------------------------------===//
+
+#include "klee/Solver/Solver.h"
+
+#include "klee/Expr/Constraints.h"
+#include "klee/Expr/Expr.h"
+#include "klee/Internal/Support/ErrorHandling.h"
+#include "klee/Solver/SolverImpl.h"
+#include "klee/Solver/SolverStats.h"
+
+#include "llvm/ADT/APInt.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace klee;
+
+namespace {
+
+constexpr char CacheMagic[8] = {'K', 'Q', 'C', 'A', 'C', 'H', 'E', '\0'};
+constexpr std::uint32_t CacheVersion = 1;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "atomics in the shared mapping must be lock-free");
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t reserved;
+  /// number of slots, a power of two
+  std::uint64_t slotCount;
+  std::uint64_t fileSize;
+  /// offset of the first unused byte of the data area
+  std::atomic<std::uint64_t> dataEnd;
+  std::atomic<std::uint64_t> entries;
+};
+
+struct QueryHash {
+  std::uint64_t low = 0, high = 0;
+
+  bool operator==(const QueryHash &other) const {
+    return low == other.low && high == other.high;
+  }
+};
+
+struct Slot {
+  QueryHash hash;
+  /// offset of the Record, 0 while the slot is unused
+  std::atomic<std::uint64_t> offset;
+};
+
+struct Record {
+  std::uint32_t result;
+  std::uint32_t payloadSize;
+};
+
+static_assert(sizeof(FileHeader) == 48, "unexpected padding");
+static_assert(sizeof(Slot) == 24, "unexpected padding");
+static_assert(sizeof(Record) == 8, "unexpected padding");
+
+/// Part of the hash that distinguishes the different kinds of queries
+enum class QueryKind : std::uint64_t {
+  Validity = 1,
+  Truth,
+  Value,
+  InitialValues,
+};
+
+std::uint64_t mix(std::uint64_t x) {
+  // finalizer of SplitMix64
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+class HashBuilder {
+  // two independently mixed halves
+  QueryHash hash = {0x243f6a8885a308d3ULL, 0x13198a2e03707344ULL};
+
+public:
+  void add(std::uint64_t value) {
+    hash.low = mix(hash.low ^ value);
+    hash.high = mix(hash.high + value * 0x9e3779b97f4a7c15ULL);
+  }
+
+  void add(const QueryHash &value) {
+    add(value.low);
+    add(value.high);
+  }
+
+  const QueryHash &get() const { return hash; }
+};
+
+/// Computes a hash of queries that is independent of the names and addresses
+/// of the arrays and expressions, i.e. is stable across runs.
+class CanonicalQueryHasher {
+  std::unordered_map<const Expr *, QueryHash> exprs;
+  std::unordered_map<const UpdateNode *, QueryHash> updates;
+  std::unordered_map<const Array *, std::uint64_t> arrays;
+
+  std::uint64_t arrayId(const Array *array) {
+    return arrays.emplace(array, arrays.size()).first->second;
+  }
+
+  QueryHash hashArray(const Array *array) {
+    HashBuilder hash;
+    hash.add(arrayId(array));
+    hash.add(array->size);
+    hash.add(array->domain);
+    hash.add(array->range);
+    hash.add(array->constantValues.size());
+    for (const auto &value : array->constantValues)
+      hash.add(value->getZExtValue());
+    return hash.get();
+  }
+
+  QueryHash hashUpdates(const UpdateList &updateList) {
+    // hash the oldest update first, so that lists sharing a tail share work
+    std::vector<const UpdateNode *> pending;
+    QueryHash result = hashArray(updateList.root);
+    for (const UpdateNode *un = updateList.head.get(); un; un = un->next.get()) {
+      auto it = updates.find(un);
+      if (it != updates.end()) {
+        result = it->second;
+        break;
+      }
+      pending.push_back(un);
+    }
+    for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+      HashBuilder hash;
+      hash.add(result);
+      hash.add(hashExpr((*it)->index));
+      hash.add(hashExpr((*it)->value));
+      result = hash.get();
+      updates.emplace(*it, result);
+    }
+    return result;
+  }
+
+public:
+  QueryHash hashExpr(const ref<Expr> &e) {
+    auto it = exprs.find(e.get());
+    if (it != exprs.end())
+      return it->second;
+
+    HashBuilder hash;
+    hash.add(e->getKind());
+    hash.add(e->getWidth());
+    if (const ConstantExpr *CE = dyn_cast<ConstantExpr>(e)) {
+      const llvm::APInt &value = CE->getAPValue();
+      for (unsigned i = 0; i < value.getNumWords(); ++i)
+        hash.add(value.getRawData()[i]);
+    } else if (const ReadExpr *RE = dyn_cast<ReadExpr>(e)) {
+      hash.add(hashUpdates(RE->updates));
+      hash.add(hashExpr(RE->index));
+    } else {
+      if (const ExtractExpr *EE = dyn_cast<ExtractExpr>(e))
+        hash.add(EE->offset);
+      for (unsigned i = 0; i < e->getNumKids(); ++i)
+        hash.add(hashExpr(e->getKid(i)));
+    }
+
+    exprs.emplace(e.get(), hash.get());
+    return hash.get();
+  }
+
+  QueryHash hashQuery(QueryKind kind, const Query &query,
+                      const std::vector<const Array *> *objects = nullptr) {
+    HashBuilder hash;
+    hash.add(static_cast<std::uint64_t>(kind));
+    hash.add(query.constraints.size());
+    for (const auto &constraint : query.constraints)
+      hash.add(hashExpr(constraint));
+    hash.add(hashExpr(query.expr));
+    if (objects) {
+      hash.add(objects->size());
+      for (const Array *array : *objects)
+        hash.add(hashArray(array));
+    }
+    return hash.get();
+  }
+};
+
+class PersistentCachingSolver : public SolverImpl {
+  Solver *solver;
+
+  int fd = -1;
+  bool writable = false;
+  char *mapping = nullptr;
+  FileHeader *header = nullptr;
+  Slot *slots = nullptr;
+
+  /// whether the result of the last operation came from the cache
+  bool lastHit = false;
+  SolverRunStatus lastHitStatus = SOLVER_RUN_STATUS_SUCCESS_SOLVABLE;
+
+  bool open(const std::string &path, std::uint64_t size);
+
+  std::uint64_t dataBegin() const {
+    return sizeof(FileHeader) + header->slotCount * sizeof(Slot);
+  }
+
+  /// Returns the payload of the cached result or nullptr on a cache miss
+  const Record *lookup(const QueryHash &hash);
+  void insert(const QueryHash &hash, std::uint32_t result, const void *payload,
+              std::uint32_t payloadSize);
+
+  const char *payload(const Record *record) const {
+    return reinterpret_cast<const char *>(record + 1);
+  }
+
+  bool hit(SolverRunStatus status) {
+    ++stats::solverCacheHits;
+    lastHit = true;
+    lastHitStatus = status;
+    return true;
+  }
+
+  void miss() {
+    ++stats::solverCacheMisses;
+    lastHit = false;
+  }
+
+public:
+  PersistentCachingSolver(Solver *s, const std::string &path,
+                          std::uint64_t size)
+      : solver(s) {
+    if (!open(path, size))
+      klee_warning("Not using solver cache file %s", path.c_str());
+  }
+  ~PersistentCachingSolver();
+
+  bool computeValidity(const Query &, Solver::Validity &result);
+  bool computeTruth(const Query &, bool &isValid);
+  bool computeValue(const Query &, ref<Expr> &result);
+  bool computeInitialValues(const Query &query,
+                            const std::vector<const Array *> &objects,
+                            std::vector<std::vector<unsigned char>> &values,
+                            bool &hasSolution);
+  SolverRunStatus getOperationStatusCode();
+  char *getConstraintLog(const Query &);
+  void setCoreSolverTimeout(time::Span timeout);
+};
+
+/// Holds an flock() on a file for its lifetime
+class FileLock {
+  int fd;
+
+public:
+  FileLock(int fd, int operation) : fd(fd) { ::flock(fd, operation); }
+  ~FileLock() { ::flock(fd, LOCK_UN); }
+};
+
+bool PersistentCachingSolver::open(const std::string &path,
+                                   std::uint64_t size) {
+  fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  writable = fd >= 0;
+  if (!writable) {
+    // others may still read a cache we cannot write
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  }
+  if (fd < 0) {
+    klee_warning("Cannot open %s: %s", path.c_str(), std::strerror(errno));
+    return false;
+  }
+
+  // a process creating the file holds an exclusive lock until it is
+  // initialized
+  FileLock lock(fd, writable ? LOCK_EX : LOCK_SH);
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    klee_warning("Cannot stat %s: %s", path.c_str(), std::strerror(errno));
+    return false;
+  }
+
+  std::uint64_t slotCount = 0; // only set if the file is created
+  std::uint64_t fileSize = st.st_size;
+  if (fileSize == 0 && writable) {
+    // reserve about 10% of the file for the hash table
+    slotCount = 1024;
+    while (slotCount * 2 * sizeof(Slot) * 10 <= size)
+      slotCount *= 2;
+    fileSize = std::max<std::uint64_t>(
+        size, sizeof(FileHeader) + slotCount * sizeof(Slot) * 2);
+    // the file is sparse, only used parts take up disk space
+    if (::ftruncate(fd, fileSize) != 0) {
+      klee_warning("Cannot resize %s: %s", path.c_str(), std::strerror(errno));
+      return false;
+    }
+  } else if (fileSize < sizeof(FileHeader)) {
+    klee_warning("%s is not a solver cache file", path.c_str());
+    return false;
+  }
+
+  int protection = PROT_READ | (writable ? PROT_WRITE : 0);
+  void *result = ::mmap(nullptr, fileSize, protection, MAP_SHARED, fd, 0);
+  if (result == MAP_FAILED) {
+    klee_warning("Cannot map %s: %s", path.c_str(), std::strerror(errno));
+    return false;
+  }
+  mapping = static_cast<char *>(result);
+  header = reinterpret_cast<FileHeader *>(mapping);
+  slots = reinterpret_cast<Slot *>(mapping + sizeof(FileHeader));
+
+  if (slotCount) {
+    header->version = CacheVersion;
+    header->slotCount = slotCount;
+    header->fileSize = fileSize;
+    header->dataEnd.store(dataBegin(), std::memory_order_relaxed);
+    header->entries.store(0, std::memory_order_relaxed);
+    std::memcpy(header->magic, CacheMagic, sizeof(CacheMagic));
+  } else if (std::memcmp(header->magic, CacheMagic, sizeof(CacheMagic)) ||
+             header->version != CacheVersion ||
+             header->fileSize != fileSize) {
+    klee_warning("%s is not a solver cache file of version %u", path.c_str(),
+                 CacheVersion);
+    ::munmap(mapping, fileSize);
+    mapping = nullptr;
+    return false;
+  }
+
+  klee_message("Using solver cache file %s (%" PRIu64 " entries%s)",
+               path.c_str(), header->entries.load(std::memory_order_relaxed),
+               writable ? "" : ", read-only");
+  return true;
+}
+
+PersistentCachingSolver::~PersistentCachingSolver() {
+  if (mapping)
+    ::munmap(mapping, header->fileSize);
+  if (fd >= 0)
+    ::close(fd);
+  delete solver;
+}
+
+const Record *PersistentCachingSolver::lookup(const QueryHash &hash) {
+  if (!mapping)
+    return nullptr;
+
+  std::uint64_t mask = header->slotCount - 1;
+  for (std::uint64_t i = 0; i <= mask; ++i) {
+    const Slot &slot = slots[(hash.low + i) & mask];
+    std::uint64_t offset = slot.offset.load(std::memory_order_acquire);
+    if (offset == 0)
+      return nullptr;
+    if (slot.hash == hash) {
+      if (offset < dataBegin() || offset + sizeof(Record) > header->fileSize)
+        return nullptr; // corrupted
+      const Record *record = reinterpret_cast<const Record *>(mapping + offset);
+      if (offset + sizeof(Record) + record->payloadSize > header->fileSize)
+        return nullptr;
+      return record;
+    }
+  }
+  return nullptr;
+}
+
+void PersistentCachingSolver::insert(const QueryHash &hash,
+                                     std::uint32_t result, const void *payload,
+                                     std::uint32_t payloadSize) {
+  if (!mapping || !writable)
+    return;
+
+  FileLock lock(fd, LOCK_EX);
+
+  std::uint64_t mask = header->slotCount - 1;
+  // keep the load factor below 3/4 so that lookups stay short
+  if (header->entries.load(std::memory_order_relaxed) >=
+      header->slotCount / 4 * 3) {
+    klee_warning_once(this, "Solver cache file is full");
+    return;
+  }
+
+  std::uint64_t size = (sizeof(Record) + payloadSize + 7) & ~std::uint64_t(7);
+  std::uint64_t offset = header->dataEnd.load(std::memory_order_relaxed);
+  if (offset + size > header->fileSize) {
+    klee_warning_once(this, "Solver cache file is full");
+    return;
+  }
+
+  for (std::uint64_t i = 0; i <= mask; ++i) {
+    Slot &slot = slots[(hash.low + i) & mask];
+    if (slot.offset.load(std::memory_order_acquire) != 0) {
+      if (slot.hash == hash)
+        return; // inserted by another process in the meantime
+      continue;
+    }
+
+    Record *record = reinterpret_cast<Record *>(mapping + offset);
+    record->result = result;
+    record->payloadSize = payloadSize;
+    if (payloadSize)
+      std::memcpy(record + 1, payload, payloadSize);
+    header->dataEnd.store(offset + size, std::memory_order_relaxed);
+
+    slot.hash = hash;
+    slot.offset.store(offset, std::memory_order_release);
+    header->entries.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+}
+
+bool PersistentCachingSolver::computeValidity(const Query &query,
+                                              Solver::Validity &result) {
+  QueryHash hash = CanonicalQueryHasher().hashQuery(QueryKind::Validity, query);
+  if (const Record *record = lookup(hash)) {
+    result = static_cast<Solver::Validity>(static_cast<int>(record->result) - 1);
+    return hit(SOLVER_RUN_STATUS_SUCCESS_SOLVABLE);
+  }
+
+  miss();
+  if (!solver->impl->computeValidity(query, result))
+    return false;
+  insert(hash, static_cast<std::uint32_t>(result + 1), nullptr, 0);
+  return true;
+}
+
+bool PersistentCachingSolver::computeTruth(const Query &query,
+                                           bool &isValid) {
+  QueryHash hash = CanonicalQueryHasher().hashQuery(QueryKind::Truth, query);
+  if (const Record *record = lookup(hash)) {
+    isValid = record->result;
+    return hit(isValid ? SOLVER_RUN_STATUS_SUCCESS_UNSOLVABLE
+                       : SOLVER_RUN_STATUS_SUCCESS_SOLVABLE);
+  }
+
+  miss();
+  if (!solver->impl->computeTruth(query, isValid))
+    return false;
+  insert(hash, isValid, nullptr, 0);
+  return true;
+}
+
+bool PersistentCachingSolver::computeValue(const Query &query,
+                                           ref<Expr> &result) {
+  QueryHash hash = CanonicalQueryHasher().hashQuery(QueryKind::Value, query);
+  if (const Record *record = lookup(hash)) {
+    // the payload holds the words of the value, the result its width
+    unsigned numWords = record->payloadSize / sizeof(std::uint64_t);
+    std::vector<std::uint64_t> words(numWords);
+    std::memcpy(words.data(), payload(record), record->payloadSize);
+    result = ConstantExpr::alloc(llvm::APInt(record->result, words));
+    return hit(SOLVER_RUN_STATUS_SUCCESS_SOLVABLE);
+  }
+
+  miss();
+  if (!solver->impl->computeValue(query, result))
+    return false;
+  if (const ConstantExpr *CE = dyn_cast<ConstantExpr>(result)) {
+    const llvm::APInt &value = CE->getAPValue();
+    insert(hash, value.getBitWidth(), value.getRawData(),
+           value.getNumWords() * sizeof(std::uint64_t));
+  }
+  return true;
+}
+
+bool PersistentCachingSolver::computeInitialValues(
+    const Query &query, const std::vector<const Array *> &objects,
+    std::vector<std::vector<unsigned char>> &values, bool &hasSolution) {
+  QueryHash hash = CanonicalQueryHasher().hashQuery(QueryKind::InitialValues,
+                                                    query, &objects);
+  if (const Record *record = lookup(hash)) {
+    // the payload holds the bytes of all objects, which are part of the hash
+    hasSolution = record->result;
+    values.clear();
+    if (hasSolution) {
+      const unsigned char *bytes =
+          reinterpret_cast<const unsigned char *>(payload(record));
+      values.reserve(objects.size());
+      for (const Array *array : objects) {
+        values.emplace_back(bytes, bytes + array->size);
+        bytes += array->size;
+      }
+    }
+    return hit(hasSolution ? SOLVER_RUN_STATUS_SUCCESS_SOLVABLE
+                           : SOLVER_RUN_STATUS_SUCCESS_UNSOLVABLE);
+  }
+
+  miss();
+  if (!solver->impl->computeInitialValues(query, objects, values, hasSolution))
+    return false;
+
+  std::vector<unsigned char> bytes;
+  if (hasSolution) {
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+      if (values[i].size() != objects[i]->size)
+        return true; // not the layout we store
+      bytes.insert(bytes.end(), values[i].begin(), values[i].end());
+    }
+  }
+  insert(hash, hasSolution, bytes.data(), bytes.size());
+  return true;
+}
+
+SolverImpl::SolverRunStatus PersistentCachingSolver::getOperationStatusCode() {
+  return lastHit ? lastHitStatus : solver->impl->getOperationStatusCode();
+}
+
+char *PersistentCachingSolver::getConstraintLog(const Query &query) {
+  return solver->impl->getConstraintLog(query);
+}
+
+void PersistentCachingSolver::setCoreSolverTimeout(time::Span timeout) {
+  solver->impl->setCoreSolverTimeout(timeout);
+}
+
+} // namespace
+
+Solver *klee::createPersistentCachingSolver(Solver *s, const std::string &path,
+                                            std::uint64_t size) {
+  return new Solver(new PersistentCachingSolver(s, path, size));
+}
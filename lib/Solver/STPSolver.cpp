@@ -10,6 +10,7 @@
 
 #ifdef ENABLE_STP
 
+#include "IncrementalFrames.h"
 #include "STPBuilder.h"
 #include "STPSolver.h"
 
@@ -18,6 +19,7 @@
 #include "klee/Expr/ExprUtil.h"
 #include "klee/Internal/Support/ErrorHandling.h"
 #include "klee/OptionCategories.h"
+#include "klee/Solver/SolverCmdLine.h"
 #include "klee/Solver/SolverImpl.h"
 
 #include "llvm/Support/CommandLine.h"
@@ -71,6 +73,11 @@ private:
   time::Span timeout;
   bool useForkedSTP;
   SolverRunStatus runStatusCode;
+  /// constraints kept asserted between queries (-solver-incremental)
+  IncrementalFrames frames;
+
+  void assertConstraints(const ConstraintManager &constraints);
+  void popAllFrames();
 
 public:
   explicit STPSolverImpl(bool useForkedSTP, bool optimizeDivides = true);
@@ -133,7 +140,32 @@ STPSolverImpl::~STPSolverImpl() {
 
 /***/
 
+void STPSolverImpl::assertConstraints(const ConstraintManager &constraints) {
+  if (!IncrementalCoreSolver) {
+    vc_push(vc);
+    for (const auto &constraint : constraints)
+      vc_assertFormula(vc, builder->construct(constraint));
+    return;
+  }
+
+  for (std::size_t popped = frames.align(constraints); popped > 0; --popped)
+    vc_pop(vc);
+  if (frames.assertedCount() < constraints.size()) {
+    vc_push(vc);
+    for (auto it = constraints.begin() + frames.assertedCount(),
+              ie = constraints.end(); it != ie; ++it)
+      vc_assertFormula(vc, builder->construct(*it));
+    frames.pushFrame(constraints);
+  }
+}
+
+void STPSolverImpl::popAllFrames() {
+  for (std::size_t popped = frames.popAll(); popped > 0; --popped)
+    vc_pop(vc);
+}
+
 char *STPSolverImpl::getConstraintLog(const Query &query) {
+  popAllFrames();
   vc_push(vc);
 
   for (const auto &constraint : query.constraints)
@@ -321,10 +353,7 @@ bool STPSolverImpl::computeInitialValues(
   runStatusCode = SOLVER_RUN_STATUS_FAILURE;
   TimerStatIncrementer t(stats::queryTime);
 
-  vc_push(vc);
-
-  for (const auto &constraint : query.constraints)
-    vc_assertFormula(vc, builder->construct(constraint));
+  assertConstraints(query.constraints);
 
   ++stats::queries;
   ++stats::queryCounterexamples;
@@ -358,7 +387,11 @@ bool STPSolverImpl::computeInitialValues(
       ++stats::queriesValid;
   }
 
-  vc_pop(vc);
+  if (!IncrementalCoreSolver)
+    vc_pop(vc);
+  else if (!success)
+    // do not rely on the state of the solver after a timeout or failure
+    popAllFrames();
 
   return success;
 }
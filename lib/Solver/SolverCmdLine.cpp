@@ -90,6 +90,26 @@ cl::opt<bool> CoreSolverOptimizeDivides(
              "passing them to the core SMT solver (default=false)"),
     cl::init(false), cl::cat(SolvingCat));
 
+cl::opt<bool> IncrementalCoreSolver(
+    "solver-incremental",
+    cl::desc("Keep the constraints of previous queries asserted in the core "
+             "SMT solver (Z3, STP) and only assert the constraints that "
+             "changed (default=false)"),
+    cl::init(false), cl::cat(SolvingCat));
+
+cl::opt<std::string> SolverCacheFile(
+    "solver-cache-file",
+    cl::desc("Cache the results of queries reaching the core solver in this "
+             "file, which is reused by later runs and can be shared by "
+             "concurrent runs (default=off)"),
+    cl::cat(SolvingCat));
+
+cl::opt<unsigned> SolverCacheSize(
+    "solver-cache-size",
+    cl::desc("Size (in MiB) of a newly created solver cache file, which is "
+             "allocated sparsely (default=1024)"),
+    cl::init(1024), cl::cat(SolvingCat));
+
 cl::bits<QueryLoggingSolverType> QueryLoggingOptions(
     "use-query-log",
     cl::desc("Log queries to a file. Multiple options can be specified "
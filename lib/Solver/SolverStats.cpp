@@ -21,8 +21,12 @@ Statistic stats::queryCexCacheHits("QueryCexCacheHits", "QCexHits") ;
 Statistic stats::queryCexCacheMisses("QueryCexCacheMisses", "QCexMisses");
 Statistic stats::queryConstructTime("QueryConstructTime", "QBtime") ;
 Statistic stats::queryConstructs("QueriesConstructs", "QB");
+Statistic stats::queryConstraintsReused("QueryConstraintsReused", "QCreused");
+Statistic stats::queryConstraintsAsserted("QueryConstraintsAsserted", "QCasserted");
 Statistic stats::queryCounterexamples("QueriesCEX", "Qcex");
 Statistic stats::queryTime("QueryTime", "Qtime");
+Statistic stats::solverCacheHits("SolverCacheHits", "SChits");
+Statistic stats::solverCacheMisses("SolverCacheMisses", "SCmisses");
 
 #ifdef KLEE_ARRAY_DEBUG
 Statistic stats::arrayHashTime("ArrayHashTime", "AHtime");
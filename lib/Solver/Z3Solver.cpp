@@ -14,6 +14,7 @@
 
 #ifdef ENABLE_Z3
 
+#include "IncrementalFrames.h"
 #include "Z3Solver.h"
 #include "Z3Builder.h"
 
@@ -21,6 +22,7 @@
 #include "klee/Expr/Assignment.h"
 #include "klee/Expr/ExprUtil.h"
 #include "klee/Solver/Solver.h"
+#include "klee/Solver/SolverCmdLine.h"
 #include "klee/Solver/SolverImpl.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/raw_ostream.h"
@@ -62,7 +64,13 @@ private:
   ::Z3_params solverParameters;
   // Parameter symbols
   ::Z3_symbol timeoutParamStrSymbol;
+  /// solver kept between queries (-solver-incremental)
+  ::Z3_solver incrementalSolver = nullptr;
+  IncrementalFrames frames;
 
+  ::Z3_solver prepareIncrementalSolver(const ConstraintManager &constraints);
+  void assertConstantArrays(::Z3_solver theSolver,
+                            const ConstantArrayFinder &constantArrays);
   bool internalRunSolver(const Query &,
                          const std::vector<const Array *> *objects,
                          std::vector<std::vector<unsigned char> > *values,
@@ -132,6 +140,8 @@ Z3SolverImpl::Z3SolverImpl()
 }
 
 Z3SolverImpl::~Z3SolverImpl() {
+  if (incrementalSolver)
+    Z3_solver_dec_ref(builder->ctx, incrementalSolver);
   Z3_params_dec_ref(builder->ctx, solverParameters);
   delete builder;
 }
@@ -244,28 +254,83 @@ bool Z3SolverImpl::computeInitialValues(
   return internalRunSolver(query, &objects, &values, hasSolution);
 }
 
+void Z3SolverImpl::assertConstantArrays(
+    ::Z3_solver theSolver, const ConstantArrayFinder &constantArrays) {
+  for (auto const &constant_array : constantArrays.results) {
+    assert(builder->constant_array_assertions.count(constant_array) == 1 &&
+           "Constant array found in query, but not handled by Z3Builder");
+    for (auto const &arrayIndexValueExpr :
+         builder->constant_array_assertions[constant_array]) {
+      Z3_solver_assert(builder->ctx, theSolver, arrayIndexValueExpr);
+    }
+  }
+}
+
+::Z3_solver
+Z3SolverImpl::prepareIncrementalSolver(const ConstraintManager &constraints) {
+  if (!incrementalSolver) {
+    incrementalSolver = Z3_mk_solver(builder->ctx);
+    Z3_solver_inc_ref(builder->ctx, incrementalSolver);
+  }
+
+  std::size_t popped = frames.align(constraints);
+  if (popped > 0) {
+    if (frames.assertedCount() == 0) {
+      // nothing in common with the previous query (e.g. it belonged to
+      // another path), so start from a fresh solver state
+      Z3_solver_reset(builder->ctx, incrementalSolver);
+    } else {
+      Z3_solver_pop(builder->ctx, incrementalSolver, popped);
+    }
+  }
+  Z3_solver_set_params(builder->ctx, incrementalSolver, solverParameters);
+
+  if (frames.assertedCount() < constraints.size()) {
+    Z3_solver_push(builder->ctx, incrementalSolver);
+    ConstantArrayFinder constant_arrays_in_constraints;
+    for (auto it = constraints.begin() + frames.assertedCount(),
+              ie = constraints.end(); it != ie; ++it) {
+      Z3_solver_assert(builder->ctx, incrementalSolver, builder->construct(*it));
+      constant_arrays_in_constraints.visit(*it);
+    }
+    assertConstantArrays(incrementalSolver, constant_arrays_in_constraints);
+    frames.pushFrame(constraints);
+  }
+
+  // frame for the query expression, popped after the query
+  Z3_solver_push(builder->ctx, incrementalSolver);
+  return incrementalSolver;
+}
+
 bool Z3SolverImpl::internalRunSolver(
     const Query &query, const std::vector<const Array *> *objects,
     std::vector<std::vector<unsigned char> > *values, bool &hasSolution) {
 
   TimerStatIncrementer t(stats::queryTime);
   // NOTE: Z3 will switch to using a slower solver internally if push/pop are
-  // used so for now it is likely that creating a new solver each time is the
-  // right way to go until Z3 changes its behaviour.
+  // used so by default a new solver is created for each query. With
+  // -solver-incremental, the constraints are kept asserted between queries
+  // instead, which pays off for long sequences of queries on one path.
   //
   // TODO: Investigate using a custom tactic as described in
   // https://github.com/klee/klee/issues/653
-  Z3_solver theSolver = Z3_mk_solver(builder->ctx);
-  Z3_solver_inc_ref(builder->ctx, theSolver);
-  Z3_solver_set_params(builder->ctx, theSolver, solverParameters);
+  Z3_solver theSolver;
+  ConstantArrayFinder constant_arrays_in_query;
+  if (IncrementalCoreSolver) {
+    theSolver = prepareIncrementalSolver(query.constraints);
+  } else {
+    theSolver = Z3_mk_solver(builder->ctx);
+    Z3_solver_inc_ref(builder->ctx, theSolver);
+    Z3_solver_set_params(builder->ctx, theSolver, solverParameters);
+
+    for (auto const &constraint : query.constraints) {
+      Z3_solver_assert(builder->ctx, theSolver, builder->construct(constraint));
+      constant_arrays_in_query.visit(constraint);
+    }
+  }
 
   runStatusCode = SOLVER_RUN_STATUS_FAILURE;
 
-  ConstantArrayFinder constant_arrays_in_query;
-  for (auto const &constraint : query.constraints) {
-    Z3_solver_assert(builder->ctx, theSolver, builder->construct(constraint));
-    constant_arrays_in_query.visit(constraint);
-  }
   ++stats::queries;
   if (objects)
     ++stats::queryCounterexamples;
@@ -273,15 +338,7 @@ bool Z3SolverImpl::internalRunSolver(
   Z3ASTHandle z3QueryExpr =
       Z3ASTHandle(builder->construct(query.expr), builder->ctx);
   constant_arrays_in_query.visit(query.expr);
-
-  for (auto const &constant_array : constant_arrays_in_query.results) {
-    assert(builder->constant_array_assertions.count(constant_array) == 1 &&
-           "Constant array found in query, but not handled by Z3Builder");
-    for (auto const &arrayIndexValueExpr :
-         builder->constant_array_assertions[constant_array]) {
-      Z3_solver_assert(builder->ctx, theSolver, arrayIndexValueExpr);
-    }
-  }
+  assertConstantArrays(theSolver, constant_arrays_in_query);
 
   // KLEE Queries are validity queries i.e.
   // ∀ X Constraints(X) → query(X)
@@ -305,7 +362,18 @@ bool Z3SolverImpl::internalRunSolver(
   runStatusCode = handleSolverResponse(theSolver, satisfiable, objects, values,
                                        hasSolution);
 
-  Z3_solver_dec_ref(builder->ctx, theSolver);
+  if (IncrementalCoreSolver) {
+    if (runStatusCode == SolverImpl::SOLVER_RUN_STATUS_SUCCESS_SOLVABLE ||
+        runStatusCode == SolverImpl::SOLVER_RUN_STATUS_SUCCESS_UNSOLVABLE) {
+      Z3_solver_pop(builder->ctx, theSolver, 1);
+    } else {
+      // do not rely on the state of the solver after a timeout or failure
+      Z3_solver_reset(builder->ctx, theSolver);
+      frames.popAll();
+    }
+  } else {
+    Z3_solver_dec_ref(builder->ctx, theSolver);
+  }
   // Clear the builder's cache to prevent memory usage exploding.
   // By using ``autoClearConstructCache=false`` and clearning now
   // we allow Z3_ast expressions to be shared from an entire
@@ -14,10 +14,6 @@ int pthread_barrier_init(pthread_barrier_t *barrier, const pthread_barrierattr_t
   }
 
   barrier->count = count;
-  barrier->currentCount = 0;
-
-  pthread_mutex_init(&barrier->mutex, NULL);
-  pthread_cond_init(&barrier->cond, NULL);
 
   kpr_ensure_valid(barrier);
 
@@ -27,15 +23,7 @@ int pthread_barrier_init(pthread_barrier_t *barrier, const pthread_barrierattr_t
 int pthread_barrier_destroy(pthread_barrier_t *barrier) {
   kpr_check_if_valid(pthread_barrier_t, barrier);
 
-  if (barrier->currentCount > 0) {
-    return EBUSY;
-  }
-
   barrier->count = 0;
-  barrier->currentCount = 0;
-
-  pthread_mutex_destroy(&barrier->mutex);
-  pthread_cond_destroy(&barrier->cond);
 
   kpr_ensure_invalid(pthread_barrier_t, barrier);
 
@@ -43,35 +31,17 @@ int pthread_barrier_destroy(pthread_barrier_t *barrier) {
 }
 
 int pthread_barrier_wait(pthread_barrier_t *barrier) {
-  // We disable the thread scheduling here to not let the data race detection error
-  // before we actually can acquire the mutex.
-  // If the object is invalid the state is terminated in any case.
-  // But in the case of a correct object the call to `pthread_mutex_lock` will reenable thread scheduling
-
   kpr_check_if_valid(pthread_barrier_t, barrier);
 
-  pthread_mutex_lock(&barrier->mutex);
-
   if (barrier->count == 0) {
     klee_report_error(__FILE__, __LINE__, "Use of uninitialized/destroyed barrier", "user");
   }
 
-  barrier->currentCount++;
-
-  int ret = 0;
-
-  if (barrier->currentCount == barrier->count) {
-    pthread_cond_broadcast(&barrier->cond);
-    barrier->currentCount = 0;
+  klee_barrier_wait(&barrier->barrier, barrier->count);
 
-    // Should only be returned to one thread (unspecified which one)
-    // TODO: Maybe choice of thread can be made symbolic in the future?
-    ret = PTHREAD_BARRIER_SERIAL_THREAD;
-  } else {
-    pthread_cond_wait(&barrier->cond, &barrier->mutex);
+  if (klee_barrier_is_serial(&barrier->barrier)) {
+    return PTHREAD_BARRIER_SERIAL_THREAD;
   }
 
-  pthread_mutex_unlock(&barrier->mutex);
-
-  return ret;
+  return 0;
 }
@@ -1,44 +1,39 @@
 #include "klee/klee.h"
 #include "klee/runtime/pthread.h"
+#include "klee/runtime/kpr/list.h"
 
 #include "kpr/internal.h"
 
 #include <errno.h>
 #include <stdbool.h>
 
-static int rwlock_tryrdlock(pthread_rwlock_t* lock) {
-  pthread_t th = pthread_self();
+// Read acquisitions are tracked per thread, as only the outermost of several
+// recursive read acquisitions is visible to klee
 
-  if (lock->acquiredWriter != NULL) {
-    if (lock->acquiredWriter == th) {
-      return EDEADLK;
-    } else {
-      return EBUSY;
+static unsigned long rwlock_read_depth(pthread_rwlock_t* lock) {
+  kpr_list* readLocks = &pthread_self()->data->readLocks;
+  unsigned long depth = 0;
+
+  kpr_list_iterator it = kpr_list_iterate(readLocks);
+  for (; kpr_list_iterator_valid(it); kpr_list_iterator_next(&it)) {
+    if (kpr_list_iterator_value(it) == lock) {
+      depth++;
     }
   }
 
-  // No writers are locked so we can go ahead and try to lock this one as well
-  lock->acquiredReaderCount++;
-  return 0;
+  return depth;
 }
 
-static int rwlock_trywrlock(pthread_rwlock_t* lock) {
-  pthread_t th = pthread_self();
+static void rwlock_forget_read(pthread_rwlock_t* lock) {
+  kpr_list* readLocks = &pthread_self()->data->readLocks;
 
-  if (lock->acquiredWriter != NULL) {
-    if (lock->acquiredWriter == th) {
-      return EDEADLK;
-    } else {
-      return EBUSY;
+  kpr_list_iterator it = kpr_list_iterate(readLocks);
+  for (; kpr_list_iterator_valid(it); kpr_list_iterator_next(&it)) {
+    if (kpr_list_iterator_value(it) == lock) {
+      kpr_list_erase(readLocks, &it);
+      return;
     }
   }
-
-  if (lock->acquiredReaderCount > 0) {
-    return EBUSY;
-  }
-
-  lock->acquiredWriter = th;
-  return 0;
 }
 
 // Now the actual implementation
@@ -47,12 +42,7 @@ int pthread_rwlock_init(pthread_rwlock_t *lock, const pthread_rwlockattr_t *attr
   kpr_check_for_double_init(lock);
   kpr_ensure_valid(lock);
 
-  lock->acquiredWriter = NULL;
-
-  lock->acquiredReaderCount = 0;
-
-  pthread_mutex_init(&lock->mutex, NULL);
-  pthread_cond_init(&lock->cond, NULL);
+  lock->lock = 0;
 
   kpr_ensure_valid(lock);
 
@@ -62,13 +52,6 @@ int pthread_rwlock_init(pthread_rwlock_t *lock, const pthread_rwlockattr_t *attr
 int pthread_rwlock_destroy(pthread_rwlock_t *lock) {
   kpr_check_if_valid(pthread_rwlock_t, lock);
 
-  if (lock->acquiredReaderCount != 0 || lock->acquiredWriter != NULL) {
-    return EBUSY;
-  }
-
-  pthread_mutex_destroy(&lock->mutex);
-  pthread_cond_destroy(&lock->cond);
-
   kpr_ensure_invalid(pthread_rwlock_t, lock);
 
   return 0;
@@ -77,94 +60,65 @@ int pthread_rwlock_destroy(pthread_rwlock_t *lock) {
 int pthread_rwlock_rdlock(pthread_rwlock_t *lock) {
   kpr_check_if_valid(pthread_rwlock_t, lock);
 
-  pthread_mutex_lock(&lock->mutex);
-
-  int result;
-  for (;;) {
-    result = rwlock_tryrdlock(lock);
-    if (result != EBUSY) {
-      break;
+  if (rwlock_read_depth(lock) == 0) {
+    int result = klee_rwlock_rdlock(&lock->lock);
+    if (result != 0) {
+      return result;
     }
-
-    pthread_cond_wait(&lock->cond, &lock->mutex);
-
-    // And try again if we did not succeed
   }
 
-  pthread_mutex_unlock(&lock->mutex);
-
-  return result;
+  kpr_list_push(&pthread_self()->data->readLocks, lock);
+  return 0;
 }
 
 int pthread_rwlock_tryrdlock(pthread_rwlock_t *lock) {
   kpr_check_if_valid(pthread_rwlock_t, lock);
 
-  pthread_mutex_lock(&lock->mutex);
-  int result = rwlock_tryrdlock(lock);
-  pthread_mutex_unlock(&lock->mutex);
+  if (rwlock_read_depth(lock) == 0) {
+    int result = klee_rwlock_tryrdlock(&lock->lock);
+    if (result != 0) {
+      return result;
+    }
+  }
 
-  return result;
+  kpr_list_push(&pthread_self()->data->readLocks, lock);
+  return 0;
 }
 
 int pthread_rwlock_wrlock(pthread_rwlock_t *lock) {
   kpr_check_if_valid(pthread_rwlock_t, lock);
 
-  pthread_mutex_lock(&lock->mutex);
-
-  int result;
-  for (;;) {
-    result = rwlock_trywrlock(lock);
-    if (result != EBUSY) {
-      break;
-    }
-
-    pthread_cond_wait(&lock->cond, &lock->mutex);
-
-    // And try again if we did not succeed
+  if (rwlock_read_depth(lock) > 0) {
+    return EDEADLK;
   }
 
-  pthread_mutex_unlock(&lock->mutex);
-
-  return result;
+  return klee_rwlock_wrlock(&lock->lock);
 }
 
 int pthread_rwlock_trywrlock(pthread_rwlock_t *lock) {
   kpr_check_if_valid(pthread_rwlock_t, lock);
 
-  pthread_mutex_lock(&lock->mutex);
-  int result = rwlock_trywrlock(lock);
-  pthread_mutex_unlock(&lock->mutex);
+  if (rwlock_read_depth(lock) > 0) {
+    return EDEADLK;
+  }
 
-  return result;
+  return klee_rwlock_trywrlock(&lock->lock);
 }
 
 int pthread_rwlock_unlock(pthread_rwlock_t *lock) {
   kpr_check_if_valid(pthread_rwlock_t, lock);
 
-  pthread_mutex_lock(&lock->mutex);
-
-  bool unlockAll = false;
-  bool validUnlock = false;
-
-  // So first of all test if we are the writer
-  if (lock->acquiredWriter == pthread_self()) {
-    lock->acquiredWriter = NULL;
-    unlockAll = true;
-    validUnlock = true;
-  } else if (lock->acquiredReaderCount > 0) {
-    lock->acquiredReaderCount--;
-    validUnlock = true;
+  unsigned long depth = rwlock_read_depth(lock);
+  if (depth > 0) {
+    rwlock_forget_read(lock);
 
-    // We can unlock all only if there are no locks left
-    unlockAll = lock->acquiredReaderCount == 0;
-  }
-
-  if (unlockAll) {
-    pthread_cond_broadcast(&lock->cond);
+    if (depth > 1) {
+      // still read-acquired by this thread
+      return 0;
+    }
   }
 
-  pthread_mutex_unlock(&lock->mutex);
-  return validUnlock ? 0 : -1;
+  return klee_rwlock_unlock(&lock->lock);
 }
 
 
@@ -18,10 +18,8 @@ static inline void kpr_sem_init(sem_t *sem, unsigned int value) {
   kpr_check_for_double_init(sem);
   kpr_ensure_valid(sem);
 
-  sem->value = value;
   sem->name = NULL;
-
-  sem->waitingCount = 0;
+  klee_semaphore_init(&sem->sem, value);
 
   kpr_ensure_valid(sem);
 }
@@ -40,11 +38,6 @@ int sem_init (sem_t *sem, int kpr_pshared, unsigned int value) {
 int sem_destroy (sem_t *sem) {
   kpr_check_if_valid(sem_t, sem);
 
-  if (sem->waitingCount > 0) {
-    errno = EBUSY;
-    return -1;
-  }
-
   if (sem->name != NULL) {
     errno = EINVAL;
     return -1;
@@ -155,45 +148,18 @@ int sem_unlink (__const char *__name) {
   return 0;
 }
 
-static int kpr_sem_trywait(sem_t* sem) {
-  if (sem->value <= 0) {
-    return EAGAIN;
-  }
-
-  sem->value--;
-  return 0;
-}
-
 int sem_wait (sem_t *sem) {
   kpr_check_if_valid(sem_t, sem);
 
-  klee_lock_acquire(&sem->mutex);
-
-  int result = 0;
-  while (1) {
-    result = kpr_sem_trywait(sem);
+  klee_semaphore_wait(&sem->sem);
 
-    if (result == EAGAIN) {
-      sem->waitingCount++;
-      klee_cond_wait(&sem->cond, &sem->mutex);
-    } else {
-      break;
-    }
-  }
-
-  klee_lock_release(&sem->mutex);
-
-  return result;
+  return 0;
 }
 
 int sem_trywait (sem_t *sem) {
   kpr_check_if_valid(sem_t, sem);
 
-  klee_lock_acquire(&sem->mutex);
-
-  int result = kpr_sem_trywait(sem);
-
-  klee_lock_release(&sem->mutex);
+  int result = klee_semaphore_trywait(&sem->sem);
 
   if (result == 0) {
     return result;
@@ -206,35 +172,20 @@ int sem_trywait (sem_t *sem) {
 int sem_post (sem_t *sem) {
   kpr_check_if_valid(sem_t, sem);
 
-  klee_lock_acquire(&sem->mutex);
+  int result = klee_semaphore_post(&sem->sem, SEM_VALUE_MAX);
 
-  if (sem->value == SEM_VALUE_MAX) {
-    klee_lock_release(&sem->mutex);
-    errno = EOVERFLOW;
+  if (result == 0) {
+    return result;
+  } else {
+    errno = result;
     return -1;
   }
-
-  sem->value++;
-  if (sem->value > 0) {
-    if (sem->waitingCount > 0) {
-      sem->waitingCount--;
-      klee_cond_signal(&sem->cond);
-    }
-  }
-
-  klee_lock_release(&sem->mutex);
-
-  return 0;
 }
 
 int sem_getvalue (sem_t *sem, int * kpr_sval) {
   kpr_check_if_valid(sem_t, sem);
 
-  klee_lock_acquire(&sem->mutex);
-
-  *kpr_sval = sem->value;
-
-  klee_lock_release(&sem->mutex);
+  *kpr_sval = klee_semaphore_getvalue(&sem->sem);
 
   return 0;
 }
@@ -18,7 +18,8 @@ static struct kpr_thread_data mainThreadData = {
 
   .returnValue = NULL,
 
-  .cleanupStack = KPR_LIST_INITIALIZER
+  .cleanupStack = KPR_LIST_INITIALIZER,
+  .readLocks = KPR_LIST_INITIALIZER
 };
 
 static struct kpr_thread mainThread = {
@@ -75,6 +76,7 @@ int pthread_create(pthread_t *th, const pthread_attr_t *attr, void *(*routine)(v
   }
 
   kpr_list_create(&thread_data->cleanupStack);
+  kpr_list_create(&thread_data->readLocks);
 
   klee_create_thread(kpr_wrapper, thread);
 
@@ -119,6 +121,8 @@ void pthread_exit(void* arg) {
     pthread_cleanup_pop(1);
   }
 
+  kpr_list_clear(&thread->data->readLocks);
+
   kpr_key_clear_data_of_thread();
 
   if (thread->data->detached == 0) {
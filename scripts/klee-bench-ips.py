@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+
+# ===-- klee-bench-ips.py -------------------------------------------------===##
+#
+#                      The KLEE Symbolic Virtual Machine
+#
+#  This file is distributed under the University of Illinois Open Source
+#  License. See LICENSE.TXT for details.
+#
+# ===----------------------------------------------------------------------===##
+
+"""Compare the instructions per second of two klee binaries.
+
+Each bitcode file is run several times with both binaries and the best
+instructions per second reported by klee are compared. The linked bitcode of
+the test/Concrete programs is left in test/Concrete/Output/linked_*.bc of the
+build directory after running the test suite, e.g.:
+
+  klee-bench-ips.py --baseline old/bin/klee --candidate new/bin/klee \\
+    build/test/Concrete/Output/linked_*.bc
+"""
+
+import argparse
+import math
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+INSTRUCTIONS = re.compile(r'KLEE: done: total instructions = (\d+)')
+IPS = re.compile(r'KLEE: done: instructions per second = (\d+)')
+
+
+def run(klee, bitcode, extra_args, output_dir):
+    if os.path.exists(output_dir):
+        shutil.rmtree(output_dir)
+    cmd = [klee, '--output-dir=' + output_dir, '--write-no-tests'] + extra_args + [bitcode]
+    proc = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                          universal_newlines=True)
+    if proc.returncode != 0:
+        raise RuntimeError('{} failed with exit code {}:\n{}'.format(' '.join(cmd), proc.returncode, proc.stderr))
+
+    instructions = INSTRUCTIONS.search(proc.stderr)
+    ips = IPS.search(proc.stderr)
+    if not instructions or not ips:
+        raise RuntimeError('{} did not report instructions per second'.format(' '.join(cmd)))
+    return int(instructions.group(1)), int(ips.group(1))
+
+
+def best_of(klee, bitcode, args, output_dir):
+    instructions = None
+    best = 0
+    for _ in range(args.runs):
+        n, ips = run(klee, bitcode, args.klee_args, output_dir)
+        if instructions is not None and instructions != n:
+            raise RuntimeError('{} executed a different number of instructions on {}'.format(klee, bitcode))
+        instructions = n
+        best = max(best, ips)
+    return instructions, best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--baseline', required=True, help='klee binary before the change')
+    parser.add_argument('--candidate', required=True, help='klee binary after the change')
+    parser.add_argument('--runs', type=int, default=5, help='runs per binary and program (default: 5)')
+    parser.add_argument('--klee-arg', dest='klee_args', action='append', default=[],
+                        help='additional argument passed to both binaries (repeatable)')
+    parser.add_argument('bitcode', nargs='+', help='bitcode files to execute')
+    args = parser.parse_args()
+
+    if args.runs < 1:
+        parser.error('--runs must be positive')
+
+    tmp = tempfile.mkdtemp(prefix='klee-bench-ips.')
+    output_dir = os.path.join(tmp, 'klee-out')
+    rows = []
+    try:
+        for bitcode in args.bitcode:
+            base_n, base_ips = best_of(args.baseline, bitcode, args, output_dir)
+            cand_n, cand_ips = best_of(args.candidate, bitcode, args, output_dir)
+            if base_n != cand_n:
+                print('warning: {}: baseline executed {} instructions, candidate {}'.format(bitcode, base_n, cand_n),
+                      file=sys.stderr)
+            rows.append((os.path.basename(bitcode), cand_n, base_ips, cand_ips))
+    except RuntimeError as e:
+        print('error: {}'.format(e), file=sys.stderr)
+        return 1
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    width = max(len('program'), max(len(r[0]) for r in rows))
+    print('{:<{w}} {:>14} {:>14} {:>14} {:>8}'.format('program', 'instructions', 'baseline ips', 'candidate ips',
+                                                      'speedup', w=width))
+    speedups = []
+    for name, n, base_ips, cand_ips in rows:
+        speedup = cand_ips / base_ips if base_ips else float('nan')
+        if base_ips and cand_ips:
+            speedups.append(speedup)
+        print('{:<{w}} {:>14} {:>14} {:>14} {:>8.3f}'.format(name, n, base_ips, cand_ips, speedup, w=width))
+    if speedups:
+        geomean = math.exp(sum(math.log(s) for s in speedups) / len(speedups))
+        print('geometric mean speedup: {:.3f}'.format(geomean))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,27 @@
+// REQUIRES: zlib
+// RUN: %clang %s -emit-llvm %O0opt -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --log-state-trace --compress-log-state-trace %t.bc
+// RUN: %klee-state-trace %t.klee-out/states.trace.gz > %t.json
+// RUN: FileCheck -input-file=%t.json %s
+// RUN: gunzip -d %t.klee-out/states.trace.gz
+// RUN: %klee-state-trace %t.klee-out/states.trace > %t.uncompressed.json
+// RUN: diff %t.json %t.uncompressed.json
+// RUN: gunzip -d %t.klee-out/states_fork.json.gz
+
+#include <assert.h>
+
+int main() {
+  int x;
+  klee_make_symbolic(&x, sizeof(x), "x");
+
+  assert(x != 42);
+
+  return 0;
+}
+
+// CHECK: "functionpointer_size": 8,
+// CHECK-DAG: "ktest": "test000001.ktest",
+// CHECK-DAG: "ktest": "test000002.ktest",
+// CHECK-DAG: "error": "assert",
+// CHECK: ]
@@ -0,0 +1,150 @@
+; RUN: %llvmas %s -o=%t.bc
+; RUN: rm -rf %t.klee-out
+; RUN: %klee --output-dir=%t.klee-out --concrete-fast-path=true --check-overshift=false %t.bc 2> %t.fast.log
+; RUN: FileCheck -input-file=%t.fast.log %s
+; RUN: FileCheck -check-prefix=CHECK-FAST -input-file=%t.klee-out/info %s
+; RUN: rm -rf %t.klee-out
+; RUN: %klee --output-dir=%t.klee-out --concrete-fast-path=false --check-overshift=false %t.bc 2> %t.generic.log
+; RUN: FileCheck -input-file=%t.generic.log %s
+; RUN: FileCheck -check-prefix=CHECK-GENERIC -input-file=%t.klee-out/info %s
+;
+; Instructions that the concrete fast path leaves to the generic path (signed
+; overflow on division, oversized shifts, division by zero) and operands of odd
+; widths must yield the same results with and without the fast path.
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+@.sdiv = private unnamed_addr constant [5 x i8] c"sdiv\00"
+@.srem = private unnamed_addr constant [5 x i8] c"srem\00"
+@.sdiv8 = private unnamed_addr constant [6 x i8] c"sdiv8\00"
+@.shl = private unnamed_addr constant [4 x i8] c"shl\00"
+@.lshr = private unnamed_addr constant [5 x i8] c"lshr\00"
+@.ashr = private unnamed_addr constant [5 x i8] c"ashr\00"
+@.shl64 = private unnamed_addr constant [6 x i8] c"shl64\00"
+@.sext7 = private unnamed_addr constant [6 x i8] c"sext7\00"
+@.sext1 = private unnamed_addr constant [6 x i8] c"sext1\00"
+@.slt7 = private unnamed_addr constant [5 x i8] c"slt7\00"
+@.ult7 = private unnamed_addr constant [5 x i8] c"ult7\00"
+@.trunc = private unnamed_addr constant [6 x i8] c"trunc\00"
+@.wrap7 = private unnamed_addr constant [6 x i8] c"wrap7\00"
+@.mul33 = private unnamed_addr constant [6 x i8] c"mul33\00"
+@.small = private unnamed_addr constant [6 x i8] c"small\00"
+@.max8 = private unnamed_addr constant [5 x i8] c"max8\00"
+@.wrap8 = private unnamed_addr constant [6 x i8] c"wrap8\00"
+@.large = private unnamed_addr constant [6 x i8] c"large\00"
+@.bool = private unnamed_addr constant [5 x i8] c"bool\00"
+@.udiv = private unnamed_addr constant [5 x i8] c"udiv\00"
+
+declare void @klee_print_expr(i8*, ...)
+
+define i32 @main() {
+entry:
+  ; signed division overflow
+  %intmin = shl i32 1, 31
+  %minusone = sub i32 0, 1
+  %sdiv = sdiv i32 %intmin, %minusone
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.sdiv, i64 0, i64 0), i32 %sdiv)
+; CHECK: sdiv:2147483648
+  %srem = srem i32 %intmin, %minusone
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.srem, i64 0, i64 0), i32 %srem)
+; CHECK: srem:0
+  %int8min = add i8 127, 1
+  %sdiv8 = sdiv i8 %int8min, -1
+  %sdiv8.ext = zext i8 %sdiv8 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.sdiv8, i64 0, i64 0), i32 %sdiv8.ext)
+; CHECK: sdiv8:128
+
+  ; shifts by at least the width of the operand
+  %amount = add i32 16, 16
+  %shl = shl i32 1, %amount
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([4 x i8], [4 x i8]* @.shl, i64 0, i64 0), i32 %shl)
+; CHECK: shl:0
+  %amount40 = add i32 %amount, 8
+  %lshr = lshr i32 %minusone, %amount40
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.lshr, i64 0, i64 0), i32 %lshr)
+; CHECK: lshr:0
+  %minuseight = sub i32 0, 8
+  %ashr = ashr i32 %minuseight, %amount
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.ashr, i64 0, i64 0), i32 %ashr)
+; CHECK: ashr:4294967295
+  %amount64 = add i64 32, 32
+  %shl64 = shl i64 1, %amount64
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.shl64, i64 0, i64 0), i64 %shl64)
+; CHECK: shl64:0
+
+  ; casts and comparisons on odd widths
+  %minusone7 = sub i7 0, 1
+  %sext7 = sext i7 %minusone7 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.sext7, i64 0, i64 0), i32 %sext7)
+; CHECK: sext7:4294967295
+  %true = icmp eq i32 %amount, 32
+  %sext1 = sext i1 %true to i8
+  %sext1.ext = zext i8 %sext1 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.sext1, i64 0, i64 0), i32 %sext1.ext)
+; CHECK: sext1:255
+  %min7 = add i7 63, 1
+  %slt7 = icmp slt i7 %min7, 63
+  %slt7.ext = zext i1 %slt7 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.slt7, i64 0, i64 0), i32 %slt7.ext)
+; CHECK: slt7:1
+  %ult7 = icmp ult i7 %min7, 63
+  %ult7.ext = zext i1 %ult7 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.ult7, i64 0, i64 0), i32 %ult7.ext)
+; CHECK: ult7:0
+  %big33 = add i33 4294967295, 2
+  %trunc = trunc i33 %big33 to i7
+  %trunc.ext = zext i7 %trunc to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.trunc, i64 0, i64 0), i32 %trunc.ext)
+; CHECK: trunc:1
+  %wrap7 = add i7 %minusone7, 1
+  %wrap7.ext = zext i7 %wrap7 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.wrap7, i64 0, i64 0), i32 %wrap7.ext)
+; CHECK: wrap7:0
+  %mul33 = mul i33 %big33, 3
+  %mul33.ext = zext i33 %mul33 to i64
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.mul33, i64 0, i64 0), i64 %mul33.ext)
+; CHECK: mul33:4294967299
+
+  ; interned results: equal values of different widths must keep their width
+  %small8 = add i8 2, 3
+  %small16 = add i16 2, 3
+  %small32 = add i32 2, 3
+  %small64 = add i64 2, 3
+  %small8.ext = zext i8 %small8 to i64
+  %small16.ext = zext i16 %small16 to i64
+  %small32.ext = zext i32 %small32 to i64
+  %sum1 = add i64 %small8.ext, %small16.ext
+  %sum2 = add i64 %sum1, %small32.ext
+  %sum3 = add i64 %sum2, %small64
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.small, i64 0, i64 0), i64 %sum3)
+; CHECK: small:20
+  %max8 = add i8 254, 1
+  %max8.ext = zext i8 %max8 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.max8, i64 0, i64 0), i32 %max8.ext)
+; CHECK: max8:255
+  %wrap8 = add i8 %max8, 1
+  %wrap8.ext = zext i8 %wrap8 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.wrap8, i64 0, i64 0), i32 %wrap8.ext)
+; CHECK: wrap8:0
+  %large16 = add i16 255, 1
+  %large16.ext = zext i16 %large16 to i32
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @.large, i64 0, i64 0), i32 %large16.ext)
+; CHECK: large:256
+  %false = icmp ne i32 %amount, 32
+  %bool = select i1 %false, i32 7, i32 9
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.bool, i64 0, i64 0), i32 %bool)
+; CHECK: bool:9
+
+  ; division by zero is reported instead of being executed
+  %zero = sub i32 5, 5
+  %udiv = udiv i32 %amount, %zero
+  call void (i8*, ...) @klee_print_expr(i8* getelementptr inbounds ([5 x i8], [5 x i8]* @.udiv, i64 0, i64 0), i32 %udiv)
+; CHECK: ERROR: {{.*}} divide by zero
+; CHECK-NOT: udiv:
+
+  ret i32 0
+}
+
+; CHECK-FAST: KLEE: done: concrete fast path instructions = {{[1-9][0-9]*}}
+; CHECK-GENERIC: KLEE: done: concrete fast path instructions = 0
@@ -0,0 +1,59 @@
+// RUN: %clang %s -emit-llvm %O0opt -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --log-state-trace %t.bc
+// RUN: %klee-state-trace %t.klee-out/states.trace > %t.json
+// RUN: FileCheck -input-file=%t.json %s
+// RUN: %klee-state-trace %t.klee-out/states.trace %t.file.json
+// RUN: diff %t.json %t.file.json
+//
+// The header is complete on its own, a trace cut off within a record still
+// converts up to the last complete record
+// RUN: head -c 56 %t.klee-out/states.trace > %t.header.trace
+// RUN: %klee-state-trace %t.header.trace 2> %t.header.log | FileCheck -check-prefix=CHECK-HEADER %s
+// RUN: not grep warning %t.header.log
+// RUN: head -c 60 %t.klee-out/states.trace > %t.cut.trace
+// RUN: %klee-state-trace %t.cut.trace 2> %t.cut.log | FileCheck -check-prefix=CHECK-HEADER %s
+// RUN: FileCheck -check-prefix=CHECK-CUT -input-file=%t.cut.log %s
+//
+// RUN: not %klee-state-trace %s 2>&1 | FileCheck -check-prefix=CHECK-INVALID %s
+
+#include <assert.h>
+
+int main() {
+  int x;
+  klee_make_symbolic(&x, sizeof(x), "x");
+
+  assert(x != 42);
+
+  return 0;
+}
+
+// CHECK: [
+// CHECK-NEXT: {
+// CHECK-NEXT: "functionpointer_size": 8,
+// CHECK-NEXT: "memory_state_size": {{[1-9][0-9]*}},
+// CHECK-NEXT: "logging_overhead": {{[0-9]+}},
+// CHECK-NEXT: "functionlists_length": {{[0-9]+}},
+// CHECK-NEXT: "functionlists_capacity": {{[0-9]+}}
+// CHECK-NEXT: },
+// CHECK-NEXT: {
+// CHECK-NEXT: "state_id": {{[0-9]+}},
+// CHECK-NEXT: "heap": {{[1-9][0-9]*}},
+// CHECK-NEXT: "timestamp": {{[0-9]+\.[0-9][0-9][0-9]}},
+// CHECK-NEXT: "instructions": {{[1-9][0-9]*}},
+// CHECK-NEXT: "instruction_id": {{[0-9]+}}
+// CHECK-NEXT: }
+
+// both paths terminate with a test case, one of them with an error
+// CHECK-DAG: "ktest": "test000001.ktest",
+// CHECK-DAG: "ktest": "test000002.ktest",
+// CHECK-DAG: "error": "assert",
+// CHECK: ]
+
+// CHECK-HEADER: "functionlists_capacity": {{[0-9]+}}
+// CHECK-HEADER-NEXT: }
+// CHECK-HEADER-NEXT: ]
+
+// CHECK-CUT: warning: trace ends with an incomplete record
+
+// CHECK-INVALID: not a state trace
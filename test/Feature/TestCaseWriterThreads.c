@@ -0,0 +1,41 @@
+// RUN: %clang %s -emit-llvm %O0opt -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --test-case-writer-threads=2 %t.bc
+// RUN: FileCheck -check-prefix=CHECK-ALL -input-file=%t.klee-out/info %s
+// RUN: ls %t.klee-out | grep -c "\.ktest$" | FileCheck -check-prefix=CHECK-COUNT %s
+// RUN: ls %t.klee-out | grep -c "\.tschedules$" | FileCheck -check-prefix=CHECK-COUNT %s
+// RUN: ls %t.klee-out/*.assert.err
+//
+// The limit only counts written test cases, even if more are pending
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --test-case-writer-threads=2 --max-tests=3 --dump-states-on-halt=false %t.bc
+// RUN: FileCheck -check-prefix=CHECK-MAX -input-file=%t.klee-out/info %s
+//
+// All test cases processed before exiting on an error are written
+// RUN: rm -rf %t.klee-out
+// RUN: not %klee --output-dir=%t.klee-out --test-case-writer-threads=2 --exit-on-error %t.bc
+// RUN: ls %t.klee-out/*.assert.err
+// RUN: ls %t.klee-out | grep -c "\.ktest$" > %t.ktests
+// RUN: ls %t.klee-out | grep -c "\.tschedules$" > %t.tschedules
+// RUN: diff %t.ktests %t.tschedules
+
+#include "klee/klee.h"
+
+#include <assert.h>
+
+int main() {
+  int x = klee_range(0, 8, "x");
+
+  for (int i = 0; i < 7; ++i) {
+    if (x == i)
+      return i;
+  }
+
+  assert(0 && "last value");
+
+  return 0;
+}
+
+// CHECK-ALL: KLEE: done: generated tests = 8
+// CHECK-COUNT: {{^}}8{{$}}
+// CHECK-MAX: KLEE: done: generated tests = 3
@@ -0,0 +1,34 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee -posix-runtime -output-dir=%t.klee-out %t.bc 2>&1 | FileCheck %s
+
+// Concurrent atomic read-modify-writes on the same object do not race
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <assert.h>
+
+static atomic_int counter = 0;
+
+static void* test(void* arg) {
+  atomic_fetch_add(&counter, 1);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  pthread_t t1, t2;
+
+  pthread_create(&t1, NULL, test, NULL);
+  pthread_create(&t2, NULL, test, NULL);
+
+  pthread_join(t1, NULL);
+  pthread_join(t2, NULL);
+
+  assert(atomic_load(&counter) == 2);
+
+  // CHECK-NOT: thread unsafe memory access
+  // CHECK-NOT: ASSERTION FAIL
+  // CHECK: KLEE: done: completed paths = {{[1-9][0-9]*}}
+
+  return 0;
+}
@@ -0,0 +1,49 @@
+// XFAIL: asan || ubsan
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee -posix-runtime -output-dir=%t.klee-out -thread-scheduling=first %t.bc 2>&1 | FileCheck %s
+// RUN: klee-stats --print-query-origins %t.klee-out > %t.stats
+// RUN: FileCheck -check-prefix=CHECK-STATS -input-file=%t.stats %s
+
+// Queries of the data race detection are attributed to their own origin, even
+// though they are issued during a memory operation
+
+#include <pthread.h>
+
+#include <klee/klee.h>
+
+static char array[8];
+
+static int index1;
+static int index2;
+
+static void* test1(void* arg) {
+  array[index1] = 1;
+  return NULL;
+}
+
+static void* test2(void* arg) {
+  array[index2] = 2;
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  pthread_t t1, t2;
+
+  index1 = klee_range(0, 8, "index1");
+  index2 = klee_range(0, 8, "index2");
+
+  pthread_create(&t1, NULL, test1, NULL);
+  pthread_create(&t2, NULL, test2, NULL);
+
+  pthread_join(t1, NULL);
+  pthread_join(t2, NULL);
+
+  // CHECK: thread unsafe memory access
+
+  return 0;
+}
+
+// CHECK-STATS: Origin
+// CHECK-STATS-DAG: {{klee-out +Resolution +[1-9][0-9]* }}
+// CHECK-STATS-DAG: {{klee-out +DataRace +[1-9][0-9]* }}
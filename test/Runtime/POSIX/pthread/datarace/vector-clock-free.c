@@ -0,0 +1,56 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee -posix-runtime -output-dir=%t.klee-out -data-race-detection-backend=differential -allocate-quarantine=0 %t.bc 2>&1 | FileCheck %s
+
+// Freeing an object only prunes the accesses of the freeing thread's current
+// epoch; both backends must still agree once its address is reused
+
+#include <pthread.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include <klee/klee.h>
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int *shared;
+
+static void* test(void* arg) {
+  pthread_mutex_lock(&mutex);
+  *shared += 1;
+  pthread_mutex_unlock(&mutex);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  pthread_t t1, t2;
+
+  shared = malloc(sizeof(int));
+  *shared = 0;
+
+  pthread_create(&t1, NULL, test, NULL);
+  pthread_create(&t2, NULL, test, NULL);
+
+  pthread_mutex_lock(&mutex);
+  int *old = shared;
+  int value = *old;
+  free(old);
+  // without a quarantine, the next allocation of the same size reuses the address
+  shared = malloc(sizeof(int));
+  assert(shared == old);
+  *shared = value;
+  pthread_mutex_unlock(&mutex);
+
+  pthread_join(t1, NULL);
+  pthread_join(t2, NULL);
+
+  assert(*shared <= 2);
+  free(shared);
+
+  // CHECK-NOT: backends disagree
+  // CHECK-NOT: thread unsafe memory access
+  // CHECK-NOT: ASSERTION FAIL
+  // CHECK: KLEE: done: completed paths = {{[1-9][0-9]*}}
+
+  return 0;
+}
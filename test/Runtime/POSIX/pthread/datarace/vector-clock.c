@@ -0,0 +1,63 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t-vector-clock.klee-out
+// RUN: rm -rf %t-differential.klee-out
+// RUN: %klee -posix-runtime -output-dir=%t-vector-clock.klee-out -data-race-detection-backend=vector-clock %t.bc 2>&1 | FileCheck %s
+// RUN: %klee -posix-runtime -output-dir=%t-differential.klee-out -data-race-detection-backend=differential %t.bc 2>&1 | FileCheck %s
+
+#include <pthread.h>
+#include <assert.h>
+
+#include <klee/klee.h>
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int shared = 42;
+static int fields[2];
+static int counter;
+static volatile int racy[3];
+
+struct args {
+  int index;
+  int racyIndex;
+};
+
+static void* test(void* arg) {
+  struct args* args = (struct args*) arg;
+
+  // read-shared: concurrent reads never race
+  int value = shared;
+
+  // concurrent writes to disjoint offsets of the same object
+  fields[args->index] = value;
+
+  pthread_mutex_lock(&mutex);
+  counter++;
+  pthread_mutex_unlock(&mutex);
+
+  // symbolic offsets that may overlap with the other thread
+  racy[args->racyIndex] = racy[args->racyIndex] + 1;
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  pthread_t t1, t2;
+
+  struct args args1 = { 0, klee_int("index1") };
+  struct args args2 = { 1, klee_int("index2") };
+  klee_assume(args1.racyIndex >= 0 & args1.racyIndex <= 1);
+  klee_assume(args2.racyIndex >= 1 & args2.racyIndex <= 2);
+
+  pthread_create(&t1, NULL, test, &args1);
+  pthread_create(&t2, NULL, test, &args2);
+
+  pthread_join(t1, NULL);
+  pthread_join(t2, NULL);
+
+  assert(counter == 2);
+  assert(fields[0] == 42 && fields[1] == 42);
+
+  // CHECK-NOT: backends disagree
+  // CHECK: thread unsafe memory access
+
+  return 0;
+}
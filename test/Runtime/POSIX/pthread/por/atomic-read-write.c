@@ -0,0 +1,30 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --posix-runtime --exit-on-error --debug-event-registration %t.bc 2>&1 | FileCheck %s
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+static atomic_int counter = 0;
+
+static void* thread(void* arg) {
+  // CHECK-DAG: registering atomic_read with current thread [[T_TID:[0-9,]+]] on atomic [[AID:[0-9]+]]
+  int v = atomic_load(&counter);
+  return (void*)(long)v;
+}
+
+int main(void) {
+  pthread_t th;
+  pthread_create(&th, NULL, thread, NULL);
+
+  // CHECK-DAG: registering atomic_read with current thread [[M_TID:[0-9,]+]] on atomic [[AID]]
+  int v = atomic_load(&counter);
+
+  pthread_join(th, NULL);
+
+  // CHECK: registering atomic_write with current thread [[M_TID]] on atomic [[AID]]
+  atomic_fetch_add(&counter, v + 1);
+
+  // CHECK-NOT: registering lock_acquire with current thread [[M_TID]] on mutex [[AID]]
+  return 0;
+}
@@ -0,0 +1,42 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: rm -rf %t-pruned.klee-out
+// RUN: %klee --output-dir=%t.klee-out --posix-runtime --exit-on-error %t.bc
+// RUN: %klee --output-dir=%t-pruned.klee-out --posix-runtime --exit-on-error --prune-unfolding=1 %t.bc
+// RUN: FileCheck -input-file=%t-pruned.klee-out/info %s
+// RUN: grep -E "completed paths|generated tests" %t.klee-out/info > %t.paths
+// RUN: grep -E "completed paths|generated tests" %t-pruned.klee-out/info > %t-pruned.paths
+// RUN: diff %t.paths %t-pruned.paths
+
+// Pruning the unfolding after every maximal configuration must not change the
+// explored paths
+
+#include <pthread.h>
+#include <assert.h>
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static int counter = 0;
+
+static void* thread(void* arg) {
+  pthread_mutex_lock(&mutex);
+  counter = counter * 2 + (int)(long)arg;
+  pthread_mutex_unlock(&mutex);
+  return NULL;
+}
+
+int main(void) {
+  pthread_t t1, t2, t3;
+
+  pthread_create(&t1, NULL, thread, (void*)1);
+  pthread_create(&t2, NULL, thread, (void*)2);
+  pthread_create(&t3, NULL, thread, (void*)3);
+
+  pthread_join(t1, NULL);
+  pthread_join(t2, NULL);
+  pthread_join(t3, NULL);
+
+  assert(counter > 0);
+  return 0;
+}
+
+// CHECK: KLEE: done: completed paths = {{[2-9]|[1-9][0-9]+}}
@@ -0,0 +1,43 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --posix-runtime --exit-on-error --debug-event-registration %t.bc 2>&1 | FileCheck %s
+
+#include <pthread.h>
+#include <assert.h>
+
+static pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+static int shared = 0;
+
+static void* reader(void* arg) {
+  // CHECK-DAG: registering rwlock_rdacquire with current thread [[T_TID:[0-9,]+]] on rwlock [[RWID:[0-9]+]]
+  pthread_rwlock_rdlock(&lock);
+  int v = shared;
+  // CHECK-DAG: registering rwlock_release with current thread [[T_TID]] on rwlock [[RWID]]
+  pthread_rwlock_unlock(&lock);
+  return (void*)(long)v;
+}
+
+int main(void) {
+  pthread_t th;
+  pthread_create(&th, NULL, reader, NULL);
+
+  // CHECK-DAG: registering rwlock_rdacquire with current thread [[M_TID:[0-9,]+]] on rwlock [[RWID]]
+  pthread_rwlock_rdlock(&lock);
+  // recursive read acquisition does not register another event
+  int rc = pthread_rwlock_rdlock(&lock);
+  assert(rc == 0);
+  pthread_rwlock_unlock(&lock);
+  int v = shared;
+  pthread_rwlock_unlock(&lock);
+
+  pthread_join(th, NULL);
+
+  // CHECK: registering rwlock_wracquire with current thread [[M_TID]] on rwlock [[RWID]]
+  rc = pthread_rwlock_wrlock(&lock);
+  assert(rc == 0);
+  shared = v + 1;
+  pthread_rwlock_unlock(&lock);
+
+  // CHECK-NOT: registering lock_acquire with current thread {{[0-9,]+}} on mutex [[RWID]]
+  return 0;
+}
@@ -0,0 +1,45 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --posix-runtime --exit-on-error --debug-event-registration %t.bc 2>&1 | FileCheck %s
+
+#include <pthread.h>
+#include <assert.h>
+#include <errno.h>
+
+static pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+static int shared = 0;
+
+static void* writer(void* arg) {
+  pthread_rwlock_wrlock(&lock);
+  shared = 1;
+  pthread_rwlock_unlock(&lock);
+  return NULL;
+}
+
+int main(void) {
+  pthread_t th;
+  pthread_create(&th, NULL, writer, NULL);
+
+  // depending on the writer, the attempt either fails or acquires the rwlock
+  // CHECK-DAG: registering rwlock_busy with current thread [[M_TID:[0-9,]+]] (read) on rwlock [[RWID:[0-9]+]]
+  // CHECK-DAG: registering rwlock_rdacquire with current thread [[M_TID]] (try) on rwlock [[RWID]]
+  int rc = pthread_rwlock_tryrdlock(&lock);
+  assert(rc == 0 || rc == EBUSY);
+  if (rc == 0) {
+    // recursive read acquisition does not register another event
+    assert(pthread_rwlock_tryrdlock(&lock) == 0);
+    pthread_rwlock_unlock(&lock);
+    assert(pthread_rwlock_trywrlock(&lock) == EDEADLK);
+    pthread_rwlock_unlock(&lock);
+  }
+
+  pthread_join(th, NULL);
+
+  // CHECK-DAG: registering rwlock_wracquire with current thread [[M_TID]] (try) on rwlock [[RWID]]
+  rc = pthread_rwlock_trywrlock(&lock);
+  assert(rc == 0 && shared == 1);
+  pthread_rwlock_unlock(&lock);
+
+  // CHECK-NOT: unsupported
+  return 0;
+}
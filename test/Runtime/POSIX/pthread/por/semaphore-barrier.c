@@ -0,0 +1,49 @@
+// RUN: %clang %s -emit-llvm %O0opt -g -c -o %t.bc
+// RUN: rm -rf %t.klee-out
+// RUN: %klee --output-dir=%t.klee-out --posix-runtime --exit-on-error --debug-event-registration %t.bc 2>&1 | FileCheck %s
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <assert.h>
+
+static sem_t sem;
+static pthread_barrier_t barrier;
+
+static void* producer(void* arg);
+
+int main(void) {
+  // CHECK: registering semaphore_create with current thread [[M_TID:[0-9,]+]] on semaphore [[SID:[0-9]+]] with value 0
+  sem_init(&sem, 0, 0);
+  pthread_barrier_init(&barrier, NULL, 2);
+
+  pthread_t th;
+  pthread_create(&th, NULL, producer, NULL);
+
+  // CHECK-DAG: registering semaphore_wait with current thread [[M_TID]] on semaphore [[SID]]
+  sem_wait(&sem);
+
+  // CHECK-DAG: registering semaphore_wait with current thread [[M_TID]] (getvalue) on semaphore [[SID]]
+  int value = -1;
+  sem_getvalue(&sem, &value);
+  assert(value == 0);
+
+  // CHECK-DAG: registering barrier_wait with current thread [[M_TID]] on barrier [[BID:[0-9]+]]
+  int rc = pthread_barrier_wait(&barrier);
+
+  // exactly one of both threads is the serial thread
+  void* other;
+  pthread_join(th, &other);
+  assert((rc == PTHREAD_BARRIER_SERIAL_THREAD) + (long)other == 1);
+
+  // CHECK-NOT: registering lock_acquire with current thread {{[0-9,]+}} on mutex [[SID]]
+  return 0;
+}
+
+static void* producer(void* arg) {
+  // CHECK-DAG: registering semaphore_post with current thread [[T_TID:[0-9,]+]] on semaphore [[SID]]
+  sem_post(&sem);
+
+  // CHECK-DAG: registering barrier_wait with current thread [[T_TID]] on barrier [[BID]]
+  int rc = pthread_barrier_wait(&barrier);
+  return (void*)(long)(rc == PTHREAD_BARRIER_SERIAL_THREAD);
+}
@@ -0,0 +1,180 @@
+//===-- klee-state-trace.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Converts a binary state trace (states.trace or states.trace.gz, written by
+// klee -log-state-trace) into the JSON format of states.json.
+//
+//===----------------------------------------------------------------------===//
+
+#include "klee/Config/config.h"
+#include "klee/Internal/ADT/StateTrace.h"
+
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef HAVE_ZLIB_H
+#include <zlib.h>
+#endif
+
+using namespace klee;
+
+namespace {
+
+class TraceReader {
+#ifdef HAVE_ZLIB_H
+  // gzread() also reads uncompressed files
+  gzFile file;
+#else
+  FILE *file;
+#endif
+
+public:
+  explicit TraceReader(const char *path) {
+#ifdef HAVE_ZLIB_H
+    file = gzopen(path, "rb");
+#else
+    file = std::fopen(path, "rb");
+#endif
+  }
+
+  ~TraceReader() {
+    if (file) {
+#ifdef HAVE_ZLIB_H
+      gzclose(file);
+#else
+      std::fclose(file);
+#endif
+    }
+  }
+
+  bool isOpen() const { return file != nullptr; }
+
+  /// Returns the number of bytes read, which is less than size on EOF or error
+  std::size_t read(void *buffer, std::size_t size) {
+#ifdef HAVE_ZLIB_H
+    int result = gzread(file, buffer, static_cast<unsigned>(size));
+    return result < 0 ? 0 : static_cast<std::size_t>(result);
+#else
+    return std::fread(buffer, 1, size, file);
+#endif
+  }
+
+  bool readString(std::string &value, std::size_t length) {
+    value.resize(length);
+    return length == 0 || read(&value[0], length) == length;
+  }
+};
+
+void printTimestamp(FILE *out, std::uint64_t microseconds) {
+  std::uint64_t milliseconds = microseconds / 1000;
+  std::fprintf(out, "    \"timestamp\": %" PRIu64 ".%03" PRIu64 ",\n",
+               milliseconds / 1000, milliseconds % 1000);
+}
+
+int convert(TraceReader &in, FILE *out, const char *path) {
+  StateTraceHeader header;
+  if (in.read(&header, sizeof(header)) != sizeof(header) ||
+      std::memcmp(header.magic, StateTraceMagic, sizeof(StateTraceMagic))) {
+    std::fprintf(stderr, "%s: not a state trace\n", path);
+    return 1;
+  }
+  if (header.version != StateTraceVersion ||
+      header.recordSize != sizeof(StateTraceRecord)) {
+    std::fprintf(stderr, "%s: unsupported state trace version %u\n", path,
+                 header.version);
+    return 1;
+  }
+
+  std::fprintf(out, "[\n  {\n");
+  std::fprintf(out, "    \"functionpointer_size\": %" PRIu64 ",\n",
+               header.functionPointerSize);
+  std::fprintf(out, "    \"memory_state_size\": %" PRIu64 ",\n",
+               header.memoryStateSize);
+  std::fprintf(out, "    \"logging_overhead\": %" PRIu64 ",\n",
+               header.loggingOverhead);
+  std::fprintf(out, "    \"functionlists_length\": %" PRIu64 ",\n",
+               header.functionListsLength);
+  std::fprintf(out, "    \"functionlists_capacity\": %" PRIu64 "\n",
+               header.functionListsCapacity);
+  std::fprintf(out, "  }");
+
+  StateTraceRecord record;
+  std::string ktest, error;
+  std::size_t bytes;
+  while ((bytes = in.read(&record, sizeof(record))) == sizeof(record)) {
+    if (!in.readString(ktest, record.ktestLength) ||
+        !in.readString(error, record.errorLength)) {
+      bytes = 1;
+      break;
+    }
+
+    std::fprintf(out, ",\n  {\n");
+    std::fprintf(out, "    \"state_id\": %" PRIu64 ",\n", record.stateId);
+    if (!ktest.empty())
+      std::fprintf(out, "    \"ktest\": \"%s\",\n", ktest.c_str());
+    if (!error.empty())
+      std::fprintf(out, "    \"error\": \"%s\",\n", error.c_str());
+    std::fprintf(out, "    \"heap\": %" PRIu64 ",\n", record.heap);
+    printTimestamp(out, record.timestamp);
+    if (record.instructionId != StateTraceNoInstruction) {
+      std::fprintf(out, "    \"instructions\": %" PRIu64 ",\n",
+                   record.instructions);
+      std::fprintf(out, "    \"instruction_id\": %u\n", record.instructionId);
+    } else {
+      std::fprintf(out, "    \"instructions\": %" PRIu64 "\n",
+                   record.instructions);
+    }
+    std::fprintf(out, "  }");
+  }
+  std::fprintf(out, "\n]\n");
+
+  if (bytes != 0) {
+    // KLEE was probably killed before flushing the trace
+    std::fprintf(stderr, "%s: warning: trace ends with an incomplete record\n",
+                 path);
+  }
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) {
+    std::fprintf(stderr,
+                 "Usage: %s <states.trace[.gz]> [<output.json>]\n"
+                 "Converts a state trace written by klee "
+                 "-log-state-trace to JSON (default output: stdout).\n",
+                 argv[0]);
+    return 1;
+  }
+
+  TraceReader in(argv[1]);
+  if (!in.isOpen()) {
+    std::fprintf(stderr, "%s: %s\n", argv[1], std::strerror(errno));
+    return 1;
+  }
+
+  FILE *out = stdout;
+  if (argc == 3) {
+    out = std::fopen(argv[2], "w");
+    if (!out) {
+      std::fprintf(stderr, "%s: %s\n", argv[2], std::strerror(errno));
+      return 1;
+    }
+  }
+
+  int result = convert(in, out, argv[1]);
+
+  if (out != stdout)
+    std::fclose(out);
+  return result;
+}
@@ -58,12 +58,17 @@
 #include <sys/wait.h>
 
 #include <cerrno>
+#include <condition_variable>
 #include <ctime>
+#include <deque>
 #include <fstream>
 #include <iomanip>
 #include <iterator>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 
 
 using namespace llvm;
@@ -130,6 +135,13 @@ namespace {
                          cl::desc("Write .configuration.dot files for each test case (default=false)"),
                          cl::cat(TestCaseCat));
 
+  cl::opt<unsigned>
+  TestCaseWriterThreads("test-case-writer-threads",
+                        cl::init(0),
+                        cl::desc("Number of threads writing the files of test cases. "
+                                 "0 writes them on the interpreter thread (default=0)"),
+                        cl::cat(TestCaseCat));
+
   /*** Startup options ***/
 
   cl::OptionCategory StartCat("Startup options",
@@ -296,6 +308,23 @@ extern cl::opt<std::string> MaxTime;
 
 /***/
 
+/// Contents of the files of a test case, collected on the interpreter thread
+struct TestCase {
+  unsigned id;
+  bool hasSolution = false;
+  std::vector<std::pair<std::string, std::vector<unsigned char>>> objects;
+  /// suffix and contents of the other files of the test case
+  std::vector<std::pair<std::string, std::string>> files;
+};
+
+/// Outcome of writing a test case, reported back to the interpreter thread
+struct WrittenTestCase {
+  unsigned id;
+  bool hasSolution = false;
+  bool ktestWritten = false;
+  std::vector<std::string> warnings;
+};
+
 class KleeHandler : public InterpreterHandler {
 private:
   Interpreter *m_interpreter;
@@ -315,6 +344,27 @@ private:
   int m_argc;
   char **m_argv;
 
+  // test cases are written by m_testCaseWriters, the interpreter only blocks
+  // when too many of them are pending
+  static constexpr std::size_t maxPendingTestCases = 64;
+  std::vector<std::thread> m_testCaseWriters;
+  std::deque<TestCase> m_pendingTestCases;
+  std::vector<WrittenTestCase> m_writtenTestCases;
+  std::mutex m_pendingTestCasesMutex;
+  std::condition_variable m_pendingTestCasesChanged;
+  unsigned m_busyTestCaseWriters = 0;
+  bool m_stopTestCaseWriters = false;
+  // test cases with a solution that were submitted but not yet collected
+  unsigned m_numPendingTests = 0;
+  // ids of test cases with a solution whose .ktest file could not be written
+  std::set<unsigned> m_unwrittenTestCases;
+
+  void submitTestCase(TestCase testCase);
+  WrittenTestCase writeTestCase(const TestCase &testCase);
+  void runTestCaseWriter();
+  void collectWrittenTestCases();
+  void reportWrittenTestCase(const WrittenTestCase &written);
+
 public:
   KleeHandler(int argc, char **argv);
   ~KleeHandler();
@@ -343,6 +393,11 @@ public:
                               const char *errorMessage,
                               const char *errorSuffix);
 
+  /// Blocks until all test cases processed so far are written
+  void waitForTestCases();
+  /// Writes all pending test cases and stops the test case writers
+  void stopTestCaseWriters();
+
   std::string getOutputFilename(const std::string &filename);
   std::unique_ptr<llvm::raw_fd_ostream> openOutputFile(const std::string &filename);
   std::string getTestFilename(const std::string &suffix, unsigned id);
@@ -426,9 +481,14 @@ KleeHandler::KleeHandler(int argc, char **argv)
 
   // open info
   m_infoFile = openOutputFile("info");
+
+  for (unsigned i = 0; i < TestCaseWriterThreads; ++i)
+    m_testCaseWriters.emplace_back(&KleeHandler::runTestCaseWriter, this);
 }
 
 KleeHandler::~KleeHandler() {
+  stopTestCaseWriters();
+
   delete m_pathWriter;
   delete m_symPathWriter;
   fclose(klee_warning_file);
@@ -457,16 +517,20 @@ std::string KleeHandler::getOutputFilename(const std::string &filename) {
   return path.str();
 }
 
+static std::string openOutputFileWarning(const std::string &path,
+                                         const std::string &error) {
+  return "error opening file \"" + path + "\".  KLEE may have run out of file "
+         "descriptors: try to increase the maximum number of open file "
+         "descriptors by using ulimit (" + error + ").";
+}
+
 std::unique_ptr<llvm::raw_fd_ostream>
 KleeHandler::openOutputFile(const std::string &filename) {
   std::string Error;
   std::string path = getOutputFilename(filename);
   auto f = klee_open_output_file(path, Error);
   if (!f) {
-    klee_warning("error opening file \"%s\".  KLEE may have run out of file "
-                 "descriptors: try to increase the maximum number of open file "
-                 "descriptors by using ulimit (%s).",
-                 path.c_str(), Error.c_str());
+    klee_warning("%s", openOutputFileWarning(path, Error).c_str());
     return nullptr;
   }
   return f;
@@ -484,15 +548,160 @@ KleeHandler::openTestFile(const std::string &suffix, unsigned id) {
 }
 
 
-/* Outputs all files (.ktest, .kquery, .cov etc.) describing a test case */
+void KleeHandler::submitTestCase(TestCase testCase) {
+  if (testCase.hasSolution)
+    ++m_numPendingTests;
+
+  if (m_testCaseWriters.empty()) {
+    reportWrittenTestCase(writeTestCase(testCase));
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_pendingTestCasesMutex);
+    m_pendingTestCasesChanged.wait(lock, [this] {
+      return m_pendingTestCases.size() < maxPendingTestCases;
+    });
+    m_pendingTestCases.push_back(std::move(testCase));
+  }
+  m_pendingTestCasesChanged.notify_all();
+
+  collectWrittenTestCases();
+}
+
+void KleeHandler::runTestCaseWriter() {
+  std::unique_lock<std::mutex> lock(m_pendingTestCasesMutex);
+  for (;;) {
+    m_pendingTestCasesChanged.wait(lock, [this] {
+      return m_stopTestCaseWriters || !m_pendingTestCases.empty();
+    });
+    if (m_pendingTestCases.empty())
+      return;
+
+    TestCase testCase = std::move(m_pendingTestCases.front());
+    m_pendingTestCases.pop_front();
+    ++m_busyTestCaseWriters;
+    m_pendingTestCasesChanged.notify_all();
+
+    lock.unlock();
+    WrittenTestCase written = writeTestCase(testCase);
+    lock.lock();
+
+    m_writtenTestCases.push_back(std::move(written));
+    --m_busyTestCaseWriters;
+    m_pendingTestCasesChanged.notify_all();
+  }
+}
+
+void KleeHandler::waitForTestCases() {
+  {
+    std::unique_lock<std::mutex> lock(m_pendingTestCasesMutex);
+    m_pendingTestCasesChanged.wait(lock, [this] {
+      return m_pendingTestCases.empty() && m_busyTestCaseWriters == 0;
+    });
+  }
+  collectWrittenTestCases();
+}
+
+void KleeHandler::stopTestCaseWriters() {
+  {
+    std::lock_guard<std::mutex> lock(m_pendingTestCasesMutex);
+    m_stopTestCaseWriters = true;
+  }
+  m_pendingTestCasesChanged.notify_all();
+  // writers only return once no test case is pending
+  for (auto &writer : m_testCaseWriters)
+    writer.join();
+  m_testCaseWriters.clear();
+
+  collectWrittenTestCases();
+}
+
+/* Reports test cases written by the test case writers since the last call,
+ * must only be called on the interpreter thread */
+void KleeHandler::collectWrittenTestCases() {
+  std::vector<WrittenTestCase> written;
+  {
+    std::lock_guard<std::mutex> lock(m_pendingTestCasesMutex);
+    written.swap(m_writtenTestCases);
+  }
+  for (const auto &testCase : written)
+    reportWrittenTestCase(testCase);
+}
+
+void KleeHandler::reportWrittenTestCase(const WrittenTestCase &written) {
+  for (const auto &warning : written.warnings)
+    klee_warning("%s", warning.c_str());
+
+  if (written.hasSolution) {
+    --m_numPendingTests;
+    if (written.ktestWritten)
+      ++m_numGeneratedTests;
+    else
+      m_unwrittenTestCases.insert(written.id);
+  }
+}
+
+/* Writes the files of a test case, may be called from any writer thread.
+ * Warnings are returned instead of printed, so that they are reported on the
+ * interpreter thread. */
+WrittenTestCase KleeHandler::writeTestCase(const TestCase &testCase) {
+  WrittenTestCase written;
+  written.id = testCase.id;
+  written.hasSolution = testCase.hasSolution;
+
+  if (testCase.hasSolution) {
+    KTest b;
+    b.numArgs = m_argc;
+    b.args = m_argv;
+    b.symArgvs = 0;
+    b.symArgvLen = 0;
+    b.numObjects = testCase.objects.size();
+    b.objects = new KTestObject[b.numObjects];
+    assert(b.objects);
+    for (unsigned i=0; i<b.numObjects; i++) {
+      KTestObject *o = &b.objects[i];
+      o->name = const_cast<char*>(testCase.objects[i].first.c_str());
+      o->numBytes = testCase.objects[i].second.size();
+      o->bytes = const_cast<unsigned char*>(testCase.objects[i].second.data());
+    }
+
+    std::string test_filename = getTestFilename("ktest", testCase.id);
+    if (kTest_toFile(&b, getOutputFilename(test_filename).c_str())) {
+      written.ktestWritten = true;
+    } else {
+      written.warnings.push_back("unable to write output test case " +
+                                 test_filename + ", losing it");
+    }
+
+    delete[] b.objects;
+  }
+
+  for (const auto &file : testCase.files) {
+    std::string error;
+    std::string path =
+        getOutputFilename(getTestFilename(file.first, testCase.id));
+    auto f = klee_open_output_file(path, error);
+    if (f)
+      *f << file.second;
+    else
+      written.warnings.push_back(openOutputFileWarning(path, error));
+  }
+
+  return written;
+}
+
+/* Outputs all files (.ktest, .kquery, .cov etc.) describing a test case.
+ * Only the solving and collecting the contents of the files happens here,
+ * the files are written by the test case writers. */
 std::string KleeHandler::processTestCase(const ExecutionState &state,
                                          const char *errorMessage,
                                          const char *errorSuffix) {
   std::string ktest_output_name = "";
 
   if (!WriteNone) {
-    std::vector< std::pair<std::string, std::vector<unsigned char> > > out;
-    bool success = m_interpreter->getSymbolicSolution(state, out);
+    TestCase testCase;
+    bool success = m_interpreter->getSymbolicSolution(state, testCase.objects);
 
     if (!success)
       klee_warning("unable to get symbolic solution, losing test case");
@@ -500,80 +709,56 @@ std::string KleeHandler::processTestCase(const ExecutionState &state,
     const auto start_time = time::getWallTime();
 
     unsigned id = ++m_numTotalTests;
+    testCase.id = id;
 
     if (success) {
-      KTest b;
-      b.numArgs = m_argc;
-      b.args = m_argv;
-      b.symArgvs = 0;
-      b.symArgvLen = 0;
-      b.numObjects = out.size();
-      b.objects = new KTestObject[b.numObjects];
-      assert(b.objects);
-      for (unsigned i=0; i<b.numObjects; i++) {
-        KTestObject *o = &b.objects[i];
-        o->name = const_cast<char*>(out[i].first.c_str());
-        o->numBytes = out[i].second.size();
-        o->bytes = new unsigned char[o->numBytes];
-        assert(o->bytes);
-        std::copy(out[i].second.begin(), out[i].second.end(), o->bytes);
-      }
+      testCase.hasSolution = true;
+    }
 
-      std::string test_filename = getTestFilename("ktest", id);
-      if (!kTest_toFile(&b, getOutputFilename(test_filename).c_str())) {
-        klee_warning("unable to write output test case, losing it");
-      } else {
-        ++m_numGeneratedTests;
-        ktest_output_name = test_filename;
-      }
+    auto &files = testCase.files;
 
-      for (unsigned i=0; i<b.numObjects; i++)
-        delete[] b.objects[i].bytes;
-      delete[] b.objects;
-    }
+    if (errorMessage)
+      files.emplace_back(errorSuffix, errorMessage);
 
-    if (errorMessage) {
-      auto f = openTestFile(errorSuffix, id);
-      if (f)
-        *f << errorMessage;
+    {
+      std::string schedules;
+      llvm::raw_string_ostream os(schedules);
+      for (auto& tid : state.schedulingHistory) {
+        os << tid << "\n";
+      }
+      files.emplace_back("tschedules", os.str());
     }
 
-    auto fSchedules = openTestFile("tschedules", id);
-    for (auto& tid : state.schedulingHistory) {
-      *fSchedules << tid << "\n";
+    {
+      std::string raceStats;
+      llvm::raw_string_ostream os(raceStats);
+      os << state.getDataRaceStats();
+      files.emplace_back("race-stats.json", os.str());
     }
 
-    auto fDataRaceStats = openTestFile("race-stats.json", id);
-    *fDataRaceStats << state.getDataRaceStats();
-
     if (WriteDotConfigurations && state.porNode) {
-      auto fConfiguration = openTestFile("configuration.dot", id);
-      {
-        std::stringstream conf;
-        conf << "// state id: " << state.id << "\n";
-        state.porNode->configuration().to_dotgraph(conf);
-        *fConfiguration << conf.str();
-      }
+      std::stringstream conf;
+      conf << "// state id: " << state.id << "\n";
+      state.porNode->configuration().to_dotgraph(conf);
+      files.emplace_back("configuration.dot", conf.str());
     }
 
     if (m_pathWriter) {
       std::vector<unsigned char> concreteBranches;
       m_pathWriter->readStream(m_interpreter->getPathStreamID(state),
                                concreteBranches);
-      auto f = openTestFile("path", id);
-      if (f) {
-        for (const auto &branch : concreteBranches) {
-          *f << branch << '\n';
-        }
+      std::string path;
+      for (const auto &branch : concreteBranches) {
+        path += branch;
+        path += '\n';
       }
+      files.emplace_back("path", std::move(path));
     }
 
     if (errorMessage || WriteKQueries) {
       std::string constraints;
       m_interpreter->getConstraintLog(state, constraints,Interpreter::KQUERY);
-      auto f = openTestFile("kquery", id);
-      if (f)
-        *f << constraints;
+      files.emplace_back("kquery", std::move(constraints));
     }
 
     if (WriteCVCs) {
@@ -581,56 +766,66 @@ std::string KleeHandler::processTestCase(const ExecutionState &state,
       // SMT-LIBv2 not CVC which is a bit confusing
       std::string constraints;
       m_interpreter->getConstraintLog(state, constraints, Interpreter::STP);
-      auto f = openTestFile("cvc", id);
-      if (f)
-        *f << constraints;
+      files.emplace_back("cvc", std::move(constraints));
     }
 
     if (WriteSMT2s) {
       std::string constraints;
-        m_interpreter->getConstraintLog(state, constraints, Interpreter::SMTLIB2);
-        auto f = openTestFile("smt2", id);
-        if (f)
-          *f << constraints;
+      m_interpreter->getConstraintLog(state, constraints, Interpreter::SMTLIB2);
+      files.emplace_back("smt2", std::move(constraints));
     }
 
     if (m_symPathWriter) {
       std::vector<unsigned char> symbolicBranches;
       m_symPathWriter->readStream(m_interpreter->getSymbolicPathStreamID(state),
                                   symbolicBranches);
-      auto f = openTestFile("sym.path", id);
-      if (f) {
-        for (const auto &branch : symbolicBranches) {
-          *f << branch << '\n';
-        }
+      std::string path;
+      for (const auto &branch : symbolicBranches) {
+        path += branch;
+        path += '\n';
       }
+      files.emplace_back("sym.path", std::move(path));
     }
 
     if (WriteCov) {
       std::map<const std::string*, std::set<unsigned> > cov;
       m_interpreter->getCoveredLines(state, cov);
-      auto f = openTestFile("cov", id);
-      if (f) {
-        for (const auto &entry : cov) {
-          for (const auto &line : entry.second) {
-            *f << *entry.first << ':' << line << '\n';
-          }
+      std::string lines;
+      llvm::raw_string_ostream os(lines);
+      for (const auto &entry : cov) {
+        for (const auto &line : entry.second) {
+          os << *entry.first << ':' << line << '\n';
         }
       }
+      files.emplace_back("cov", os.str());
     }
 
-    if (m_numGeneratedTests == MaxTests)
-      m_interpreter->setHaltExecution(true);
-
     if (WriteTestInfo) {
       time::Span elapsed_time(time::getWallTime() - start_time);
-      auto f = openTestFile("info", id);
-      if (f)
-        *f << "Time to generate test case: " << elapsed_time << '\n';
+      std::string info;
+      llvm::raw_string_ostream os(info);
+      os << "Time to generate test case: " << elapsed_time << '\n';
+      files.emplace_back("info", os.str());
+    }
+
+    submitTestCase(std::move(testCase));
+
+    // Without test case writers, the .ktest file has been written by now.
+    // Otherwise, a failure to write it is reported later, naming the file.
+    if (success && !m_unwrittenTestCases.count(id))
+      ktest_output_name = getTestFilename("ktest", id);
+
+    // only test cases that were written count, so wait for the pending ones
+    // once they could reach the limit
+    if (MaxTests && m_numGeneratedTests + m_numPendingTests >= MaxTests) {
+      waitForTestCases();
+      if (m_numGeneratedTests >= MaxTests)
+        m_interpreter->setHaltExecution(true);
     }
   } // if (!WriteNone)
 
   if (errorMessage && OptExitOnError) {
+    waitForTestCases();
     m_interpreter->prepareForEarlyExit();
     klee_error("EXITING ON ERROR:\n%s\n", errorMessage);
   }
@@ -1017,6 +1212,7 @@ void externalsAndGlobalsCheck(const llvm::Module *m) {
 }
 
 static Interpreter *theInterpreter = 0;
+static KleeHandler *theHandler = nullptr;
 
 static bool interrupted = false;
 
@@ -1038,11 +1234,19 @@ static void interrupt_handle() {
     sys::SetInterruptFunction(interrupt_handle);
   } else {
     llvm::errs() << "KLEE: ctrl-c detected, exiting.\n";
+    // exit immediately, without waiting for pending test cases
+    theHandler = nullptr;
     exit(1);
   }
   interrupted = true;
 }
 
+// klee_error() exits without destroying the handler
+static void stop_test_case_writers() {
+  if (theHandler)
+    theHandler->stopTestCaseWriters();
+}
+
 static void interrupt_handle_watchdog() {
   // just wait for the child to finish
 }
@@ -1398,6 +1602,8 @@ int main(int argc, char **argv, char **envp) {
 
   Interpreter::InterpreterOptions IOpts;
   KleeHandler *handler = new KleeHandler(pArgc, pArgv);
+  theHandler = handler;
+  atexit(stop_test_case_writers);
   Interpreter *interpreter =
     theInterpreter = Interpreter::create(ctx, IOpts, handler);
   assert(interpreter);
@@ -1425,6 +1631,7 @@ int main(int argc, char **argv, char **envp) {
 
 
   auto startTime = std::time(nullptr);
+  const auto startWallTime = time::getWallTime();
   { // output clock info and start time
     std::stringstream startInfo;
     startInfo << time::getClockInfo()
@@ -1530,7 +1737,10 @@ int main(int argc, char **argv, char **envp) {
     }
   }
 
+  handler->waitForTestCases();
+
   auto endTime = std::time(nullptr);
+  const time::Span elapsedWallTime(time::getWallTime() - startWallTime);
   { // output end and elapsed time
     std::uint32_t h;
     std::uint8_t m, s;
@@ -1566,8 +1776,14 @@ int main(int argc, char **argv, char **envp) {
     *theStatisticManager->getStatisticByName("QueriesCEX");
   uint64_t queryConstructs =
     *theStatisticManager->getStatisticByName("QueriesConstructs");
+  uint64_t queryConstraintsReused =
+    *theStatisticManager->getStatisticByName("QueryConstraintsReused");
+  uint64_t queryConstraintsAsserted =
+    *theStatisticManager->getStatisticByName("QueryConstraintsAsserted");
   uint64_t instructions =
     *theStatisticManager->getStatisticByName("Instructions");
+  uint64_t concreteInstructions =
+    *theStatisticManager->getStatisticByName("ConcreteInstructions");
   uint64_t forks =
     *theStatisticManager->getStatisticByName("Forks");
 
@@ -1585,6 +1801,15 @@ int main(int argc, char **argv, char **envp) {
     << "KLEE: done: valid queries = " << queriesValid << "\n"
     << "KLEE: done: invalid queries = " << queriesInvalid << "\n"
     << "KLEE: done: query cex = " << queryCounterexamples << "\n";
+  if (queryConstraintsReused + queryConstraintsAsserted)
+    handler->getInfoStream()
+      << "KLEE: done: incremental solver constraint reuse = "
+      << 100 * queryConstraintsReused /
+             (queryConstraintsReused + queryConstraintsAsserted)
+      << "%\n";
+  handler->getInfoStream()
+    << "KLEE: done: concrete fast path instructions = "
+    << concreteInstructions << "\n";
 
   handler->getInfoStream()
     << "KLEE: done: data race detection stats = " << DataRaceDetection::getGlobalStats();
@@ -1593,6 +1818,9 @@ int main(int argc, char **argv, char **envp) {
   stats << "\n";
   stats << "KLEE: done: total instructions = "
         << instructions << "\n";
+  if (elapsedWallTime.toMicroseconds() > 0)
+    stats << "KLEE: done: instructions per second = "
+          << static_cast<uint64_t>(instructions / elapsedWallTime.toSeconds()) << "\n";
   stats << "KLEE: done: completed paths = "
         << handler->getNumPathsExplored() << "\n";
   stats << "KLEE: done: max number of threads created = "
@@ -1617,6 +1845,7 @@ int main(int argc, char **argv, char **envp) {
 
   handler->getInfoStream() << stats.str();
 
+  theHandler = nullptr;
   delete handler;
 
   return 0;
@@ -0,0 +1,143 @@
+//===-- MemoryTest.cpp ----------------------------------------------------===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "../../lib/Core/Context.h"
+#include "../../lib/Core/Memory.h"
+#include "klee/Expr/ArrayCache.h"
+#include "klee/Expr/Expr.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace klee;
+
+namespace {
+
+constexpr unsigned pageSize = 4096;
+
+// three pages, the last one is only partially used
+constexpr unsigned objectSize = 2 * pageSize + 100;
+
+ArrayCache ac;
+
+ref<ObjectState> createObjectState(unsigned size) {
+  static bool initialized = false;
+  if (!initialized) {
+    Context::initialize(true, Expr::Int64);
+    initialized = true;
+  }
+  auto *mo = new MemoryObject(0x10000, size, 8, false, false, true, false,
+                              nullptr, {}, nullptr);
+  ref<ObjectState> os = new ObjectState(mo);
+  os->initializeToZero();
+  return os;
+}
+
+uint64_t readConstant(const ObjectState &os, unsigned offset,
+                      Expr::Width width) {
+  ref<Expr> value = os.read(offset, width);
+  EXPECT_TRUE(isa<ConstantExpr>(value));
+  return cast<ConstantExpr>(value)->getZExtValue();
+}
+
+TEST(ObjectStateTest, PageBoundaries) {
+  ref<ObjectState> os = createObjectState(objectSize);
+
+  // accesses that straddle the first and second page boundary
+  os->write32(pageSize - 2, 0xdeadbeef);
+  os->write64(2 * pageSize - 4, 0x0123456789abcdefull);
+
+  EXPECT_EQ(readConstant(*os, pageSize - 2, Expr::Int32), 0xdeadbeefu);
+  EXPECT_EQ(readConstant(*os, pageSize - 1, Expr::Int8), 0xbeu);
+  EXPECT_EQ(readConstant(*os, pageSize, Expr::Int8), 0xadu);
+  EXPECT_EQ(readConstant(*os, 2 * pageSize - 4, Expr::Int64),
+            0x0123456789abcdefull);
+  EXPECT_EQ(readConstant(*os, 2 * pageSize, Expr::Int32), 0x01234567u);
+
+  // the concrete store is contiguous when copied out
+  std::vector<uint8_t> store(objectSize);
+  os->copyConcreteStoreTo(store.data());
+  EXPECT_EQ(store[pageSize - 3], 0u);
+  EXPECT_EQ(store[pageSize - 2], 0xefu);
+  EXPECT_EQ(store[pageSize + 1], 0xdeu);
+  EXPECT_EQ(store[2 * pageSize + 3], 0x01u);
+  EXPECT_EQ(store[2 * pageSize + 4], 0u);
+  EXPECT_TRUE(os->concreteStoreEquals(store.data()));
+
+  store[pageSize] = 0;
+  EXPECT_FALSE(os->concreteStoreEquals(store.data()));
+}
+
+TEST(ObjectStateTest, PartialWrites) {
+  ref<ObjectState> os = createObjectState(objectSize);
+
+  // last byte of the partially used page
+  os->write8(objectSize - 1, 0x42);
+  EXPECT_EQ(readConstant(*os, objectSize - 1, Expr::Int8), 0x42u);
+  EXPECT_EQ(readConstant(*os, objectSize - 2, Expr::Int8), 0u);
+  EXPECT_EQ(readConstant(*os, objectSize - 4, Expr::Int32), 0x42000000u);
+
+  // a symbolic byte in the middle of a concrete word stays symbolic while the
+  // surrounding bytes keep their concrete values
+  const Array *array = ac.CreateArray("arr", 1);
+  ref<Expr> symbolic =
+      ReadExpr::create(UpdateList(array, 0), ConstantExpr::create(0, Expr::Int32));
+  os->write32(pageSize - 2, 0x11223344);
+  os->write(pageSize, symbolic);
+  ref<Expr> word = os->read(pageSize - 2, Expr::Int32);
+  EXPECT_FALSE(isa<ConstantExpr>(word));
+  EXPECT_EQ(os->read8(pageSize), symbolic);
+  EXPECT_EQ(readConstant(*os, pageSize - 2, Expr::Int16), 0x3344u);
+  EXPECT_EQ(readConstant(*os, pageSize + 1, Expr::Int8), 0x11u);
+
+  // overwriting the symbolic byte makes the word concrete again
+  os->write8(pageSize, 0x22);
+  EXPECT_EQ(readConstant(*os, pageSize - 2, Expr::Int32), 0x11223344u);
+}
+
+TEST(ObjectStateTest, CopyOnWriteSharing) {
+  ref<ObjectState> os = createObjectState(objectSize);
+  ref<ObjectState> copy = new ObjectState(*os);
+
+  for (unsigned offset = 0; offset < objectSize; offset += pageSize) {
+    EXPECT_TRUE(copy->sharesPageWith(*os, offset));
+  }
+
+  // writing to the copy only unshares the written page
+  copy->write8(pageSize + 5, 0x17);
+  EXPECT_TRUE(copy->sharesPageWith(*os, 0));
+  EXPECT_FALSE(copy->sharesPageWith(*os, pageSize));
+  EXPECT_TRUE(copy->sharesPageWith(*os, 2 * pageSize));
+  EXPECT_EQ(readConstant(*copy, pageSize + 5, Expr::Int8), 0x17u);
+  EXPECT_EQ(readConstant(*os, pageSize + 5, Expr::Int8), 0u);
+
+  // copying in an unchanged store does not unshare anything, a change only
+  // unshares the page it is on
+  std::vector<uint8_t> store(objectSize);
+  copy->copyConcreteStoreTo(store.data());
+  copy->copyConcreteStoreFrom(store.data());
+  EXPECT_TRUE(copy->sharesPageWith(*os, 0));
+  EXPECT_TRUE(copy->sharesPageWith(*os, 2 * pageSize));
+
+  store[2 * pageSize + 99] = 0x99;
+  copy->copyConcreteStoreFrom(store.data());
+  EXPECT_TRUE(copy->sharesPageWith(*os, 0));
+  EXPECT_FALSE(copy->sharesPageWith(*os, 2 * pageSize));
+  EXPECT_EQ(readConstant(*copy, 2 * pageSize + 99, Expr::Int8), 0x99u);
+  EXPECT_EQ(readConstant(*os, 2 * pageSize + 99, Expr::Int8), 0u);
+
+  // the original is still writeable independently
+  os->write8(0, 0x01);
+  EXPECT_FALSE(copy->sharesPageWith(*os, 0));
+  EXPECT_EQ(readConstant(*copy, 0, Expr::Int8), 0u);
+}
+
+} // namespace
@@ -0,0 +1,109 @@
+//===-- SearcherTest.cpp --------------------------------------------------===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "../../lib/Core/Searcher.h"
+#include "klee/ExecutionState.h"
+
+#include "por/node.h"
+
+#include <memory>
+#include <vector>
+
+using namespace klee;
+
+namespace {
+
+std::unique_ptr<ExecutionState> createState(por::node *node = nullptr,
+                                            std::size_t catchUp = 0) {
+  auto state = std::make_unique<ExecutionState>(std::vector<ref<Expr>>());
+  state->porNode = node;
+  // only the length of the catch-up sequence is considered
+  state->catchUp.resize(catchUp, nullptr);
+  return state;
+}
+
+/// Returns a node below a new root whose standby state is owned by the root
+por::node *createStandbyNode(std::unique_ptr<por::node> &root) {
+  root = std::make_unique<por::node>();
+  return root->make_left_child(std::make_shared<const ExecutionState>(
+      std::vector<ref<Expr>>()));
+}
+
+TEST(SearcherTest, MinCatchUpKeepsSelectedState) {
+  MinCatchUpSearcher searcher;
+  auto a = createState();
+  auto b = createState();
+  searcher.update(nullptr, {a.get()}, {});
+  EXPECT_EQ(&searcher.selectState(), a.get());
+
+  // newer states do not interrupt the selected one
+  searcher.update(a.get(), {b.get()}, {});
+  EXPECT_EQ(&searcher.selectState(), a.get());
+
+  searcher.update(a.get(), {}, {a.get()});
+  EXPECT_EQ(&searcher.selectState(), b.get());
+  searcher.update(b.get(), {}, {b.get()});
+  EXPECT_TRUE(searcher.empty());
+}
+
+TEST(SearcherTest, MinCatchUpPrefersSameStandbyAndShortCatchUp) {
+  std::unique_ptr<por::node> root1, root2;
+  por::node *n1 = createStandbyNode(root1);
+  por::node *n2 = createStandbyNode(root2);
+
+  MinCatchUpSearcher searcher;
+  auto first = createState(n1);
+  searcher.update(nullptr, {first.get()}, {});
+  EXPECT_EQ(&searcher.selectState(), first.get());
+
+  auto sibling = createState(n1, 5);
+  auto cheapSibling = createState(n1, 2);
+  auto other = createState(n2, 0);
+  searcher.update(first.get(), {sibling.get(), cheapSibling.get(), other.get()},
+                  {first.get()});
+
+  // states of the same standby state come first, cheapest catch-up first
+  EXPECT_EQ(&searcher.selectState(), cheapSibling.get());
+  searcher.update(cheapSibling.get(), {}, {cheapSibling.get()});
+  EXPECT_EQ(&searcher.selectState(), sibling.get());
+  searcher.update(sibling.get(), {}, {sibling.get()});
+  EXPECT_EQ(&searcher.selectState(), other.get());
+  searcher.update(other.get(), {}, {other.get()});
+  EXPECT_TRUE(searcher.empty());
+}
+
+TEST(SearcherTest, MinCatchUpFreedStandbyState) {
+  std::unique_ptr<por::node> root;
+  por::node *n = createStandbyNode(root);
+
+  MinCatchUpSearcher searcher;
+  auto a = createState(n);
+  searcher.update(nullptr, {a.get()}, {});
+  EXPECT_EQ(&searcher.selectState(), a.get());
+  searcher.update(a.get(), {}, {a.get()});
+
+  // free the standby state of the last selected state; a new standby state
+  // may be allocated at the same address, but must not count as the same
+  a.reset();
+  root.reset();
+  n = createStandbyNode(root);
+
+  auto unrelated = createState(n);
+  auto newest = createState();
+  searcher.update(nullptr, {unrelated.get(), newest.get()}, {});
+  EXPECT_EQ(&searcher.selectState(), newest.get());
+  searcher.update(newest.get(), {}, {newest.get()});
+  EXPECT_EQ(&searcher.selectState(), unrelated.get());
+  searcher.update(unrelated.get(), {}, {unrelated.get()});
+  EXPECT_TRUE(searcher.empty());
+}
+
+} // namespace
@@ -0,0 +1,92 @@
+//===-- ConstraintsTest.cpp -----------------------------------------------===//
+//
+//                     The KLEE Symbolic Virtual Machine
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "klee/Expr/ArrayCache.h"
+#include "klee/Expr/Constraints.h"
+#include "klee/Expr/Expr.h"
+
+#include <vector>
+
+using namespace klee;
+
+namespace {
+
+ArrayCache ac;
+
+ref<Expr> readAt(const Array *array, unsigned index) {
+  return ReadExpr::create(UpdateList(array, 0),
+                          ConstantExpr::create(index, Expr::Int32));
+}
+
+ref<Expr> byte(uint64_t value) {
+  return ConstantExpr::create(value, Expr::Int8);
+}
+
+std::vector<ref<Expr>> independentOf(const ConstraintManager &cm,
+                                     ref<Expr> e) {
+  std::vector<ref<Expr>> result;
+  cm.getIndependentConstraints(e, result);
+  return result;
+}
+
+TEST(ConstraintsTest, IndependentConstraints) {
+  const Array *a = ac.CreateArray("independent_a", 8);
+  const Array *b = ac.CreateArray("independent_b", 8);
+  const Array *c = ac.CreateArray("independent_c", 8);
+
+  ConstraintManager cm;
+  cm.addConstraint(UltExpr::create(readAt(a, 0), byte(10)));
+  cm.addConstraint(UltExpr::create(readAt(b, 0), byte(10)));
+  cm.addConstraint(UltExpr::create(readAt(a, 1), readAt(b, 0)));
+  cm.addConstraint(UltExpr::create(readAt(c, 0), byte(3)));
+
+  // a[1] is connected to b[0], but a[0] is not
+  EXPECT_EQ(2u, independentOf(cm, UgtExpr::create(readAt(a, 1), byte(1))).size());
+  EXPECT_EQ(1u, independentOf(cm, UgtExpr::create(readAt(a, 0), byte(1))).size());
+  EXPECT_EQ(0u, independentOf(cm, UgtExpr::create(readAt(c, 1), byte(1))).size());
+
+  // a symbolic read of a in a copy connects all elements of a
+  ConstraintManager copy = cm;
+  ref<Expr> symbolicRead = ReadExpr::create(
+      UpdateList(a, 0), ZExtExpr::create(readAt(c, 1), Expr::Int32));
+  copy.addConstraint(UltExpr::create(symbolicRead, byte(5)));
+
+  EXPECT_EQ(4u, independentOf(copy, UgtExpr::create(readAt(a, 0), byte(1))).size());
+  EXPECT_EQ(1u, independentOf(cm, UgtExpr::create(readAt(a, 0), byte(1))).size());
+
+  auto factors = copy.getIndependentFactors(UgtExpr::create(readAt(c, 0), byte(1)));
+  ASSERT_EQ(2u, factors.size());
+  EXPECT_EQ(2u, factors[0].size());
+  EXPECT_EQ(4u, factors[1].size());
+
+  EXPECT_EQ(3u, cm.getIndependentFactors(ref<Expr>()).size());
+}
+
+TEST(ConstraintsTest, IndependentConstraintsAfterRewrite) {
+  const Array *a = ac.CreateArray("rewrite_a", 8);
+  const Array *b = ac.CreateArray("rewrite_b", 8);
+
+  ConstraintManager cm;
+  cm.addConstraint(UltExpr::create(readAt(a, 0), byte(10)));
+  cm.addConstraint(UltExpr::create(readAt(b, 0), byte(10)));
+  cm.addConstraint(UltExpr::create(readAt(a, 1), readAt(b, 0)));
+  EXPECT_EQ(2u, independentOf(cm, readAt(b, 0)).size());
+
+  // rewriting the first constraint removes it and moves all others
+  cm.addConstraint(EqExpr::create(byte(4), readAt(a, 0)));
+  ASSERT_EQ(3u, cm.size());
+
+  auto required = independentOf(cm, readAt(b, 0));
+  ASSERT_EQ(2u, required.size());
+  EXPECT_EQ(*cm.begin(), required[0]);
+}
+
+} // namespace
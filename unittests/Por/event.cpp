@@ -59,4 +59,319 @@ namespace {
 			}
 		}
 	}
+
+	TEST(EventTest, AtomicAccesses) {
+		por::configuration configuration; // construct a default configuration with 1 main thread
+		auto init1 = configuration.thread_heads().begin()->second;
+		auto thread1 = init1->tid();
+		auto thread2 = por::thread_id{thread1, 1};
+		configuration.create_thread(thread1, thread2).commit(configuration);
+		configuration.init_thread(thread2, thread1).commit(configuration);
+		auto rd1 = configuration.atomic_read(thread1, 1).commit(configuration);
+		auto rd2 = configuration.atomic_read(thread2, 1).commit(configuration);
+		auto wr2 = configuration.atomic_write(thread2, 1).commit(configuration);
+		auto rd3 = configuration.atomic_read(thread1, 1).commit(configuration);
+		auto other = configuration.atomic_write(thread1, 2).commit(configuration);
+
+		// concurrent reads commute
+		ASSERT_EQ(rd1->write_predecessor(), nullptr);
+		ASSERT_EQ(rd2->write_predecessor(), nullptr);
+		ASSERT_TRUE(rd1->is_independent_of(rd2));
+		ASSERT_TRUE(rd2->is_independent_of(rd1));
+
+		// a write is dependent on all reads of the previous write
+		ASSERT_FALSE(wr2->is_independent_of(rd1));
+		ASSERT_FALSE(rd1->is_independent_of(wr2));
+		auto wr2rp = static_cast<por::event::atomic_write const*>(wr2)->read_predecessors();
+		ASSERT_EQ(wr2rp.size(), static_cast<std::size_t>(1));
+		ASSERT_EQ(*wr2rp.begin(), rd1);
+		ASSERT_EQ(rd3->write_predecessor(), wr2);
+
+		// accesses to different atomics are independent
+		ASSERT_TRUE(other->is_independent_of(wr2));
+		ASSERT_TRUE(other->is_independent_of(rd2));
+
+		// reading its own write: the write is listed only once
+		auto rd4 = configuration.atomic_read(thread2, 1).commit(configuration);
+		ASSERT_EQ(rd4->write_predecessor(), wr2);
+		ASSERT_EQ(rd4->thread_predecessor(), wr2);
+		auto rd4preds = rd4->predecessors();
+		ASSERT_EQ(std::distance(rd4preds.begin(), rd4preds.end()), 1);
+		ASSERT_EQ(std::count(wr2->successors().begin(), wr2->successors().end(), rd4), 1);
+
+		auto cex = configuration.conflicting_extensions();
+		ASSERT_EQ(cex.size(), static_cast<std::size_t>(2));
+		for(auto& e : cex) {
+			if(e->kind() == por::event::event_kind::atomic_write) {
+				// wr2 before rd1
+				ASSERT_EQ(e->thread_predecessor(), rd2);
+				ASSERT_EQ(e->write_predecessor(), nullptr);
+				ASSERT_TRUE(static_cast<por::event::atomic_write const*>(e)->read_predecessors().empty());
+			} else {
+				// rd3 before wr2
+				ASSERT_EQ(e->kind(), por::event::event_kind::atomic_read);
+				ASSERT_EQ(e->thread_predecessor(), rd1);
+				ASSERT_EQ(e->write_predecessor(), nullptr);
+			}
+		}
+
+		// overwriting its own write: the write is listed only once
+		auto other2 = configuration.atomic_write(thread1, 2).commit(configuration);
+		ASSERT_EQ(other2->write_predecessor(), other);
+		ASSERT_EQ(other2->thread_predecessor(), other);
+		ASSERT_TRUE(static_cast<por::event::atomic_write const*>(other2)->read_predecessors().empty());
+		auto other2preds = other2->predecessors();
+		ASSERT_EQ(std::distance(other2preds.begin(), other2preds.end()), 1);
+		ASSERT_EQ(std::count(other->successors().begin(), other->successors().end(), other2), 1);
+	}
+	TEST(EventTest, RwLockAccesses) {
+		por::configuration configuration; // construct a default configuration with 1 main thread
+		auto init1 = configuration.thread_heads().begin()->second;
+		auto thread1 = init1->tid();
+		auto thread2 = por::thread_id{thread1, 1};
+		configuration.create_thread(thread1, thread2).commit(configuration);
+		configuration.init_thread(thread2, thread1).commit(configuration);
+		auto rdacq1 = configuration.rdacquire_rwlock(thread1, 1).commit(configuration);
+		auto rdacq2 = configuration.rdacquire_rwlock(thread2, 1).commit(configuration);
+		ASSERT_FALSE(configuration.can_wracquire_rwlock(1));
+		auto rdrel1 = configuration.release_rwlock(thread1, 1).commit(configuration);
+		auto rdrel2 = configuration.release_rwlock(thread2, 1).commit(configuration);
+		auto wracq2 = configuration.wracquire_rwlock(thread2, 1).commit(configuration);
+		ASSERT_FALSE(configuration.can_rdacquire_rwlock(1));
+		auto wrrel2 = configuration.release_rwlock(thread2, 1).commit(configuration);
+		auto rdacq3 = configuration.rdacquire_rwlock(thread1, 1).commit(configuration);
+		auto other = configuration.wracquire_rwlock(thread1, 2).commit(configuration);
+
+		// concurrent readers commute
+		ASSERT_EQ(rdacq1->write_predecessor(), nullptr);
+		ASSERT_EQ(rdacq2->write_predecessor(), nullptr);
+		ASSERT_TRUE(rdacq1->is_independent_of(rdacq2));
+		ASSERT_TRUE(rdrel1->is_independent_of(rdacq2));
+		ASSERT_TRUE(rdrel2->is_independent_of(rdrel1));
+
+		// a writer is dependent on all preceding readers
+		ASSERT_FALSE(wracq2->is_independent_of(rdrel1));
+		ASSERT_FALSE(rdacq3->is_independent_of(wrrel2));
+		auto wracq2rp = static_cast<por::event::rwlock_wracquire const*>(wracq2)->read_predecessors();
+		ASSERT_EQ(wracq2rp.size(), static_cast<std::size_t>(1));
+		ASSERT_EQ(*wracq2rp.begin(), rdrel1);
+		ASSERT_EQ(rdacq3->write_predecessor(), wrrel2);
+		ASSERT_EQ(wrrel2->write_predecessor(), nullptr);
+
+		// operations on different rwlocks are independent
+		ASSERT_TRUE(other->is_independent_of(wracq2));
+		ASSERT_TRUE(other->is_independent_of(rdacq2));
+
+		auto cex = configuration.conflicting_extensions();
+		ASSERT_EQ(cex.size(), static_cast<std::size_t>(2));
+		for(auto& e : cex) {
+			if(e->kind() == por::event::event_kind::rwlock_wracquire) {
+				// wracq2 before rdacq1
+				ASSERT_EQ(e->thread_predecessor(), rdrel2);
+				ASSERT_EQ(e->write_predecessor(), nullptr);
+				ASSERT_TRUE(static_cast<por::event::rwlock_wracquire const*>(e)->read_predecessors().empty());
+			} else {
+				// rdacq3 before wracq2
+				ASSERT_EQ(e->kind(), por::event::event_kind::rwlock_rdacquire);
+				ASSERT_EQ(e->thread_predecessor(), rdrel1);
+				ASSERT_EQ(e->write_predecessor(), nullptr);
+			}
+		}
+	}
+
+	TEST(EventTest, RwLockTryOperations) {
+		por::configuration configuration; // construct a default configuration with 1 main thread
+		auto init1 = configuration.thread_heads().begin()->second;
+		auto thread1 = init1->tid();
+		auto thread2 = por::thread_id{thread1, 1};
+		configuration.create_thread(thread1, thread2).commit(configuration);
+		auto init2 = configuration.init_thread(thread2, thread1).commit(configuration);
+		auto wracq1 = configuration.wracquire_rwlock(thread1, 1).commit(configuration);
+		ASSERT_FALSE(configuration.can_rdacquire_rwlock(1));
+		auto busy2 = configuration.busy_rwlock(thread2, 1, false).commit(configuration);
+		auto wrrel1 = configuration.release_rwlock(thread1, 1).commit(configuration);
+		ASSERT_TRUE(configuration.can_wracquire_rwlock(1));
+		auto trywr2 = configuration.wracquire_rwlock(thread2, 1, por::event::rwlock_operation::trylock).commit(configuration);
+
+		// a failed attempt observes the holder and has to precede its release
+		ASSERT_EQ(busy2->kind(), por::event::event_kind::rwlock_busy);
+		ASSERT_EQ(busy2->thread_predecessor(), init2);
+		ASSERT_EQ(busy2->write_predecessor(), wracq1);
+		ASSERT_FALSE(static_cast<por::event::rwlock_busy const*>(busy2)->is_write_attempt());
+		ASSERT_TRUE(wracq1->is_less_than(*busy2));
+		auto wrrel1bp = static_cast<por::event::rwlock_release const*>(wrrel1)->busy_predecessors();
+		ASSERT_EQ(wrrel1bp.size(), static_cast<std::size_t>(1));
+		ASSERT_EQ(*wrrel1bp.begin(), busy2);
+		ASSERT_FALSE(busy2->is_independent_of(wrrel1));
+		ASSERT_FALSE(busy2->is_independent_of(trywr2));
+		ASSERT_EQ(trywr2->write_predecessor(), wrrel1);
+		ASSERT_EQ(static_cast<por::event::rwlock_wracquire const*>(trywr2)->operation(), por::event::rwlock_operation::trylock);
+
+		auto cex = configuration.conflicting_extensions();
+		ASSERT_EQ(cex.size(), static_cast<std::size_t>(3));
+		for(auto& e : cex) {
+			if(e->kind() == por::event::event_kind::rwlock_rdacquire) {
+				// tryrdlock of thread2 succeeds before wracq1
+				ASSERT_EQ(e->thread_predecessor(), init2);
+				ASSERT_EQ(e->write_predecessor(), nullptr);
+				ASSERT_EQ(static_cast<por::event::rwlock_rdacquire const*>(e)->operation(), por::event::rwlock_operation::trylock);
+			} else if(e->kind() == por::event::event_kind::rwlock_release) {
+				// wrrel1 before the failed tryrdlock
+				ASSERT_EQ(e->thread_predecessor(), wracq1);
+				ASSERT_TRUE(static_cast<por::event::rwlock_release const*>(e)->busy_predecessors().empty());
+			} else {
+				// trywrlock of thread2 fails before wrrel1
+				ASSERT_EQ(e->kind(), por::event::event_kind::rwlock_busy);
+				ASSERT_EQ(e->thread_predecessor(), busy2);
+				ASSERT_EQ(e->write_predecessor(), wracq1);
+				ASSERT_TRUE(static_cast<por::event::rwlock_busy const*>(e)->is_write_attempt());
+			}
+		}
+	}
+
+	TEST(EventTest, RwLockTryWriteWhileReadAcquired) {
+		por::configuration configuration; // construct a default configuration with 1 main thread
+		auto init1 = configuration.thread_heads().begin()->second;
+		auto thread1 = init1->tid();
+		auto thread2 = por::thread_id{thread1, 1};
+		configuration.create_thread(thread1, thread2).commit(configuration);
+		auto init2 = configuration.init_thread(thread2, thread1).commit(configuration);
+		auto rdacq1 = configuration.rdacquire_rwlock(thread1, 1).commit(configuration);
+		auto busy2 = configuration.busy_rwlock(thread2, 1, true).commit(configuration);
+		auto rdrel1 = configuration.release_rwlock(thread1, 1).commit(configuration);
+		auto trywr2 = configuration.wracquire_rwlock(thread2, 1, por::event::rwlock_operation::trylock).commit(configuration);
+
+		ASSERT_EQ(busy2->write_predecessor(), nullptr);
+		ASSERT_FALSE(static_cast<por::event::rwlock_busy const*>(busy2)->is_write_locked());
+		ASSERT_TRUE(rdacq1->is_less_than(*busy2));
+		ASSERT_TRUE(busy2->is_independent_of(rdacq1));
+		ASSERT_TRUE(busy2->is_less_than(*rdrel1));
+		auto trywr2rp = static_cast<por::event::rwlock_wracquire const*>(trywr2)->read_predecessors();
+		ASSERT_EQ(trywr2rp.size(), static_cast<std::size_t>(1));
+		ASSERT_EQ(*trywr2rp.begin(), rdrel1);
+
+		auto cex = configuration.conflicting_extensions();
+		ASSERT_EQ(cex.size(), static_cast<std::size_t>(3));
+		for(auto& e : cex) {
+			if(e->kind() == por::event::event_kind::rwlock_wracquire) {
+				// trywrlock of thread2 succeeds before rdacq1
+				ASSERT_EQ(e->thread_predecessor(), init2);
+				ASSERT_TRUE(static_cast<por::event::rwlock_wracquire const*>(e)->read_predecessors().empty());
+			} else if(e->kind() == por::event::event_kind::rwlock_release) {
+				// rdrel1 before the first failed trywrlock
+				ASSERT_EQ(e->thread_predecessor(), rdacq1);
+				ASSERT_TRUE(static_cast<por::event::rwlock_release const*>(e)->busy_predecessors().empty());
+			} else {
+				// second trywrlock of thread2 fails as well
+				ASSERT_EQ(e->kind(), por::event::event_kind::rwlock_busy);
+				ASSERT_EQ(e->thread_predecessor(), busy2);
+				ASSERT_TRUE(static_cast<por::event::rwlock_busy const*>(e)->observed_predecessors().empty());
+			}
+		}
+	}
+
+	TEST(EventTest, SemaphoreAndBarrier) {
+		por::configuration configuration; // construct a default configuration with 1 main thread
+		auto init1 = configuration.thread_heads().begin()->second;
+		auto thread1 = init1->tid();
+		auto thread2 = por::thread_id{thread1, 1};
+		auto create = configuration.create_semaphore(thread1, 1, 0).commit(configuration);
+		configuration.create_thread(thread1, thread2).commit(configuration);
+		auto init2 = configuration.init_thread(thread2, thread1).commit(configuration);
+		ASSERT_FALSE(configuration.can_wait_semaphore(1));
+		auto post1 = configuration.post_semaphore(thread2, 1).commit(configuration);
+		ASSERT_TRUE(configuration.can_wait_semaphore(1));
+		auto wait1 = configuration.wait_semaphore(thread1, 1, por::event::semaphore_operation::wait).commit(configuration);
+		ASSERT_EQ(configuration.semaphore_value(1), static_cast<std::size_t>(0));
+		auto post2 = configuration.post_semaphore(thread2, 1).commit(configuration);
+		auto get1 = configuration.wait_semaphore(thread1, 1, por::event::semaphore_operation::getvalue).commit(configuration);
+		ASSERT_EQ(configuration.semaphore_value(1), static_cast<std::size_t>(1));
+		auto post3 = configuration.post_semaphore(thread1, 1).commit(configuration);
+		ASSERT_EQ(configuration.semaphore_value(1), static_cast<std::size_t>(2));
+
+		// posts commute, but are ordered with respect to waits
+		ASSERT_EQ(post1->write_predecessor(), create);
+		ASSERT_EQ(post2->write_predecessor(), wait1);
+		ASSERT_TRUE(post3->is_independent_of(post2));
+		ASSERT_FALSE(post2->is_independent_of(wait1));
+		ASSERT_FALSE(get1->is_independent_of(post2));
+		ASSERT_TRUE(create->is_independent_of(post1));
+		auto wait1pp = static_cast<por::event::semaphore_wait const*>(wait1)->post_predecessors();
+		ASSERT_EQ(wait1pp.size(), static_cast<std::size_t>(1));
+		ASSERT_EQ(*wait1pp.begin(), post1);
+		ASSERT_TRUE(static_cast<por::event::semaphore_wait const*>(wait1)->is_consuming());
+		ASSERT_FALSE(static_cast<por::event::semaphore_wait const*>(get1)->is_consuming());
+
+		// arrivals at a barrier are independent of each other
+		std::vector<por::event::event const*> arrivals{post3, post2};
+		ASSERT_TRUE(configuration.barrier_arrivals_follow_last_round(2, arrivals));
+		auto bar1 = configuration.wait_barrier(thread1, 2, arrivals).commit(configuration);
+		auto bar2 = configuration.wait_barrier(thread2, 2, arrivals).commit(configuration);
+		ASSERT_TRUE(bar1->is_independent_of(bar2));
+		ASSERT_EQ(static_cast<por::event::barrier_wait const*>(bar1)->arrival_predecessors().size(), static_cast<std::size_t>(1));
+		ASSERT_EQ(static_cast<por::event::barrier_wait const*>(bar2)->arrival_predecessors().size(), static_cast<std::size_t>(1));
+		ASSERT_NE(static_cast<por::event::barrier_wait const*>(bar1)->is_serial(), static_cast<por::event::barrier_wait const*>(bar2)->is_serial());
+		ASSERT_EQ(configuration.barrier_heads().at(2).size(), static_cast<std::size_t>(2));
+		ASSERT_FALSE(configuration.barrier_arrivals_follow_last_round(2, {init2}));
+		ASSERT_TRUE(configuration.barrier_arrivals_follow_last_round(2, {bar1, bar2}));
+
+		auto cex = configuration.conflicting_extensions();
+		ASSERT_EQ(cex.size(), static_cast<std::size_t>(2));
+		for(auto& e : cex) {
+			if(e->kind() == por::event::event_kind::semaphore_post) {
+				// post2 before wait1
+				ASSERT_EQ(e->thread_predecessor(), post1);
+				ASSERT_EQ(e->write_predecessor(), create);
+			} else {
+				// get1 before post2
+				ASSERT_EQ(e->kind(), por::event::event_kind::semaphore_wait);
+				auto get = static_cast<por::event::semaphore_wait const*>(e);
+				ASSERT_EQ(get->thread_predecessor(), wait1);
+				ASSERT_EQ(get->operation(), por::event::semaphore_operation::getvalue);
+				ASSERT_EQ(get->value(), static_cast<std::size_t>(0));
+				ASSERT_TRUE(get->post_predecessors().empty());
+			}
+		}
+	}
+
+	TEST(EventTest, IncrementalConflictingExtensions) {
+		auto first_half = [](por::configuration& configuration) {
+			auto thread1 = configuration.thread_heads().begin()->second->tid();
+			auto thread2 = por::thread_id{thread1, 1};
+			configuration.create_thread(thread1, thread2).commit(configuration);
+			configuration.init_thread(thread2, thread1).commit(configuration);
+			configuration.acquire_lock(thread1, 1).commit(configuration);
+			configuration.release_lock(thread1, 1).commit(configuration);
+			configuration.signal_thread(thread1, 2, por::thread_id()).commit(configuration);
+			configuration.acquire_lock(thread2, 1).commit(configuration);
+			configuration.release_lock(thread2, 1).commit(configuration);
+		};
+		auto second_half = [](por::configuration& configuration) {
+			auto thread1 = configuration.thread_heads().begin()->second->tid();
+			auto thread2 = por::thread_id{thread1, 1};
+			configuration.acquire_lock(thread1, 1).commit(configuration);
+			configuration.release_lock(thread1, 1).commit(configuration);
+			configuration.acquire_lock(thread2, 3).commit(configuration);
+			configuration.wait1(thread2, 2, 3).commit(configuration);
+		};
+
+		por::configuration configuration;
+		first_half(configuration);
+		auto cex1 = configuration.conflicting_extensions(true);
+		ASSERT_FALSE(cex1.empty());
+		ASSERT_TRUE(configuration.conflicting_extensions(true).empty());
+
+		por::configuration extended = configuration;
+		second_half(extended);
+		auto cex2 = extended.conflicting_extensions(true);
+		ASSERT_FALSE(cex2.empty());
+		ASSERT_TRUE(extended.conflicting_extensions(true).empty());
+		ASSERT_TRUE(configuration.conflicting_extensions(true).empty());
+
+		// same result as computing all conflicting extensions at once
+		por::configuration reference;
+		first_half(reference);
+		second_half(reference);
+		ASSERT_EQ(reference.conflicting_extensions(true).size(), cex1.size() + cex2.size());
+	}
 } // namespace
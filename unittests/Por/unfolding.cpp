@@ -1,4 +1,5 @@
 #include "por/configuration.h"
+#include "por/erv.h"
 #include "por/thread_id.h"
 
 #include "gtest/gtest.h"
@@ -17,4 +18,80 @@ namespace {
 		auto acq2 = configuration2.acquire_lock(thread1, 2).commit(configuration2);
 		ASSERT_NE(acq1, acq2);
 	}
+
+	TEST(UnfoldingTest, AdequateOrderIndependentOfCache) {
+		// two threads with local configurations of the same size but different events
+		auto build = [](por::configuration& configuration) {
+			auto thread1 = configuration.thread_heads().begin()->second->tid();
+			auto thread2 = por::thread_id{thread1, 1};
+			std::vector<por::event::event const*> events;
+			events.push_back(configuration.create_thread(thread1, thread2).commit(configuration));
+			events.push_back(configuration.init_thread(thread2, thread1).commit(configuration));
+			for(std::size_t i = 0; i < 2; ++i) {
+				events.push_back(configuration.atomic_write(thread1, 1).commit(configuration));
+				events.push_back(configuration.atomic_write(thread2, 2).commit(configuration));
+			}
+			events.push_back(configuration.atomic_write(thread1, 1).commit(configuration));
+			return events;
+		};
+
+		por::configuration configuration1;
+		auto events1 = build(configuration1);
+		auto a1 = configuration1.last_of_tid(events1.back()->tid());
+		auto b1 = configuration1.last_of_tid(events1[1]->tid());
+		ASSERT_EQ(a1->local_configuration_size(), b1->local_configuration_size());
+
+		// all predecessors are cached before a2 and b2 are compared
+		por::configuration configuration2;
+		auto events2 = build(configuration2);
+		for(auto const* e : events2) {
+			por::compare_adequate_total_order(*e, *e);
+		}
+		auto a2 = configuration2.last_of_tid(events2.back()->tid());
+		auto b2 = configuration2.last_of_tid(events2[1]->tid());
+
+		bool less1 = por::compare_adequate_total_order(*a1, *b1);
+		// the caches of the predecessors are filled on demand
+		ASSERT_NE(a1->thread_predecessor()->_erv_cache, nullptr);
+		ASSERT_NE(less1, por::compare_adequate_total_order(*b1, *a1));
+		ASSERT_FALSE(por::compare_adequate_total_order(*a1, *a1));
+		ASSERT_EQ(less1, por::compare_adequate_total_order(*a2, *b2));
+		ASSERT_NE(less1, por::compare_adequate_total_order(*b2, *a2));
+	}
+
+	TEST(UnfoldingTest, PruneUnreachableEvents) {
+		por::configuration configuration1;
+		auto thread1 = configuration1.thread_heads().begin()->second->tid();
+		auto thread2 = por::thread_id{thread1, 1};
+		configuration1.create_thread(thread1, thread2).commit(configuration1);
+		configuration1.init_thread(thread2, thread1).commit(configuration1);
+		auto acq1 = configuration1.acquire_lock(thread1, 1).commit(configuration1);
+		configuration1.release_lock(thread1, 1).commit(configuration1);
+		configuration1.acquire_lock(thread2, 1).commit(configuration1);
+		configuration1.release_lock(thread2, 1).commit(configuration1);
+
+		// alternative: thread2 acquires lock first
+		auto cex = configuration1.conflicting_extensions();
+		ASSERT_EQ(cex.size(), static_cast<std::size_t>(1));
+
+		// events only in configuration2
+		por::configuration configuration2 = configuration1;
+		configuration2.acquire_lock(thread1, 2).commit(configuration2);
+		configuration2.release_lock(thread1, 2).commit(configuration2);
+
+		auto unfolding = configuration1.unfolding();
+		std::size_t size = unfolding->size();
+		std::size_t stored = unfolding->stored();
+
+		std::vector<por::event::event const*> live(configuration1.begin(), configuration1.end());
+		ASSERT_EQ(unfolding->prune(live), static_cast<std::size_t>(2));
+		ASSERT_EQ(unfolding->size(), size - 2);
+		ASSERT_EQ(unfolding->stored(), stored);
+
+		// conflicting extensions of live events are kept
+		auto conflicts = acq1->immediate_conflicts();
+		ASSERT_NE(std::find(conflicts.begin(), conflicts.end(), cex.front()), conflicts.end());
+		ASSERT_EQ(unfolding->prune(live), static_cast<std::size_t>(0));
+	}
+
 }
@@ -14,10 +14,16 @@
 #include "klee/Expr/Expr.h"
 #include "klee/Solver/Solver.h"
 #include "klee/Solver/SolverCmdLine.h"
+#include "klee/Solver/SolverImpl.h"
+#include "klee/Solver/SolverStats.h"
+
+#include "../../lib/Solver/IncrementalFrames.h"
 
 #include "llvm/ADT/StringExtras.h"
 
 #include <iostream>
+#include <unistd.h>
+#include <vector>
 
 using namespace klee;
 
@@ -168,4 +174,255 @@ TEST(SolverTest, Evaluation) {
   delete solver;
 }
 
+/// Answers every query with the same result and counts the queries
+class CountingSolver : public SolverImpl {
+  unsigned &queries;
+
+public:
+  explicit CountingSolver(unsigned &queries) : queries(queries) {}
+
+  bool computeTruth(const Query &, bool &isValid) {
+    ++queries;
+    isValid = false;
+    return true;
+  }
+  bool computeValue(const Query &query, ref<Expr> &result) {
+    ++queries;
+    result = ConstantExpr::create(42, query.expr->getWidth());
+    return true;
+  }
+  bool computeInitialValues(const Query &,
+                            const std::vector<const Array *> &objects,
+                            std::vector<std::vector<unsigned char>> &values,
+                            bool &hasSolution) {
+    ++queries;
+    values.clear();
+    for (const Array *array : objects)
+      values.emplace_back(array->size, 7);
+    hasSolution = true;
+    return true;
+  }
+  SolverRunStatus getOperationStatusCode() {
+    return SOLVER_RUN_STATUS_SUCCESS_SOLVABLE;
+  }
+};
+
+TEST(SolverTest, PersistentCache) {
+  char path[] = "/tmp/klee-solver-cache-XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_NE(fd, -1);
+  close(fd);
+  unlink(path);
+
+  unsigned queries = 0;
+  auto query = [&](const char *name, bool &truth, std::uint64_t &value,
+                   std::vector<unsigned char> &bytes) {
+    Solver *solver = createPersistentCachingSolver(
+        new Solver(new CountingSolver(queries)), path, 1 << 20);
+    const Array *array = ac.CreateArray(name, 4);
+    ref<Expr> read = Expr::createTempRead(array, Expr::Int32);
+    ConstraintManager constraints;
+    constraints.addConstraint(UltExpr::create(read, ConstantExpr::create(10, 32)));
+
+    ASSERT_TRUE(solver->mustBeTrue(
+        Query(constraints, EqExpr::create(read, ConstantExpr::create(3, 32))),
+        truth));
+    ref<ConstantExpr> result;
+    ASSERT_TRUE(solver->getValue(Query(constraints, read), result));
+    value = result->getZExtValue();
+    std::vector<std::vector<unsigned char>> values;
+    ASSERT_TRUE(solver->getInitialValues(Query(constraints, read), {array},
+                                         values));
+    ASSERT_EQ(values.size(), 1u);
+    bytes = values[0];
+    delete solver;
+  };
+
+  bool truth;
+  std::uint64_t value;
+  std::vector<unsigned char> bytes;
+  query("persistent1", truth, value, bytes);
+  EXPECT_EQ(queries, 3u);
+  EXPECT_FALSE(truth);
+  EXPECT_EQ(value, 42u);
+  EXPECT_EQ(bytes, std::vector<unsigned char>(4, 7));
+
+  // the same queries on a differently named array are answered from the file
+  truth = true;
+  value = 0;
+  bytes.clear();
+  query("persistent2", truth, value, bytes);
+  EXPECT_EQ(queries, 3u);
+  EXPECT_FALSE(truth);
+  EXPECT_EQ(value, 42u);
+  EXPECT_EQ(bytes, std::vector<unsigned char>(4, 7));
+
+  unlink(path);
+}
+
+
+ref<Expr> read32(const Array *array) {
+  return Expr::createTempRead(array, Expr::Int32);
+}
+
+ref<Expr> const32(uint64_t value) { return ConstantExpr::create(value, 32); }
+
+TEST(SolverTest, IncrementalFrames) {
+  const Array *array = ac.CreateArray("frames", 4);
+  ref<Expr> x = read32(array);
+  ConstraintManager c1;
+  c1.addConstraint(UltExpr::create(const32(5), x));
+  ConstraintManager c2(c1);
+  c2.addConstraint(UltExpr::create(x, const32(10)));
+  ConstraintManager c3(c1);
+  c3.addConstraint(UltExpr::create(x, const32(3)));
+  ConstraintManager c4;
+  c4.addConstraint(EqExpr::create(x, const32(7)));
+
+  IncrementalFrames frames;
+  EXPECT_EQ(frames.align(c1), 0u);
+  EXPECT_EQ(frames.assertedCount(), 0u);
+  frames.pushFrame(c1);
+  EXPECT_EQ(frames.assertedCount(), 1u);
+
+  // extending the previous constraints keeps all frames
+  EXPECT_EQ(frames.align(c2), 0u);
+  EXPECT_EQ(frames.assertedCount(), 1u);
+  frames.pushFrame(c2);
+  EXPECT_EQ(frames.assertedCount(), 2u);
+  EXPECT_EQ(frames.align(c2), 0u);
+  EXPECT_EQ(frames.assertedCount(), 2u);
+
+  // overlapping constraints only pop the frames after the common prefix
+  EXPECT_EQ(frames.align(c3), 1u);
+  EXPECT_EQ(frames.assertedCount(), 1u);
+  frames.pushFrame(c3);
+  EXPECT_EQ(frames.align(c1), 1u);
+  EXPECT_EQ(frames.assertedCount(), 1u);
+
+  // disjoint constraints pop everything
+  frames.pushFrame(c2);
+  EXPECT_EQ(frames.align(c4), 2u);
+  EXPECT_EQ(frames.assertedCount(), 0u);
+  frames.pushFrame(c4);
+
+  // empty constraints share no prefix with anything
+  EXPECT_EQ(frames.align(ConstraintManager()), 1u);
+  EXPECT_EQ(frames.assertedCount(), 0u);
+
+  frames.pushFrame(c1);
+  frames.pushFrame(c2);
+  EXPECT_EQ(frames.popAll(), 2u);
+  EXPECT_EQ(frames.assertedCount(), 0u);
+  EXPECT_EQ(frames.align(c2), 0u);
+  EXPECT_EQ(frames.assertedCount(), 0u);
+}
+
+/// Answers of the core solver to a sequence of queries whose constraint sets
+/// overlap, extend each other or are disjoint
+std::vector<bool> runIncrementalSequence() {
+  const Array *a = ac.CreateArray("incrementalA", 4);
+  const Array *b = ac.CreateArray("incrementalB", 4);
+  ref<Expr> ra = read32(a);
+  ref<Expr> rb = read32(b);
+
+  ConstraintManager c1;
+  c1.addConstraint(UltExpr::create(const32(5), ra));
+  ConstraintManager c2(c1);
+  c2.addConstraint(UltExpr::create(ra, const32(10)));
+  ConstraintManager c3(c1);
+  c3.addConstraint(UltExpr::create(ra, const32(3)));
+  ConstraintManager c4;
+  c4.addConstraint(UltExpr::create(rb, const32(2)));
+  ConstraintManager c5(c2);
+  c5.addConstraint(EqExpr::create(rb, ra));
+
+  std::vector<std::pair<const ConstraintManager *, ref<Expr>>> queries = {
+      {&c1, EqExpr::create(ra, const32(7))},
+      {&c2, UltExpr::create(const32(4), ra)},
+      {&c2, EqExpr::create(ra, const32(20))},
+      {&c3, EqExpr::create(ra, const32(1))},
+      {&c2, UltExpr::create(ra, const32(9))},
+      {&c4, EqExpr::create(rb, const32(1))},
+      {&c4, UltExpr::create(rb, const32(2))},
+      {&c5, UltExpr::create(const32(5), rb)},
+      {&c1, UltExpr::create(const32(9), ra)},
+  };
+
+  Solver *solver = createCoreSolver(CoreSolverToUse);
+  std::vector<bool> results;
+  for (const auto &query : queries) {
+    bool mustBeTrue = false;
+    bool mayBeTrue = false;
+    EXPECT_TRUE(solver->mustBeTrue(Query(*query.first, query.second), mustBeTrue));
+    EXPECT_TRUE(solver->mayBeTrue(Query(*query.first, query.second), mayBeTrue));
+    std::vector<std::vector<unsigned char>> values;
+    bool hasSolution = solver->getInitialValues(Query(*query.first, query.second), {a, b}, values);
+    results.push_back(mustBeTrue);
+    results.push_back(mayBeTrue);
+    results.push_back(hasSolution);
+  }
+  delete solver;
+  return results;
+}
+
+TEST(SolverTest, IncrementalMatchesNonIncremental) {
+  bool incremental = IncrementalCoreSolver;
+
+  IncrementalCoreSolver = false;
+  std::vector<bool> expected = runIncrementalSequence();
+  IncrementalCoreSolver = true;
+  std::vector<bool> actual = runIncrementalSequence();
+
+  IncrementalCoreSolver = incremental;
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(SolverTest, IncrementalFailure) {
+  bool incremental = IncrementalCoreSolver;
+  IncrementalCoreSolver = true;
+
+  const Array *x = ac.CreateArray("factorX", 4);
+  const Array *y = ac.CreateArray("factorY", 4);
+  ref<Expr> rx = ZExtExpr::create(read32(x), Expr::Int64);
+  ref<Expr> ry = ZExtExpr::create(read32(y), Expr::Int64);
+  ref<Expr> one = ConstantExpr::create(1, Expr::Int64);
+
+  ConstraintManager prefix;
+  prefix.addConstraint(UltExpr::create(one, rx));
+  prefix.addConstraint(UltExpr::create(one, ry));
+  // factoring the product of two large primes does not finish in time
+  ConstraintManager hard(prefix);
+  hard.addConstraint(EqExpr::create(
+      MulExpr::create(rx, ry),
+      ConstantExpr::create(4294967291ull * 4294967279ull, Expr::Int64)));
+
+  Solver *solver = createCoreSolver(CoreSolverToUse);
+  ref<Expr> nonZero = NeExpr::create(rx, ConstantExpr::create(0, Expr::Int64));
+  bool result = false;
+  ASSERT_TRUE(solver->mustBeTrue(Query(prefix, nonZero), result));
+  EXPECT_TRUE(result);
+
+  solver->setCoreSolverTimeout(time::Span("1ms"));
+  std::vector<std::vector<unsigned char>> values;
+  bool success = solver->getInitialValues(
+      Query(hard, ConstantExpr::create(0, Expr::Bool)), {x, y}, values);
+  solver->setCoreSolverTimeout(time::Span());
+
+  // after a failure, the prefix has to be asserted again instead of being
+  // assumed to still be asserted in the solver
+  uint64_t reused = stats::queryConstraintsReused;
+  result = false;
+  ASSERT_TRUE(solver->mustBeTrue(Query(prefix, nonZero), result));
+  EXPECT_TRUE(result);
+  if (!success) {
+    EXPECT_EQ(stats::queryConstraintsReused, reused);
+  } else {
+    EXPECT_EQ(stats::queryConstraintsReused, reused + prefix.size());
+  }
+
+  delete solver;
+  IncrementalCoreSolver = incremental;
+}
+
 }
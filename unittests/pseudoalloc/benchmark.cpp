@@ -0,0 +1,129 @@
+#include "pseudoalloc/pseudoalloc.h"
+#include "xoshiro.h"
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+	#include "gtest/gtest.h"
+#endif
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+	using clock_type = std::chrono::steady_clock;
+
+	double seconds_since(clock_type::time_point start) {
+		return std::chrono::duration<double>(clock_type::now() - start).count();
+	}
+
+	/// Keeps `live` objects with sizes in [min_size, max_size] allocated, replacing a random one in each iteration
+	class Workload {
+		xoshiro512 rng;
+		std::uniform_int_distribution<std::size_t> size_distribution;
+		std::vector<std::pair<void*, std::size_t>> allocations;
+
+	public:
+		Workload(std::size_t min_size, std::size_t max_size, std::uint64_t seed = 0x31337)
+		  : rng(seed)
+		  , size_distribution(min_size, max_size) {}
+
+		void fill(pseudoalloc::allocator_t& allocator, std::size_t live) {
+			while(allocations.size() < live) {
+				auto size = size_distribution(rng);
+				allocations.emplace_back(allocator.allocate(size), size);
+			}
+		}
+
+		void churn(pseudoalloc::allocator_t& allocator, std::uint64_t iterations) {
+			for(std::uint64_t i = 0; i < iterations; ++i) {
+				auto index = std::uniform_int_distribution<std::size_t>(0, allocations.size() - 1)(rng);
+				allocator.free(allocations[index].first, allocations[index].second);
+				auto size = size_distribution(rng);
+				allocations[index] = std::make_pair(allocator.allocate(size), size);
+			}
+		}
+
+		void clear(pseudoalloc::allocator_t& allocator) {
+			for(auto const& [ptr, size] : allocations) {
+				allocator.free(ptr, size);
+			}
+			allocations.clear();
+		}
+	};
+
+	void allocation_throughput(pseudoalloc::mapping_t& mapping, char const* name, std::size_t min_size,
+	                           std::size_t max_size, std::size_t live, std::uint64_t iterations) {
+		auto allocator = pseudoalloc::allocator_t(mapping, 0);
+		Workload workload(min_size, max_size);
+		workload.fill(allocator, live);
+
+		auto start = clock_type::now();
+		workload.churn(allocator, iterations);
+		auto elapsed = seconds_since(start);
+		workload.clear(allocator);
+
+		std::cout << name << " (" << live << " live objects): " << static_cast<std::uint64_t>(iterations / elapsed)
+		          << " allocations/s\n";
+	}
+
+	void copy_cost(pseudoalloc::mapping_t& mapping, std::size_t live, std::uint64_t copies) {
+		auto allocator = pseudoalloc::allocator_t(mapping, 0);
+		Workload small(1, 4096);
+		Workload large(4097, 1 << 20);
+		small.fill(allocator, live);
+		large.fill(allocator, live);
+
+		std::uint64_t sink = 0;
+		auto start = clock_type::now();
+		for(std::uint64_t i = 0; i < copies; ++i) {
+			auto copy = allocator;
+			sink += reinterpret_cast<std::uintptr_t>(&copy) & 1;
+		}
+		auto const copy_elapsed = seconds_since(start);
+
+		start = clock_type::now();
+		for(std::uint64_t i = 0; i < copies; ++i) {
+			// the first modification of a copy has to duplicate the state of the modified suballocators
+			auto copy = allocator;
+			auto* small_ptr = copy.allocate(8);
+			auto* large_ptr = copy.allocate(8192);
+			sink += reinterpret_cast<std::uintptr_t>(small_ptr) ^ reinterpret_cast<std::uintptr_t>(large_ptr);
+		}
+		auto const modify_elapsed = seconds_since(start);
+
+		small.clear(allocator);
+		large.clear(allocator);
+
+		std::cout << "copy (" << live << " small + " << live << " large live objects): "
+		          << static_cast<std::uint64_t>(copy_elapsed / copies * 1e9) << " ns, with first modification: "
+		          << static_cast<std::uint64_t>(modify_elapsed / copies * 1e9) << " ns"
+		          << (sink == 0 ? "" : " ") << "\n";
+	}
+} // namespace
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+int benchmark_test() {
+#else
+int main() {
+#endif
+	std::cout << "Using pseudoalloc" << (pseudoalloc::checked_build ? " (checked)" : " (unchecked)") << "\n";
+	auto mapping = pseudoalloc::mapping_t(static_cast<std::size_t>(1) << 44);
+
+	for(std::size_t live : {16, 256, 4096}) {
+		allocation_throughput(mapping, "small objects", 1, 4096, live, 200'000);
+		allocation_throughput(mapping, "large objects", 4097, 1 << 20, live, 200'000);
+		copy_cost(mapping, live, 1'000);
+	}
+
+	std::exit(0);
+}
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+// only a measurement, so it is disabled by default (run with --gtest_also_run_disabled_tests)
+TEST(PseudoallocDeathTest, DISABLED_Benchmark) { ASSERT_EXIT(benchmark_test(), ::testing::ExitedWithCode(0), ""); }
+#endif
@@ -0,0 +1,98 @@
+#include "pseudoalloc/pseudoalloc.h"
+#include "xoshiro.h"
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+	#include "gtest/gtest.h"
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+	/// Performs a random sequence of allocations and deallocations, recording every returned address
+	class Sequence {
+		xoshiro512 rng;
+		std::vector<std::pair<void*, std::size_t>> allocations;
+
+	public:
+		std::vector<void*> trace;
+
+		Sequence(std::uint64_t seed) : rng(seed) {}
+
+		void run(pseudoalloc::allocator_t& allocator, std::uint64_t const iterations) {
+			std::uniform_int_distribution<std::uint32_t> choice(0, 999);
+			std::uniform_int_distribution<std::size_t> small_size(1, 4096);
+			std::uniform_int_distribution<std::size_t> large_size(4097, 1 << 20);
+			for(std::uint64_t i = 0; i < iterations; ++i) {
+				auto chosen = choice(rng);
+				if(chosen < 600) {
+					auto size = small_size(rng);
+					allocations.emplace_back(allocator.allocate(size), size);
+					trace.emplace_back(allocations.back().first);
+				} else if(chosen < 650) {
+					auto size = large_size(rng);
+					allocations.emplace_back(allocator.allocate(size), size);
+					trace.emplace_back(allocations.back().first);
+				} else if(!allocations.empty()) {
+					auto index = std::uniform_int_distribution<std::size_t>(0, allocations.size() - 1)(rng);
+					allocator.free(allocations[index].first, allocations[index].second);
+					allocations[index] = allocations.back();
+					allocations.pop_back();
+				}
+			}
+		}
+	};
+} // namespace
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+int cow_test() {
+#else
+int main() {
+#endif
+	auto mapping = pseudoalloc::mapping_t(static_cast<std::size_t>(1) << 44);
+
+	for(std::uint32_t quarantine : {static_cast<std::uint32_t>(0), static_cast<std::uint32_t>(3)}) {
+		std::cout << "quarantine = " << quarantine << "\n";
+
+		auto original = pseudoalloc::allocator_t(mapping, quarantine);
+		Sequence prefix(0x31337);
+		prefix.run(original, 10'000);
+
+		// copies are independent of each other, but behave exactly like the allocator they were copied from
+		auto copy = original;
+		Sequence a = prefix;
+		Sequence b = prefix;
+		a.trace.clear();
+		b.trace.clear();
+		a.run(original, 10'000);
+		b.run(copy, 10'000);
+		assert(!a.trace.empty());
+		assert(a.trace == b.trace);
+
+		// diverging operations on a copy do not influence the allocator it was copied from
+		auto untouched = original;
+		Sequence diverging = b;
+		diverging.run(copy, 20'000);
+
+		Sequence c = a;
+		Sequence d = a;
+		c.trace.clear();
+		d.trace.clear();
+		c.run(original, 10'000);
+		d.run(untouched, 10'000);
+		assert(!c.trace.empty());
+		assert(c.trace == d.trace);
+	}
+
+	std::exit(0);
+}
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+TEST(PseudoallocDeathTest, CopyOnWrite) { ASSERT_EXIT(cow_test(), ::testing::ExitedWithCode(0), ""); }
+#endif
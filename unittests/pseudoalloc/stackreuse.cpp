@@ -0,0 +1,114 @@
+#include "pseudoalloc/pseudoalloc.h"
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+	#include "gtest/gtest.h"
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+int stack_reuse_test() {
+#else
+int main() {
+#endif
+	auto mapping = pseudoalloc::mapping_t(static_cast<std::size_t>(1) << 32);
+	auto allocator = pseudoalloc::stack_allocator_t(mapping, 0); /// allocator without a quarantine zone
+
+	static const std::size_t sizes[] = {1, 4, 24, 8, 3, 4096, 100'000, 16, 7};
+
+	std::vector<char*> frame;
+	for(auto size : sizes) {
+		auto* ptr = static_cast<char*>(allocator.allocate(size));
+		std::cout << "size = " << size << ": " << static_cast<void*>(ptr) << "\n";
+		assert(ptr);
+
+		// objects are aligned to the largest power of two not above their size
+		std::size_t alignment = 1;
+		while(alignment * 2 <= size && alignment < 4096) {
+			alignment *= 2;
+		}
+		assert(reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0);
+
+		// objects do not touch each other
+		if(!frame.empty()) {
+			assert(ptr > frame.back());
+		}
+		frame.push_back(ptr);
+	}
+	for(std::size_t i = 1; i < frame.size(); ++i) {
+		assert(frame[i - 1] + sizes[i - 1] < frame[i]);
+	}
+
+	// a copy continues from the same position and is independent of the original
+	auto copy = allocator;
+	auto* a = copy.allocate(32);
+	copy.free(a, 32);
+
+	// freeing and reallocating the same objects returns the same addresses
+	for(std::size_t i = frame.size(); i-- > 0;) {
+		allocator.free(frame[i], sizes[i]);
+	}
+	for(std::size_t i = 0; i < frame.size(); ++i) {
+		auto* ptr = allocator.allocate(sizes[i]);
+		assert(ptr == frame[i]);
+	}
+
+	auto* b = allocator.allocate(32);
+	assert(a == b);
+
+	std::exit(0);
+}
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+int stack_quarantine_test() {
+	auto mapping = pseudoalloc::mapping_t(static_cast<std::size_t>(1) << 32);
+	auto allocator = pseudoalloc::stack_allocator_t(mapping, 2);
+
+	// a popped frame is not reused while it is quarantined
+	auto* a = static_cast<char*>(allocator.allocate(64));
+	auto* b = static_cast<char*>(allocator.allocate(64));
+	allocator.free(b, 64);
+	allocator.free(a, 64);
+	auto* c = static_cast<char*>(allocator.allocate(64));
+	assert(c >= b + 64);
+	allocator.free(c, 64);
+
+	// objects leave the quarantine after two more deallocations, so repeatedly pushing and popping the same frame
+	// cycles through three locations
+	char* frames[6];
+	for(auto& frame : frames) {
+		frame = static_cast<char*>(allocator.allocate(64));
+		allocator.free(frame, 64);
+	}
+	for(std::size_t i = 0; i < 6; ++i) {
+		for(std::size_t j = 1; j <= 2 && j <= i; ++j) {
+			assert(frames[i] != frames[i - j]);
+		}
+		if(i >= 3) {
+			assert(frames[i] == frames[i - 3]);
+		}
+	}
+
+	// an unlimited quarantine never reuses addresses
+	auto unlimited = pseudoalloc::stack_allocator_t(mapping, pseudoalloc::stack_allocator_t::unlimited_quarantine);
+	char* previous = nullptr;
+	for(int i = 0; i < 16; ++i) {
+		auto* ptr = static_cast<char*>(unlimited.allocate(24));
+		assert(ptr > previous);
+		unlimited.free(ptr, 24);
+		previous = ptr;
+	}
+
+	std::exit(0);
+}
+#endif
+
+#if defined(USE_GTEST_INSTEAD_OF_MAIN)
+TEST(PseudoallocDeathTest, StackReuse) { ASSERT_EXIT(stack_reuse_test(), ::testing::ExitedWithCode(0), ""); }
+TEST(PseudoallocDeathTest, StackQuarantine) { ASSERT_EXIT(stack_quarantine_test(), ::testing::ExitedWithCode(0), ""); }
+#endif